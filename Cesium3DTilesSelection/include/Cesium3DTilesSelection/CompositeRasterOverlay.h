@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Library.h"
+#include "RasterOverlay.h"
+
+#include <CesiumUtility/IntrusivePointer.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+
+/**
+ * @brief How the image of a {@link CompositeRasterOverlayLayer} is combined
+ * with the images of the layers beneath it.
+ *
+ * In every mode, the layer's alpha, multiplied by its
+ * {@link CompositeRasterOverlayLayer::opacity}, controls how much of the
+ * blended color covers the layers beneath it.
+ */
+enum class RasterOverlayBlendMode {
+  /**
+   * @brief The layer's color is drawn over the layers beneath it.
+   */
+  Normal,
+
+  /**
+   * @brief The layer's color is multiplied with the color beneath it, which
+   * darkens it. This is useful for hillshades.
+   */
+  Multiply,
+
+  /**
+   * @brief The inverse of the layer's color is multiplied with the inverse of
+   * the color beneath it, which lightens it.
+   */
+  Screen
+};
+
+/**
+ * @brief A layer of a {@link CompositeRasterOverlay}.
+ */
+struct CESIUM3DTILESSELECTION_API CompositeRasterOverlayLayer {
+  /**
+   * @brief The overlay whose images are drawn in this layer.
+   *
+   * The options of this overlay that select its images, such as
+   * {@link RasterOverlayOptions::maximumTextureSize} and
+   * {@link RasterOverlayOptions::reprojection}, are used. Tiles are loaded,
+   * compressed, and prepared for rendering by the composite overlay, so the
+   * options that control those steps are taken from it instead.
+   */
+  CesiumUtility::IntrusivePointer<RasterOverlay> pOverlay;
+
+  /**
+   * @brief How this layer is combined with the layers beneath it.
+   */
+  RasterOverlayBlendMode blendMode = RasterOverlayBlendMode::Normal;
+
+  /**
+   * @brief The opacity of this layer, from 0.0 for invisible to 1.0 for the
+   * layer's own alpha.
+   */
+  float opacity = 1.0f;
+};
+
+/**
+ * @brief A raster overlay that blends the images of several other overlays
+ * into a single image per tile.
+ *
+ * Each overlay added to a {@link RasterOverlayCollection} is draped with its
+ * own texture, so every overlay adds a texture binding and an upload for each
+ * geometry tile. Adding the overlays as layers of this overlay instead blends
+ * them into one image in a worker thread while each tile loads, so they are
+ * uploaded and drawn as a single texture.
+ *
+ * All layers must share a projection, which is the projection of the first
+ * layer whose tile provider is created successfully. A layer can be brought
+ * into that projection with {@link RasterOverlayOptions::reprojection}. The
+ * images of every layer are loaded for the same rectangle and level-of-detail,
+ * and resampled to the resolution of the most detailed one where they differ.
+ * Layers are drawn from the first to the last, so the last layer is on top.
+ */
+class CESIUM3DTILESSELECTION_API CompositeRasterOverlay final
+    : public RasterOverlay {
+public:
+  /**
+   * @brief Creates a new instance.
+   *
+   * @param name The user-given name of this overlay layer.
+   * @param layers The layers to blend, from the bottom to the top.
+   * @param overlayOptions The {@link RasterOverlayOptions} for this instance.
+   */
+  CompositeRasterOverlay(
+      const std::string& name,
+      const std::vector<CompositeRasterOverlayLayer>& layers,
+      const RasterOverlayOptions& overlayOptions = RasterOverlayOptions());
+  virtual ~CompositeRasterOverlay() override;
+
+  /**
+   * @brief Gets the layers of this overlay, from the bottom to the top.
+   */
+  const std::vector<CompositeRasterOverlayLayer>& getLayers() const noexcept {
+    return this->_layers;
+  }
+
+  /**
+   * @copydoc RasterOverlay::createTileProvider
+   */
+  virtual CesiumAsync::Future<CreateTileProviderResult> createTileProvider(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAssetAccessor,
+      const std::shared_ptr<CreditSystem>& pCreditSystem,
+      const std::shared_ptr<IPrepareRendererResources>&
+          pPrepareRendererResources,
+      const std::shared_ptr<spdlog::logger>& pLogger,
+      CesiumUtility::IntrusivePointer<const RasterOverlay> pOwner)
+      const override;
+
+private:
+  std::vector<CompositeRasterOverlayLayer> _layers;
+};
+
+} // namespace Cesium3DTilesSelection
@@ -4,12 +4,14 @@
 
 #include <Cesium3DTilesSelection/CreditSystem.h>
 #include <Cesium3DTilesSelection/RasterOverlayDetails.h>
+#include <CesiumGeometry/OrientedBoundingBox.h>
 #include <CesiumGeospatial/BoundingRegion.h>
 #include <CesiumGeospatial/GlobeRectangle.h>
 #include <CesiumGltf/Model.h>
 
 #include <glm/glm.hpp>
 
+#include <optional>
 #include <vector>
 
 namespace Cesium3DTilesSelection {
@@ -123,6 +125,29 @@ struct CESIUM3DTILESSELECTION_API GltfUtilities {
       const CesiumGltf::Model& gltf,
       const glm::dmat4& transform);
 
+  /**
+   * @brief Computes an oriented bounding box with the given orientation that
+   * contains the vertex positions in a glTF model.
+   *
+   * The box is found by projecting every vertex position onto each of the
+   * given axes and taking the smallest and largest results, so it is only as
+   * tight as the axes are well-suited to the model. Each instance of a mesh
+   * instanced with `EXT_mesh_gpu_instancing` is bounded by the mesh's own box
+   * under the instance transform.
+   *
+   * @param gltf The model.
+   * @param transform The transform from model coordinates to ECEF coordinates.
+   * @param axes The directions of the box's axes in ECEF coordinates. Each
+   * column must be a unit vector, and the columns must be perpendicular to
+   * each other.
+   * @return The computed box, or `std::nullopt` if the glTF contains no
+   * geometry or its instance transforms can't be read.
+   */
+  static std::optional<CesiumGeometry::OrientedBoundingBox> computeBoundingBox(
+      const CesiumGltf::Model& gltf,
+      const glm::dmat4& transform,
+      const glm::dmat3& axes);
+
   /**
    * @brief Parse the copyright field of a gltf model and create credits for it.
    *
@@ -14,6 +14,8 @@
 #include <list>
 #include <memory>
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace Cesium3DTilesSelection {
 
@@ -56,6 +58,9 @@ public:
       uint32_t imageWidth,
       uint32_t imageHeight) noexcept;
 
+  /** @brief Destroys this instance, releasing its cached images. */
+  virtual ~QuadtreeRasterOverlayTileProvider() noexcept override;
+
   /**
    * @brief Returns the minimum tile level of this instance.
    */
@@ -97,6 +102,9 @@ public:
       const CesiumGeometry::Rectangle& rectangle,
       const glm::dvec2& screenPixels);
 
+  /** @copydoc RasterOverlayTileProvider::removeTile */
+  virtual void removeTile(RasterOverlayTile* pTile) noexcept override;
+
 protected:
   /**
    * @brief Asynchronously loads a tile in the quadtree.
@@ -108,6 +116,42 @@ protected:
   virtual CesiumAsync::Future<LoadedRasterOverlayImage>
   loadQuadtreeTileImage(const CesiumGeometry::QuadtreeTileID& tileID) const = 0;
 
+  /**
+   * @brief Asynchronously loads several tiles in the quadtree.
+   *
+   * This is called instead of {@link loadQuadtreeTileImage} when more than one
+   * quadtree tile that is not already cached is needed to cover a
+   * {@link RasterOverlayTile}. A provider for a server that can return several
+   * tiles in one response, such as an image of a bounding box or an archive of
+   * tiles, can override this to request them all at once and split the
+   * response. The default implementation calls {@link loadQuadtreeTileImage}
+   * for each tile.
+   *
+   * A tile whose image has errors is replaced by its parent tile, which is
+   * loaded with {@link loadQuadtreeTileImage}, as if it had been loaded alone.
+   *
+   * @param tileIDs The IDs of the quadtree tiles to load, which are all at the
+   * same level.
+   * @return A Future that resolves to the loaded image data or error
+   * information of each tile, in the order of `tileIDs`.
+   */
+  virtual CesiumAsync::Future<std::vector<LoadedRasterOverlayImage>>
+  loadQuadtreeTileImages(
+      const std::vector<CesiumGeometry::QuadtreeTileID>& tileIDs) const;
+
+  /**
+   * @brief Creates a tile, or reuses the tile for a single quadtree tile when
+   * {@link RasterOverlayOptions::shareQuadtreeTiles} is enabled.
+   *
+   * @param rectangle The rectangle that the returned tile must cover.
+   * @param targetScreenPixels The maximum number of pixels on the screen that
+   * the tile is meant to cover.
+   * @return The tile.
+   */
+  virtual CesiumUtility::IntrusivePointer<RasterOverlayTile> createTile(
+      const CesiumGeometry::Rectangle& rectangle,
+      const glm::dvec2& targetScreenPixels) override;
+
 private:
   virtual CesiumAsync::Future<LoadedRasterOverlayImage>
   loadTileImage(RasterOverlayTile& overlayTile) override final;
@@ -120,18 +164,24 @@ private:
   CesiumAsync::SharedFuture<LoadedQuadtreeImage>
   getQuadtreeTile(const CesiumGeometry::QuadtreeTileID& tileID);
 
+  CesiumAsync::SharedFuture<LoadedQuadtreeImage> cacheQuadtreeTile(
+      const CesiumGeometry::QuadtreeTileID& tileID,
+      CesiumAsync::Future<LoadedRasterOverlayImage>&& loadFuture);
+
+  std::vector<CesiumAsync::SharedFuture<LoadedQuadtreeImage>>
+  loadQuadtreeTileBatch(
+      const std::vector<CesiumGeometry::QuadtreeTileID>& tileIDs);
+
   /**
    * @brief Map raster tiles to geometry tile.
    *
    * @param geometryRectangle The rectangle for which to load tiles.
-   * @param targetGeometricError The geometric error controlling which quadtree
-   * level to use to cover the rectangle.
-   * @return A vector of shared futures, each of which will resolve to image
-   * data that is required to cover the rectangle with the given geometric
-   * error.
+   * @param targetScreenPixels The number of screen pixels controlling which
+   * quadtree level to use to cover the rectangle.
+   * @return The IDs of the quadtree tiles that are required to cover the
+   * rectangle at the selected level.
    */
-  std::vector<CesiumAsync::SharedFuture<LoadedQuadtreeImage>>
-  mapRasterTilesToGeometryTile(
+  std::vector<CesiumGeometry::QuadtreeTileID> mapRasterTilesToGeometryTile(
       const CesiumGeometry::Rectangle& geometryRectangle,
       const glm::dvec2 targetScreenPixels);
 
@@ -177,5 +227,13 @@ private:
       _tileLookup;
 
   std::atomic<int64_t> _cachedBytes;
+
+  // The tiles created for a single quadtree tile when
+  // RasterOverlayOptions::shareQuadtreeTiles is enabled. These are not owned;
+  // a tile removes itself via removeTile when its last reference is released.
+  std::unordered_map<CesiumGeometry::QuadtreeTileID, RasterOverlayTile*>
+      _sharedTiles;
+  std::unordered_map<const RasterOverlayTile*, CesiumGeometry::QuadtreeTileID>
+      _sharedTileIDs;
 };
 } // namespace Cesium3DTilesSelection
@@ -184,6 +184,19 @@ public:
    */
   bool loadThrottled() noexcept;
 
+  /**
+   * @brief Requests that the mapped {@link RasterOverlayTile} be loaded with
+   * the given priority.
+   *
+   * The load starts at the next call to
+   * {@link RasterOverlayTileProvider::processTileLoadQueue}, if it is among
+   * the most important requests.
+   *
+   * @param priority The relative priority of loading the tile. Lower priority
+   * values load sooner.
+   */
+  void queueLoad(double priority);
+
   /**
    * @brief Creates a maping between a {@link RasterOverlay} and a {@link Tile}.
    *
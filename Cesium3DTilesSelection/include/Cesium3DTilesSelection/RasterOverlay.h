@@ -4,6 +4,7 @@
 #include "RasterOverlayLoadFailureDetails.h"
 
 #include <CesiumAsync/IAssetAccessor.h>
+#include <CesiumGeospatial/Projection.h>
 #include <CesiumGltf/Ktx2TranscodeTargets.h>
 #include <CesiumUtility/IntrusivePointer.h>
 #include <CesiumUtility/ReferenceCountedNonThreadSafe.h>
@@ -25,6 +26,39 @@ class IPrepareRendererResources;
 class RasterOverlayTileProvider;
 class RasterOverlayCollection;
 
+/**
+ * @brief Options for resampling the images of a raster overlay into a
+ * different projection.
+ *
+ * @see RasterOverlayOptions::reprojection
+ */
+struct CESIUM3DTILESSELECTION_API RasterOverlayReprojectionOptions {
+  /**
+   * @brief The projection to resample the overlay's images into.
+   */
+  CesiumGeospatial::Projection projection =
+      CesiumGeospatial::GeographicProjection();
+
+  /**
+   * @brief The width of each resampled image, in pixels, or 0 to use the
+   * width of the image it is resampled from.
+   */
+  int32_t imageWidth = 0;
+
+  /**
+   * @brief The height of each resampled image, in pixels, or 0 to use the
+   * height of the image it is resampled from.
+   */
+  int32_t imageHeight = 0;
+
+  /**
+   * @brief The maximum number of bytes of resampled images to cache in memory,
+   * so that a tile that is unloaded and then needed again is not resampled
+   * again.
+   */
+  int64_t cacheBytes = 16 * 1024 * 1024;
+};
+
 /**
  * @brief Options for loading raster overlays.
  */
@@ -48,6 +82,42 @@ struct CESIUM3DTILESSELECTION_API RasterOverlayOptions {
    */
   int64_t subTileCacheBytes = 16 * 1024 * 1024;
 
+  /**
+   * @brief Whether geometry tiles that are covered by a single sub-tile
+   * share a raster overlay tile for that sub-tile, rather than each receiving
+   * their own copy of its pixels.
+   *
+   * This is used by provider types, such as
+   * {@link QuadtreeRasterOverlayTileProvider}, that have an underlying tiling
+   * scheme. When enabled, every geometry tile that falls within a single
+   * quadtree tile is given the same {@link RasterOverlayTile}, whose rectangle
+   * is that of the quadtree tile, and the
+   * {@link RasterMappedTo3DTile::getTranslation} and
+   * {@link RasterMappedTo3DTile::getScale} select the part of it that covers
+   * each geometry tile. The image is loaded and prepared for rendering only
+   * once. Geometry tiles that need more than one quadtree tile still receive
+   * an image combined from all of them.
+   */
+  bool shareQuadtreeTiles = false;
+
+  /**
+   * @brief Resamples this overlay's images into another projection.
+   *
+   * By default, each overlay is draped using texture coordinates generated for
+   * its own projection, so geometry draped with overlays in several
+   * projections needs a set of texture coordinates for each. When this is set
+   * to a projection that differs from the overlay's own, the overlay's tile
+   * provider reports this projection from
+   * {@link RasterOverlayTileProvider::getTileProjection}, loads each image in
+   * its own projection, and resamples it with bilinear filtering in a worker
+   * thread.
+   *
+   * Only uncompressed images with one byte per channel can be resampled, so
+   * {@link ktx2TranscodeTargets} should not select a compressed format when
+   * this is set.
+   */
+  std::optional<RasterOverlayReprojectionOptions> reprojection;
+
   /**
    * @brief The maximum pixel size of raster overlay textures, in either
    * direction.
@@ -77,6 +147,23 @@ struct CESIUM3DTILESSELECTION_API RasterOverlayOptions {
    */
   CesiumGltf::Ktx2TranscodeTargets ktx2TranscodeTargets;
 
+  /**
+   * @brief Whether to compress this overlay's images into a GPU compressed
+   * pixel format in a worker thread after they are loaded.
+   *
+   * Raster overlay images are otherwise decoded to uncompressed RGBA pixels,
+   * which take four to eight times as much memory. The format is the one that
+   * {@link ktx2TranscodeTargets} selects for ETC1S textures: `ETC1S_RGB` for
+   * images that are entirely opaque and `ETC1S_RGBA` for others. `BC1_RGB`,
+   * `BC3_RGBA`, `ETC1_RGB`, and `ETC2_RGBA` are supported, and `BC7_RGBA` is
+   * replaced with `BC1_RGB` or `BC3_RGBA`. Images are left uncompressed when
+   * the selected format is not supported.
+   *
+   * Because mip levels can't be generated for a compressed image on the GPU,
+   * they are generated before the image is compressed.
+   */
+  bool compressImages = false;
+
   /**
    * @brief A callback function that is invoked when a raster overlay resource
    * fails to load.
@@ -3,6 +3,7 @@
 #include "CreditSystem.h"
 #include "Library.h"
 #include "RasterMappedTo3DTile.h"
+#include "RasterOverlay.h"
 
 #include <CesiumAsync/IAssetAccessor.h>
 #include <CesiumGeospatial/Projection.h>
@@ -14,6 +15,7 @@
 #include <spdlog/fwd.h>
 
 #include <cassert>
+#include <memory>
 #include <optional>
 
 namespace Cesium3DTilesSelection {
@@ -21,6 +23,7 @@ namespace Cesium3DTilesSelection {
 class RasterOverlay;
 class RasterOverlayTile;
 class IPrepareRendererResources;
+class ReprojectedImageCache;
 
 /**
  * @brief Summarizes the result of loading an image of a {@link RasterOverlay}.
@@ -233,11 +236,24 @@ public:
 
   /**
    * @brief Returns the {@link CesiumGeospatial::Projection} of this instance.
+   *
+   * This is the projection of the images loaded by {@link loadTileImage}.
    */
   const CesiumGeospatial::Projection& getProjection() const noexcept {
     return this->_projection;
   }
 
+  /**
+   * @brief Returns the {@link CesiumGeospatial::Projection} of the tiles
+   * returned by {@link getTile}.
+   *
+   * This is the same as {@link getProjection}, unless the
+   * {@link RasterOverlayOptions::reprojection} of the owner selects a
+   * different projection when this instance is created. In that case the
+   * images are resampled into this projection after they are loaded.
+   */
+  const CesiumGeospatial::Projection& getTileProjection() const noexcept;
+
   /**
    * @brief Returns the coverage {@link CesiumGeometry::Rectangle} of this
    * instance.
@@ -246,6 +262,14 @@ public:
     return this->_coverageRectangle;
   }
 
+  /**
+   * @brief Returns the coverage {@link CesiumGeometry::Rectangle} of this
+   * instance, expressed in the {@link getTileProjection}.
+   */
+  const CesiumGeometry::Rectangle& getTileCoverageRectangle() const noexcept {
+    return this->_tileCoverageRectangle;
+  }
+
   /**
    * @brief Returns a new {@link RasterOverlayTile} with the given
    * specifications.
@@ -254,16 +278,18 @@ public:
    * call {@link RasterOverlayTileProvider::loadTile} or
    * {@link RasterOverlayTileProvider::loadTileThrottled}.
    *
-   * @param rectangle The rectangle that the returned image must cover. It is
-   * allowed to cover a slightly larger rectangle in order to maintain pixel
-   * alignment. It may also cover a smaller rectangle when the overlay itself
-   * does not cover the entire rectangle.
+   * @param rectangle The rectangle that the returned image must cover,
+   * expressed in the {@link getTileProjection}. It is allowed to cover a
+   * slightly larger rectangle in order to maintain pixel alignment. It may
+   * also cover a smaller rectangle when the overlay itself does not cover the
+   * entire rectangle.
    * @param targetScreenPixels The maximum number of pixels on the screen that
    * this tile is meant to cover. The overlay image should be approximately this
    * many pixels divided by the
    * {@link RasterOverlayOptions::maximumScreenSpaceError} in order to achieve
    * the desired level-of-detail, but it does not need to be exactly this size.
-   * @return The tile.
+   * @return The tile. Depending on the provider, this may be a tile that
+   * covers a larger rectangle and is shared with other callers.
    */
   CesiumUtility::IntrusivePointer<RasterOverlayTile> getTile(
       const CesiumGeometry::Rectangle& rectangle,
@@ -292,7 +318,7 @@ public:
    *
    * @param pTile The tile, which must have no oustanding references.
    */
-  void removeTile(RasterOverlayTile* pTile) noexcept;
+  virtual void removeTile(RasterOverlayTile* pTile) noexcept;
 
   /**
    * @brief Get the per-TileProvider {@link Credit} if one exists.
@@ -338,7 +364,51 @@ public:
    */
   bool loadTileThrottled(RasterOverlayTile& tile);
 
+  /**
+   * @brief Requests that a tile be loaded by the next call to
+   * {@link processTileLoadQueue}.
+   *
+   * Requests are kept only until the next call to
+   * {@link processTileLoadQueue}, so a tile that is still needed must be
+   * requested again, with its current priority, before each call. A tile that
+   * is requested more than once is loaded at its highest priority. Tiles that
+   * are not in the `RasterOverlayTile::LoadState::Unloaded` state, and tiles
+   * of a placeholder, are ignored.
+   *
+   * @param tile The tile to load.
+   * @param priority The relative priority of loading this tile, usually that
+   * of the geometry tile it is draped on. Lower priority values load sooner.
+   */
+  void queueTileLoad(RasterOverlayTile& tile, double priority);
+
+  /**
+   * @brief Starts loading the tiles requested with {@link queueTileLoad}, in
+   * order of priority, until too many tile loads are in progress.
+   *
+   * This uses the same limit as {@link loadTileThrottled}. Requests for tiles
+   * that could not be started are discarded, so that a tile that is no longer
+   * needed does not take the place of one that is.
+   */
+  void processTileLoadQueue();
+
 protected:
+  /**
+   * @brief Creates the tile returned by {@link getTile}.
+   *
+   * This is only called for non-placeholder providers, and only when the
+   * rectangle overlaps this provider's coverage rectangle. The default
+   * implementation creates a new tile covering exactly the given rectangle.
+   * Derived classes may override it to return an existing tile instead.
+   *
+   * @param rectangle The rectangle that the returned tile must cover.
+   * @param targetScreenPixels The maximum number of pixels on the screen that
+   * the tile is meant to cover.
+   * @return The tile.
+   */
+  virtual CesiumUtility::IntrusivePointer<RasterOverlayTile> createTile(
+      const CesiumGeometry::Rectangle& rectangle,
+      const glm::dvec2& targetScreenPixels);
+
   /**
    * @brief Loads the image for a tile.
    *
@@ -364,6 +434,22 @@ protected:
       LoadTileImageFromUrlOptions&& options = {}) const;
 
 private:
+  friend class CompositeRasterOverlayTileProvider;
+
+  /**
+   * @brief Loads the image for a tile in the {@link getTileProjection},
+   * resampling it when the images are reprojected.
+   *
+   * @param tile The tile for which to load the image.
+   * @param pSourceTile Set to the temporary tile that the image is loaded for
+   * in this instance's own projection, if any. It must be kept alive until
+   * the returned future resolves, and released in the main thread.
+   * @return A future that resolves to the image or error information.
+   */
+  CesiumAsync::Future<LoadedRasterOverlayImage> loadTileImageInTileProjection(
+      RasterOverlayTile& tile,
+      CesiumUtility::IntrusivePointer<RasterOverlayTile>& pSourceTile);
+
   void doLoad(RasterOverlayTile& tile, bool isThrottledLoad);
 
   /**
@@ -394,10 +480,27 @@ private:
   std::shared_ptr<spdlog::logger> _pLogger;
   CesiumGeospatial::Projection _projection;
   CesiumGeometry::Rectangle _coverageRectangle;
+
+  // Set when the images are resampled into another projection, along with
+  // the coverage rectangle in that projection and the resampled images.
+  std::optional<RasterOverlayReprojectionOptions> _reprojection;
+  CesiumGeometry::Rectangle _tileCoverageRectangle;
+  std::shared_ptr<ReprojectedImageCache> _pReprojectedImages;
   CesiumUtility::IntrusivePointer<RasterOverlayTile> _pPlaceholder;
   int64_t _tileDataBytes;
   int32_t _totalTilesCurrentlyLoading;
   int32_t _throttledTilesCurrentlyLoading;
+
+  struct TileLoadRequest {
+    CesiumUtility::IntrusivePointer<RasterOverlayTile> pTile;
+    double priority;
+
+    bool operator<(const TileLoadRequest& rhs) const noexcept {
+      return this->priority < rhs.priority;
+    }
+  };
+
+  std::vector<TileLoadRequest> _tileLoadQueue;
   CESIUM_TRACE_DECLARE_TRACK_SET(
       _loadingSlots,
       "Raster Overlay Tile Loading Slot");
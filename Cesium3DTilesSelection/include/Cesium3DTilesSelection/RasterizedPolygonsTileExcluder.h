@@ -3,8 +3,11 @@
 #include "ITileExcluder.h"
 #include "Library.h"
 
+#include <CesiumGeospatial/GlobeRectangle.h>
 #include <CesiumUtility/IntrusivePointer.h>
 
+#include <unordered_map>
+
 namespace Cesium3DTilesSelection {
 
 class RasterizedPolygonsOverlay;
@@ -31,6 +34,10 @@ public:
    * @brief Determines whether a given tile is entirely inside a polygon and
    * therefore should be excluded.
    *
+   * The result for each tile is remembered along with the tile's bounding
+   * rectangle, so asking again about the same tile in a later frame does not
+   * test the polygons again.
+   *
    * @param tile The tile to check.
    * @return true if the tile should be excluded because it is entirely inside a
    * polygon.
@@ -43,7 +50,16 @@ public:
   const RasterizedPolygonsOverlay& getOverlay() const;
 
 private:
+  struct CachedResult {
+    CesiumGeospatial::GlobeRectangle rectangle;
+    bool exclude;
+  };
+
   CesiumUtility::IntrusivePointer<const RasterizedPolygonsOverlay> _pOverlay;
+
+  // Keyed by tile, but only valid if the rectangle still matches the tile's
+  // bounding volume, because a destroyed tile's address may be reused.
+  mutable std::unordered_map<const Tile*, CachedResult> _cache;
 };
 
 } // namespace Cesium3DTilesSelection
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "BoundingVolume.h"
+#include "Library.h"
+#include "TileOcclusionRendererProxy.h"
+#include "ViewState.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+
+/**
+ * @brief A {@link TileOcclusionRendererProxyPool} that determines occlusion
+ * on the CPU, for applications that have no renderer to run occlusion queries,
+ * such as those that only call {@link Tileset::updateViewOffline}.
+ *
+ * Before each call to {@link Tileset::updateView} or
+ * {@link Tileset::updateViewOffline}, call {@link updateOccluders} with the
+ * same views and with the tiles that were rendered the previous time. The
+ * triangles of those tiles are rasterized into a small hierarchical depth
+ * buffer for each view, and a tile is reported as occluded when its bounding
+ * volume is hidden behind them in every view.
+ *
+ * Occluders are rasterized conservatively: the triangles of each tile are
+ * rasterized together, and a texel of the depth buffer only hides what is
+ * behind it when the tile's triangles cover all of it. Triangles are joined
+ * where they share the exact positions of an edge's vertices, so gaps between
+ * them are never treated as closed, however narrow. Each texel holds the
+ * farthest depth of the triangles overlapping it, and bounding volumes are
+ * tested against every texel that they may cover.
+ *
+ * Set {@link TilesetExternals::pTileOcclusionProxyPool} to an instance of this
+ * class to use it.
+ */
+class CESIUM3DTILESSELECTION_API SoftwareTileOcclusionProxyPool final
+    : public TileOcclusionRendererProxyPool {
+public:
+  /**
+   * @brief Constructs a new instance.
+   *
+   * @param maximumPoolSize The maximum number of tiles that occlusion is
+   * tracked for at once.
+   * @param depthBufferWidth The width of the depth buffer for each view, in
+   * texels.
+   * @param depthBufferHeight The height of the depth buffer for each view, in
+   * texels.
+   */
+  SoftwareTileOcclusionProxyPool(
+      int32_t maximumPoolSize,
+      uint32_t depthBufferWidth = 256,
+      uint32_t depthBufferHeight = 128);
+
+  /**
+   * @brief Destroys this pool and all of its proxies.
+   */
+  ~SoftwareTileOcclusionProxyPool() noexcept override;
+
+  /**
+   * @brief Rasterizes the given tiles into a depth buffer for each of the
+   * given views, replacing anything rasterized before.
+   *
+   * Only tiles with loaded renderable content contribute. Triangles that are
+   * partially behind the eye of a view are skipped for that view.
+   *
+   * @param frustums The views that the tileset will be updated with next.
+   * @param occluders The tiles whose content hides the tiles behind it,
+   * typically {@link ViewUpdateResult::tilesToRenderThisFrame} from the
+   * previous update.
+   */
+  void updateOccluders(
+      const std::vector<ViewState>& frustums,
+      const std::vector<Tile*>& occluders);
+
+  /**
+   * @brief Determines whether a bounding volume is hidden in every view given
+   * to the last call to {@link updateOccluders}.
+   *
+   * @param boundingVolume The bounding volume.
+   * @return true if the bounding volume is hidden in every view, or false if
+   * it may be visible in at least one view or if there are no views.
+   */
+  bool isOccluded(const BoundingVolume& boundingVolume) const noexcept;
+
+protected:
+  TileOcclusionRendererProxy* createProxy() override;
+  void destroyProxy(TileOcclusionRendererProxy* pProxy) override;
+
+private:
+  class Proxy;
+  struct OccluderView;
+
+  uint32_t _depthBufferWidth;
+  uint32_t _depthBufferHeight;
+  std::vector<std::unique_ptr<OccluderView>> _views;
+};
+
+} // namespace Cesium3DTilesSelection
@@ -15,6 +15,7 @@
 
 #include <rapidjson/fwd.h>
 
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -161,6 +162,31 @@ public:
   const ViewUpdateResult&
   updateViewOffline(const std::vector<ViewState>& frustums);
 
+  /**
+   * @brief Updates the tileset for each of many sets of views, waiting for the
+   * tiles needed by each to finish loading, like
+   * {@link Tileset::updateViewOffline}.
+   *
+   * This is much faster than calling {@link Tileset::updateViewOffline} for
+   * each set of views in turn. The view sets are processed in batches, and the
+   * tiles needed by every view set in a batch are loaded together, so a tile
+   * needed by several view sets is only requested once and many loads are in
+   * flight at a time. Then the selection for each view set is reported as it
+   * is computed.
+   *
+   * @param viewSets The sets of {@link ViewState}s to update the tileset for.
+   * Each set is handled as if it were passed to
+   * {@link Tileset::updateViewOffline}.
+   * @param callback The function to call with the index of each view set and
+   * the tiles to render for it, in the order of `viewSets`. The result is only
+   * valid until the callback returns.
+   * @param options Options for controlling the batching and load concurrency.
+   */
+  void updateViewsOffline(
+      const std::vector<std::vector<ViewState>>& viewSets,
+      const std::function<void(size_t, const ViewUpdateResult&)>& callback,
+      const OfflineViewUpdateOptions& options = {});
+
   /**
    * @brief Updates this view, returning the set of tiles to render in this
    * view.
@@ -374,6 +400,7 @@ private:
       double tilePriority);
 
   void _processLoadQueue();
+  void _processRasterOverlayLoadQueue();
   void _unloadCachedTiles(double timeBudget) noexcept;
   void _markTileVisited(Tile& tile) noexcept;
 
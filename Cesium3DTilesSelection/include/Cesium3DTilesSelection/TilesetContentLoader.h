@@ -15,6 +15,7 @@
 
 #include <spdlog/logger.h>
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -76,6 +77,14 @@ struct CESIUM3DTILESSELECTION_API TileLoadInput {
    * @brief The request headers that will be attached to the request.
    */
   const std::vector<CesiumAsync::IAssetAccessor::THeader>& requestHeaders;
+
+  /**
+   * @brief The maximum width and height of the images in the tile's content,
+   * or 0 if images should be decoded at their full resolution.
+   *
+   * This is passed on to {@link CesiumGltfReader::GltfReaderOptions::maximumImageDimension}.
+   */
+  int32_t maximumImageDimension = 0;
 };
 
 /**
@@ -62,7 +62,8 @@ public:
    * tile bounding volumes.
    *
    * If not specified, the traversal will not attempt to leverage occlusion
-   * information.
+   * information. Applications without a renderer that can run occlusion
+   * queries can use a {@link SoftwareTileOcclusionProxyPool}.
    */
   std::shared_ptr<TileOcclusionRendererProxyPool> pTileOcclusionProxyPool =
       nullptr;
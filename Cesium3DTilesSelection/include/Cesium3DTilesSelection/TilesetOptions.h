@@ -4,6 +4,7 @@
 
 #include <CesiumGltf/Ktx2TranscodeTargets.h>
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -40,11 +41,60 @@ struct CESIUM3DTILESSELECTION_API TilesetContentOptions {
    */
   bool generateMissingNormalsSmooth = false;
 
+  /**
+   * @brief Whether to replace each tile's bounding box or bounding sphere
+   * with a tighter box computed from the tile's content once it is loaded.
+   *
+   * Authored bounding volumes are often much larger than the content they
+   * contain, which makes tiles look closer to the camera than they are and
+   * causes more tiles to be refined and loaded than necessary. The tighter box
+   * is used for culling and screen-space error from then on.
+   *
+   * Every tile's content bounding volume is replaced by the box fit to its
+   * content. The bounding volume of the tile itself must also contain the
+   * content of its descendants, so it is replaced by a box that contains both
+   * the content and the bounding volumes of the tile's children. Tiles whose
+   * children have not been created when their content loads keep their
+   * bounding volume. Either box is only used if it is smaller than the volume
+   * it replaces.
+   *
+   * Bounding regions are not affected, because they are also used to map
+   * raster overlays.
+   */
+  bool computeTightBoundingVolumes = false;
+
   /**
    * @brief For each possible input transmission format, this struct names
    * the ideal target gpu-compressed pixel format to transcode to.
    */
   CesiumGltf::Ktx2TranscodeTargets ktx2TranscodeTargets;
+
+  /**
+   * @brief Whether to limit the resolution of the images in a tile's content
+   * to the resolution at which the tile can be seen.
+   *
+   * A tile that is refined by replacing it with its children is only
+   * displayed until its screen-space error exceeds
+   * {@link TilesetOptions::maximumScreenSpaceError}, which bounds the number
+   * of pixels it covers on screen. When this is true, images that are more
+   * than twice that size are downscaled as they are decoded, saving decode
+   * time and memory for detail that would never be seen. Images in tiles
+   * that are refined by adding their children, or that have no children when
+   * they are loaded, are decoded at full resolution.
+   *
+   * Tiles that were loaded before the maximum screen-space error is raised
+   * keep their reduced resolution until they are reloaded.
+   */
+  bool limitImageResolutionToScreenSize = false;
+
+  /**
+   * @brief The maximum number of bytes of implicit tiling subtrees to keep
+   * loaded for each implicit tileset.
+   *
+   * When this is exceeded, the least recently used subtrees are unloaded and
+   * requested again if they are needed. The root subtree is never unloaded.
+   */
+  int64_t maximumCachedSubtreeBytes = 16 * 1024 * 1024;
 };
 
 /**
@@ -61,6 +111,31 @@ struct CESIUM3DTILESSELECTION_API FogDensityAtHeight {
   double fogDensity;
 };
 
+/**
+ * @brief Options for {@link Tileset::updateViewsOffline}.
+ */
+struct CESIUM3DTILESSELECTION_API OfflineViewUpdateOptions {
+  /**
+   * @brief The number of view sets whose tiles are loaded together.
+   *
+   * The tiles needed by all of the view sets in a batch are requested at the
+   * same time, so tiles that are shared between them are only loaded once, and
+   * the loads for different views overlap. Larger batches allow more overlap
+   * but keep more tiles loaded at once.
+   */
+  size_t viewSetsPerBatch = 16;
+
+  /**
+   * @brief The maximum number of tiles that may simultaneously be in the
+   * process of loading while updating the views.
+   *
+   * This replaces {@link TilesetOptions::maximumSimultaneousTileLoads} until
+   * {@link Tileset::updateViewsOffline} returns, if it is larger. Without a
+   * frame rate to maintain, more loads can usually be in flight at once.
+   */
+  uint32_t maximumSimultaneousTileLoads = 100;
+};
+
 /**
  * @brief Additional options for configuring a {@link Tileset}.
  */
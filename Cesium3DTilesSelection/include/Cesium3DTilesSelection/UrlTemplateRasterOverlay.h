@@ -10,6 +10,7 @@
 #include <CesiumGeospatial/Projection.h>
 
 #include <functional>
+#include <map>
 #include <memory>
 
 namespace Cesium3DTilesSelection {
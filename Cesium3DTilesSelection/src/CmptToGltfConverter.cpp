@@ -4,6 +4,9 @@
 
 #include <spdlog/fmt/fmt.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace Cesium3DTilesSelection {
 namespace {
 struct CmptHeader {
@@ -56,6 +59,11 @@ GltfConverterResult CmptToGltfConverter::convert(
   }
 
   std::vector<GltfConverterResult> innerTiles;
+  // Every inner tile needs at least a header, so don't trust a tilesLength
+  // that couldn't possibly fit in the available bytes.
+  innerTiles.reserve(std::min(
+      size_t(pHeader->tilesLength),
+      size_t(pHeader->byteLength / sizeof(InnerHeader))));
   uint32_t pos = sizeof(CmptHeader);
 
   for (uint32_t i = 0; i < pHeader->tilesLength && pos < pHeader->byteLength;
@@ -97,16 +105,24 @@ GltfConverterResult CmptToGltfConverter::convert(
     return std::move(innerTiles[0]);
   }
 
-  for (size_t i = 0; i < innerTiles.size(); ++i) {
-    if (innerTiles[i].model) {
+  // Merge all inner models in a single pass so that each element is moved
+  // exactly once, rather than folding them together pairwise.
+  std::vector<CesiumGltf::Model> innerModels;
+  innerModels.reserve(innerTiles.size());
+  for (GltfConverterResult& innerTile : innerTiles) {
+    if (innerTile.model) {
       if (result.model) {
-        result.model->merge(std::move(*innerTiles[i].model));
+        innerModels.emplace_back(std::move(*innerTile.model));
       } else {
-        result.model = std::move(innerTiles[i].model);
+        result.model = std::move(innerTile.model);
       }
     }
 
-    result.errors.merge(innerTiles[i].errors);
+    result.errors.merge(std::move(innerTile.errors));
+  }
+
+  if (result.model && !innerModels.empty()) {
+    result.model->merge(std::move(innerModels));
   }
 
   return result;
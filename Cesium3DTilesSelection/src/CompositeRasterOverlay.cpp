@@ -0,0 +1,335 @@
+#include "Cesium3DTilesSelection/CompositeRasterOverlay.h"
+
+#include "RasterCompositing.h"
+
+#include "Cesium3DTilesSelection/RasterOverlayTile.h"
+#include "Cesium3DTilesSelection/RasterOverlayTileProvider.h"
+#include "Cesium3DTilesSelection/spdlog-cesium.h"
+
+#include <CesiumUtility/Tracing.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace CesiumAsync;
+using namespace CesiumGeometry;
+using namespace CesiumGeospatial;
+using namespace CesiumGltf;
+using namespace CesiumUtility;
+
+namespace Cesium3DTilesSelection {
+
+namespace {
+struct LayerProvider {
+  IntrusivePointer<RasterOverlayTileProvider> pTileProvider;
+  RasterOverlayBlendMode blendMode;
+  float opacity;
+};
+
+// The image loaded for one layer of a tile, in the order of the layers.
+struct LayerImage {
+  LoadedRasterOverlayImage loaded;
+  RasterOverlayBlendMode blendMode;
+  float opacity;
+  std::optional<Credit> providerCredit;
+};
+
+LoadedRasterOverlayImage compositeLayerImages(
+    std::vector<LayerImage>&& layerImages,
+    const Projection& projection,
+    const Rectangle& rectangle,
+    int32_t maximumTextureSize) {
+  CESIUM_TRACE("compositeLayerImages");
+
+  LoadedRasterOverlayImage result;
+  result.rectangle = rectangle;
+
+  // The composited image has the resolution of the most detailed layer.
+  double pixelsPerUnitX = 0.0;
+  double pixelsPerUnitY = 0.0;
+  bool anyLoaded = false;
+  for (const LayerImage& layerImage : layerImages) {
+    const LoadedRasterOverlayImage& loaded = layerImage.loaded;
+    if (!loaded.image) {
+      continue;
+    }
+    anyLoaded = true;
+    const double width = loaded.rectangle.computeWidth();
+    const double height = loaded.rectangle.computeHeight();
+    if (width > 0.0 && height > 0.0) {
+      pixelsPerUnitX = std::max(pixelsPerUnitX, loaded.image->width / width);
+      pixelsPerUnitY = std::max(pixelsPerUnitY, loaded.image->height / height);
+    }
+  }
+
+  // A tile only fails when every layer fails. Otherwise, the errors of the
+  // layers that failed are reported as warnings.
+  for (LayerImage& layerImage : layerImages) {
+    std::vector<std::string>& errors =
+        anyLoaded ? result.warnings : result.errors;
+    errors.insert(
+        errors.end(),
+        std::make_move_iterator(layerImage.loaded.errors.begin()),
+        std::make_move_iterator(layerImage.loaded.errors.end()));
+    result.warnings.insert(
+        result.warnings.end(),
+        std::make_move_iterator(layerImage.loaded.warnings.begin()),
+        std::make_move_iterator(layerImage.loaded.warnings.end()));
+  }
+
+  if (!result.errors.empty()) {
+    return result;
+  }
+
+  // When no layer covers the tile, it is left transparent.
+
+  ImageCesium& image = result.image.emplace();
+  image.width = std::clamp(
+      int32_t(std::ceil(pixelsPerUnitX * rectangle.computeWidth())),
+      1,
+      maximumTextureSize);
+  image.height = std::clamp(
+      int32_t(std::ceil(pixelsPerUnitY * rectangle.computeHeight())),
+      1,
+      maximumTextureSize);
+  image.channels = 4;
+  image.bytesPerChannel = 1;
+  image.pixelData.resize(size_t(image.width * image.height * 4));
+
+  for (LayerImage& layerImage : layerImages) {
+    LoadedRasterOverlayImage& loaded = layerImage.loaded;
+    if (!loaded.image) {
+      continue;
+    }
+
+    if (!blendImage(
+            image,
+            rectangle,
+            *loaded.image,
+            loaded.rectangle,
+            projection,
+            layerImage.blendMode,
+            layerImage.opacity)) {
+      result.warnings.emplace_back(
+          "A layer's image could not be composited because it is compressed "
+          "or has more than one byte per channel.");
+      continue;
+    }
+
+    result.moreDetailAvailable =
+        result.moreDetailAvailable || loaded.moreDetailAvailable;
+    if (layerImage.providerCredit) {
+      result.credits.emplace_back(*layerImage.providerCredit);
+    }
+    result.credits.insert(
+        result.credits.end(),
+        loaded.credits.begin(),
+        loaded.credits.end());
+  }
+
+  return result;
+}
+} // namespace
+
+class CompositeRasterOverlayTileProvider final
+    : public RasterOverlayTileProvider {
+public:
+  CompositeRasterOverlayTileProvider(
+      const IntrusivePointer<const RasterOverlay>& pOwner,
+      const AsyncSystem& asyncSystem,
+      const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
+      const std::shared_ptr<IPrepareRendererResources>&
+          pPrepareRendererResources,
+      const std::shared_ptr<spdlog::logger>& pLogger,
+      const Projection& projection,
+      const Rectangle& coverageRectangle,
+      std::vector<LayerProvider>&& layers)
+      : RasterOverlayTileProvider(
+            pOwner,
+            asyncSystem,
+            pAssetAccessor,
+            std::nullopt,
+            pPrepareRendererResources,
+            pLogger,
+            projection,
+            coverageRectangle),
+        _layers(std::move(layers)) {}
+
+protected:
+  virtual Future<LoadedRasterOverlayImage>
+  loadTileImage(RasterOverlayTile& overlayTile) override {
+    // Each layer loads its image for a temporary tile of its own covering the
+    // same rectangle. These tiles are kept alive until the images have been
+    // composited and released in the main thread.
+    std::vector<IntrusivePointer<RasterOverlayTile>> layerTiles;
+    std::vector<Future<LayerImage>> futures;
+    for (const LayerProvider& layer : this->_layers) {
+      RasterOverlayTileProvider& layerProvider = *layer.pTileProvider;
+      if (!overlayTile.getRectangle().overlaps(
+              layerProvider.getTileCoverageRectangle())) {
+        continue;
+      }
+
+      IntrusivePointer<RasterOverlayTile> pLayerTile = new RasterOverlayTile(
+          layerProvider,
+          overlayTile.getTargetScreenPixels(),
+          overlayTile.getRectangle());
+      IntrusivePointer<RasterOverlayTile> pSourceTile = nullptr;
+      futures.emplace_back(
+          layerProvider.loadTileImageInTileProjection(*pLayerTile, pSourceTile)
+              .catchImmediately([](const std::exception& e) {
+                // Don't let one layer fail the others.
+                LoadedRasterOverlayImage failed;
+                failed.errors.emplace_back(e.what());
+                return failed;
+              })
+              .thenImmediately(
+                  [blendMode = layer.blendMode,
+                   opacity = layer.opacity,
+                   providerCredit = layerProvider.getCredit()](
+                      LoadedRasterOverlayImage&& loaded) {
+                    return LayerImage{
+                        std::move(loaded),
+                        blendMode,
+                        opacity,
+                        providerCredit};
+                  }));
+      layerTiles.emplace_back(std::move(pLayerTile));
+      if (pSourceTile) {
+        layerTiles.emplace_back(std::move(pSourceTile));
+      }
+    }
+
+    return this->getAsyncSystem()
+        .all(std::move(futures))
+        .thenInWorkerThread(
+            [projection = this->getProjection(),
+             rectangle = overlayTile.getRectangle(),
+             maximumTextureSize =
+                 this->getOwner().getOptions().maximumTextureSize](
+                std::vector<LayerImage>&& layerImages) {
+              return compositeLayerImages(
+                  std::move(layerImages),
+                  projection,
+                  rectangle,
+                  maximumTextureSize);
+            })
+        .thenInMainThread(
+            [layerTiles = std::move(layerTiles)](
+                LoadedRasterOverlayImage&& result) mutable {
+              layerTiles.clear();
+              return std::move(result);
+            });
+  }
+
+private:
+  std::vector<LayerProvider> _layers;
+};
+
+CompositeRasterOverlay::CompositeRasterOverlay(
+    const std::string& name,
+    const std::vector<CompositeRasterOverlayLayer>& layers,
+    const RasterOverlayOptions& overlayOptions)
+    : RasterOverlay(name, overlayOptions), _layers(layers) {}
+
+CompositeRasterOverlay::~CompositeRasterOverlay() {}
+
+Future<RasterOverlay::CreateTileProviderResult>
+CompositeRasterOverlay::createTileProvider(
+    const AsyncSystem& asyncSystem,
+    const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
+    const std::shared_ptr<CreditSystem>& pCreditSystem,
+    const std::shared_ptr<IPrepareRendererResources>& pPrepareRendererResources,
+    const std::shared_ptr<spdlog::logger>& pLogger,
+    IntrusivePointer<const RasterOverlay> pOwner) const {
+  pOwner = pOwner ? pOwner : this;
+
+  // Each layer is loaded with its own options, so it is not aggregated into
+  // the owner.
+  std::vector<Future<CreateTileProviderResult>> futures;
+  futures.reserve(this->_layers.size());
+  for (const CompositeRasterOverlayLayer& layer : this->_layers) {
+    futures.emplace_back(layer.pOverlay->createTileProvider(
+        asyncSystem,
+        pAssetAccessor,
+        pCreditSystem,
+        pPrepareRendererResources,
+        pLogger,
+        nullptr));
+  }
+
+  return asyncSystem.all(std::move(futures))
+      .thenInMainThread(
+          [pOwner,
+           layers = this->_layers,
+           asyncSystem,
+           pAssetAccessor,
+           pPrepareRendererResources,
+           pLogger](std::vector<CreateTileProviderResult>&& results)
+              -> CreateTileProviderResult {
+            std::vector<LayerProvider> layerProviders;
+            std::optional<Projection> maybeProjection;
+            Rectangle coverageRectangle(0.0, 0.0, 0.0, 0.0);
+
+            for (size_t i = 0; i < results.size(); ++i) {
+              const CompositeRasterOverlayLayer& layer = layers[i];
+              CreateTileProviderResult& result = results[i];
+              if (!result) {
+                const RasterOverlayLoadFailureDetails& failureDetails =
+                    result.error();
+                if (layer.pOverlay->getOptions().loadErrorCallback) {
+                  layer.pOverlay->getOptions().loadErrorCallback(
+                      failureDetails);
+                } else {
+                  SPDLOG_LOGGER_ERROR(pLogger, failureDetails.message);
+                }
+                continue;
+              }
+
+              IntrusivePointer<RasterOverlayTileProvider>& pTileProvider =
+                  *result;
+              const Projection& projection = pTileProvider->getTileProjection();
+              if (!maybeProjection) {
+                maybeProjection = projection;
+                coverageRectangle = pTileProvider->getTileCoverageRectangle();
+              } else if (!(projection == *maybeProjection)) {
+                SPDLOG_LOGGER_WARN(
+                    pLogger,
+                    "Layer {} of composite raster overlay {} is not in the "
+                    "projection of the first layer and will not be drawn.",
+                    layer.pOverlay->getName(),
+                    pOwner->getName());
+                continue;
+              } else {
+                coverageRectangle = coverageRectangle.computeUnion(
+                    pTileProvider->getTileCoverageRectangle());
+              }
+
+              layerProviders.emplace_back(LayerProvider{
+                  std::move(pTileProvider),
+                  layer.blendMode,
+                  layer.opacity});
+            }
+
+            if (!maybeProjection) {
+              return nonstd::make_unexpected(RasterOverlayLoadFailureDetails{
+                  RasterOverlayLoadType::TileProvider,
+                  nullptr,
+                  "No layer of the composite raster overlay could be "
+                  "loaded."});
+            }
+
+            return IntrusivePointer<RasterOverlayTileProvider>(
+                new CompositeRasterOverlayTileProvider(
+                    pOwner,
+                    asyncSystem,
+                    pAssetAccessor,
+                    pPrepareRendererResources,
+                    pLogger,
+                    *maybeProjection,
+                    coverageRectangle,
+                    std::move(layerProviders)));
+          });
+}
+
+} // namespace Cesium3DTilesSelection
@@ -0,0 +1,232 @@
+#include "FeatureTableDecoding.h"
+
+#include <spdlog/fmt/fmt.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+namespace {
+std::optional<size_t> getByteOffset(const rapidjson::Value& property) {
+  if (!property.IsObject()) {
+    return std::nullopt;
+  }
+
+  const auto byteOffsetIt = property.FindMember("byteOffset");
+  if (byteOffsetIt == property.MemberEnd() ||
+      !byteOffsetIt->value.IsUint()) {
+    return std::nullopt;
+  }
+
+  return byteOffsetIt->value.GetUint();
+}
+
+template <typename T>
+std::vector<T> copyToAligned(const gsl::span<const std::byte>& data) {
+  // Feature table bodies are only required to be aligned within the tile, and
+  // the tile itself may be anywhere in memory, so copy to an aligned buffer
+  // before reading. The decode loops below are then free to vectorize.
+  std::vector<T> result(data.size() / sizeof(T));
+  std::memcpy(result.data(), data.data(), result.size() * sizeof(T));
+  return result;
+}
+
+template <typename T>
+void octDecodeValues(
+    const gsl::span<const std::byte>& encoded,
+    const gsl::span<float>& output) {
+  const std::vector<T> values = copyToAligned<T>(encoded);
+  assert(values.size() / 2 * 3 == output.size());
+
+  const float toSNormScale = 2.0f / float(std::numeric_limits<T>::max());
+
+  const T* pIn = values.data();
+  float* pOut = output.data();
+  const size_t count = std::min(values.size() / 2, output.size() / 3);
+  for (size_t i = 0; i < count; ++i) {
+    float x = static_cast<float>(pIn[2 * i]) * toSNormScale - 1.0f;
+    float y = static_cast<float>(pIn[2 * i + 1]) * toSNormScale - 1.0f;
+    const float z = 1.0f - std::abs(x) - std::abs(y);
+
+    // Branch-free form of folding the lower hemisphere back over the
+    // diagonals.
+    const float t = std::max(-z, 0.0f);
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+
+    const float inverseLength = 1.0f / std::sqrt(x * x + y * y + z * z);
+    pOut[3 * i] = x * inverseLength;
+    pOut[3 * i + 1] = y * inverseLength;
+    pOut[3 * i + 2] = z * inverseLength;
+  }
+}
+} // namespace
+
+rapidjson::Document FeatureTableDecoding::parseJson(
+    const gsl::span<const std::byte>& jsonData,
+    ErrorList& errors) {
+  rapidjson::Document document;
+  document.Parse(
+      reinterpret_cast<const char*>(jsonData.data()),
+      jsonData.size());
+  if (document.HasParseError()) {
+    errors.emplaceError(fmt::format(
+        "Error when parsing feature table JSON, error code {} at byte offset "
+        "{}",
+        document.GetParseError(),
+        document.GetErrorOffset()));
+  } else if (!document.IsObject()) {
+    errors.emplaceError("The feature table JSON is not an object.");
+  }
+
+  return document;
+}
+
+std::optional<uint32_t> FeatureTableDecoding::getGlobalUint32(
+    const rapidjson::Value& featureTableJson,
+    const gsl::span<const std::byte>& featureTableBinary,
+    const char* name) {
+  const auto it = featureTableJson.FindMember(name);
+  if (it == featureTableJson.MemberEnd()) {
+    return std::nullopt;
+  }
+
+  if (it->value.IsUint()) {
+    return it->value.GetUint();
+  }
+
+  const std::optional<size_t> byteOffset = getByteOffset(it->value);
+  if (!byteOffset ||
+      *byteOffset + sizeof(uint32_t) > featureTableBinary.size()) {
+    return std::nullopt;
+  }
+
+  uint32_t result;
+  std::memcpy(&result, featureTableBinary.data() + *byteOffset, sizeof(result));
+  return result;
+}
+
+std::optional<glm::dvec3> FeatureTableDecoding::getGlobalVec3(
+    const rapidjson::Value& featureTableJson,
+    const gsl::span<const std::byte>& featureTableBinary,
+    const char* name) {
+  const auto it = featureTableJson.FindMember(name);
+  if (it == featureTableJson.MemberEnd()) {
+    return std::nullopt;
+  }
+
+  const rapidjson::Value& value = it->value;
+  if (value.IsArray()) {
+    if (value.Size() != 3 || !value[0].IsNumber() || !value[1].IsNumber() ||
+        !value[2].IsNumber()) {
+      return std::nullopt;
+    }
+
+    return glm::dvec3(
+        value[0].GetDouble(),
+        value[1].GetDouble(),
+        value[2].GetDouble());
+  }
+
+  const std::optional<size_t> byteOffset = getByteOffset(value);
+  if (!byteOffset ||
+      *byteOffset + 3 * sizeof(float) > featureTableBinary.size()) {
+    return std::nullopt;
+  }
+
+  float components[3];
+  std::memcpy(
+      components,
+      featureTableBinary.data() + *byteOffset,
+      sizeof(components));
+  return glm::dvec3(components[0], components[1], components[2]);
+}
+
+bool FeatureTableDecoding::getGlobalBool(
+    const rapidjson::Value& featureTableJson,
+    const char* name,
+    bool defaultValue) {
+  const auto it = featureTableJson.FindMember(name);
+  if (it == featureTableJson.MemberEnd() || !it->value.IsBool()) {
+    return defaultValue;
+  }
+
+  return it->value.GetBool();
+}
+
+std::optional<gsl::span<const std::byte>> FeatureTableDecoding::getPropertyData(
+    const rapidjson::Value& featureTableJson,
+    const gsl::span<const std::byte>& featureTableBinary,
+    const char* name,
+    size_t count,
+    size_t elementByteSize,
+    ErrorList& errors) {
+  const auto it = featureTableJson.FindMember(name);
+  if (it == featureTableJson.MemberEnd()) {
+    return std::nullopt;
+  }
+
+  const std::optional<size_t> byteOffset = getByteOffset(it->value);
+  if (!byteOffset) {
+    errors.emplaceError(fmt::format(
+        "The feature table property {} does not have a valid byteOffset.",
+        name));
+    return std::nullopt;
+  }
+
+  const size_t byteLength = count * elementByteSize;
+  if (*byteOffset > featureTableBinary.size() ||
+      byteLength > featureTableBinary.size() - *byteOffset) {
+    errors.emplaceError(fmt::format(
+        "The feature table property {} needs {} bytes at offset {}, but the "
+        "feature table binary is only {} bytes.",
+        name,
+        byteLength,
+        *byteOffset,
+        featureTableBinary.size()));
+    return std::nullopt;
+  }
+
+  return featureTableBinary.subspan(*byteOffset, byteLength);
+}
+
+void FeatureTableDecoding::dequantizePositions(
+    const gsl::span<const std::byte>& quantized,
+    const glm::dvec3& offset,
+    const glm::dvec3& scale,
+    const gsl::span<float>& output) {
+  const std::vector<uint16_t> values = copyToAligned<uint16_t>(quantized);
+  assert(values.size() == output.size());
+
+  const float offsetX = static_cast<float>(offset.x);
+  const float offsetY = static_cast<float>(offset.y);
+  const float offsetZ = static_cast<float>(offset.z);
+  const float scaleX = static_cast<float>(scale.x / 65535.0);
+  const float scaleY = static_cast<float>(scale.y / 65535.0);
+  const float scaleZ = static_cast<float>(scale.z / 65535.0);
+
+  const uint16_t* pIn = values.data();
+  float* pOut = output.data();
+  const size_t count = std::min(values.size(), output.size()) / 3;
+  for (size_t i = 0; i < count; ++i) {
+    pOut[3 * i] = offsetX + static_cast<float>(pIn[3 * i]) * scaleX;
+    pOut[3 * i + 1] = offsetY + static_cast<float>(pIn[3 * i + 1]) * scaleY;
+    pOut[3 * i + 2] = offsetZ + static_cast<float>(pIn[3 * i + 2]) * scaleZ;
+  }
+}
+
+void FeatureTableDecoding::octDecode(
+    const gsl::span<const std::byte>& encoded,
+    bool sixteenBitComponents,
+    const gsl::span<float>& output) {
+  if (sixteenBitComponents) {
+    octDecodeValues<uint16_t>(encoded, output);
+  } else {
+    octDecodeValues<uint8_t>(encoded, output);
+  }
+}
+} // namespace Cesium3DTilesSelection
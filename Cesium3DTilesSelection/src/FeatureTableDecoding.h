@@ -0,0 +1,101 @@
+#pragma once
+
+#include <Cesium3DTilesSelection/ErrorList.h>
+
+#include <glm/vec3.hpp>
+#include <gsl/span>
+#include <rapidjson/document.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace Cesium3DTilesSelection {
+/**
+ * @brief Helpers for reading the feature tables of the i3dm and pnts tile
+ * formats.
+ *
+ * Feature table properties are either stored directly in the JSON header or
+ * as a `byteOffset` reference into the binary body. These helpers resolve
+ * both forms and bounds-check every binary access.
+ */
+struct FeatureTableDecoding {
+  /**
+   * @brief Parses the feature table JSON, adding an error to `errors` if it
+   * is malformed.
+   */
+  static rapidjson::Document
+  parseJson(const gsl::span<const std::byte>& jsonData, ErrorList& errors);
+
+  /**
+   * @brief Gets a global unsigned integer property such as `POINTS_LENGTH`.
+   */
+  static std::optional<uint32_t> getGlobalUint32(
+      const rapidjson::Value& featureTableJson,
+      const gsl::span<const std::byte>& featureTableBinary,
+      const char* name);
+
+  /**
+   * @brief Gets a global three-component property such as `RTC_CENTER`.
+   */
+  static std::optional<glm::dvec3> getGlobalVec3(
+      const rapidjson::Value& featureTableJson,
+      const gsl::span<const std::byte>& featureTableBinary,
+      const char* name);
+
+  /**
+   * @brief Gets a global boolean property such as `EAST_NORTH_UP`.
+   */
+  static bool getGlobalBool(
+      const rapidjson::Value& featureTableJson,
+      const char* name,
+      bool defaultValue);
+
+  /**
+   * @brief Gets the binary data of a per-feature property.
+   *
+   * Returns `std::nullopt` if the property does not exist. If it exists but
+   * its `count * elementByteSize` bytes do not fit in the binary body, an
+   * error is added to `errors` and `std::nullopt` is returned.
+   */
+  static std::optional<gsl::span<const std::byte>> getPropertyData(
+      const rapidjson::Value& featureTableJson,
+      const gsl::span<const std::byte>& featureTableBinary,
+      const char* name,
+      size_t count,
+      size_t elementByteSize,
+      ErrorList& errors);
+
+  /**
+   * @brief Dequantizes `count` `POSITION_QUANTIZED` values into `output`.
+   *
+   * Each output position is `offset + quantized * scale / 65535`. The
+   * offset is applied in single precision, so callers should pass an offset
+   * relative to a nearby center rather than an absolute Earth-centered one.
+   *
+   * @param quantized Three unsigned shorts per position.
+   * @param offset The quantized volume offset, relative to the output origin.
+   * @param scale The quantized volume scale.
+   * @param output Three floats per position.
+   */
+  static void dequantizePositions(
+      const gsl::span<const std::byte>& quantized,
+      const glm::dvec3& offset,
+      const glm::dvec3& scale,
+      const gsl::span<float>& output);
+
+  /**
+   * @brief Decodes oct-encoded unit vectors into `output`.
+   *
+   * @param encoded Two unsigned integers per vector, either bytes
+   * (`NORMAL_OCT16P`) or unsigned shorts (`NORMAL_UP_OCT32P`).
+   * @param sixteenBitComponents Whether the components are unsigned shorts
+   * rather than bytes.
+   * @param output Three floats per vector.
+   */
+  static void octDecode(
+      const gsl::span<const std::byte>& encoded,
+      bool sixteenBitComponents,
+      const gsl::span<float>& output);
+};
+} // namespace Cesium3DTilesSelection
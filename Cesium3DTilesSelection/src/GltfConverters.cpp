@@ -1,8 +1,62 @@
 #include <Cesium3DTilesSelection/GltfConverters.h>
+#include <CesiumUtility/Metrics.h>
+#include <CesiumUtility/ScopeGuard.h>
 
 #include <spdlog/spdlog.h>
 
 namespace Cesium3DTilesSelection {
+namespace {
+struct FormatMetrics {
+  CesiumUtility::MetricCounter* pBytesDecoded;
+  CesiumUtility::MetricHistogram* pDecodeMicroseconds;
+};
+
+// The metrics of each registered magic and file extension. They are looked up
+// in the registry once, when the format is registered, so that recording them
+// for a tile takes no lock.
+std::unordered_map<std::string, FormatMetrics> metricsByMagic;
+std::unordered_map<std::string, FormatMetrics> metricsByFileExtension;
+
+FormatMetrics createFormatMetrics(std::string_view format) {
+  if (!format.empty() && format[0] == '.') {
+    format.remove_prefix(1);
+  }
+
+  CesiumUtility::MetricsRegistry& registry =
+      CesiumUtility::MetricsRegistry::getDefault();
+  const std::string prefix = "tileContent." + std::string(format);
+  return FormatMetrics{
+      &registry.counter(prefix + ".bytesDecoded"),
+      &registry.histogram(prefix + ".decodeMicroseconds")};
+}
+
+// The number of conversions in progress on this thread. Converters of
+// composite formats convert their inner tiles through GltfConverters too, and
+// only the outermost conversion is recorded so inner bytes aren't counted
+// twice.
+thread_local int32_t conversionDepth = 0;
+
+GltfConverterResult convertAndRecordMetrics(
+    const GltfConverters::ConverterFunction& converter,
+    const std::unordered_map<std::string, FormatMetrics>& metricsByFormat,
+    const std::string& format,
+    const gsl::span<const std::byte>& content,
+    const CesiumGltfReader::GltfReaderOptions& options) {
+  auto it = metricsByFormat.find(format);
+  if (conversionDepth > 0 || it == metricsByFormat.end()) {
+    return converter(content, options);
+  }
+
+  ++conversionDepth;
+  CesiumUtility::ScopeGuard decrementDepth{[]() { --conversionDepth; }};
+
+  const FormatMetrics& metrics = it->second;
+  metrics.pBytesDecoded->increment(static_cast<int64_t>(content.size()));
+  CesiumUtility::ScopedMetricTimer timer(*metrics.pDecodeMicroseconds);
+  return converter(content, options);
+}
+} // namespace
+
 std::unordered_map<std::string, GltfConverters::ConverterFunction>
     GltfConverters::_loadersByMagic;
 
@@ -14,6 +68,7 @@ void GltfConverters::registerMagic(
     ConverterFunction converter) {
   SPDLOG_INFO("Registering magic header {}", magic);
   _loadersByMagic[magic] = converter;
+  metricsByMagic[magic] = createFormatMetrics(magic);
 }
 
 void GltfConverters::registerFileExtension(
@@ -23,6 +78,8 @@ void GltfConverters::registerFileExtension(
 
   std::string lowerCaseFileExtension = toLowerCase(fileExtension);
   _loadersByFileExtension[lowerCaseFileExtension] = converter;
+  metricsByFileExtension[lowerCaseFileExtension] =
+      createFormatMetrics(lowerCaseFileExtension);
 }
 
 GltfConverters::ConverterFunction
@@ -44,13 +101,23 @@ GltfConverterResult GltfConverters::convert(
   std::string magic;
   auto converterFun = getConverterByMagic(content, magic);
   if (converterFun) {
-    return converterFun(content, options);
+    return convertAndRecordMetrics(
+        converterFun,
+        metricsByMagic,
+        magic,
+        content,
+        options);
   }
 
   std::string fileExtension;
   converterFun = getConverterByFileExtension(filePath, fileExtension);
   if (converterFun) {
-    return converterFun(content, options);
+    return convertAndRecordMetrics(
+        converterFun,
+        metricsByFileExtension,
+        fileExtension,
+        content,
+        options);
   }
 
   ErrorList errors;
@@ -69,7 +136,12 @@ GltfConverterResult GltfConverters::convert(
   std::string magic;
   auto converter = getConverterByMagic(content, magic);
   if (converter) {
-    return converter(content, options);
+    return convertAndRecordMetrics(
+        converter,
+        metricsByMagic,
+        magic,
+        content,
+        options);
   }
 
   ErrorList errors;
@@ -7,10 +7,91 @@
 #include <CesiumGltf/AccessorView.h>
 #include <CesiumGltf/AccessorWriter.h>
 #include <CesiumGltf/ExtensionCesiumRTC.h>
+#include <CesiumGltf/ExtensionExtMeshGpuInstancing.h>
 
+#include <glm/gtc/quaternion.hpp>
+
+#include <limits>
+#include <optional>
+#include <string>
 #include <vector>
 
 namespace Cesium3DTilesSelection {
+namespace {
+// Views an attribute of EXT_mesh_gpu_instancing, if the node has it. Fails if
+// the attribute can't be viewed, or if it has a different number of elements
+// than the attributes viewed before it.
+template <typename T>
+bool viewInstanceAttribute(
+    const CesiumGltf::Model& gltf,
+    const CesiumGltf::ExtensionExtMeshGpuInstancing& instancing,
+    const std::string& name,
+    CesiumGltf::AccessorView<T>& view,
+    std::optional<int64_t>& count) {
+  auto it = instancing.attributes.find(name);
+  if (it == instancing.attributes.end()) {
+    return true;
+  }
+
+  view = CesiumGltf::AccessorView<T>(gltf, it->second);
+  if (view.status() != CesiumGltf::AccessorViewStatus::Valid ||
+      (count && *count != view.size())) {
+    return false;
+  }
+
+  count = view.size();
+  return true;
+}
+
+// Returns the transform of each instance of a node instanced with
+// EXT_mesh_gpu_instancing, in the node's coordinate system, or std::nullopt
+// if the instance transforms can't be read.
+std::optional<std::vector<glm::dmat4>> getInstanceTransforms(
+    const CesiumGltf::Model& gltf,
+    const CesiumGltf::ExtensionExtMeshGpuInstancing& instancing) {
+  // Rotations given as normalized integers aren't supported.
+  CesiumGltf::AccessorView<glm::vec3> translations;
+  CesiumGltf::AccessorView<glm::vec4> rotations;
+  CesiumGltf::AccessorView<glm::vec3> scales;
+  std::optional<int64_t> count;
+  if (!viewInstanceAttribute(
+          gltf,
+          instancing,
+          "TRANSLATION",
+          translations,
+          count) ||
+      !viewInstanceAttribute(gltf, instancing, "ROTATION", rotations, count) ||
+      !viewInstanceAttribute(gltf, instancing, "SCALE", scales, count) ||
+      !count) {
+    return std::nullopt;
+  }
+
+  std::vector<glm::dmat4> transforms(size_t(*count), glm::dmat4(1.0));
+  for (int64_t i = 0; i < *count; ++i) {
+    glm::dmat4& transform = transforms[size_t(i)];
+    if (rotations.size() > 0) {
+      const glm::vec4& rotation = rotations[i];
+      transform = glm::dmat4(glm::mat4_cast(glm::dquat(
+          double(rotation.w),
+          double(rotation.x),
+          double(rotation.y),
+          double(rotation.z))));
+    }
+    if (scales.size() > 0) {
+      const glm::dvec3 scale(scales[i]);
+      transform[0] *= scale.x;
+      transform[1] *= scale.y;
+      transform[2] *= scale.z;
+    }
+    if (translations.size() > 0) {
+      transform[3] = glm::dvec4(glm::dvec3(translations[i]), 1.0);
+    }
+  }
+
+  return transforms;
+}
+} // namespace
+
 /*static*/ glm::dmat4x4 GltfUtilities::applyRtcCenter(
     const CesiumGltf::Model& gltf,
     const glm::dmat4x4& rootTransform) {
@@ -385,6 +466,125 @@ GltfUtilities::computeBoundingRegion(
   return computedBounds.toRegion();
 }
 
+/*static*/ std::optional<CesiumGeometry::OrientedBoundingBox>
+GltfUtilities::computeBoundingBox(
+    const CesiumGltf::Model& gltf,
+    const glm::dmat4& transform,
+    const glm::dmat3& axes) {
+  glm::dmat4 rootTransform = transform;
+  rootTransform = applyRtcCenter(gltf, rootTransform);
+  rootTransform = applyGltfUpAxisTransform(gltf, rootTransform);
+
+  // Projecting a position onto each axis is a multiplication by the transpose
+  // of the axes, so fold that into each primitive's transform.
+  const glm::dmat4 toAxes(glm::transpose(axes));
+
+  glm::dvec3 minimum(std::numeric_limits<double>::max());
+  glm::dvec3 maximum(std::numeric_limits<double>::lowest());
+  bool bounded = true;
+
+  gltf.forEachPrimitiveInScene(
+      -1,
+      [&rootTransform, &toAxes, &minimum, &maximum, &bounded](
+          const CesiumGltf::Model& gltf_,
+          const CesiumGltf::Node& node,
+          const CesiumGltf::Mesh& /*mesh*/,
+          const CesiumGltf::MeshPrimitive& primitive,
+          const glm::dmat4& nodeTransform) {
+        auto positionIt = primitive.attributes.find("POSITION");
+        if (positionIt == primitive.attributes.end()) {
+          return;
+        }
+
+        const int positionAccessorIndex = positionIt->second;
+        if (positionAccessorIndex < 0 ||
+            positionAccessorIndex >= static_cast<int>(gltf_.accessors.size())) {
+          return;
+        }
+
+        const CesiumGltf::AccessorView<glm::vec3> positionView(
+            gltf_,
+            positionAccessorIndex);
+        if (positionView.status() != CesiumGltf::AccessorViewStatus::Valid) {
+          return;
+        }
+
+        std::optional<SkirtMeshMetadata> skirtMeshMetadata =
+            SkirtMeshMetadata::parseFromGltfExtras(primitive.extras);
+        int64_t vertexBegin, vertexEnd;
+        if (skirtMeshMetadata.has_value()) {
+          vertexBegin = skirtMeshMetadata->noSkirtVerticesBegin;
+          vertexEnd = skirtMeshMetadata->noSkirtVerticesBegin +
+                      skirtMeshMetadata->noSkirtVerticesCount;
+        } else {
+          vertexBegin = 0;
+          vertexEnd = positionView.size();
+        }
+
+        const glm::dmat4 fullTransform =
+            toAxes * rootTransform * nodeTransform;
+
+        const CesiumGltf::ExtensionExtMeshGpuInstancing* pInstancing =
+            node.getExtension<CesiumGltf::ExtensionExtMeshGpuInstancing>();
+        if (!pInstancing) {
+          for (int64_t i = vertexBegin; i < vertexEnd; ++i) {
+            const glm::dvec3 position(
+                fullTransform * glm::dvec4(glm::dvec3(positionView[i]), 1.0));
+            minimum = glm::min(minimum, position);
+            maximum = glm::max(maximum, position);
+          }
+          return;
+        }
+
+        // Each instance is bounded by the corners of the mesh's own box
+        // under the instance transform.
+        std::optional<std::vector<glm::dmat4>> maybeInstanceTransforms =
+            getInstanceTransforms(gltf_, *pInstancing);
+        if (!maybeInstanceTransforms) {
+          bounded = false;
+          return;
+        }
+
+        glm::dvec3 meshMinimum(std::numeric_limits<double>::max());
+        glm::dvec3 meshMaximum(std::numeric_limits<double>::lowest());
+        for (int64_t i = vertexBegin; i < vertexEnd; ++i) {
+          const glm::dvec3 position(positionView[i]);
+          meshMinimum = glm::min(meshMinimum, position);
+          meshMaximum = glm::max(meshMaximum, position);
+        }
+        if (meshMinimum.x > meshMaximum.x) {
+          return;
+        }
+
+        for (const glm::dmat4& instanceTransform : *maybeInstanceTransforms) {
+          const glm::dmat4 instanceToAxes = fullTransform * instanceTransform;
+          for (int corner = 0; corner < 8; ++corner) {
+            const glm::dvec3 meshCorner(
+                (corner & 1) ? meshMaximum.x : meshMinimum.x,
+                (corner & 2) ? meshMaximum.y : meshMinimum.y,
+                (corner & 4) ? meshMaximum.z : meshMinimum.z);
+            const glm::dvec3 position(
+                instanceToAxes * glm::dvec4(meshCorner, 1.0));
+            minimum = glm::min(minimum, position);
+            maximum = glm::max(maximum, position);
+          }
+        }
+      });
+
+  if (!bounded || minimum.x > maximum.x) {
+    return std::nullopt;
+  }
+
+  const glm::dvec3 center = axes * ((minimum + maximum) * 0.5);
+  const glm::dvec3 halfExtents = (maximum - minimum) * 0.5;
+  return CesiumGeometry::OrientedBoundingBox(
+      center,
+      glm::dmat3(
+          axes[0] * halfExtents.x,
+          axes[1] * halfExtents.y,
+          axes[2] * halfExtents.z));
+}
+
 std::vector<Credit> GltfUtilities::parseGltfCopyright(
     CreditSystem& creditSystem,
     const CesiumGltf::Model& gltf,
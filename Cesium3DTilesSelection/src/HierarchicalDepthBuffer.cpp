@@ -0,0 +1,335 @@
+#include "HierarchicalDepthBuffer.h"
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace Cesium3DTilesSelection {
+
+namespace {
+// Stop building the hierarchy when a level is this size or smaller.
+constexpr uint32_t coarsestLevelSize = 4;
+
+// Look for the level in which a rectangle covers about this many texels
+// across, so each query reads at most a handful of texels.
+constexpr double texelsPerQuery = 4.0;
+
+constexpr float emptyDepth = std::numeric_limits<float>::max();
+
+// The flags of each texel of the mesh being rasterized.
+constexpr uint8_t centerCovered = 1;
+constexpr uint8_t outlineCrosses = 2;
+
+double edgeFunction(
+    const glm::dvec2& a,
+    const glm::dvec2& b,
+    const glm::dvec2& point) noexcept {
+  return (b.x - a.x) * (point.y - a.y) - (b.y - a.y) * (point.x - a.x);
+}
+} // namespace
+
+HierarchicalDepthBuffer::HierarchicalDepthBuffer(
+    uint32_t width,
+    uint32_t height)
+    : _levels(),
+      _meshEdges(),
+      _meshTexels(),
+      _meshDepths(),
+      _meshColumnBegin(0),
+      _meshColumnEnd(0),
+      _meshRowBegin(0),
+      _meshRowEnd(0) {
+  width = std::max(width, 1U);
+  height = std::max(height, 1U);
+  for (;;) {
+    this->_levels.push_back(Level{
+        width,
+        height,
+        std::vector<float>(size_t(width) * size_t(height), emptyDepth)});
+    if (width <= coarsestLevelSize && height <= coarsestLevelSize) {
+      break;
+    }
+    width = (width + 1) / 2;
+    height = (height + 1) / 2;
+  }
+
+  const Level& finest = this->_levels[0];
+  const size_t texelCount = size_t(finest.width) * size_t(finest.height);
+  this->_meshTexels.resize(texelCount, 0);
+  this->_meshDepths.resize(texelCount, 0.0f);
+}
+
+void HierarchicalDepthBuffer::clear() noexcept {
+  for (Level& level : this->_levels) {
+    std::fill(level.depths.begin(), level.depths.end(), emptyDepth);
+  }
+}
+
+void HierarchicalDepthBuffer::beginMesh() noexcept {
+  this->_meshEdges.clear();
+  this->_meshColumnBegin = this->_levels[0].width;
+  this->_meshColumnEnd = 0;
+  this->_meshRowBegin = this->_levels[0].height;
+  this->_meshRowEnd = 0;
+}
+
+void HierarchicalDepthBuffer::addTriangle(
+    const glm::dvec3& a,
+    const glm::dvec3& b,
+    const glm::dvec3& c) {
+  const Level& level = this->_levels[0];
+  const glm::dvec2 scale(level.width * 0.5, level.height * 0.5);
+
+  // Vertices in texel coordinates, wound counter-clockwise.
+  glm::dvec2 v0 = (glm::dvec2(a) + 1.0) * scale;
+  glm::dvec2 v1 = (glm::dvec2(b) + 1.0) * scale;
+  glm::dvec2 v2 = (glm::dvec2(c) + 1.0) * scale;
+  const double area = edgeFunction(v0, v1, v2);
+  if (!(std::abs(area) > 0.0)) {
+    return;
+  }
+  if (area < 0.0) {
+    std::swap(v1, v2);
+  }
+
+  // Count the triangles on each side of each edge.
+  const glm::dvec2* vertices[3] = {&v0, &v1, &v2};
+  for (size_t i = 0; i < 3; ++i) {
+    const glm::dvec2& start = *vertices[i];
+    const glm::dvec2& end = *vertices[(i + 1) % 3];
+    const bool reversed =
+        end.x < start.x || (end.x == start.x && end.y < start.y);
+    const Edge edge = reversed ? Edge{end, start} : Edge{start, end};
+
+    // The triangle is on the left of each of its counter-clockwise edges.
+    const bool onLeft = !reversed;
+    auto result =
+        this->_meshEdges.emplace(edge, EdgeTriangles{1, onLeft, false});
+    if (!result.second) {
+      EdgeTriangles& triangles = result.first->second;
+      ++triangles.count;
+      triangles.inside =
+          triangles.count == 2 && triangles.firstOnLeft != onLeft;
+    }
+  }
+
+  const glm::dvec2 minimum = glm::min(glm::min(v0, v1), v2);
+  const glm::dvec2 maximum = glm::max(glm::max(v0, v1), v2);
+
+  // The texels that the triangle may overlap.
+  const double firstX = std::max(std::floor(minimum.x), 0.0);
+  const double lastX = std::min(std::ceil(maximum.x) - 1.0, level.width - 1.0);
+  const double firstY = std::max(std::floor(minimum.y), 0.0);
+  const double lastY =
+      std::min(std::ceil(maximum.y) - 1.0, level.height - 1.0);
+  if (firstX > lastX || firstY > lastY) {
+    return;
+  }
+
+  const float depth = static_cast<float>(std::max(std::max(a.z, b.z), c.z));
+
+  // Step the edge functions from texel to texel instead of evaluating them at
+  // each one.
+  const glm::dvec2 start(firstX + 0.5, firstY + 0.5);
+  double row0 = edgeFunction(v1, v2, start);
+  double row1 = edgeFunction(v2, v0, start);
+  double row2 = edgeFunction(v0, v1, start);
+  const double stepX0 = v1.y - v2.y;
+  const double stepX1 = v2.y - v0.y;
+  const double stepX2 = v0.y - v1.y;
+  const double stepY0 = v2.x - v1.x;
+  const double stepY1 = v0.x - v2.x;
+  const double stepY2 = v1.x - v0.x;
+
+  // A texel may overlap the triangle unless an edge function, at the texel's
+  // center, is more negative than it can increase toward the texel's
+  // corners.
+  const double inset0 = 0.5 * (std::abs(stepX0) + std::abs(stepY0));
+  const double inset1 = 0.5 * (std::abs(stepX1) + std::abs(stepY1));
+  const double inset2 = 0.5 * (std::abs(stepX2) + std::abs(stepY2));
+
+  const size_t columnBegin = static_cast<size_t>(firstX);
+  const size_t columnEnd = static_cast<size_t>(lastX) + 1;
+  const size_t rowBegin = static_cast<size_t>(firstY);
+  const size_t rowEnd = static_cast<size_t>(lastY) + 1;
+  this->_meshColumnBegin = std::min(this->_meshColumnBegin, columnBegin);
+  this->_meshColumnEnd = std::max(this->_meshColumnEnd, columnEnd);
+  this->_meshRowBegin = std::min(this->_meshRowBegin, rowBegin);
+  this->_meshRowEnd = std::max(this->_meshRowEnd, rowEnd);
+
+  for (size_t y = rowBegin; y < rowEnd; ++y) {
+    uint8_t* pTexels = this->_meshTexels.data() + y * level.width;
+    float* pDepths = this->_meshDepths.data() + y * level.width;
+    double w0 = row0;
+    double w1 = row1;
+    double w2 = row2;
+    for (size_t x = columnBegin; x < columnEnd; ++x) {
+      if (w0 >= -inset0 && w1 >= -inset1 && w2 >= -inset2) {
+        pDepths[x] = std::max(pDepths[x], depth);
+        if (w0 >= 0.0 && w1 >= 0.0 && w2 >= 0.0) {
+          pTexels[x] |= centerCovered;
+        }
+      }
+      w0 += stepX0;
+      w1 += stepX1;
+      w2 += stepX2;
+    }
+    row0 += stepY0;
+    row1 += stepY1;
+    row2 += stepY2;
+  }
+}
+
+void HierarchicalDepthBuffer::endMesh() {
+  for (const auto& edge : this->_meshEdges) {
+    if (!edge.second.inside) {
+      this->markOutline(edge.first.first, edge.first.second);
+    }
+  }
+  this->_meshEdges.clear();
+
+  // Inside the outline, every texel is either entirely covered or not
+  // covered at all, so its center tells which.
+  Level& level = this->_levels[0];
+  for (size_t y = this->_meshRowBegin; y < this->_meshRowEnd; ++y) {
+    const size_t rowStart = y * level.width;
+    uint8_t* pTexels = this->_meshTexels.data() + rowStart;
+    float* pDepths = this->_meshDepths.data() + rowStart;
+    float* pRow = level.depths.data() + rowStart;
+    for (size_t x = this->_meshColumnBegin; x < this->_meshColumnEnd; ++x) {
+      if (pTexels[x] == centerCovered) {
+        pRow[x] = std::min(pRow[x], pDepths[x]);
+      }
+      pTexels[x] = 0;
+      pDepths[x] = 0.0f;
+    }
+  }
+
+  this->beginMesh();
+}
+
+size_t HierarchicalDepthBuffer::EdgeHash::operator()(
+    const Edge& edge) const noexcept {
+  const std::hash<double> hash;
+  size_t result = hash(edge.first.x);
+  for (const double value : {edge.first.y, edge.second.x, edge.second.y}) {
+    result = result * 31 + hash(value);
+  }
+  return result;
+}
+
+void HierarchicalDepthBuffer::markOutline(
+    const glm::dvec2& first,
+    const glm::dvec2& second) noexcept {
+  const Level& level = this->_levels[0];
+  const glm::dvec2& bottom = first.y <= second.y ? first : second;
+  const glm::dvec2& top = first.y <= second.y ? second : first;
+
+  // Mark every texel whose interior the edge passes through, one row at a
+  // time. An edge that only runs along the side of a texel leaves it to the
+  // test of its center.
+  const double firstRow = std::max(std::floor(bottom.y), 0.0);
+  const double lastRow = std::min(std::ceil(top.y) - 1.0, level.height - 1.0);
+  for (double row = firstRow; row <= lastRow; ++row) {
+    double xStart = bottom.x;
+    double xEnd = top.x;
+    if (top.y > bottom.y) {
+      const double slope = (top.x - bottom.x) / (top.y - bottom.y);
+      xStart = bottom.x + slope * (std::max(row, bottom.y) - bottom.y);
+      xEnd = bottom.x + slope * (std::min(row + 1.0, top.y) - bottom.y);
+    }
+
+    const double firstColumn =
+        std::max(std::floor(std::min(xStart, xEnd)), 0.0);
+    const double lastColumn = std::min(
+        std::ceil(std::max(xStart, xEnd)) - 1.0,
+        level.width - 1.0);
+    uint8_t* pTexels =
+        this->_meshTexels.data() + static_cast<size_t>(row) * level.width;
+    for (double column = firstColumn; column <= lastColumn; ++column) {
+      pTexels[static_cast<size_t>(column)] |= outlineCrosses;
+    }
+  }
+}
+
+void HierarchicalDepthBuffer::buildHierarchy() noexcept {
+  for (size_t i = 1; i < this->_levels.size(); ++i) {
+    const Level& source = this->_levels[i - 1];
+    Level& target = this->_levels[i];
+    for (uint32_t y = 0; y < target.height; ++y) {
+      const uint32_t sourceY0 = 2 * y;
+      const uint32_t sourceY1 = std::min(sourceY0 + 1, source.height - 1);
+      const float* pSource0 = source.depths.data() + sourceY0 * source.width;
+      const float* pSource1 = source.depths.data() + sourceY1 * source.width;
+      float* pTarget = target.depths.data() + y * target.width;
+      for (uint32_t x = 0; x < target.width; ++x) {
+        const uint32_t sourceX0 = 2 * x;
+        const uint32_t sourceX1 = std::min(sourceX0 + 1, source.width - 1);
+        pTarget[x] = std::max(
+            std::max(pSource0[sourceX0], pSource0[sourceX1]),
+            std::max(pSource1[sourceX0], pSource1[sourceX1]));
+      }
+    }
+  }
+}
+
+bool HierarchicalDepthBuffer::isHidden(
+    const glm::dvec2& minimum,
+    const glm::dvec2& maximum,
+    double depth) const noexcept {
+  if (maximum.x < -1.0 || maximum.y < -1.0 || minimum.x > 1.0 ||
+      minimum.y > 1.0) {
+    return false;
+  }
+
+  const Level& finest = this->_levels[0];
+  const glm::dvec2 scale(finest.width * 0.5, finest.height * 0.5);
+  const glm::dvec2 texelMinimum = glm::max(
+      (glm::max(minimum, glm::dvec2(-1.0)) + 1.0) * scale,
+      glm::dvec2(0.0));
+  const glm::dvec2 texelMaximum = glm::min(
+      (glm::min(maximum, glm::dvec2(1.0)) + 1.0) * scale,
+      glm::dvec2(finest.width, finest.height));
+
+  const double extent = std::max(
+      texelMaximum.x - texelMinimum.x,
+      texelMaximum.y - texelMinimum.y);
+  size_t levelIndex = 0;
+  if (extent > texelsPerQuery) {
+    levelIndex = static_cast<size_t>(
+        std::ceil(std::log2(extent / texelsPerQuery)));
+    levelIndex = std::min(levelIndex, this->_levels.size() - 1);
+  }
+
+  const Level& level = this->_levels[levelIndex];
+  const double texelSize = double(uint64_t(1) << levelIndex);
+  const uint32_t firstX = std::min(
+      static_cast<uint32_t>(texelMinimum.x / texelSize),
+      level.width - 1);
+  const uint32_t lastX = std::min(
+      static_cast<uint32_t>(texelMaximum.x / texelSize),
+      level.width - 1);
+  const uint32_t firstY = std::min(
+      static_cast<uint32_t>(texelMinimum.y / texelSize),
+      level.height - 1);
+  const uint32_t lastY = std::min(
+      static_cast<uint32_t>(texelMaximum.y / texelSize),
+      level.height - 1);
+
+  const float nearest = static_cast<float>(depth);
+  for (uint32_t y = firstY; y <= lastY; ++y) {
+    const float* pRow = level.depths.data() + size_t(y) * level.width;
+    for (uint32_t x = firstX; x <= lastX; ++x) {
+      if (!(pRow[x] < nearest)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+} // namespace Cesium3DTilesSelection
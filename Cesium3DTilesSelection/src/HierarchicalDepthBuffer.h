@@ -0,0 +1,168 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+
+/**
+ * @brief A small depth buffer with a hierarchy of progressively coarser
+ * levels, used to decide on the CPU whether something is hidden behind
+ * previously rasterized triangles.
+ *
+ * Positions are given in normalized device coordinates, where x and y range
+ * from -1.0 to 1.0 across the viewport, and z is the distance from the eye
+ * along the view direction. Each level of the hierarchy stores, for each
+ * texel, the _farthest_ depth of the four texels beneath it, so a region that
+ * is farther away than every texel covering it in any level is hidden.
+ */
+class HierarchicalDepthBuffer {
+public:
+  /**
+   * @brief Creates a depth buffer with nothing rasterized into it.
+   *
+   * @param width The width of the most detailed level, in texels.
+   * @param height The height of the most detailed level, in texels.
+   */
+  HierarchicalDepthBuffer(uint32_t width, uint32_t height);
+
+  /**
+   * @brief Gets the width of the most detailed level, in texels.
+   */
+  uint32_t getWidth() const noexcept { return this->_levels[0].width; }
+
+  /**
+   * @brief Gets the height of the most detailed level, in texels.
+   */
+  uint32_t getHeight() const noexcept { return this->_levels[0].height; }
+
+  /**
+   * @brief Removes everything that has been rasterized.
+   */
+  void clear() noexcept;
+
+  /**
+   * @brief Starts rasterizing a mesh into the most detailed level. Add its
+   * triangles with {@link addTriangle}, and then call {@link endMesh}.
+   */
+  void beginMesh() noexcept;
+
+  /**
+   * @brief Adds a triangle to the mesh started by {@link beginMesh}.
+   *
+   * The vertices must all be in front of the eye. Triangles with no area in
+   * the view are ignored.
+   */
+  void addTriangle(
+      const glm::dvec3& a,
+      const glm::dvec3& b,
+      const glm::dvec3& c);
+
+  /**
+   * @brief Writes the texels that the mesh started by {@link beginMesh}
+   * covers entirely.
+   *
+   * A texel is covered when its center is inside one of the mesh's triangles
+   * and no edge of the mesh's outline crosses it. The outline is made of the
+   * edges that have a triangle on only one side in the view: edges of a
+   * single triangle, and edges where the mesh folds over. Triangles that
+   * share an edge are found by matching the exact positions of its vertices.
+   * So a mesh of triangles much smaller than a texel hides whatever is
+   * behind it, but gaps between triangles that don't share edges are never
+   * closed, however narrow.
+   *
+   * Each covered texel receives the depth of the _farthest_ vertex of any
+   * triangle of the mesh that overlaps it, unless it already holds a nearer
+   * depth. This never causes something visible to be reported as hidden. The
+   * hierarchy is not updated until {@link buildHierarchy} is called.
+   */
+  void endMesh();
+
+  /**
+   * @brief Rasterizes a mesh made of a single triangle, so only the texels
+   * entirely inside the triangle are written.
+   */
+  void rasterizeTriangle(
+      const glm::dvec3& a,
+      const glm::dvec3& b,
+      const glm::dvec3& c) {
+    this->beginMesh();
+    this->addTriangle(a, b, c);
+    this->endMesh();
+  }
+
+  /**
+   * @brief Updates the coarser levels from the most detailed one.
+   */
+  void buildHierarchy() noexcept;
+
+  /**
+   * @brief Determines whether a screen-space rectangle is entirely hidden.
+   *
+   * @param minimum The minimum x and y of the rectangle, in normalized device
+   * coordinates.
+   * @param maximum The maximum x and y of the rectangle, in normalized device
+   * coordinates.
+   * @param depth The nearest depth of anything in the rectangle.
+   * @return true if every texel covering the rectangle holds a depth nearer
+   * than `depth`. A rectangle that is entirely outside the viewport is never
+   * hidden.
+   */
+  bool isHidden(
+      const glm::dvec2& minimum,
+      const glm::dvec2& maximum,
+      double depth) const noexcept;
+
+private:
+  struct Level {
+    uint32_t width;
+    uint32_t height;
+    std::vector<float> depths;
+  };
+
+  // An edge of the mesh being rasterized, with its vertices in texel
+  // coordinates in lexicographic order.
+  struct Edge {
+    glm::dvec2 first;
+    glm::dvec2 second;
+
+    bool operator==(const Edge& rhs) const noexcept {
+      return this->first == rhs.first && this->second == rhs.second;
+    }
+  };
+
+  struct EdgeHash {
+    size_t operator()(const Edge& edge) const noexcept;
+  };
+
+  // The triangles that share an edge. The edge is inside the mesh if there
+  // are exactly two, on opposite sides of it.
+  struct EdgeTriangles {
+    uint32_t count;
+    bool firstOnLeft;
+    bool inside;
+  };
+
+  void markOutline(const glm::dvec2& first, const glm::dvec2& second) noexcept;
+
+  std::vector<Level> _levels;
+
+  // The mesh being rasterized. For each texel of the most detailed level,
+  // whether its center is covered and whether the outline crosses it, and
+  // the farthest depth of the triangles that overlap it. Only the texels in
+  // the given columns and rows have been written.
+  std::unordered_map<Edge, EdgeTriangles, EdgeHash> _meshEdges;
+  std::vector<uint8_t> _meshTexels;
+  std::vector<float> _meshDepths;
+  size_t _meshColumnBegin;
+  size_t _meshColumnEnd;
+  size_t _meshRowBegin;
+  size_t _meshRowEnd;
+};
+
+} // namespace Cesium3DTilesSelection
@@ -0,0 +1,661 @@
+#include "I3dmToGltfConverter.h"
+
+#include "BinaryToGltfConverter.h"
+#include "FeatureTableDecoding.h"
+
+#include <CesiumGeometry/AxisTransforms.h>
+#include <CesiumGeospatial/Transforms.h>
+#include <CesiumGltf/ExtensionCesiumRTC.h>
+#include <CesiumGltf/ExtensionExtMeshGpuInstancing.h>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/matrix.hpp>
+#include <spdlog/fmt/fmt.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace CesiumGltf;
+
+namespace Cesium3DTilesSelection {
+namespace {
+struct I3dmHeader {
+  unsigned char magic[4];
+  uint32_t version;
+  uint32_t byteLength;
+  uint32_t featureTableJsonByteLength;
+  uint32_t featureTableBinaryByteLength;
+  uint32_t batchTableJsonByteLength;
+  uint32_t batchTableBinaryByteLength;
+  uint32_t gltfFormat;
+};
+
+static_assert(sizeof(I3dmHeader) == 32);
+
+struct MeshNode {
+  int32_t mesh;
+  glm::dmat4 transform;
+};
+
+std::vector<float> readFloats(const gsl::span<const std::byte>& data) {
+  std::vector<float> result(data.size() / sizeof(float));
+  std::memcpy(result.data(), data.data(), result.size() * sizeof(float));
+  return result;
+}
+
+glm::dmat4 getNodeTransform(const Node& node) {
+  if (node.matrix.size() == 16) {
+    glm::dmat4 matrix;
+    std::memcpy(&matrix, node.matrix.data(), sizeof(glm::dmat4));
+    if (matrix != glm::dmat4(1.0)) {
+      return matrix;
+    }
+  }
+
+  glm::dmat4 translation(1.0);
+  if (node.translation.size() == 3) {
+    translation[3] = glm::dvec4(
+        node.translation[0],
+        node.translation[1],
+        node.translation[2],
+        1.0);
+  }
+
+  glm::dquat rotation(1.0, 0.0, 0.0, 0.0);
+  if (node.rotation.size() == 4) {
+    rotation[0] = node.rotation[0];
+    rotation[1] = node.rotation[1];
+    rotation[2] = node.rotation[2];
+    rotation[3] = node.rotation[3];
+  }
+
+  glm::dmat4 scale(1.0);
+  if (node.scale.size() == 3) {
+    scale[0].x = node.scale[0];
+    scale[1].y = node.scale[1];
+    scale[2].z = node.scale[2];
+  }
+
+  return translation * glm::dmat4(rotation) * scale;
+}
+
+void collectMeshNodes(
+    const Model& gltf,
+    int32_t nodeIndex,
+    const glm::dmat4& parentTransform,
+    size_t depth,
+    std::vector<MeshNode>& meshNodes) {
+  const Node* pNode = Model::getSafe(&gltf.nodes, nodeIndex);
+  // A valid glTF node hierarchy is never deeper than the number of nodes, so
+  // this also guards against cycles in invalid ones.
+  if (!pNode || depth > gltf.nodes.size()) {
+    return;
+  }
+
+  const glm::dmat4 transform = parentTransform * getNodeTransform(*pNode);
+  if (pNode->mesh >= 0) {
+    meshNodes.push_back(MeshNode{pNode->mesh, transform});
+  }
+
+  for (int32_t child : pNode->children) {
+    collectMeshNodes(gltf, child, transform, depth + 1, meshNodes);
+  }
+}
+
+// Finds every node with a mesh that would be rendered, using the same rules
+// as Model::forEachPrimitiveInScene, along with its global transform.
+std::vector<MeshNode> getMeshNodes(const Model& gltf) {
+  std::vector<MeshNode> meshNodes;
+  const glm::dmat4 identity(1.0);
+
+  const Scene* pScene = Model::getSafe(&gltf.scenes, gltf.scene);
+  if (!pScene && !gltf.scenes.empty()) {
+    pScene = &gltf.scenes[0];
+  }
+
+  if (pScene) {
+    for (int32_t rootNode : pScene->nodes) {
+      collectMeshNodes(gltf, rootNode, identity, 0, meshNodes);
+    }
+  } else if (!gltf.nodes.empty()) {
+    collectMeshNodes(gltf, 0, identity, 0, meshNodes);
+  } else {
+    for (size_t i = 0; i < gltf.meshes.size(); ++i) {
+      meshNodes.push_back(MeshNode{int32_t(i), identity});
+    }
+  }
+
+  return meshNodes;
+}
+
+int32_t createAccessor(
+    Model& gltf,
+    std::vector<std::byte>&& data,
+    const std::string& type,
+    int64_t count) {
+  const int32_t bufferId = int32_t(gltf.buffers.size());
+  Buffer& buffer = gltf.buffers.emplace_back();
+  buffer.byteLength = int64_t(data.size());
+  buffer.cesium.data = std::move(data);
+
+  const int32_t bufferViewId = int32_t(gltf.bufferViews.size());
+  BufferView& bufferView = gltf.bufferViews.emplace_back();
+  bufferView.buffer = bufferId;
+  bufferView.byteLength = buffer.byteLength;
+
+  const int32_t accessorId = int32_t(gltf.accessors.size());
+  Accessor& accessor = gltf.accessors.emplace_back();
+  accessor.bufferView = bufferViewId;
+  accessor.componentType = Accessor::ComponentType::FLOAT;
+  accessor.type = type;
+  accessor.count = count;
+  return accessorId;
+}
+
+bool parseI3dmHeader(
+    const gsl::span<const std::byte>& instancesBinary,
+    I3dmHeader& header,
+    GltfConverterResult& result) {
+  if (instancesBinary.size() < sizeof(I3dmHeader)) {
+    result.errors.emplaceError("The I3DM is invalid because it is too small to "
+                               "include a I3DM header.");
+    return false;
+  }
+
+  std::memcpy(&header, instancesBinary.data(), sizeof(I3dmHeader));
+
+  if (header.version != 1) {
+    result.errors.emplaceError(
+        fmt::format("Unsupported I3DM version {}.", header.version));
+    return false;
+  }
+
+  if (header.byteLength > instancesBinary.size()) {
+    result.errors.emplaceError(
+        "The I3DM is invalid because the total data available is less than the "
+        "size specified in its header.");
+    return false;
+  }
+
+  const uint64_t glbStart = uint64_t(sizeof(I3dmHeader)) +
+                            header.featureTableJsonByteLength +
+                            header.featureTableBinaryByteLength +
+                            header.batchTableJsonByteLength +
+                            header.batchTableBinaryByteLength;
+  if (glbStart >= header.byteLength) {
+    result.errors.emplaceError(
+        "The I3DM is invalid because the start of the "
+        "glTF model is after the end of the entire I3DM.");
+    return false;
+  }
+
+  return true;
+}
+
+// Decodes the instance positions, relative to the returned RTC center.
+std::optional<glm::dvec3> decodePositions(
+    const rapidjson::Value& featureTableJson,
+    const gsl::span<const std::byte>& featureTableBinary,
+    uint32_t instancesLength,
+    std::vector<glm::dvec3>& positions,
+    ErrorList& errors) {
+  std::optional<glm::dvec3> rtcCenter = FeatureTableDecoding::getGlobalVec3(
+      featureTableJson,
+      featureTableBinary,
+      "RTC_CENTER");
+
+  std::vector<float> values(size_t(instancesLength) * 3);
+
+  const std::optional<gsl::span<const std::byte>> positionData =
+      FeatureTableDecoding::getPropertyData(
+          featureTableJson,
+          featureTableBinary,
+          "POSITION",
+          instancesLength,
+          3 * sizeof(float),
+          errors);
+  if (positionData) {
+    values = readFloats(*positionData);
+  } else {
+    const std::optional<gsl::span<const std::byte>> quantizedData =
+        FeatureTableDecoding::getPropertyData(
+            featureTableJson,
+            featureTableBinary,
+            "POSITION_QUANTIZED",
+            instancesLength,
+            3 * sizeof(uint16_t),
+            errors);
+    const std::optional<glm::dvec3> offset =
+        FeatureTableDecoding::getGlobalVec3(
+            featureTableJson,
+            featureTableBinary,
+            "QUANTIZED_VOLUME_OFFSET");
+    const std::optional<glm::dvec3> scale = FeatureTableDecoding::getGlobalVec3(
+        featureTableJson,
+        featureTableBinary,
+        "QUANTIZED_VOLUME_SCALE");
+    if (!quantizedData || !offset || !scale) {
+      errors.emplaceError(
+          "The I3DM feature table must contain either POSITION, or "
+          "POSITION_QUANTIZED along with QUANTIZED_VOLUME_OFFSET and "
+          "QUANTIZED_VOLUME_SCALE.");
+      return rtcCenter;
+    }
+
+    // Without an RTC_CENTER, dequantize relative to the center of the
+    // quantized volume to keep single-precision positions accurate.
+    glm::dvec3 origin(0.0);
+    if (!rtcCenter) {
+      origin = *offset + *scale * 0.5;
+      rtcCenter = origin;
+    }
+
+    FeatureTableDecoding::dequantizePositions(
+        *quantizedData,
+        *offset - origin,
+        *scale,
+        values);
+  }
+
+  positions.resize(instancesLength);
+  for (size_t i = 0; i < positions.size(); ++i) {
+    positions[i] =
+        glm::dvec3(values[3 * i], values[3 * i + 1], values[3 * i + 2]);
+  }
+
+  if (!rtcCenter && !positions.empty()) {
+    // Positions may be absolute Earth-centered coordinates. Make them relative
+    // to their center so instance translations stay small.
+    glm::dvec3 minimum = positions[0];
+    glm::dvec3 maximum = positions[0];
+    for (const glm::dvec3& position : positions) {
+      minimum = glm::min(minimum, position);
+      maximum = glm::max(maximum, position);
+    }
+
+    rtcCenter = (minimum + maximum) * 0.5;
+    for (glm::dvec3& position : positions) {
+      position -= *rtcCenter;
+    }
+  }
+
+  return rtcCenter;
+}
+
+void decodeRotations(
+    const rapidjson::Value& featureTableJson,
+    const gsl::span<const std::byte>& featureTableBinary,
+    const std::vector<glm::dvec3>& positions,
+    const glm::dvec3& rtcCenter,
+    std::vector<glm::dmat3>& rotations,
+    ErrorList& errors) {
+  const size_t count = positions.size();
+  rotations.assign(count, glm::dmat3(1.0));
+
+  std::vector<float> up;
+  std::vector<float> right;
+
+  const std::optional<gsl::span<const std::byte>> upData =
+      FeatureTableDecoding::getPropertyData(
+          featureTableJson,
+          featureTableBinary,
+          "NORMAL_UP",
+          count,
+          3 * sizeof(float),
+          errors);
+  const std::optional<gsl::span<const std::byte>> rightData =
+      FeatureTableDecoding::getPropertyData(
+          featureTableJson,
+          featureTableBinary,
+          "NORMAL_RIGHT",
+          count,
+          3 * sizeof(float),
+          errors);
+  if (upData && rightData) {
+    up = readFloats(*upData);
+    right = readFloats(*rightData);
+  } else {
+    const std::optional<gsl::span<const std::byte>> upOctData =
+        FeatureTableDecoding::getPropertyData(
+            featureTableJson,
+            featureTableBinary,
+            "NORMAL_UP_OCT32P",
+            count,
+            2 * sizeof(uint16_t),
+            errors);
+    const std::optional<gsl::span<const std::byte>> rightOctData =
+        FeatureTableDecoding::getPropertyData(
+            featureTableJson,
+            featureTableBinary,
+            "NORMAL_RIGHT_OCT32P",
+            count,
+            2 * sizeof(uint16_t),
+            errors);
+    if (upOctData && rightOctData) {
+      up.resize(count * 3);
+      right.resize(count * 3);
+      FeatureTableDecoding::octDecode(*upOctData, true, up);
+      FeatureTableDecoding::octDecode(*rightOctData, true, right);
+    }
+  }
+
+  if (!up.empty()) {
+    for (size_t i = 0; i < count; ++i) {
+      const glm::dvec3 upAxis(up[3 * i], up[3 * i + 1], up[3 * i + 2]);
+      const glm::dvec3 rightAxis(
+          right[3 * i],
+          right[3 * i + 1],
+          right[3 * i + 2]);
+      rotations[i] =
+          glm::dmat3(rightAxis, upAxis, glm::cross(rightAxis, upAxis));
+    }
+  } else if (FeatureTableDecoding::getGlobalBool(
+                 featureTableJson,
+                 "EAST_NORTH_UP",
+                 false)) {
+    for (size_t i = 0; i < count; ++i) {
+      rotations[i] =
+          glm::dmat3(CesiumGeospatial::Transforms::eastNorthUpToFixedFrame(
+              rtcCenter + positions[i]));
+    }
+  }
+}
+
+void decodeScales(
+    const rapidjson::Value& featureTableJson,
+    const gsl::span<const std::byte>& featureTableBinary,
+    size_t count,
+    std::vector<glm::dvec3>& scales,
+    ErrorList& errors) {
+  scales.assign(count, glm::dvec3(1.0));
+
+  const std::optional<gsl::span<const std::byte>> nonUniformData =
+      FeatureTableDecoding::getPropertyData(
+          featureTableJson,
+          featureTableBinary,
+          "SCALE_NON_UNIFORM",
+          count,
+          3 * sizeof(float),
+          errors);
+  if (nonUniformData) {
+    const std::vector<float> values = readFloats(*nonUniformData);
+    for (size_t i = 0; i < count; ++i) {
+      scales[i] =
+          glm::dvec3(values[3 * i], values[3 * i + 1], values[3 * i + 2]);
+    }
+    return;
+  }
+
+  const std::optional<gsl::span<const std::byte>> uniformData =
+      FeatureTableDecoding::getPropertyData(
+          featureTableJson,
+          featureTableBinary,
+          "SCALE",
+          count,
+          sizeof(float),
+          errors);
+  if (uniformData) {
+    const std::vector<float> values = readFloats(*uniformData);
+    for (size_t i = 0; i < count; ++i) {
+      scales[i] = glm::dvec3(values[i]);
+    }
+  }
+}
+
+// Creates the EXT_mesh_gpu_instancing attributes for a mesh with the given
+// global transform.
+//
+// 3D Tiles applies each instance transform to the whole Z-up model, i.e.
+// after the glTF node transforms and the Y-up to Z-up conversion. The
+// extension instead applies the instance transforms before the node
+// transform, so the node transform and axis conversion are folded into each
+// instance transform, and the instanced node itself is left untransformed.
+std::unordered_map<std::string, int32_t> createInstancingAttributes(
+    Model& gltf,
+    const std::vector<glm::dmat4>& instanceTransforms,
+    const glm::dmat4& meshTransform) {
+  const size_t count = instanceTransforms.size();
+  const glm::dmat4 toInstanceSpace =
+      CesiumGeometry::AxisTransforms::Y_UP_TO_Z_UP * meshTransform;
+
+  std::vector<std::byte> translationData(count * 3 * sizeof(float));
+  std::vector<std::byte> rotationData(count * 4 * sizeof(float));
+  std::vector<std::byte> scaleData(count * 3 * sizeof(float));
+  float* pTranslations = reinterpret_cast<float*>(translationData.data());
+  float* pRotations = reinterpret_cast<float*>(rotationData.data());
+  float* pScales = reinterpret_cast<float*>(scaleData.data());
+
+  for (size_t i = 0; i < count; ++i) {
+    const glm::dmat4 transform = CesiumGeometry::AxisTransforms::Z_UP_TO_Y_UP *
+                                 instanceTransforms[i] * toInstanceSpace;
+
+    glm::dmat3 rotationAndScale(transform);
+    glm::dvec3 scale(
+        glm::length(rotationAndScale[0]),
+        glm::length(rotationAndScale[1]),
+        glm::length(rotationAndScale[2]));
+    if (glm::determinant(rotationAndScale) < 0.0) {
+      scale.x = -scale.x;
+    }
+
+    for (glm::length_t column = 0; column < 3; ++column) {
+      if (scale[column] != 0.0) {
+        rotationAndScale[column] /= scale[column];
+      }
+    }
+
+    const glm::dquat rotation = glm::quat_cast(rotationAndScale);
+
+    pTranslations[3 * i] = static_cast<float>(transform[3].x);
+    pTranslations[3 * i + 1] = static_cast<float>(transform[3].y);
+    pTranslations[3 * i + 2] = static_cast<float>(transform[3].z);
+    pRotations[4 * i] = static_cast<float>(rotation.x);
+    pRotations[4 * i + 1] = static_cast<float>(rotation.y);
+    pRotations[4 * i + 2] = static_cast<float>(rotation.z);
+    pRotations[4 * i + 3] = static_cast<float>(rotation.w);
+    pScales[3 * i] = static_cast<float>(scale.x);
+    pScales[3 * i + 1] = static_cast<float>(scale.y);
+    pScales[3 * i + 2] = static_cast<float>(scale.z);
+  }
+
+  std::unordered_map<std::string, int32_t> attributes;
+  attributes["TRANSLATION"] = createAccessor(
+      gltf,
+      std::move(translationData),
+      Accessor::Type::VEC3,
+      int64_t(count));
+  attributes["ROTATION"] = createAccessor(
+      gltf,
+      std::move(rotationData),
+      Accessor::Type::VEC4,
+      int64_t(count));
+  attributes["SCALE"] = createAccessor(
+      gltf,
+      std::move(scaleData),
+      Accessor::Type::VEC3,
+      int64_t(count));
+  return attributes;
+}
+
+void addExtensionName(std::vector<std::string>& extensions, const char* name) {
+  if (std::find(extensions.begin(), extensions.end(), name) ==
+      extensions.end()) {
+    extensions.emplace_back(name);
+  }
+}
+
+void convertI3dmContentToGltf(
+    const gsl::span<const std::byte>& instancesBinary,
+    const I3dmHeader& header,
+    const CesiumGltfReader::GltfReaderOptions& options,
+    GltfConverterResult& result) {
+  const gsl::span<const std::byte> featureTableJsonData =
+      instancesBinary.subspan(
+          sizeof(I3dmHeader),
+          header.featureTableJsonByteLength);
+  const gsl::span<const std::byte> featureTableBinaryData =
+      instancesBinary.subspan(
+          sizeof(I3dmHeader) + header.featureTableJsonByteLength,
+          header.featureTableBinaryByteLength);
+
+  rapidjson::Document featureTableJson =
+      FeatureTableDecoding::parseJson(featureTableJsonData, result.errors);
+  if (result.errors) {
+    return;
+  }
+
+  const std::optional<uint32_t> instancesLength =
+      FeatureTableDecoding::getGlobalUint32(
+          featureTableJson,
+          featureTableBinaryData,
+          "INSTANCES_LENGTH");
+  if (!instancesLength) {
+    result.errors.emplaceError(
+        "The I3DM feature table does not contain a valid INSTANCES_LENGTH.");
+    return;
+  }
+
+  if (header.gltfFormat != 1) {
+    // Converters are synchronous and have no asset accessor with which to
+    // fetch an external glTF, so report the tile as failed instead of
+    // silently producing one without geometry.
+    result.errors.emplaceError(
+        "I3DM tiles that reference an external glTF by URI are not "
+        "supported.");
+    return;
+  }
+
+  const size_t glbStart = sizeof(I3dmHeader) +
+                          header.featureTableJsonByteLength +
+                          header.featureTableBinaryByteLength +
+                          header.batchTableJsonByteLength +
+                          header.batchTableBinaryByteLength;
+  GltfConverterResult binToGltfResult = BinaryToGltfConverter::convert(
+      instancesBinary.subspan(glbStart, header.byteLength - glbStart),
+      options);
+  result.model = std::move(binToGltfResult.model);
+  result.errors.merge(std::move(binToGltfResult.errors));
+  if (!result.model || result.errors) {
+    return;
+  }
+
+  Model& gltf = *result.model;
+  if (*instancesLength == 0) {
+    // Nothing is rendered, so point the default scene at an empty scene.
+    gltf.scenes.emplace_back();
+    gltf.scene = int32_t(gltf.scenes.size() - 1);
+    return;
+  }
+
+  std::vector<glm::dvec3> positions;
+  const std::optional<glm::dvec3> rtcCenter = decodePositions(
+      featureTableJson,
+      featureTableBinaryData,
+      *instancesLength,
+      positions,
+      result.errors);
+  if (result.errors) {
+    return;
+  }
+
+  std::vector<glm::dmat3> rotations;
+  decodeRotations(
+      featureTableJson,
+      featureTableBinaryData,
+      positions,
+      rtcCenter.value_or(glm::dvec3(0.0)),
+      rotations,
+      result.errors);
+
+  std::vector<glm::dvec3> scales;
+  decodeScales(
+      featureTableJson,
+      featureTableBinaryData,
+      positions.size(),
+      scales,
+      result.errors);
+  if (result.errors) {
+    return;
+  }
+
+  std::vector<glm::dmat4> instanceTransforms(positions.size());
+  for (size_t i = 0; i < instanceTransforms.size(); ++i) {
+    glm::dmat4& transform = instanceTransforms[i];
+    transform = glm::dmat4(glm::dmat3(
+        rotations[i][0] * scales[i].x,
+        rotations[i][1] * scales[i].y,
+        rotations[i][2] * scales[i].z));
+    transform[3] = glm::dvec4(positions[i], 1.0);
+  }
+
+  if (rtcCenter) {
+    ExtensionCesiumRTC& cesiumRTC = gltf.addExtension<ExtensionCesiumRTC>();
+    cesiumRTC.center = {rtcCenter->x, rtcCenter->y, rtcCenter->z};
+  }
+
+  // Meshes that share a global transform (usually the identity) can share
+  // one set of instance attributes.
+  std::vector<std::pair<glm::dmat4, std::unordered_map<std::string, int32_t>>>
+      attributesByTransform;
+
+  Scene instancedScene;
+  for (const MeshNode& meshNode : getMeshNodes(gltf)) {
+    auto it = std::find_if(
+        attributesByTransform.begin(),
+        attributesByTransform.end(),
+        [&meshNode](const auto& entry) {
+          return entry.first == meshNode.transform;
+        });
+    if (it == attributesByTransform.end()) {
+      attributesByTransform.emplace_back(
+          meshNode.transform,
+          createInstancingAttributes(
+              gltf,
+              instanceTransforms,
+              meshNode.transform));
+      it = attributesByTransform.end() - 1;
+    }
+
+    instancedScene.nodes.emplace_back(int32_t(gltf.nodes.size()));
+    Node& node = gltf.nodes.emplace_back();
+    node.mesh = meshNode.mesh;
+    node.addExtension<ExtensionExtMeshGpuInstancing>().attributes = it->second;
+  }
+
+  gltf.scenes.emplace_back(std::move(instancedScene));
+  gltf.scene = int32_t(gltf.scenes.size() - 1);
+
+  addExtensionName(
+      gltf.extensionsUsed,
+      ExtensionExtMeshGpuInstancing::ExtensionName);
+  addExtensionName(
+      gltf.extensionsRequired,
+      ExtensionExtMeshGpuInstancing::ExtensionName);
+}
+} // namespace
+
+GltfConverterResult I3dmToGltfConverter::convert(
+    const gsl::span<const std::byte>& instancesBinary,
+    const CesiumGltfReader::GltfReaderOptions& options) {
+  GltfConverterResult result;
+  I3dmHeader header;
+  if (!parseI3dmHeader(instancesBinary, header, result)) {
+    return result;
+  }
+
+  convertI3dmContentToGltf(instancesBinary, header, options, result);
+  if (result.errors) {
+    result.model.reset();
+  }
+
+  return result;
+}
+} // namespace Cesium3DTilesSelection
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SubtreeAvailability.h"
+#include "SubtreeAvailabilityCache.h"
 
 #include <Cesium3DTilesSelection/TilesetContentLoader.h>
 #include <CesiumGeometry/OctreeTileID.h>
@@ -8,8 +9,9 @@
 #include <CesiumGeospatial/BoundingRegion.h>
 
 #include <cmath>
+#include <memory>
+#include <optional>
 #include <string>
-#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -34,9 +36,11 @@ public:
         _subtreeLevels{subtreeLevels},
         _availableLevels{availableLevels},
         _boundingVolume{std::forward<ImplicitBoundingVolumeType>(volume)},
-        _loadedSubtrees(static_cast<size_t>(std::ceil(
+        _subtreeLevelCount{static_cast<uint32_t>(std::ceil(
             static_cast<float>(availableLevels) /
-            static_cast<float>(subtreeLevels)))) {}
+            static_cast<float>(subtreeLevels)))},
+        _loadedSubtrees{},
+        _subtreeRequestContext{} {}
 
   CesiumAsync::Future<TileLoadResult>
   loadTileContent(const TileLoadInput& loadInput) override;
@@ -54,6 +58,18 @@ public:
       SubtreeAvailability&& subtreeAvailability);
 
 private:
+  struct SubtreeRequestContext {
+    CesiumAsync::AsyncSystem asyncSystem;
+    std::shared_ptr<CesiumAsync::IAssetAccessor> pAssetAccessor;
+    std::shared_ptr<spdlog::logger> pLogger;
+    std::vector<CesiumAsync::IAssetAccessor::THeader> requestHeaders;
+  };
+
+  void updateSubtreeRequestContext(const TileLoadInput& loadInput);
+
+  CesiumAsync::Future<void>
+  loadSubtree(const CesiumGeometry::OctreeTileID& subtreeID);
+
   static std::string resolveUrl(
       const std::string& baseUrl,
       const std::string& urlTemplate,
@@ -65,7 +81,8 @@ private:
   uint32_t _subtreeLevels;
   uint32_t _availableLevels;
   ImplicitOctreeBoundingVolume _boundingVolume;
-  std::vector<std::unordered_map<uint64_t, SubtreeAvailability>>
-      _loadedSubtrees;
+  uint32_t _subtreeLevelCount;
+  SubtreeAvailabilityCache _loadedSubtrees;
+  std::optional<SubtreeRequestContext> _subtreeRequestContext;
 };
 } // namespace Cesium3DTilesSelection
@@ -165,9 +165,9 @@ CesiumAsync::Future<TileLoadResult> requestTileContent(
     const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAssetAccessor,
     const std::string& tileUrl,
     const std::vector<CesiumAsync::IAssetAccessor::THeader>& requestHeaders,
-    CesiumGltf::Ktx2TranscodeTargets ktx2TranscodeTargets) {
+    const CesiumGltfReader::GltfReaderOptions& gltfOptions) {
   return pAssetAccessor->get(asyncSystem, tileUrl, requestHeaders)
-      .thenInWorkerThread([pLogger, ktx2TranscodeTargets](
+      .thenInWorkerThread([pLogger, gltfOptions](
                               std::shared_ptr<CesiumAsync::IAssetRequest>&&
                                   pCompletedRequest) mutable {
         const CesiumAsync::IAssetResponse* pResponse =
@@ -203,8 +203,6 @@ CesiumAsync::Future<TileLoadResult> requestTileContent(
 
         if (converter) {
           // Convert to gltf
-          CesiumGltfReader::GltfReaderOptions gltfOptions;
-          gltfOptions.ktx2TranscodeTargets = ktx2TranscodeTargets;
           GltfConverterResult result = converter(responseData, gltfOptions);
 
           // Report any errors if there are any
@@ -268,7 +266,7 @@ ImplicitQuadtreeLoader::loadTileContent(const TileLoadInput& loadInput) {
 
   // find the subtree ID
   uint32_t subtreeLevelIdx = pQuadtreeID->level / this->_subtreeLevels;
-  if (subtreeLevelIdx >= _loadedSubtrees.size()) {
+  if (subtreeLevelIdx >= this->_subtreeLevelCount) {
     return asyncSystem.createResolvedFuture<TileLoadResult>(
         TileLoadResult::createFailedResult(nullptr));
   }
@@ -279,6 +277,8 @@ ImplicitQuadtreeLoader::loadTileContent(const TileLoadInput& loadInput) {
   uint32_t subtreeY = pQuadtreeID->y >> levelLeft;
   CesiumGeometry::QuadtreeTileID subtreeID{subtreeLevel, subtreeX, subtreeY};
 
+  this->updateSubtreeRequestContext(loadInput);
+
   // the below morton index hash to the subtree assumes that tileID's components
   // x and y never exceed 32-bit. In other words, the max levels this loader can
   // support is 33 which will have 4^32 tiles in the level 32th. The 64-bit
@@ -291,35 +291,17 @@ ImplicitQuadtreeLoader::loadTileContent(const TileLoadInput& loadInput) {
   // parent loader. The solution isn't implemented at the moment, as implicit
   // tilesets that exceeds 33 levels are expected to be very rare
   uint64_t subtreeMortonIdx = libmorton::morton2D_64_encode(subtreeX, subtreeY);
-  auto subtreeIt =
-      this->_loadedSubtrees[subtreeLevelIdx].find(subtreeMortonIdx);
-  if (subtreeIt == this->_loadedSubtrees[subtreeLevelIdx].end()) {
-    // subtree is not loaded, so load it now.
-    std::string subtreeUrl =
-        resolveUrl(this->_baseUrl, this->_subtreeUrlTemplate, subtreeID);
-    return SubtreeAvailability::loadSubtree(
-               2,
-               asyncSystem,
-               pAssetAccessor,
-               pLogger,
-               subtreeUrl,
-               requestHeaders)
-        .thenInMainThread([this, subtreeID](std::optional<SubtreeAvailability>&&
-                                                subtreeAvailability) mutable {
-          if (subtreeAvailability) {
-            this->addSubtreeAvailability(
-                subtreeID,
-                std::move(*subtreeAvailability));
-          }
-
-          // tell client to retry later
-          return TileLoadResult::createRetryLaterResult(nullptr);
-        });
+  const SubtreeAvailability* pSubtree =
+      this->_loadedSubtrees.find(subtreeLevelIdx, subtreeMortonIdx);
+  if (!pSubtree) {
+    // subtree is not loaded, so load it now and tell client to retry later
+    return this->loadSubtree(subtreeID).thenImmediately(
+        []() { return TileLoadResult::createRetryLaterResult(nullptr); });
   }
 
   // subtree is available, so check if tile has content or not. If it has, then
   // request it
-  if (!isTileContentAvailable(subtreeID, *pQuadtreeID, subtreeIt->second)) {
+  if (!isTileContentAvailable(subtreeID, *pQuadtreeID, *pSubtree)) {
     // check if tile has empty content
     return asyncSystem.createResolvedFuture(TileLoadResult{
         TileEmptyContent{},
@@ -334,13 +316,16 @@ ImplicitQuadtreeLoader::loadTileContent(const TileLoadInput& loadInput) {
 
   std::string tileUrl =
       resolveUrl(this->_baseUrl, this->_contentUrlTemplate, *pQuadtreeID);
+  CesiumGltfReader::GltfReaderOptions gltfOptions;
+  gltfOptions.ktx2TranscodeTargets = contentOptions.ktx2TranscodeTargets;
+  gltfOptions.maximumImageDimension = loadInput.maximumImageDimension;
   return requestTileContent(
       pLogger,
       asyncSystem,
       pAssetAccessor,
       tileUrl,
       requestHeaders,
-      contentOptions.ktx2TranscodeTargets);
+      gltfOptions);
 }
 
 TileChildrenResult
@@ -351,7 +336,7 @@ ImplicitQuadtreeLoader::createTileChildren(const Tile& tile) {
 
   // find the subtree ID
   uint32_t subtreeLevelIdx = pQuadtreeID->level / this->_subtreeLevels;
-  if (subtreeLevelIdx >= this->_loadedSubtrees.size()) {
+  if (subtreeLevelIdx >= this->_subtreeLevelCount) {
     return {{}, TileLoadResultState::Failed};
   }
 
@@ -360,14 +345,14 @@ ImplicitQuadtreeLoader::createTileChildren(const Tile& tile) {
   uint32_t subtreeY = pQuadtreeID->y >> levelLeft;
 
   uint64_t subtreeMortonIdx = libmorton::morton2D_64_encode(subtreeX, subtreeY);
-  auto subtreeIt =
-      this->_loadedSubtrees[subtreeLevelIdx].find(subtreeMortonIdx);
-  if (subtreeIt != this->_loadedSubtrees[subtreeLevelIdx].end()) {
+  const SubtreeAvailability* pSubtree =
+      this->_loadedSubtrees.find(subtreeLevelIdx, subtreeMortonIdx);
+  if (pSubtree) {
     uint64_t relativeTileMortonIdx = libmorton::morton2D_64_encode(
         pQuadtreeID->x - (subtreeX << levelLeft),
         pQuadtreeID->y - (subtreeY << levelLeft));
     auto children = populateSubtree(
-        subtreeIt->second,
+        *pSubtree,
         this->_subtreeLevels,
         static_cast<std::uint32_t>(levelLeft),
         relativeTileMortonIdx,
@@ -377,6 +362,16 @@ ImplicitQuadtreeLoader::createTileChildren(const Tile& tile) {
     return {std::move(children), TileLoadResultState::Success};
   }
 
+  // the subtree has been unloaded from the cache since the tile's content was
+  // loaded, so request it again.
+  if (this->_subtreeRequestContext) {
+    CesiumGeometry::QuadtreeTileID subtreeID{
+        this->_subtreeLevels * subtreeLevelIdx,
+        subtreeX,
+        subtreeY};
+    this->loadSubtree(subtreeID);
+  }
+
   return {{}, TileLoadResultState::RetryLater};
 }
 
@@ -397,18 +392,75 @@ void ImplicitQuadtreeLoader::addSubtreeAvailability(
     const CesiumGeometry::QuadtreeTileID& subtreeID,
     SubtreeAvailability&& subtreeAvailability) {
   uint32_t levelIndex = subtreeID.level / this->_subtreeLevels;
-  if (levelIndex >= this->_loadedSubtrees.size()) {
+  if (levelIndex >= this->_subtreeLevelCount) {
     return;
   }
 
   uint64_t subtreeMortonID =
       libmorton::morton2D_64_encode(subtreeID.x, subtreeID.y);
 
-  this->_loadedSubtrees[levelIndex].insert_or_assign(
+  this->_loadedSubtrees.insert(
+      levelIndex,
       subtreeMortonID,
       std::move(subtreeAvailability));
 }
 
+void ImplicitQuadtreeLoader::updateSubtreeRequestContext(
+    const TileLoadInput& loadInput) {
+  // Remember how to request subtrees, so that createTileChildren can request
+  // one again after it has been unloaded from the cache. The request headers
+  // are only copied again when they change.
+  if (!this->_subtreeRequestContext ||
+      this->_subtreeRequestContext->pAssetAccessor !=
+          loadInput.pAssetAccessor ||
+      this->_subtreeRequestContext->requestHeaders !=
+          loadInput.requestHeaders) {
+    this->_subtreeRequestContext = SubtreeRequestContext{
+        loadInput.asyncSystem,
+        loadInput.pAssetAccessor,
+        loadInput.pLogger,
+        loadInput.requestHeaders};
+  }
+
+  const int64_t maximumBytes =
+      loadInput.contentOptions.maximumCachedSubtreeBytes;
+  if (this->_loadedSubtrees.getMaximumBytes() != maximumBytes) {
+    this->_loadedSubtrees.setMaximumBytes(maximumBytes);
+  }
+}
+
+CesiumAsync::Future<void> ImplicitQuadtreeLoader::loadSubtree(
+    const CesiumGeometry::QuadtreeTileID& subtreeID) {
+  const SubtreeRequestContext& context = *this->_subtreeRequestContext;
+  uint32_t levelIndex = subtreeID.level / this->_subtreeLevels;
+  uint64_t subtreeMortonID =
+      libmorton::morton2D_64_encode(subtreeID.x, subtreeID.y);
+  if (!this->_loadedSubtrees.beginLoading(levelIndex, subtreeMortonID)) {
+    // another tile is already waiting for this subtree
+    return context.asyncSystem.createResolvedFuture();
+  }
+
+  std::string subtreeUrl =
+      resolveUrl(this->_baseUrl, this->_subtreeUrlTemplate, subtreeID);
+  return SubtreeAvailability::loadSubtree(
+             2,
+             context.asyncSystem,
+             context.pAssetAccessor,
+             context.pLogger,
+             subtreeUrl,
+             context.requestHeaders)
+      .thenInMainThread(
+          [this, subtreeID, levelIndex, subtreeMortonID](
+              std::optional<SubtreeAvailability>&& subtreeAvailability) {
+            this->_loadedSubtrees.endLoading(levelIndex, subtreeMortonID);
+            if (subtreeAvailability) {
+              this->addSubtreeAvailability(
+                  subtreeID,
+                  std::move(*subtreeAvailability));
+            }
+          });
+}
+
 std::string ImplicitQuadtreeLoader::resolveUrl(
     const std::string& baseUrl,
     const std::string& urlTemplate,
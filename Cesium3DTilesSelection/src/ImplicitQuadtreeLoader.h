@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SubtreeAvailability.h"
+#include "SubtreeAvailabilityCache.h"
 
 #include <Cesium3DTilesSelection/TilesetContentLoader.h>
 #include <CesiumGeometry/OrientedBoundingBox.h>
@@ -9,8 +10,9 @@
 #include <CesiumGeospatial/S2CellBoundingVolume.h>
 
 #include <cmath>
+#include <memory>
+#include <optional>
 #include <string>
-#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -36,9 +38,11 @@ public:
         _subtreeLevels{subtreeLevels},
         _availableLevels{availableLevels},
         _boundingVolume{std::forward<ImplicitBoundingVolumeType>(volume)},
-        _loadedSubtrees(static_cast<size_t>(std::ceil(
+        _subtreeLevelCount{static_cast<uint32_t>(std::ceil(
             static_cast<float>(availableLevels) /
-            static_cast<float>(subtreeLevels)))) {}
+            static_cast<float>(subtreeLevels)))},
+        _loadedSubtrees{},
+        _subtreeRequestContext{} {}
 
   CesiumAsync::Future<TileLoadResult>
   loadTileContent(const TileLoadInput& loadInput) override;
@@ -56,6 +60,18 @@ public:
       SubtreeAvailability&& subtreeAvailability);
 
 private:
+  struct SubtreeRequestContext {
+    CesiumAsync::AsyncSystem asyncSystem;
+    std::shared_ptr<CesiumAsync::IAssetAccessor> pAssetAccessor;
+    std::shared_ptr<spdlog::logger> pLogger;
+    std::vector<CesiumAsync::IAssetAccessor::THeader> requestHeaders;
+  };
+
+  void updateSubtreeRequestContext(const TileLoadInput& loadInput);
+
+  CesiumAsync::Future<void>
+  loadSubtree(const CesiumGeometry::QuadtreeTileID& subtreeID);
+
   static std::string resolveUrl(
       const std::string& baseUrl,
       const std::string& urlTemplate,
@@ -67,7 +83,8 @@ private:
   uint32_t _subtreeLevels;
   uint32_t _availableLevels;
   ImplicitQuadtreeBoundingVolume _boundingVolume;
-  std::vector<std::unordered_map<uint64_t, SubtreeAvailability>>
-      _loadedSubtrees;
+  uint32_t _subtreeLevelCount;
+  SubtreeAvailabilityCache _loadedSubtrees;
+  std::optional<SubtreeRequestContext> _subtreeRequestContext;
 };
 } // namespace Cesium3DTilesSelection
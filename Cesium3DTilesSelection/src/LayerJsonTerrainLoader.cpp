@@ -12,6 +12,8 @@
 #include <libmorton/morton.h>
 #include <rapidjson/document.h>
 
+#include <algorithm>
+
 using namespace CesiumAsync;
 using namespace Cesium3DTilesSelection;
 using namespace CesiumGeometry;
@@ -172,9 +174,7 @@ void addRectangleAvailabilityToLayer(
     const QuadtreeTileID& subtreeID,
     const std::vector<CesiumGeometry::QuadtreeTileRectangularRange>&
         rectangleAvailabilities) {
-  for (const QuadtreeTileRectangularRange& range : rectangleAvailabilities) {
-    layer.contentAvailability.addAvailableTileRange(range);
-  }
+  layer.contentAvailability.addAvailableTileRanges(rectangleAvailabilities);
 
   uint32_t subtreeLevelIdx;
   uint64_t subtreeMortonIdx;
@@ -310,9 +310,7 @@ Future<LoadLayersResult> loadLayersRecursive(
         QuantizedMeshLoader::loadAvailabilityRectangles(layerJson, 0);
     loadLayersResult.errors.merge(metadata.errors);
 
-    for (const auto& rectangle : metadata.availability) {
-      availability.addAvailableTileRange(rectangle);
-    }
+    availability.addAvailableTileRanges(metadata.availability);
   }
 
   const auto attributionIt = layerJson.FindMember("attribution");
@@ -945,19 +943,10 @@ bool LayerJsonTerrainLoader::tileHasUpsampledChild(const Tile& tile) const {
     const QuadtreeTileID* pQuadtreeTileID =
         std::get_if<QuadtreeTileID>(&tile.getTileID());
 
-    const QuadtreeTileID swID(
-        pQuadtreeTileID->level + 1,
-        pQuadtreeTileID->x * 2,
-        pQuadtreeTileID->y * 2);
-    const QuadtreeTileID seID(swID.level, swID.x + 1, swID.y);
-    const QuadtreeTileID nwID(swID.level, swID.x, swID.y + 1);
-    const QuadtreeTileID neID(swID.level, swID.x + 1, swID.y + 1);
-
-    uint32_t totalChildren = 0;
-    totalChildren += this->tileIsAvailableInAnyLayer(swID);
-    totalChildren += this->tileIsAvailableInAnyLayer(seID);
-    totalChildren += this->tileIsAvailableInAnyLayer(nwID);
-    totalChildren += this->tileIsAvailableInAnyLayer(neID);
+    const std::array<bool, 4> available =
+        this->childTilesAreAvailableInAnyLayer(*pQuadtreeTileID);
+    const auto totalChildren =
+        std::count(available.begin(), available.end(), true);
     return totalChildren > 0 && totalChildren < 4;
   } else {
     for (const auto& child : tileChildren) {
@@ -986,10 +975,8 @@ LayerJsonTerrainLoader::createTileChildrenImpl(const Tile& tile) {
   const QuadtreeTileID neID(swID.level, swID.x + 1, swID.y + 1);
 
   // If _any_ child is available, we create _all_ children
-  bool sw = this->tileIsAvailableInAnyLayer(swID);
-  bool se = this->tileIsAvailableInAnyLayer(seID);
-  bool nw = this->tileIsAvailableInAnyLayer(nwID);
-  bool ne = this->tileIsAvailableInAnyLayer(neID);
+  const auto [sw, se, nw, ne] =
+      this->childTilesAreAvailableInAnyLayer(*pQuadtreeTileID);
 
   if (sw || se || nw || ne) {
     std::vector<Tile> children;
@@ -1005,16 +992,24 @@ LayerJsonTerrainLoader::createTileChildrenImpl(const Tile& tile) {
   return {};
 }
 
-bool LayerJsonTerrainLoader::tileIsAvailableInAnyLayer(
+std::array<bool, 4> LayerJsonTerrainLoader::childTilesAreAvailableInAnyLayer(
     const QuadtreeTileID& tileID) const {
+  std::array<bool, 4> result{};
   for (const Layer& layer : this->_layers) {
-    auto availableState = tileIsAvailableInLayer(tileID, layer);
-    if (availableState == AvailableState::Available) {
-      return true;
+    const std::array<uint8_t, 4> available =
+        layer.contentAvailability.areChildTilesAvailable(tileID);
+    bool allAvailable = true;
+    for (size_t i = 0; i < result.size(); ++i) {
+      result[i] = result[i] || available[i] != 0;
+      allAvailable = allAvailable && result[i];
+    }
+
+    if (allAvailable) {
+      break;
     }
   }
 
-  return false;
+  return result;
 }
 
 LayerJsonTerrainLoader::AvailableState
@@ -13,6 +13,7 @@
 
 #include <rapidjson/fwd.h>
 
+#include <array>
 #include <memory>
 #include <optional>
 #include <string>
@@ -85,8 +86,8 @@ private:
 
   std::vector<Tile> createTileChildrenImpl(const Tile& tile);
 
-  bool
-  tileIsAvailableInAnyLayer(const CesiumGeometry::QuadtreeTileID& tileID) const;
+  std::array<bool, 4> childTilesAreAvailableInAnyLayer(
+      const CesiumGeometry::QuadtreeTileID& tileID) const;
 
   AvailableState tileIsAvailableInLayer(
       const CesiumGeometry::QuadtreeTileID& tileID,
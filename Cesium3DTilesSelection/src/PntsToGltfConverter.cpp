@@ -0,0 +1,538 @@
+#include "PntsToGltfConverter.h"
+
+#include "FeatureTableDecoding.h"
+
+#include <CesiumGeometry/AxisTransforms.h>
+#include <CesiumGltf/ExtensionCesiumRTC.h>
+#include <CesiumGltf/ExtensionKhrMaterialsUnlit.h>
+
+#include <glm/common.hpp>
+#include <glm/mat4x4.hpp>
+#include <spdlog/fmt/fmt.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace CesiumGltf;
+
+namespace Cesium3DTilesSelection {
+namespace {
+struct PntsHeader {
+  unsigned char magic[4];
+  uint32_t version;
+  uint32_t byteLength;
+  uint32_t featureTableJsonByteLength;
+  uint32_t featureTableBinaryByteLength;
+  uint32_t batchTableJsonByteLength;
+  uint32_t batchTableBinaryByteLength;
+};
+
+static_assert(sizeof(PntsHeader) == 28);
+
+double srgbToLinear(double value) {
+  return value <= 0.04045 ? value / 12.92
+                          : std::pow((value + 0.055) / 1.055, 2.4);
+}
+
+// Point cloud colors are sRGB, while glTF vertex colors are linear. Eight bits
+// aren't enough to hold dark linear values, so colors are stored as
+// normalized unsigned shorts: twice the size of the source, but half the size
+// of floats.
+const std::array<uint16_t, 256>& getSrgbToLinearTable() {
+  static const std::array<uint16_t, 256> table = []() {
+    std::array<uint16_t, 256> result{};
+    for (size_t i = 0; i < result.size(); ++i) {
+      result[i] = static_cast<uint16_t>(std::lround(
+          srgbToLinear(double(i) / 255.0) *
+          double(std::numeric_limits<uint16_t>::max())));
+    }
+    return result;
+  }();
+  return table;
+}
+
+int32_t createAccessor(
+    Model& gltf,
+    std::vector<std::byte>&& data,
+    int32_t componentType,
+    const std::string& type,
+    int64_t count,
+    bool normalized) {
+  const int32_t bufferId = int32_t(gltf.buffers.size());
+  Buffer& buffer = gltf.buffers.emplace_back();
+  buffer.byteLength = int64_t(data.size());
+  buffer.cesium.data = std::move(data);
+
+  const int32_t bufferViewId = int32_t(gltf.bufferViews.size());
+  BufferView& bufferView = gltf.bufferViews.emplace_back();
+  bufferView.buffer = bufferId;
+  bufferView.byteLength = buffer.byteLength;
+  bufferView.target = BufferView::Target::ARRAY_BUFFER;
+
+  const int32_t accessorId = int32_t(gltf.accessors.size());
+  Accessor& accessor = gltf.accessors.emplace_back();
+  accessor.bufferView = bufferViewId;
+  accessor.componentType = componentType;
+  accessor.type = type;
+  accessor.count = count;
+  accessor.normalized = normalized;
+  return accessorId;
+}
+
+bool parsePntsHeader(
+    const gsl::span<const std::byte>& pointCloudBinary,
+    PntsHeader& header,
+    GltfConverterResult& result) {
+  if (pointCloudBinary.size() < sizeof(PntsHeader)) {
+    result.errors.emplaceError("The PNTS is invalid because it is too small to "
+                               "include a PNTS header.");
+    return false;
+  }
+
+  std::memcpy(&header, pointCloudBinary.data(), sizeof(PntsHeader));
+
+  if (header.version != 1) {
+    result.errors.emplaceError(
+        fmt::format("Unsupported PNTS version {}.", header.version));
+    return false;
+  }
+
+  if (header.byteLength > pointCloudBinary.size()) {
+    result.errors.emplaceError(
+        "The PNTS is invalid because the total data available is less than the "
+        "size specified in its header.");
+    return false;
+  }
+
+  const uint64_t featureTableEnd = uint64_t(sizeof(PntsHeader)) +
+                                   header.featureTableJsonByteLength +
+                                   header.featureTableBinaryByteLength;
+  if (featureTableEnd > header.byteLength) {
+    result.errors.emplaceError(
+        "The PNTS is invalid because its feature table extends past the end "
+        "of the entire PNTS.");
+    return false;
+  }
+
+  return true;
+}
+
+// Decodes positions relative to the returned RTC center, if any, and returns
+// their bounds in `minimum` and `maximum`.
+std::optional<glm::dvec3> decodePositions(
+    const rapidjson::Value& featureTableJson,
+    const gsl::span<const std::byte>& featureTableBinary,
+    uint32_t pointsLength,
+    std::vector<std::byte>& positionData,
+    glm::dvec3& minimum,
+    glm::dvec3& maximum,
+    ErrorList& errors) {
+  std::optional<glm::dvec3> rtcCenter = FeatureTableDecoding::getGlobalVec3(
+      featureTableJson,
+      featureTableBinary,
+      "RTC_CENTER");
+
+  positionData.resize(size_t(pointsLength) * 3 * sizeof(float));
+  const gsl::span<float> positions(
+      reinterpret_cast<float*>(positionData.data()),
+      size_t(pointsLength) * 3);
+
+  const std::optional<gsl::span<const std::byte>> floatData =
+      FeatureTableDecoding::getPropertyData(
+          featureTableJson,
+          featureTableBinary,
+          "POSITION",
+          pointsLength,
+          3 * sizeof(float),
+          errors);
+  if (floatData) {
+    // Already in the output format.
+    std::memcpy(positionData.data(), floatData->data(), floatData->size());
+  } else {
+    const std::optional<gsl::span<const std::byte>> quantizedData =
+        FeatureTableDecoding::getPropertyData(
+            featureTableJson,
+            featureTableBinary,
+            "POSITION_QUANTIZED",
+            pointsLength,
+            3 * sizeof(uint16_t),
+            errors);
+    const std::optional<glm::dvec3> offset =
+        FeatureTableDecoding::getGlobalVec3(
+            featureTableJson,
+            featureTableBinary,
+            "QUANTIZED_VOLUME_OFFSET");
+    const std::optional<glm::dvec3> scale = FeatureTableDecoding::getGlobalVec3(
+        featureTableJson,
+        featureTableBinary,
+        "QUANTIZED_VOLUME_SCALE");
+    if (!quantizedData || !offset || !scale) {
+      errors.emplaceError(
+          "The PNTS feature table must contain either POSITION, or "
+          "POSITION_QUANTIZED along with QUANTIZED_VOLUME_OFFSET and "
+          "QUANTIZED_VOLUME_SCALE.");
+      return rtcCenter;
+    }
+
+    // Without an RTC_CENTER, dequantize relative to the center of the
+    // quantized volume to keep single-precision positions accurate.
+    glm::dvec3 origin(0.0);
+    if (!rtcCenter) {
+      origin = *offset + *scale * 0.5;
+      rtcCenter = origin;
+    }
+
+    FeatureTableDecoding::dequantizePositions(
+        *quantizedData,
+        *offset - origin,
+        *scale,
+        positions);
+  }
+
+  glm::vec3 floatMinimum(std::numeric_limits<float>::max());
+  glm::vec3 floatMaximum(std::numeric_limits<float>::lowest());
+  for (size_t i = 0; i < pointsLength; ++i) {
+    const glm::vec3 position(
+        positions[3 * i],
+        positions[3 * i + 1],
+        positions[3 * i + 2]);
+    floatMinimum = glm::min(floatMinimum, position);
+    floatMaximum = glm::max(floatMaximum, position);
+  }
+
+  minimum = glm::dvec3(floatMinimum);
+  maximum = glm::dvec3(floatMaximum);
+
+  if (!rtcCenter) {
+    // Positions may be absolute Earth-centered coordinates, which lose
+    // precision on the GPU. Make them relative to their center instead.
+    const glm::dvec3 center = (minimum + maximum) * 0.5;
+    for (size_t i = 0; i < pointsLength; ++i) {
+      for (size_t c = 0; c < 3; ++c) {
+        float& value = positions[3 * i + c];
+        value = static_cast<float>(double(value) - center[glm::length_t(c)]);
+      }
+    }
+
+    minimum -= center;
+    maximum -= center;
+    rtcCenter = center;
+  }
+
+  return rtcCenter;
+}
+
+// Returns the COLOR_0 accessor, or -1 if there are no per-point colors.
+int32_t decodeColors(
+    Model& gltf,
+    const rapidjson::Value& featureTableJson,
+    const gsl::span<const std::byte>& featureTableBinary,
+    uint32_t pointsLength,
+    bool& hasTranslucency,
+    ErrorList& errors) {
+  const std::array<uint16_t, 256>& toLinear = getSrgbToLinearTable();
+  const size_t count = pointsLength;
+
+  const std::optional<gsl::span<const std::byte>> rgbaData =
+      FeatureTableDecoding::getPropertyData(
+          featureTableJson,
+          featureTableBinary,
+          "RGBA",
+          count,
+          4,
+          errors);
+  if (rgbaData) {
+    std::vector<std::byte> colorData(count * 4 * sizeof(uint16_t));
+    uint16_t* pOut = reinterpret_cast<uint16_t*>(colorData.data());
+    const uint8_t* pIn = reinterpret_cast<const uint8_t*>(rgbaData->data());
+    uint8_t minimumAlpha = 255;
+    for (size_t i = 0; i < count; ++i) {
+      pOut[4 * i] = toLinear[pIn[4 * i]];
+      pOut[4 * i + 1] = toLinear[pIn[4 * i + 1]];
+      pOut[4 * i + 2] = toLinear[pIn[4 * i + 2]];
+      // Alpha is not gamma-encoded; scale it from 8 to 16 bits.
+      pOut[4 * i + 3] = static_cast<uint16_t>(pIn[4 * i + 3] * 257);
+      minimumAlpha = std::min(minimumAlpha, pIn[4 * i + 3]);
+    }
+
+    hasTranslucency = minimumAlpha < 255;
+    return createAccessor(
+        gltf,
+        std::move(colorData),
+        Accessor::ComponentType::UNSIGNED_SHORT,
+        Accessor::Type::VEC4,
+        int64_t(count),
+        true);
+  }
+
+  std::vector<std::byte> colorData(count * 3 * sizeof(uint16_t));
+  uint16_t* pOut = reinterpret_cast<uint16_t*>(colorData.data());
+
+  const std::optional<gsl::span<const std::byte>> rgbData =
+      FeatureTableDecoding::getPropertyData(
+          featureTableJson,
+          featureTableBinary,
+          "RGB",
+          count,
+          3,
+          errors);
+  std::optional<gsl::span<const std::byte>> rgb565Data;
+  if (!rgbData) {
+    rgb565Data = FeatureTableDecoding::getPropertyData(
+        featureTableJson,
+        featureTableBinary,
+        "RGB565",
+        count,
+        sizeof(uint16_t),
+        errors);
+  }
+
+  if (rgbData) {
+    const uint8_t* pIn = reinterpret_cast<const uint8_t*>(rgbData->data());
+    for (size_t i = 0; i < count * 3; ++i) {
+      pOut[i] = toLinear[pIn[i]];
+    }
+  } else if (rgb565Data) {
+    std::vector<uint16_t> packed(count);
+    std::memcpy(packed.data(), rgb565Data->data(), rgb565Data->size());
+    for (size_t i = 0; i < count; ++i) {
+      const uint32_t red = (packed[i] >> 11) & 0x1F;
+      const uint32_t green = (packed[i] >> 5) & 0x3F;
+      const uint32_t blue = packed[i] & 0x1F;
+      pOut[3 * i] = toLinear[(red << 3) | (red >> 2)];
+      pOut[3 * i + 1] = toLinear[(green << 2) | (green >> 4)];
+      pOut[3 * i + 2] = toLinear[(blue << 3) | (blue >> 2)];
+    }
+  } else {
+    return -1;
+  }
+
+  return createAccessor(
+      gltf,
+      std::move(colorData),
+      Accessor::ComponentType::UNSIGNED_SHORT,
+      Accessor::Type::VEC3,
+      int64_t(count),
+      true);
+}
+
+// Returns the NORMAL accessor, or -1 if there are no per-point normals.
+int32_t decodeNormals(
+    Model& gltf,
+    const rapidjson::Value& featureTableJson,
+    const gsl::span<const std::byte>& featureTableBinary,
+    uint32_t pointsLength,
+    ErrorList& errors) {
+  const size_t count = pointsLength;
+  std::vector<std::byte> normalData(count * 3 * sizeof(float));
+
+  const std::optional<gsl::span<const std::byte>> floatData =
+      FeatureTableDecoding::getPropertyData(
+          featureTableJson,
+          featureTableBinary,
+          "NORMAL",
+          count,
+          3 * sizeof(float),
+          errors);
+  if (floatData) {
+    std::memcpy(normalData.data(), floatData->data(), floatData->size());
+  } else {
+    const std::optional<gsl::span<const std::byte>> octData =
+        FeatureTableDecoding::getPropertyData(
+            featureTableJson,
+            featureTableBinary,
+            "NORMAL_OCT16P",
+            count,
+            2,
+            errors);
+    if (!octData) {
+      return -1;
+    }
+
+    FeatureTableDecoding::octDecode(
+        *octData,
+        false,
+        gsl::span<float>(
+            reinterpret_cast<float*>(normalData.data()),
+            count * 3));
+  }
+
+  return createAccessor(
+      gltf,
+      std::move(normalData),
+      Accessor::ComponentType::FLOAT,
+      Accessor::Type::VEC3,
+      int64_t(count),
+      false);
+}
+
+void convertPntsContentToGltf(
+    const gsl::span<const std::byte>& pointCloudBinary,
+    const PntsHeader& header,
+    GltfConverterResult& result) {
+  const gsl::span<const std::byte> featureTableJsonData =
+      pointCloudBinary.subspan(
+          sizeof(PntsHeader),
+          header.featureTableJsonByteLength);
+  const gsl::span<const std::byte> featureTableBinaryData =
+      pointCloudBinary.subspan(
+          sizeof(PntsHeader) + header.featureTableJsonByteLength,
+          header.featureTableBinaryByteLength);
+
+  rapidjson::Document featureTableJson =
+      FeatureTableDecoding::parseJson(featureTableJsonData, result.errors);
+  if (result.errors) {
+    return;
+  }
+
+  const auto extensionsIt = featureTableJson.FindMember("extensions");
+  if (extensionsIt != featureTableJson.MemberEnd() &&
+      extensionsIt->value.IsObject() &&
+      extensionsIt->value.HasMember("3DTILES_draco_point_compression")) {
+    result.errors.emplaceError(
+        "PNTS tiles using 3DTILES_draco_point_compression are not yet "
+        "supported.");
+    return;
+  }
+
+  const std::optional<uint32_t> pointsLength =
+      FeatureTableDecoding::getGlobalUint32(
+          featureTableJson,
+          featureTableBinaryData,
+          "POINTS_LENGTH");
+  if (!pointsLength) {
+    result.errors.emplaceError(
+        "The PNTS feature table does not contain a valid POINTS_LENGTH.");
+    return;
+  }
+
+  Model& gltf = result.model.emplace();
+  if (*pointsLength == 0) {
+    return;
+  }
+
+  std::vector<std::byte> positionData;
+  glm::dvec3 minimum;
+  glm::dvec3 maximum;
+  const std::optional<glm::dvec3> rtcCenter = decodePositions(
+      featureTableJson,
+      featureTableBinaryData,
+      *pointsLength,
+      positionData,
+      minimum,
+      maximum,
+      result.errors);
+  if (result.errors) {
+    return;
+  }
+
+  if (rtcCenter) {
+    ExtensionCesiumRTC& cesiumRTC = gltf.addExtension<ExtensionCesiumRTC>();
+    cesiumRTC.center = {rtcCenter->x, rtcCenter->y, rtcCenter->z};
+  }
+
+  const int32_t positionAccessorId = createAccessor(
+      gltf,
+      std::move(positionData),
+      Accessor::ComponentType::FLOAT,
+      Accessor::Type::VEC3,
+      int64_t(*pointsLength),
+      false);
+  Accessor& positionAccessor = gltf.accessors[size_t(positionAccessorId)];
+  positionAccessor.min = {minimum.x, minimum.y, minimum.z};
+  positionAccessor.max = {maximum.x, maximum.y, maximum.z};
+
+  bool hasTranslucency = false;
+  const int32_t colorAccessorId = decodeColors(
+      gltf,
+      featureTableJson,
+      featureTableBinaryData,
+      *pointsLength,
+      hasTranslucency,
+      result.errors);
+  const int32_t normalAccessorId = decodeNormals(
+      gltf,
+      featureTableJson,
+      featureTableBinaryData,
+      *pointsLength,
+      result.errors);
+  if (result.errors) {
+    return;
+  }
+
+  Material& material = gltf.materials.emplace_back();
+  MaterialPBRMetallicRoughness& pbr = material.pbrMetallicRoughness.emplace();
+  pbr.metallicFactor = 0.0;
+  pbr.roughnessFactor = 1.0;
+
+  const auto constantRgbaIt = featureTableJson.FindMember("CONSTANT_RGBA");
+  if (colorAccessorId < 0 && constantRgbaIt != featureTableJson.MemberEnd() &&
+      constantRgbaIt->value.IsArray() && constantRgbaIt->value.Size() == 4) {
+    const rapidjson::Value& rgba = constantRgbaIt->value;
+    pbr.baseColorFactor.resize(4);
+    for (rapidjson::SizeType i = 0; i < 4; ++i) {
+      const double value =
+          rgba[i].IsNumber() ? rgba[i].GetDouble() / 255.0 : 1.0;
+      pbr.baseColorFactor[i] = i < 3 ? srgbToLinear(value) : value;
+    }
+    hasTranslucency = pbr.baseColorFactor[3] < 1.0;
+  }
+
+  if (hasTranslucency) {
+    material.alphaMode = Material::AlphaMode::BLEND;
+  }
+
+  if (normalAccessorId < 0) {
+    // Points without normals can't be lit.
+    material.addExtension<ExtensionKhrMaterialsUnlit>();
+    gltf.extensionsUsed.emplace_back(ExtensionKhrMaterialsUnlit::ExtensionName);
+  }
+
+  Mesh& mesh = gltf.meshes.emplace_back();
+  MeshPrimitive& primitive = mesh.primitives.emplace_back();
+  primitive.mode = MeshPrimitive::Mode::POINTS;
+  primitive.material = 0;
+  primitive.attributes.emplace("POSITION", positionAccessorId);
+  if (colorAccessorId >= 0) {
+    primitive.attributes.emplace("COLOR_0", colorAccessorId);
+  }
+  if (normalAccessorId >= 0) {
+    primitive.attributes.emplace("NORMAL", normalAccessorId);
+  }
+
+  // Point positions are already Z-up, so undo the Y-up to Z-up transform that
+  // is applied to every glTF.
+  Node& node = gltf.nodes.emplace_back();
+  node.mesh = 0;
+  const glm::dmat4& zUpToYUp = CesiumGeometry::AxisTransforms::Z_UP_TO_Y_UP;
+  std::memcpy(node.matrix.data(), &zUpToYUp, sizeof(glm::dmat4));
+
+  Scene& scene = gltf.scenes.emplace_back();
+  scene.nodes.emplace_back(0);
+  gltf.scene = 0;
+}
+} // namespace
+
+GltfConverterResult PntsToGltfConverter::convert(
+    const gsl::span<const std::byte>& pointCloudBinary,
+    const CesiumGltfReader::GltfReaderOptions& /*options*/) {
+  GltfConverterResult result;
+  PntsHeader header;
+  if (!parsePntsHeader(pointCloudBinary, header, result)) {
+    return result;
+  }
+
+  convertPntsContentToGltf(pointCloudBinary, header, result);
+  if (result.errors) {
+    result.model.reset();
+  }
+
+  return result;
+}
+} // namespace Cesium3DTilesSelection
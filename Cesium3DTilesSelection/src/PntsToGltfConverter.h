@@ -0,0 +1,16 @@
+#pragma once
+
+#include <Cesium3DTilesSelection/GltfConverterResult.h>
+#include <CesiumGltfReader/GltfReader.h>
+
+#include <gsl/span>
+
+#include <cstddef>
+
+namespace Cesium3DTilesSelection {
+struct PntsToGltfConverter {
+  static GltfConverterResult convert(
+      const gsl::span<const std::byte>& pointCloudBinary,
+      const CesiumGltfReader::GltfReaderOptions& options);
+};
+} // namespace Cesium3DTilesSelection
@@ -1,10 +1,12 @@
 #include "Cesium3DTilesSelection/QuadtreeRasterOverlayTileProvider.h"
 
 #include "Cesium3DTilesSelection/RasterOverlay.h"
+#include "Cesium3DTilesSelection/RasterOverlayTile.h"
 
 #include <CesiumGeometry/QuadtreeTilingScheme.h>
 #include <CesiumGltfReader/ImageManipulation.h>
 #include <CesiumUtility/Math.h>
+#include <CesiumUtility/Metrics.h>
 #include <CesiumUtility/SpanHelper.h>
 
 using namespace CesiumAsync;
@@ -20,6 +22,13 @@ namespace {
 // much" into the next pixel, we'll ignore the extra.
 constexpr double pixelTolerance = 0.01;
 
+// The bytes cached by all quadtree overlay providers together.
+MetricGauge& getCachedBytesGauge() {
+  static MetricGauge& gauge =
+      MetricsRegistry::getDefault().gauge("rasterOverlay.cachedBytes");
+  return gauge;
+}
+
 } // namespace
 
 namespace Cesium3DTilesSelection {
@@ -54,7 +63,14 @@ QuadtreeRasterOverlayTileProvider::QuadtreeRasterOverlayTileProvider(
       _tilingScheme(tilingScheme),
       _tilesOldToRecent(),
       _tileLookup(),
-      _cachedBytes(0) {}
+      _cachedBytes(0),
+      _sharedTiles(),
+      _sharedTileIDs() {}
+
+QuadtreeRasterOverlayTileProvider::
+    ~QuadtreeRasterOverlayTileProvider() noexcept {
+  getCachedBytesGauge().add(-this->_cachedBytes);
+}
 
 uint32_t QuadtreeRasterOverlayTileProvider::computeLevelFromTargetScreenPixels(
     const CesiumGeometry::Rectangle& rectangle,
@@ -95,12 +111,11 @@ uint32_t QuadtreeRasterOverlayTileProvider::computeLevelFromTargetScreenPixels(
   return imageryLevel;
 }
 
-std::vector<CesiumAsync::SharedFuture<
-    QuadtreeRasterOverlayTileProvider::LoadedQuadtreeImage>>
+std::vector<QuadtreeTileID>
 QuadtreeRasterOverlayTileProvider::mapRasterTilesToGeometryTile(
     const CesiumGeometry::Rectangle& geometryRectangle,
     const glm::dvec2 targetScreenPixels) {
-  std::vector<CesiumAsync::SharedFuture<LoadedQuadtreeImage>> result;
+  std::vector<QuadtreeTileID> result;
 
   const QuadtreeTilingScheme& imageryTilingScheme = this->getTilingScheme();
 
@@ -270,15 +285,55 @@ QuadtreeRasterOverlayTileProvider::mapRasterTilesToGeometryTile(
         continue;
       }
 
-      CesiumAsync::SharedFuture<LoadedQuadtreeImage> pTile =
-          this->getQuadtreeTile(QuadtreeTileID(level, i, j));
-      result.emplace_back(std::move(pTile));
+      result.emplace_back(level, i, j);
     }
   }
 
   return result;
 }
 
+CesiumUtility::IntrusivePointer<RasterOverlayTile>
+QuadtreeRasterOverlayTileProvider::createTile(
+    const CesiumGeometry::Rectangle& rectangle,
+    const glm::dvec2& targetScreenPixels) {
+  if (!this->getOwner().getOptions().shareQuadtreeTiles) {
+    return RasterOverlayTileProvider::createTile(rectangle, targetScreenPixels);
+  }
+
+  const std::vector<QuadtreeTileID> tileIDs =
+      this->mapRasterTilesToGeometryTile(rectangle, targetScreenPixels);
+  if (tileIDs.size() != 1) {
+    // Several quadtree tiles must be combined into one image to cover this
+    // rectangle, so that image can't be shared.
+    return RasterOverlayTileProvider::createTile(rectangle, targetScreenPixels);
+  }
+
+  const QuadtreeTileID& tileID = tileIDs.front();
+  auto sharedIt = this->_sharedTiles.find(tileID);
+  if (sharedIt != this->_sharedTiles.end()) {
+    return sharedIt->second;
+  }
+
+  IntrusivePointer<RasterOverlayTile> pTile = new RasterOverlayTile(
+      *this,
+      targetScreenPixels,
+      this->getTilingScheme().tileToRectangle(tileID));
+  this->_sharedTiles.emplace(tileID, pTile.get());
+  this->_sharedTileIDs.emplace(pTile.get(), tileID);
+  return pTile;
+}
+
+void QuadtreeRasterOverlayTileProvider::removeTile(
+    RasterOverlayTile* pTile) noexcept {
+  auto idIt = this->_sharedTileIDs.find(pTile);
+  if (idIt != this->_sharedTileIDs.end()) {
+    this->_sharedTiles.erase(idIt->second);
+    this->_sharedTileIDs.erase(idIt);
+  }
+
+  RasterOverlayTileProvider::removeTile(pTile);
+}
+
 CesiumAsync::SharedFuture<
     QuadtreeRasterOverlayTileProvider::LoadedQuadtreeImage>
 QuadtreeRasterOverlayTileProvider::getQuadtreeTile(
@@ -296,6 +351,14 @@ QuadtreeRasterOverlayTileProvider::getQuadtreeTile(
     return cacheIt->future;
   }
 
+  return this->cacheQuadtreeTile(tileID, this->loadQuadtreeTileImage(tileID));
+}
+
+CesiumAsync::SharedFuture<
+    QuadtreeRasterOverlayTileProvider::LoadedQuadtreeImage>
+QuadtreeRasterOverlayTileProvider::cacheQuadtreeTile(
+    const CesiumGeometry::QuadtreeTileID& tileID,
+    CesiumAsync::Future<LoadedRasterOverlayImage>&& loadFuture) {
   // We create this lambda here instead of where it's used below so that we
   // don't need to pass `this` through a thenImmediately lambda, which would
   // create the possibility of accidentally using this pointer to a
@@ -314,7 +377,7 @@ QuadtreeRasterOverlayTileProvider::getQuadtreeTile(
   };
 
   Future<LoadedQuadtreeImage> future =
-      this->loadQuadtreeTileImage(tileID)
+      std::move(loadFuture)
           .catchImmediately([](std::exception&& e) {
             // Turn an exception into an error.
             LoadedRasterOverlayImage result;
@@ -330,7 +393,9 @@ QuadtreeRasterOverlayTileProvider::getQuadtreeTile(
             if (loaded.image && loaded.errors.empty() &&
                 loaded.image->width > 0 && loaded.image->height > 0) {
               // Successfully loaded, continue.
-              cachedBytes += int64_t(loaded.image->pixelData.size());
+              const int64_t bytes = int64_t(loaded.image->pixelData.size());
+              cachedBytes += bytes;
+              getCachedBytesGauge().add(bytes);
 
 #if SHOW_TILE_BOUNDARIES
               // Highlight the edges in red to show tile boundaries.
@@ -377,6 +442,60 @@ QuadtreeRasterOverlayTileProvider::getQuadtreeTile(
   return result;
 }
 
+std::vector<CesiumAsync::SharedFuture<
+    QuadtreeRasterOverlayTileProvider::LoadedQuadtreeImage>>
+QuadtreeRasterOverlayTileProvider::loadQuadtreeTileBatch(
+    const std::vector<CesiumGeometry::QuadtreeTileID>& tileIDs) {
+  SharedFuture<std::shared_ptr<std::vector<LoadedRasterOverlayImage>>> batch =
+      this->loadQuadtreeTileImages(tileIDs)
+          .thenImmediately([](std::vector<LoadedRasterOverlayImage>&& images) {
+            return std::make_shared<std::vector<LoadedRasterOverlayImage>>(
+                std::move(images));
+          })
+          .share();
+
+  std::vector<SharedFuture<LoadedQuadtreeImage>> tiles;
+  tiles.reserve(tileIDs.size());
+  for (size_t i = 0; i < tileIDs.size(); ++i) {
+    // Each tile takes its own image out of the batch, so it isn't copied.
+    tiles.emplace_back(this->cacheQuadtreeTile(
+        tileIDs[i],
+        batch.thenImmediately(
+            [i](const std::shared_ptr<std::vector<LoadedRasterOverlayImage>>&
+                    pImages) -> LoadedRasterOverlayImage {
+              if (i < pImages->size()) {
+                return std::move((*pImages)[i]);
+              }
+
+              LoadedRasterOverlayImage missing;
+              missing.errors.emplace_back(
+                  "The batch of quadtree tiles did not include this tile.");
+              return missing;
+            })));
+  }
+
+  return tiles;
+}
+
+CesiumAsync::Future<std::vector<LoadedRasterOverlayImage>>
+QuadtreeRasterOverlayTileProvider::loadQuadtreeTileImages(
+    const std::vector<CesiumGeometry::QuadtreeTileID>& tileIDs) const {
+  std::vector<Future<LoadedRasterOverlayImage>> futures;
+  futures.reserve(tileIDs.size());
+  for (const QuadtreeTileID& tileID : tileIDs) {
+    futures.emplace_back(
+        this->loadQuadtreeTileImage(tileID).catchImmediately(
+            [](std::exception&& e) {
+              // Don't let one tile fail the others.
+              LoadedRasterOverlayImage result;
+              result.errors.emplace_back(e.what());
+              return result;
+            }));
+  }
+
+  return this->getAsyncSystem().all(std::move(futures));
+}
+
 namespace {
 
 PixelRectangle computePixelRectangle(
@@ -411,12 +530,13 @@ PixelRectangle computePixelRectangle(
   return PixelRectangle{x, y, maxX - x, maxY - y};
 }
 
-// Copy part of a source image to part of a target image.
+// Describes the copy of part of a source image to part of a target image.
 // The two rectangles are the extents of each image, and the part of the
 // source image where the source subset rectangle overlaps the target
-// rectangle is copied to the target image.
-void blitImage(
-    ImageCesium& target,
+// rectangle is copied to the target image. Returns std::nullopt if the two
+// do not overlap.
+std::optional<ImageBlit> computeImageBlit(
+    const ImageCesium& target,
     const Rectangle& targetRectangle,
     const ImageCesium& source,
     const Rectangle& sourceRectangle,
@@ -426,15 +546,13 @@ void blitImage(
       targetRectangle.computeIntersection(sourceToCopy);
   if (!overlap) {
     // No overlap, nothing to do.
-    return;
+    return std::nullopt;
   }
 
-  const PixelRectangle targetPixels =
-      computePixelRectangle(target, targetRectangle, *overlap);
-  const PixelRectangle sourcePixels =
-      computePixelRectangle(source, sourceRectangle, *overlap);
-
-  ImageManipulation::blitImage(target, targetPixels, source, sourcePixels);
+  return ImageBlit{
+      &source,
+      computePixelRectangle(source, sourceRectangle, *overlap),
+      computePixelRectangle(target, targetRectangle, *overlap)};
 }
 
 } // namespace
@@ -443,11 +561,46 @@ CesiumAsync::Future<LoadedRasterOverlayImage>
 QuadtreeRasterOverlayTileProvider::loadTileImage(
     RasterOverlayTile& overlayTile) {
   // Figure out which quadtree level we need, and which tiles from that level.
-  // Load each needed tile (or pull it from cache).
-  std::vector<CesiumAsync::SharedFuture<LoadedQuadtreeImage>> tiles =
-      this->mapRasterTilesToGeometryTile(
-          overlayTile.getRectangle(),
-          overlayTile.getTargetScreenPixels());
+  // A shared tile already knows the one quadtree tile it represents.
+  std::vector<QuadtreeTileID> tileIDs;
+  auto sharedIt = this->_sharedTileIDs.find(&overlayTile);
+  if (sharedIt != this->_sharedTileIDs.end()) {
+    tileIDs.emplace_back(sharedIt->second);
+  } else {
+    tileIDs = this->mapRasterTilesToGeometryTile(
+        overlayTile.getRectangle(),
+        overlayTile.getTargetScreenPixels());
+  }
+
+  // Tiles that aren't cached yet are loaded together, so that a provider that
+  // can load several tiles with one request only makes one.
+  std::vector<QuadtreeTileID> uncachedTileIDs;
+  for (const QuadtreeTileID& tileID : tileIDs) {
+    if (this->_tileLookup.find(tileID) == this->_tileLookup.end()) {
+      uncachedTileIDs.emplace_back(tileID);
+    }
+  }
+
+  std::vector<CesiumAsync::SharedFuture<LoadedQuadtreeImage>> batchTiles;
+  if (uncachedTileIDs.size() > 1) {
+    batchTiles = this->loadQuadtreeTileBatch(uncachedTileIDs);
+  }
+
+  // Load each needed tile (or pull it from cache). The tiles of the batch
+  // use its futures directly, because caching the later tiles of the batch
+  // may already have evicted the earlier ones from the cache.
+  std::vector<CesiumAsync::SharedFuture<LoadedQuadtreeImage>> tiles;
+  tiles.reserve(tileIDs.size());
+  size_t batchIndex = 0;
+  for (const QuadtreeTileID& tileID : tileIDs) {
+    if (batchIndex < batchTiles.size() &&
+        uncachedTileIDs[batchIndex] == tileID) {
+      tiles.emplace_back(std::move(batchTiles[batchIndex]));
+      ++batchIndex;
+    } else {
+      tiles.emplace_back(this->getQuadtreeTile(tileID));
+    }
+  }
 
   return this->getAsyncSystem()
       .all(std::move(tiles))
@@ -517,8 +670,10 @@ void QuadtreeRasterOverlayTileProvider::unloadCachedTiles() {
     // pointer goes out of scope, so reduce the cachedBytes accordingly.
     if (pImage.use_count() == 1) {
       if (pImage->image) {
-        this->_cachedBytes -= int64_t(pImage->image->pixelData.size());
+        const int64_t bytes = int64_t(pImage->image->pixelData.size());
+        this->_cachedBytes -= bytes;
         assert(this->_cachedBytes >= 0);
+        getCachedBytesGauge().add(-bytes);
       }
     }
   }
@@ -677,6 +832,8 @@ QuadtreeRasterOverlayTileProvider::combineImages(
   target.pixelData.resize(size_t(
       target.width * target.height * target.channels * target.bytesPerChannel));
 
+  std::vector<ImageBlit> blits;
+  blits.reserve(images.size());
   for (auto it = images.begin(); it != images.end(); ++it) {
     const LoadedRasterOverlayImage& loaded = *it->pLoaded;
     if (!loaded.image) {
@@ -685,14 +842,19 @@ QuadtreeRasterOverlayTileProvider::combineImages(
 
     result.moreDetailAvailable |= loaded.moreDetailAvailable;
 
-    blitImage(
+    std::optional<ImageBlit> maybeBlit = computeImageBlit(
         target,
         result.rectangle,
         *loaded.image,
         loaded.rectangle,
         it->subset);
+    if (maybeBlit) {
+      blits.emplace_back(*maybeBlit);
+    }
   }
 
+  ImageManipulation::blitImages(target, blits);
+
   size_t combinedCreditsCount = 0;
   for (auto it = images.begin(); it != images.end(); ++it) {
     const LoadedRasterOverlayImage& loaded = *it->pLoaded;
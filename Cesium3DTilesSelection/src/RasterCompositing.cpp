@@ -0,0 +1,160 @@
+#include "RasterCompositing.h"
+
+#include "RasterReprojection.h"
+
+#include <CesiumUtility/Tracing.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace CesiumGeometry;
+using namespace CesiumGeospatial;
+using namespace CesiumGltf;
+
+namespace Cesium3DTilesSelection {
+
+namespace {
+// The range of target pixels, along one axis, whose centers lie within the
+// given range of source coordinates, where pixel coordinates increase with
+// the coordinate.
+struct PixelRange {
+  int32_t first;
+  int32_t last;
+};
+
+PixelRange computePixelRange(
+    double sourceFirst,
+    double sourceLast,
+    double targetPixelSize,
+    int32_t targetSize) noexcept {
+  // Pixel centers are halfway between integer pixel coordinates.
+  const double first = std::ceil(sourceFirst / targetPixelSize - 0.5);
+  const double last = std::floor(sourceLast / targetPixelSize - 0.5);
+  return PixelRange{
+      int32_t(std::max(first, 0.0)),
+      int32_t(std::min(last, double(targetSize - 1)))};
+}
+
+float blendChannel(
+    RasterOverlayBlendMode blendMode,
+    float target,
+    float source) noexcept {
+  switch (blendMode) {
+  case RasterOverlayBlendMode::Multiply:
+    return target * source;
+  case RasterOverlayBlendMode::Screen:
+    return target + source - target * source;
+  case RasterOverlayBlendMode::Normal:
+  default:
+    return source;
+  }
+}
+} // namespace
+
+bool blendImage(
+    ImageCesium& target,
+    const Rectangle& targetRectangle,
+    const ImageCesium& source,
+    const Rectangle& sourceRectangle,
+    const Projection& projection,
+    RasterOverlayBlendMode blendMode,
+    float opacity) {
+  CESIUM_TRACE("blendImage");
+
+  if (target.compressedPixelFormat != GpuCompressedPixelFormat::NONE ||
+      target.channels != 4 || target.bytesPerChannel != 1 ||
+      target.width <= 0 || target.height <= 0 ||
+      target.pixelData.size() <
+          size_t(target.width) * size_t(target.height) * 4 ||
+      source.channels > 4) {
+    return false;
+  }
+
+  const double pixelWidth = targetRectangle.computeWidth() / target.width;
+  const double pixelHeight = targetRectangle.computeHeight() / target.height;
+  const PixelRange columns = computePixelRange(
+      sourceRectangle.minimumX - targetRectangle.minimumX,
+      sourceRectangle.maximumX - targetRectangle.minimumX,
+      pixelWidth,
+      target.width);
+
+  // Rows are stored from the top down.
+  const PixelRange rows = computePixelRange(
+      targetRectangle.maximumY - sourceRectangle.maximumY,
+      targetRectangle.maximumY - sourceRectangle.minimumY,
+      pixelHeight,
+      target.height);
+
+  if (columns.first > columns.last || rows.first > rows.last) {
+    return true;
+  }
+
+  // Resample the source image to the covered target pixels.
+  const int32_t width = columns.last - columns.first + 1;
+  const int32_t height = rows.last - rows.first + 1;
+  const Rectangle coveredRectangle(
+      targetRectangle.minimumX + columns.first * pixelWidth,
+      targetRectangle.maximumY - (rows.last + 1) * pixelHeight,
+      targetRectangle.minimumX + (columns.last + 1) * pixelWidth,
+      targetRectangle.maximumY - rows.first * pixelHeight);
+  std::optional<ImageCesium> maybeResampled = reprojectImage(
+      source,
+      projection,
+      sourceRectangle,
+      projection,
+      coveredRectangle,
+      width,
+      height);
+  if (!maybeResampled) {
+    return false;
+  }
+
+  const size_t channels = size_t(maybeResampled->channels);
+  const bool hasAlpha = channels == 2 || channels == 4;
+  const bool isLuminance = channels <= 2;
+  const uint8_t* pSource =
+      reinterpret_cast<const uint8_t*>(maybeResampled->pixelData.data());
+  uint8_t* pTarget = reinterpret_cast<uint8_t*>(target.pixelData.data());
+  const float alphaScale = std::clamp(opacity, 0.0f, 1.0f) / 255.0f;
+
+  for (size_t j = 0; j < size_t(height); ++j) {
+    const size_t targetRow = size_t(rows.first) + j;
+    const size_t targetColumn = size_t(columns.first);
+    uint8_t* pTargetRow =
+        pTarget + (targetRow * size_t(target.width) + targetColumn) * 4;
+    for (size_t i = 0; i < size_t(width); ++i) {
+      const uint8_t* pSourcePixel =
+          pSource + (j * size_t(width) + i) * channels;
+      uint8_t* pTargetPixel = pTargetRow + i * 4;
+
+      const float sourceAlpha =
+          float(hasAlpha ? pSourcePixel[channels - 1] : 255) * alphaScale;
+      if (sourceAlpha <= 0.0f) {
+        continue;
+      }
+
+      // Blend the colors where both are present, then composite the result
+      // over the target with straight (not premultiplied) alpha.
+      const float targetAlpha = float(pTargetPixel[3]) / 255.0f;
+      const float alpha = sourceAlpha + targetAlpha * (1.0f - sourceAlpha);
+      const float targetWeight = targetAlpha * (1.0f - sourceAlpha) / alpha;
+      const float sourceWeight = sourceAlpha / alpha;
+      for (size_t c = 0; c < 3; ++c) {
+        const float sourceColor =
+            float(pSourcePixel[isLuminance ? 0 : c]) / 255.0f;
+        const float targetColor = float(pTargetPixel[c]) / 255.0f;
+        const float blended =
+            (1.0f - targetAlpha) * sourceColor +
+            targetAlpha * blendChannel(blendMode, targetColor, sourceColor);
+        const float color =
+            sourceWeight * blended + targetWeight * targetColor;
+        pTargetPixel[c] = uint8_t(std::lround(color * 255.0f));
+      }
+      pTargetPixel[3] = uint8_t(std::lround(alpha * 255.0f));
+    }
+  }
+
+  return true;
+}
+
+} // namespace Cesium3DTilesSelection
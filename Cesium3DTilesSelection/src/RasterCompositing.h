@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Cesium3DTilesSelection/CompositeRasterOverlay.h>
+#include <CesiumGeometry/Rectangle.h>
+#include <CesiumGeospatial/Projection.h>
+#include <CesiumGltf/ImageCesium.h>
+
+namespace Cesium3DTilesSelection {
+
+/**
+ * @brief Blends an image over the part of another image that it covers.
+ *
+ * Both images are in the same projection. The source image is resampled with
+ * bilinear filtering to the pixels of the target image whose centers lie
+ * within the source rectangle, and those pixels are blended with the source
+ * pixels using the given mode. Other target pixels are not changed.
+ *
+ * Source images with one or two channels are treated as luminance and
+ * luminance-alpha images. Images with one or three channels are opaque.
+ *
+ * @param target The image to blend onto, which must be uncompressed and have
+ * four channels of one byte each.
+ * @param targetRectangle The rectangle covered by the target image, from the
+ * outer edges of its outermost pixels.
+ * @param source The image to blend, which must be uncompressed and have one to
+ * four channels of one byte each.
+ * @param sourceRectangle The rectangle covered by the source image, from the
+ * outer edges of its outermost pixels.
+ * @param projection The projection of both rectangles.
+ * @param blendMode How the source colors are combined with the target colors.
+ * @param opacity The factor by which the alpha of the source image is
+ * multiplied.
+ * @return True if the image was blended, or false if either image is not
+ * supported.
+ */
+bool blendImage(
+    CesiumGltf::ImageCesium& target,
+    const CesiumGeometry::Rectangle& targetRectangle,
+    const CesiumGltf::ImageCesium& source,
+    const CesiumGeometry::Rectangle& sourceRectangle,
+    const CesiumGeospatial::Projection& projection,
+    RasterOverlayBlendMode blendMode,
+    float opacity);
+
+} // namespace Cesium3DTilesSelection
@@ -0,0 +1,590 @@
+#include "RasterCompression.h"
+
+#include <CesiumUtility/Tracing.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+using namespace CesiumGltf;
+
+namespace Cesium3DTilesSelection {
+
+namespace {
+// The RGBA pixels of a 4x4 block, row by row.
+using Block = std::array<std::array<int32_t, 4>, 16>;
+
+void readBlock(
+    const uint8_t* pPixels,
+    int32_t width,
+    int32_t height,
+    size_t channels,
+    int32_t blockX,
+    int32_t blockY,
+    Block& block) noexcept {
+  for (int32_t y = 0; y < 4; ++y) {
+    const int32_t sourceY = std::min(blockY * 4 + y, height - 1);
+    for (int32_t x = 0; x < 4; ++x) {
+      const int32_t sourceX = std::min(blockX * 4 + x, width - 1);
+      const uint8_t* pPixel =
+          pPixels +
+          (size_t(sourceY) * size_t(width) + size_t(sourceX)) * channels;
+      std::array<int32_t, 4>& pixel = block[size_t(y * 4 + x)];
+      pixel[0] = pPixel[0];
+      pixel[1] = pPixel[1];
+      pixel[2] = pPixel[2];
+      pixel[3] = channels > 3 ? pPixel[3] : 255;
+    }
+  }
+}
+
+int32_t squaredDistance(
+    const std::array<int32_t, 4>& pixel,
+    const std::array<int32_t, 3>& color) noexcept {
+  const int32_t r = pixel[0] - color[0];
+  const int32_t g = pixel[1] - color[1];
+  const int32_t b = pixel[2] - color[2];
+  return r * r + g * g + b * b;
+}
+
+uint16_t packRgb565(const std::array<int32_t, 4>& pixel) noexcept {
+  const uint32_t r = uint32_t(pixel[0] * 31 + 127) / 255;
+  const uint32_t g = uint32_t(pixel[1] * 63 + 127) / 255;
+  const uint32_t b = uint32_t(pixel[2] * 31 + 127) / 255;
+  return uint16_t((r << 11) | (g << 5) | b);
+}
+
+std::array<int32_t, 3> unpackRgb565(uint16_t color) noexcept {
+  const int32_t r = (color >> 11) & 31;
+  const int32_t g = (color >> 5) & 63;
+  const int32_t b = color & 31;
+  return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+// Writes a BC1 color block. The block is always in four-color mode, so it is
+// also a valid BC3 color block.
+void encodeBc1Colors(const Block& block, std::byte* pOut) noexcept {
+  std::array<double, 3> mean{};
+  for (const std::array<int32_t, 4>& pixel : block) {
+    for (size_t c = 0; c < 3; ++c) {
+      mean[c] += pixel[c];
+    }
+  }
+  for (double& component : mean) {
+    component /= 16.0;
+  }
+
+  std::array<std::array<double, 3>, 3> covariance{};
+  for (const std::array<int32_t, 4>& pixel : block) {
+    const std::array<double, 3> d{
+        pixel[0] - mean[0],
+        pixel[1] - mean[1],
+        pixel[2] - mean[2]};
+    for (size_t i = 0; i < 3; ++i) {
+      for (size_t j = 0; j < 3; ++j) {
+        covariance[i][j] += d[i] * d[j];
+      }
+    }
+  }
+
+  // A few power iterations approximate the principal axis of the colors.
+  std::array<double, 3> axis{1.0, 1.0, 1.0};
+  for (int32_t iteration = 0; iteration < 4; ++iteration) {
+    std::array<double, 3> next{};
+    for (size_t i = 0; i < 3; ++i) {
+      next[i] = covariance[i][0] * axis[0] + covariance[i][1] * axis[1] +
+                covariance[i][2] * axis[2];
+    }
+    const double length = std::max(
+        {std::abs(next[0]), std::abs(next[1]), std::abs(next[2])});
+    if (length == 0.0) {
+      break;
+    }
+    for (size_t i = 0; i < 3; ++i) {
+      axis[i] = next[i] / length;
+    }
+  }
+
+  // The pixels farthest apart along the axis are the endpoints.
+  size_t minimumIndex = 0;
+  size_t maximumIndex = 0;
+  double minimum = std::numeric_limits<double>::max();
+  double maximum = std::numeric_limits<double>::lowest();
+  for (size_t i = 0; i < block.size(); ++i) {
+    const double projected = block[i][0] * axis[0] + block[i][1] * axis[1] +
+                             block[i][2] * axis[2];
+    if (projected < minimum) {
+      minimum = projected;
+      minimumIndex = i;
+    }
+    if (projected > maximum) {
+      maximum = projected;
+      maximumIndex = i;
+    }
+  }
+
+  uint16_t color0 = packRgb565(block[maximumIndex]);
+  uint16_t color1 = packRgb565(block[minimumIndex]);
+  if (color0 < color1) {
+    std::swap(color0, color1);
+  }
+
+  uint32_t indices = 0;
+  if (color0 != color1) {
+    const std::array<int32_t, 3> endpoint0 = unpackRgb565(color0);
+    const std::array<int32_t, 3> endpoint1 = unpackRgb565(color1);
+    std::array<std::array<int32_t, 3>, 4> palette{endpoint0, endpoint1};
+    for (size_t c = 0; c < 3; ++c) {
+      palette[2][c] = (2 * endpoint0[c] + endpoint1[c]) / 3;
+      palette[3][c] = (endpoint0[c] + 2 * endpoint1[c]) / 3;
+    }
+
+    for (size_t i = 0; i < block.size(); ++i) {
+      uint32_t bestIndex = 0;
+      int32_t bestError = std::numeric_limits<int32_t>::max();
+      for (uint32_t index = 0; index < 4; ++index) {
+        const int32_t error = squaredDistance(block[i], palette[index]);
+        if (error < bestError) {
+          bestError = error;
+          bestIndex = index;
+        }
+      }
+      indices |= bestIndex << (2 * i);
+    }
+  }
+
+  pOut[0] = std::byte(color0 & 0xff);
+  pOut[1] = std::byte(color0 >> 8);
+  pOut[2] = std::byte(color1 & 0xff);
+  pOut[3] = std::byte(color1 >> 8);
+  for (size_t i = 0; i < 4; ++i) {
+    pOut[4 + i] = std::byte((indices >> (8 * i)) & 0xff);
+  }
+}
+
+// Writes a BC3 alpha block using the eight-value mode.
+void encodeBc3Alpha(const Block& block, std::byte* pOut) noexcept {
+  int32_t minimum = 255;
+  int32_t maximum = 0;
+  for (const std::array<int32_t, 4>& pixel : block) {
+    minimum = std::min(minimum, pixel[3]);
+    maximum = std::max(maximum, pixel[3]);
+  }
+
+  uint64_t indices = 0;
+  if (maximum != minimum) {
+    const int32_t range = maximum - minimum;
+    for (size_t i = 0; i < block.size(); ++i) {
+      // Steps from the minimum to the maximum in sevenths.
+      const int32_t step = ((block[i][3] - minimum) * 7 + range / 2) / range;
+      uint64_t index;
+      if (step == 7) {
+        index = 0;
+      } else if (step == 0) {
+        index = 1;
+      } else {
+        index = uint64_t(8 - step);
+      }
+      indices |= index << (3 * i);
+    }
+  }
+
+  pOut[0] = std::byte(maximum);
+  pOut[1] = std::byte(minimum);
+  for (size_t i = 0; i < 6; ++i) {
+    pOut[2 + i] = std::byte((indices >> (8 * i)) & 0xff);
+  }
+}
+
+constexpr std::array<std::array<int32_t, 2>, 8> etc1Modifiers{
+    {{2, 8},
+     {5, 17},
+     {9, 29},
+     {13, 42},
+     {18, 60},
+     {24, 80},
+     {33, 106},
+     {47, 183}}};
+
+// The modifier for each ETC1 pixel index.
+int32_t getEtc1Modifier(uint32_t table, uint32_t index) noexcept {
+  const int32_t magnitude = etc1Modifiers[table][index & 1];
+  return (index & 2) ? -magnitude : magnitude;
+}
+
+bool isInSecondSubblock(size_t pixel, bool flip) noexcept {
+  return flip ? pixel >= 8 : (pixel & 3) >= 2;
+}
+
+struct Etc1Subblock {
+  std::array<int32_t, 3> baseColor;
+  uint32_t table;
+  int64_t error;
+};
+
+// Chooses the ETC1 pixel index whose modifier m has the least error for a
+// pixel. The modifier is added to every channel, so its error is, apart from a
+// term that is the same for every modifier, 3m^2 - 2mS, where S is the sum of
+// the differences between the channels of the pixel and those of the base
+// color. That is least for the modifier closest to S/3, so the large modifier
+// b is better than the small one a when 2|S| > 3(a + b).
+uint32_t chooseEtc1Index(int32_t sum, uint32_t table) noexcept {
+  const int32_t threshold =
+      3 * (etc1Modifiers[table][0] + etc1Modifiers[table][1]);
+  const uint32_t large = 2 * std::abs(sum) > threshold ? 1 : 0;
+  const uint32_t negative = sum < 0 ? 2 : 0;
+  return negative | large;
+}
+
+int32_t computeEtc1Sum(
+    const std::array<int32_t, 4>& pixel,
+    const Etc1Subblock& subblock) noexcept {
+  return pixel[0] - subblock.baseColor[0] + pixel[1] - subblock.baseColor[1] +
+         pixel[2] - subblock.baseColor[2];
+}
+
+// Finds the modifier table with the least error for the pixels of a subblock
+// around its base color.
+void chooseEtc1Table(
+    const Block& block,
+    bool flip,
+    bool second,
+    Etc1Subblock& subblock) noexcept {
+  int64_t baseError = 0;
+  std::array<int32_t, 8> sums{};
+  size_t count = 0;
+  for (size_t i = 0; i < block.size(); ++i) {
+    if (isInSecondSubblock(i, flip) != second) {
+      continue;
+    }
+    baseError += squaredDistance(block[i], subblock.baseColor);
+    sums[count++] = computeEtc1Sum(block[i], subblock);
+  }
+
+  subblock.error = std::numeric_limits<int64_t>::max();
+  for (uint32_t table = 0; table < 8; ++table) {
+    int64_t error = baseError;
+    for (const int32_t sum : sums) {
+      const int32_t modifier =
+          getEtc1Modifier(table, chooseEtc1Index(sum, table));
+      error += 3 * modifier * modifier - 2 * modifier * sum;
+    }
+    if (error < subblock.error) {
+      subblock.error = error;
+      subblock.table = table;
+    }
+  }
+}
+
+int32_t quantize(double value, int32_t maximum) noexcept {
+  return std::clamp(
+      int32_t(std::lround(value * maximum / 255.0)),
+      0,
+      maximum);
+}
+
+// Writes an ETC1 block, which is also a valid ETC2 RGB block. The
+// differential mode is only used when both base colors are in range, so the
+// block never selects one of the additional ETC2 modes.
+void encodeEtc1Colors(const Block& block, std::byte* pOut) noexcept {
+  uint64_t bestError = std::numeric_limits<uint64_t>::max();
+  std::array<uint8_t, 8> best{};
+
+  for (const bool flip : {false, true}) {
+    std::array<std::array<double, 3>, 2> averages{};
+    for (size_t i = 0; i < block.size(); ++i) {
+      std::array<double, 3>& average = averages[isInSecondSubblock(i, flip)];
+      for (size_t c = 0; c < 3; ++c) {
+        average[c] += block[i][c] / 8.0;
+      }
+    }
+
+    std::array<std::array<int32_t, 3>, 2> quantized{};
+    bool differential = true;
+    for (size_t c = 0; c < 3; ++c) {
+      quantized[0][c] = quantize(averages[0][c], 31);
+      quantized[1][c] = quantize(averages[1][c], 31);
+      const int32_t delta = quantized[1][c] - quantized[0][c];
+      differential = differential && delta >= -4 && delta <= 3;
+    }
+
+    std::array<Etc1Subblock, 2> subblocks{};
+    for (size_t s = 0; s < 2; ++s) {
+      for (size_t c = 0; c < 3; ++c) {
+        if (differential) {
+          const int32_t value = quantized[s][c];
+          subblocks[s].baseColor[c] = (value << 3) | (value >> 2);
+        } else {
+          quantized[s][c] = quantize(averages[s][c], 15);
+          subblocks[s].baseColor[c] = quantized[s][c] * 17;
+        }
+      }
+      chooseEtc1Table(block, flip, s == 1, subblocks[s]);
+    }
+
+    const uint64_t error =
+        uint64_t(subblocks[0].error) + uint64_t(subblocks[1].error);
+    if (error >= bestError) {
+      continue;
+    }
+    bestError = error;
+
+    for (size_t c = 0; c < 3; ++c) {
+      if (differential) {
+        const int32_t delta = quantized[1][c] - quantized[0][c];
+        best[c] = uint8_t((quantized[0][c] << 3) | (delta & 7));
+      } else {
+        best[c] = uint8_t((quantized[0][c] << 4) | quantized[1][c]);
+      }
+    }
+    best[3] = uint8_t(
+        (subblocks[0].table << 5) | (subblocks[1].table << 2) |
+        (uint32_t(differential) << 1) | uint32_t(flip));
+
+    // Pixels are numbered down each column, and the most significant bits of
+    // their indices come first.
+    uint32_t mostSignificant = 0;
+    uint32_t leastSignificant = 0;
+    for (size_t i = 0; i < block.size(); ++i) {
+      const Etc1Subblock& subblock = subblocks[isInSecondSubblock(i, flip)];
+      const uint32_t index =
+          chooseEtc1Index(computeEtc1Sum(block[i], subblock), subblock.table);
+      const uint32_t bit = uint32_t((i & 3) * 4 + (i >> 2));
+      mostSignificant |= (index >> 1) << bit;
+      leastSignificant |= (index & 1) << bit;
+    }
+    const uint32_t indices = (mostSignificant << 16) | leastSignificant;
+    for (size_t i = 0; i < 4; ++i) {
+      best[4 + i] = uint8_t(indices >> (24 - 8 * i));
+    }
+  }
+
+  for (size_t i = 0; i < best.size(); ++i) {
+    pOut[i] = std::byte(best[i]);
+  }
+}
+
+constexpr std::array<std::array<int32_t, 8>, 16> eacModifiers{
+    {{-3, -6, -9, -15, 2, 5, 8, 14},
+     {-3, -7, -10, -13, 2, 6, 9, 12},
+     {-2, -5, -8, -13, 1, 4, 7, 12},
+     {-2, -4, -6, -13, 1, 3, 5, 12},
+     {-3, -6, -8, -12, 2, 5, 7, 11},
+     {-3, -7, -9, -11, 2, 6, 8, 10},
+     {-4, -7, -8, -11, 3, 6, 7, 10},
+     {-3, -5, -8, -11, 2, 4, 7, 10},
+     {-2, -6, -8, -10, 1, 5, 7, 9},
+     {-2, -5, -8, -10, 1, 4, 7, 9},
+     {-2, -4, -8, -10, 1, 3, 7, 9},
+     {-2, -5, -7, -10, 1, 4, 6, 9},
+     {-3, -4, -7, -10, 2, 3, 6, 9},
+     {-1, -2, -3, -10, 0, 1, 2, 9},
+     {-4, -6, -8, -9, 3, 5, 7, 8},
+     {-3, -5, -7, -9, 2, 4, 6, 8}}};
+
+// Writes an ETC2 EAC alpha block.
+void encodeEacAlpha(const Block& block, std::byte* pOut) noexcept {
+  int32_t minimum = 255;
+  int32_t maximum = 0;
+  for (const std::array<int32_t, 4>& pixel : block) {
+    minimum = std::min(minimum, pixel[3]);
+    maximum = std::max(maximum, pixel[3]);
+  }
+
+  // A uniform alpha uses the table that has a zero modifier.
+  int32_t bestBase = minimum;
+  int32_t bestMultiplier = 1;
+  uint32_t bestTable = 13;
+  uint64_t bestIndices = 0;
+  if (minimum == maximum) {
+    for (size_t i = 0; i < block.size(); ++i) {
+      bestIndices |= uint64_t(4) << (45 - 3 * ((i & 3) * 4 + (i >> 2)));
+    }
+  } else {
+    int64_t bestError = std::numeric_limits<int64_t>::max();
+    for (uint32_t table = 0; table < eacModifiers.size(); ++table) {
+      const std::array<int32_t, 8>& modifiers = eacModifiers[table];
+      const int32_t span = modifiers[7] - modifiers[3];
+      const int32_t multiplier =
+          std::clamp((maximum - minimum + span / 2) / span, 1, 15);
+      const int32_t base = std::clamp(
+          (maximum + minimum - multiplier * (modifiers[7] + modifiers[3])) / 2,
+          0,
+          255);
+
+      int64_t error = 0;
+      uint64_t indices = 0;
+      for (size_t i = 0; i < block.size(); ++i) {
+        uint32_t bestIndex = 0;
+        int32_t bestPixelError = std::numeric_limits<int32_t>::max();
+        for (uint32_t index = 0; index < 8; ++index) {
+          const int32_t value =
+              std::clamp(base + modifiers[index] * multiplier, 0, 255);
+          const int32_t difference = value - block[i][3];
+          if (difference * difference < bestPixelError) {
+            bestPixelError = difference * difference;
+            bestIndex = index;
+          }
+        }
+        error += bestPixelError;
+        indices |= uint64_t(bestIndex) << (45 - 3 * ((i & 3) * 4 + (i >> 2)));
+      }
+
+      if (error < bestError) {
+        bestError = error;
+        bestBase = base;
+        bestMultiplier = multiplier;
+        bestTable = table;
+        bestIndices = indices;
+      }
+    }
+  }
+
+  pOut[0] = std::byte(bestBase);
+  pOut[1] = std::byte((uint32_t(bestMultiplier) << 4) | bestTable);
+  for (size_t i = 0; i < 6; ++i) {
+    pOut[2 + i] = std::byte((bestIndices >> (40 - 8 * i)) & 0xff);
+  }
+}
+
+size_t getBlockBytes(GpuCompressedPixelFormat format) noexcept {
+  switch (format) {
+  case GpuCompressedPixelFormat::BC1_RGB:
+  case GpuCompressedPixelFormat::ETC1_RGB:
+    return 8;
+  case GpuCompressedPixelFormat::BC3_RGBA:
+  case GpuCompressedPixelFormat::ETC2_RGBA:
+    return 16;
+  default:
+    return 0;
+  }
+}
+
+void encodeBlock(
+    GpuCompressedPixelFormat format,
+    const Block& block,
+    std::byte* pOut) noexcept {
+  switch (format) {
+  case GpuCompressedPixelFormat::BC1_RGB:
+    encodeBc1Colors(block, pOut);
+    break;
+  case GpuCompressedPixelFormat::BC3_RGBA:
+    encodeBc3Alpha(block, pOut);
+    encodeBc1Colors(block, pOut + 8);
+    break;
+  case GpuCompressedPixelFormat::ETC1_RGB:
+    encodeEtc1Colors(block, pOut);
+    break;
+  case GpuCompressedPixelFormat::ETC2_RGBA:
+    encodeEacAlpha(block, pOut);
+    encodeEtc1Colors(block, pOut + 8);
+    break;
+  default:
+    break;
+  }
+}
+} // namespace
+
+GpuCompressedPixelFormat selectCompressedPixelFormat(
+    const ImageCesium& image,
+    const Ktx2TranscodeTargets& targets) {
+  bool opaque = true;
+  if (image.channels > 3) {
+    const size_t channels = size_t(image.channels);
+    const size_t bytes = image.mipPositions.empty()
+                             ? image.pixelData.size()
+                             : image.mipPositions[0].byteSize;
+    for (size_t i = 3; opaque && i < bytes; i += channels) {
+      opaque = image.pixelData[i] == std::byte(255);
+    }
+  }
+
+  const GpuCompressedPixelFormat target =
+      opaque ? targets.ETC1S_RGB : targets.ETC1S_RGBA;
+  switch (target) {
+  case GpuCompressedPixelFormat::BC1_RGB:
+  case GpuCompressedPixelFormat::BC3_RGBA:
+  case GpuCompressedPixelFormat::ETC1_RGB:
+  case GpuCompressedPixelFormat::ETC2_RGBA:
+    return target;
+  case GpuCompressedPixelFormat::BC7_RGBA:
+    return opaque ? GpuCompressedPixelFormat::BC1_RGB
+                  : GpuCompressedPixelFormat::BC3_RGBA;
+  default:
+    return GpuCompressedPixelFormat::NONE;
+  }
+}
+
+std::optional<ImageCesium>
+compressImage(const ImageCesium& image, GpuCompressedPixelFormat format) {
+  const size_t blockBytes = getBlockBytes(format);
+  if (blockBytes == 0 ||
+      image.compressedPixelFormat != GpuCompressedPixelFormat::NONE ||
+      image.bytesPerChannel != 1 || image.channels < 3 ||
+      image.channels > 4 || image.width <= 0 || image.height <= 0) {
+    return std::nullopt;
+  }
+
+  CESIUM_TRACE(
+      "compress image " + std::to_string(image.width) + "x" +
+      std::to_string(image.height));
+
+  const size_t channels = size_t(image.channels);
+  std::vector<ImageCesiumMipPosition> sourceMips = image.mipPositions;
+  if (sourceMips.empty()) {
+    sourceMips.push_back(
+        {0,
+         size_t(image.width) * size_t(image.height) * channels});
+  }
+
+  ImageCesium result;
+  result.width = image.width;
+  result.height = image.height;
+  result.channels = image.channels;
+  result.bytesPerChannel = image.bytesPerChannel;
+  result.compressedPixelFormat = format;
+
+  size_t totalBytes = 0;
+  for (size_t level = 0; level < sourceMips.size(); ++level) {
+    const size_t blocksX = (size_t(std::max(image.width >> level, 1)) + 3) / 4;
+    const size_t blocksY =
+        (size_t(std::max(image.height >> level, 1)) + 3) / 4;
+    result.mipPositions.push_back(
+        {totalBytes, blocksX * blocksY * blockBytes});
+    totalBytes += blocksX * blocksY * blockBytes;
+  }
+  result.pixelData.resize(totalBytes);
+
+  Block block;
+  for (size_t level = 0; level < sourceMips.size(); ++level) {
+    const int32_t width = std::max(image.width >> level, 1);
+    const int32_t height = std::max(image.height >> level, 1);
+    const ImageCesiumMipPosition& source = sourceMips[level];
+    if (source.byteOffset + size_t(width) * size_t(height) * channels >
+        image.pixelData.size()) {
+      return std::nullopt;
+    }
+
+    const uint8_t* pPixels =
+        reinterpret_cast<const uint8_t*>(image.pixelData.data()) +
+        source.byteOffset;
+    std::byte* pOut =
+        result.pixelData.data() + result.mipPositions[level].byteOffset;
+    const int32_t blocksX = (width + 3) / 4;
+    const int32_t blocksY = (height + 3) / 4;
+    for (int32_t blockY = 0; blockY < blocksY; ++blockY) {
+      for (int32_t blockX = 0; blockX < blocksX; ++blockX) {
+        readBlock(pPixels, width, height, channels, blockX, blockY, block);
+        encodeBlock(format, block, pOut);
+        pOut += blockBytes;
+      }
+    }
+  }
+
+  return result;
+}
+
+} // namespace Cesium3DTilesSelection
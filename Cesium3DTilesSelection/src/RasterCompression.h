@@ -0,0 +1,56 @@
+#pragma once
+
+#include <CesiumGltf/ImageCesium.h>
+#include <CesiumGltf/Ktx2TranscodeTargets.h>
+
+#include <optional>
+
+namespace Cesium3DTilesSelection {
+
+/**
+ * @brief Selects the GPU compressed pixel format to compress a raster overlay
+ * image into.
+ *
+ * The format is the one that `targets` selects for ETC1S textures, which are
+ * a lossy, general-purpose transmission format like most raster overlay
+ * images: `Ktx2TranscodeTargets::ETC1S_RGB` for images that are entirely
+ * opaque, and `Ktx2TranscodeTargets::ETC1S_RGBA` for others. Only the formats
+ * that {@link compressImage} can produce are returned. Clients that support
+ * `BC7_RGBA` also support `BC1_RGB` and `BC3_RGBA`, so those are returned in
+ * its place.
+ *
+ * @param image The uncompressed image.
+ * @param targets The transcode targets negotiated with the client.
+ * @return The format, or `GpuCompressedPixelFormat::NONE` if the image should
+ * not be compressed.
+ */
+CesiumGltf::GpuCompressedPixelFormat selectCompressedPixelFormat(
+    const CesiumGltf::ImageCesium& image,
+    const CesiumGltf::Ktx2TranscodeTargets& targets);
+
+/**
+ * @brief Compresses an image into a GPU block-compressed pixel format.
+ *
+ * This is a fast encoder meant to be used on worker threads while tiles load.
+ * Each 4x4 block is encoded independently: BC1 and BC3 colors use the
+ * endpoints found along the principal axis of the block's colors, ETC1
+ * chooses the subblock orientation and modifier tables with the least error
+ * around each subblock's average color, and the alpha of BC3 and ETC2 is
+ * fitted to the alpha range of the block. Blocks that extend past the edge of
+ * the image repeat its edge pixels.
+ *
+ * Every mip level listed in `image.mipPositions` is compressed, so mip levels
+ * should be generated before compressing.
+ *
+ * @param image The image, which must be uncompressed and have three or four
+ * channels of one byte each.
+ * @param format The format to compress into, which must be `BC1_RGB`,
+ * `BC3_RGBA`, `ETC1_RGB`, or `ETC2_RGBA`.
+ * @return The compressed image, or `std::nullopt` if the image or format is
+ * not supported.
+ */
+std::optional<CesiumGltf::ImageCesium> compressImage(
+    const CesiumGltf::ImageCesium& image,
+    CesiumGltf::GpuCompressedPixelFormat format);
+
+} // namespace Cesium3DTilesSelection
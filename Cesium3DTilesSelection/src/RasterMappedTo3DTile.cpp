@@ -220,6 +220,16 @@ bool RasterMappedTo3DTile::loadThrottled() noexcept {
   return provider.loadTileThrottled(*pLoading);
 }
 
+void RasterMappedTo3DTile::queueLoad(double priority) {
+  RasterOverlayTile* pLoading = this->getLoadingTile();
+  if (!pLoading) {
+    return;
+  }
+
+  RasterOverlayTileProvider& provider = pLoading->getTileProvider();
+  provider.queueTileLoad(*pLoading, priority);
+}
+
 namespace {
 
 IntrusivePointer<RasterOverlayTile>
@@ -331,7 +341,7 @@ RasterMappedTo3DTile* addRealTile(
   // width/height as if it's on the ellipsoid surface.
   const double heightForSizeEstimation = 0.0;
 
-  const Projection& projection = tileProvider.getProjection();
+  const Projection& projection = tileProvider.getTileProjection();
 
   // If the tile is loaded, use the precise rectangle computed from the content.
   const TileContent& content = tile.getContent();
@@ -355,8 +365,8 @@ RasterMappedTo3DTile* addRealTile(
       return addRealTile(tile, tileProvider, *pRectangle, screenPixels, index);
     } else {
       // We don't have a precise rectangle for this projection, which means the
-      // tile was loaded before we knew we needed this projection. We'll need to
-      // reload the tile (later).
+      // tile was loaded before we knew we needed this projection. The texture
+      // coordinates will be added to the tile (later).
       int32_t existingIndex =
           int32_t(overlayDetails.rasterOverlayProjections.size());
       int32_t textureCoordinateIndex =
@@ -372,7 +382,7 @@ RasterMappedTo3DTile* addRealTile(
       addProjectionToList(missingProjections, projection);
   std::optional<Rectangle> maybeRectangle =
       getPreciseRectangleFromBoundingVolume(
-          tileProvider.getProjection(),
+          tileProvider.getTileProjection(),
           tile.getBoundingVolume());
   if (maybeRectangle) {
     const glm::dvec2 screenPixels = computeDesiredScreenPixels(
@@ -414,7 +424,7 @@ void RasterMappedTo3DTile::computeTranslationAndScale(const Tile& tile) {
   const RasterOverlayTileProvider& tileProvider =
       this->_pReadyTile->getTileProvider();
 
-  const Projection& projection = tileProvider.getProjection();
+  const Projection& projection = tileProvider.getTileProjection();
   const std::vector<Projection>& projections =
       overlayDetails.rasterOverlayProjections;
   const std::vector<Rectangle>& rectangles =
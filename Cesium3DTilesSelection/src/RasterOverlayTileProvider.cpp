@@ -1,5 +1,8 @@
 #include "Cesium3DTilesSelection/RasterOverlayTileProvider.h"
 
+#include "RasterCompression.h"
+#include "RasterReprojection.h"
+
 #include "Cesium3DTilesSelection/IPrepareRendererResources.h"
 #include "Cesium3DTilesSelection/RasterOverlay.h"
 #include "Cesium3DTilesSelection/RasterOverlayTile.h"
@@ -12,6 +15,8 @@
 #include <CesiumUtility/Tracing.h>
 #include <CesiumUtility/joinToString.h>
 
+#include <algorithm>
+
 using namespace CesiumAsync;
 using namespace CesiumGeometry;
 using namespace CesiumGeospatial;
@@ -37,10 +42,14 @@ RasterOverlayTileProvider::RasterOverlayTileProvider(
       _projection(CesiumGeospatial::GeographicProjection()),
       _coverageRectangle(CesiumGeospatial::GeographicProjection::
                              computeMaximumProjectedRectangle()),
+      _reprojection(),
+      _tileCoverageRectangle(_coverageRectangle),
+      _pReprojectedImages(nullptr),
       _pPlaceholder(),
       _tileDataBytes(0),
       _totalTilesCurrentlyLoading(0),
-      _throttledTilesCurrentlyLoading(0) {
+      _throttledTilesCurrentlyLoading(0),
+      _tileLoadQueue() {
   this->_pPlaceholder = new RasterOverlayTile(*this);
 }
 
@@ -61,10 +70,25 @@ RasterOverlayTileProvider::RasterOverlayTileProvider(
       _pLogger(pLogger),
       _projection(projection),
       _coverageRectangle(coverageRectangle),
+      _reprojection(),
+      _tileCoverageRectangle(coverageRectangle),
+      _pReprojectedImages(nullptr),
       _pPlaceholder(nullptr),
       _tileDataBytes(0),
       _totalTilesCurrentlyLoading(0),
-      _throttledTilesCurrentlyLoading(0) {}
+      _throttledTilesCurrentlyLoading(0),
+      _tileLoadQueue() {
+  const std::optional<RasterOverlayReprojectionOptions>& reprojection =
+      this->_pOwner->getOptions().reprojection;
+  if (reprojection && !(reprojection->projection == projection)) {
+    this->_reprojection = reprojection;
+    this->_tileCoverageRectangle = projectRectangleSimple(
+        reprojection->projection,
+        unprojectRectangleSimple(projection, coverageRectangle));
+    this->_pReprojectedImages =
+        std::make_shared<ReprojectedImageCache>(reprojection->cacheBytes);
+  }
+}
 
 RasterOverlayTileProvider::~RasterOverlayTileProvider() noexcept {
   // Explicitly release the placeholder first, because RasterOverlayTiles must
@@ -75,6 +99,12 @@ RasterOverlayTileProvider::~RasterOverlayTileProvider() noexcept {
   }
 }
 
+const CesiumGeospatial::Projection&
+RasterOverlayTileProvider::getTileProjection() const noexcept {
+  return this->_reprojection ? this->_reprojection->projection
+                             : this->_projection;
+}
+
 CesiumUtility::IntrusivePointer<RasterOverlayTile>
 RasterOverlayTileProvider::getTile(
     const CesiumGeometry::Rectangle& rectangle,
@@ -83,10 +113,23 @@ RasterOverlayTileProvider::getTile(
     return this->_pPlaceholder;
   }
 
-  if (!rectangle.overlaps(this->_coverageRectangle)) {
+  if (!rectangle.overlaps(this->_tileCoverageRectangle)) {
     return nullptr;
   }
 
+  if (this->_reprojection) {
+    // Derived classes expect tiles in their own projection, so they can't
+    // provide these.
+    return new RasterOverlayTile(*this, targetScreenPixels, rectangle);
+  }
+
+  return this->createTile(rectangle, targetScreenPixels);
+}
+
+CesiumUtility::IntrusivePointer<RasterOverlayTile>
+RasterOverlayTileProvider::createTile(
+    const CesiumGeometry::Rectangle& rectangle,
+    const glm::dvec2& targetScreenPixels) {
   return new RasterOverlayTile(*this, targetScreenPixels, rectangle);
 }
 
@@ -119,6 +162,33 @@ bool RasterOverlayTileProvider::loadTileThrottled(RasterOverlayTile& tile) {
   return true;
 }
 
+void RasterOverlayTileProvider::queueTileLoad(
+    RasterOverlayTile& tile,
+    double priority) {
+  if (this->_pPlaceholder ||
+      tile.getState() != RasterOverlayTile::LoadState::Unloaded) {
+    return;
+  }
+
+  this->_tileLoadQueue.push_back({&tile, priority});
+}
+
+void RasterOverlayTileProvider::processTileLoadQueue() {
+  CESIUM_TRACE("RasterOverlayTileProvider::processTileLoadQueue");
+
+  // Tiles requested more than once are started at their first, highest
+  // priority, request, and their later requests do nothing.
+  std::stable_sort(this->_tileLoadQueue.begin(), this->_tileLoadQueue.end());
+
+  for (const TileLoadRequest& request : this->_tileLoadQueue) {
+    if (!this->loadTileThrottled(*request.pTile)) {
+      break;
+    }
+  }
+
+  this->_tileLoadQueue.clear();
+}
+
 CesiumAsync::Future<LoadedRasterOverlayImage>
 RasterOverlayTileProvider::loadTileImageFromUrl(
     const std::string& url,
@@ -212,6 +282,37 @@ struct LoadResult {
   bool moreDetailAvailable = true;
 };
 
+/**
+ * @brief Compresses an uncompressed image, with all of its mip levels, into the
+ * format selected by the given transcode targets.
+ *
+ * This function is intended to be called on the worker thread. The image is
+ * left unchanged if it is already compressed, or if the targets don't select
+ * a format that can be produced.
+ */
+void compressLoadedImage(
+    ImageCesium& image,
+    const Ktx2TranscodeTargets& targets,
+    const std::shared_ptr<spdlog::logger>& pLogger) {
+  const GpuCompressedPixelFormat format =
+      selectCompressedPixelFormat(image, targets);
+  if (format == GpuCompressedPixelFormat::NONE ||
+      image.compressedPixelFormat != GpuCompressedPixelFormat::NONE) {
+    return;
+  }
+
+  std::optional<std::string> mipError = GltfReader::generateMipMaps(image);
+  if (mipError) {
+    SPDLOG_LOGGER_WARN(pLogger, "Could not compress image: {}", *mipError);
+    return;
+  }
+
+  std::optional<ImageCesium> maybeCompressed = compressImage(image, format);
+  if (maybeCompressed) {
+    image = std::move(*maybeCompressed);
+  }
+}
+
 /**
  * @brief Processes the given `LoadedRasterOverlayImage`, producing a
  * `LoadResult`.
@@ -222,7 +323,8 @@ struct LoadResult {
  * `LoadResult` with the state `RasterOverlayTile::LoadState::Failed` will be
  * returned.
  *
- * Otherwise, the image data will be passed to
+ * Otherwise, the image will be compressed if the overlay's options request
+ * it, and then passed to
  * `IPrepareRendererResources::prepareRasterInLoadThread`, and the function
  * will return a `LoadResult` with the image, the prepared renderer resources,
  * and the state `RasterOverlayTile::LoadState::Loaded`.
@@ -232,13 +334,16 @@ struct LoadResult {
  * @param pLogger The logger
  * @param loadedImage The `LoadedRasterOverlayImage`
  * @param rendererOptions Renderer options
+ * @param compressionTargets The transcode targets used to select the format
+ * to compress the image into, or `std::nullopt` to leave it uncompressed.
  * @return The `LoadResult`
  */
 static LoadResult createLoadResultFromLoadedImage(
     const std::shared_ptr<IPrepareRendererResources>& pPrepareRendererResources,
     const std::shared_ptr<spdlog::logger>& pLogger,
     LoadedRasterOverlayImage&& loadedImage,
-    const std::any& rendererOptions) {
+    const std::any& rendererOptions,
+    const std::optional<Ktx2TranscodeTargets>& compressionTargets) {
   if (!loadedImage.image.has_value()) {
     SPDLOG_LOGGER_ERROR(
         pLogger,
@@ -272,6 +377,10 @@ static LoadResult createLoadResultFromLoadedImage(
         std::to_string(image.height) + "x" + std::to_string(image.channels) +
         "x" + std::to_string(image.bytesPerChannel));
 
+    if (compressionTargets) {
+      compressLoadedImage(image, *compressionTargets, pLogger);
+    }
+
     void* pRendererResources = nullptr;
     if (pPrepareRendererResources) {
       pRendererResources = pPrepareRendererResources->prepareRasterInLoadThread(
@@ -295,8 +404,112 @@ static LoadResult createLoadResultFromLoadedImage(
   return result;
 }
 
+/**
+ * @brief Resamples a loaded image from the projection it was loaded in into
+ * the projection of the tile it was loaded for.
+ *
+ * This function is intended to be called on the worker thread.
+ *
+ * Images that failed to load or are empty are returned unchanged. The
+ * resampled image covers the part of the tile's rectangle that the loaded
+ * image covers.
+ *
+ * @param loadedImage The image, in the source projection.
+ * @param sourceProjection The projection the image was loaded in.
+ * @param reprojection The options for resampling the image.
+ * @param tileRectangle The tile's rectangle, in the target projection.
+ * @return The resampled image.
+ */
+LoadedRasterOverlayImage reprojectLoadedImage(
+    LoadedRasterOverlayImage&& loadedImage,
+    const Projection& sourceProjection,
+    const RasterOverlayReprojectionOptions& reprojection,
+    const Rectangle& tileRectangle) {
+  if (!loadedImage.image || loadedImage.image->width <= 0 ||
+      loadedImage.image->height <= 0) {
+    return std::move(loadedImage);
+  }
+
+  const Rectangle loadedRectangle = projectRectangleSimple(
+      reprojection.projection,
+      unprojectRectangleSimple(sourceProjection, loadedImage.rectangle));
+  const Rectangle rectangle = tileRectangle.computeIntersection(loadedRectangle)
+                                  .value_or(tileRectangle);
+
+  std::optional<ImageCesium> maybeImage = reprojectImage(
+      *loadedImage.image,
+      sourceProjection,
+      loadedImage.rectangle,
+      reprojection.projection,
+      rectangle,
+      reprojection.imageWidth > 0 ? reprojection.imageWidth
+                                  : loadedImage.image->width,
+      reprojection.imageHeight > 0 ? reprojection.imageHeight
+                                   : loadedImage.image->height);
+  if (!maybeImage) {
+    loadedImage.image.reset();
+    loadedImage.errors.emplace_back(
+        "The image could not be reprojected, because it is compressed or does "
+        "not have one byte per channel.");
+    return std::move(loadedImage);
+  }
+
+  loadedImage.image = std::move(maybeImage);
+  loadedImage.rectangle = rectangle;
+  return std::move(loadedImage);
+}
+
 } // namespace
 
+Future<LoadedRasterOverlayImage>
+RasterOverlayTileProvider::loadTileImageInTileProjection(
+    RasterOverlayTile& tile,
+    IntrusivePointer<RasterOverlayTile>& pSourceTile) {
+  if (!this->_reprojection) {
+    return this->loadTileImage(tile);
+  }
+
+  std::optional<LoadedRasterOverlayImage> cached =
+      this->_pReprojectedImages->find(
+          tile.getRectangle(),
+          tile.getTargetScreenPixels());
+  if (cached) {
+    return this->_asyncSystem.createResolvedFuture(std::move(*cached));
+  }
+
+  // The derived class loads the image for a temporary tile covering the same
+  // area in its own projection.
+  pSourceTile = new RasterOverlayTile(
+      *this,
+      tile.getTargetScreenPixels(),
+      projectRectangleSimple(
+          this->_projection,
+          unprojectRectangleSimple(
+              this->_reprojection->projection,
+              tile.getRectangle())));
+  return this->loadTileImage(*pSourceTile)
+      .thenInWorkerThread(
+          [sourceProjection = this->_projection,
+           reprojection = *this->_reprojection,
+           rectangle = tile.getRectangle(),
+           targetScreenPixels = tile.getTargetScreenPixels(),
+           pCache = this->_pReprojectedImages](
+              LoadedRasterOverlayImage&& loadedImage) {
+            LoadedRasterOverlayImage result = reprojectLoadedImage(
+                std::move(loadedImage),
+                sourceProjection,
+                reprojection,
+                rectangle);
+            if (result.image) {
+              pCache->add(
+                  rectangle,
+                  targetScreenPixels,
+                  LoadedRasterOverlayImage(result));
+            }
+            return result;
+          });
+}
+
 void RasterOverlayTileProvider::doLoad(
     RasterOverlayTile& tile,
     bool isThrottledLoad) {
@@ -317,20 +530,33 @@ void RasterOverlayTileProvider::doLoad(
   IntrusivePointer<RasterOverlayTile> pTile = &tile;
   IntrusivePointer<RasterOverlayTileProvider> thiz = this;
 
-  this->loadTileImage(tile)
+  // When reprojecting, the source tile is kept alive until the main thread
+  // continuation, because tiles may only be released in the main thread.
+  IntrusivePointer<RasterOverlayTile> pSourceTile = nullptr;
+  Future<LoadedRasterOverlayImage> loaded =
+      this->loadTileImageInTileProjection(tile, pSourceTile);
+
+  std::optional<Ktx2TranscodeTargets> compressionTargets;
+  if (this->_pOwner->getOptions().compressImages) {
+    compressionTargets = this->_pOwner->getOptions().ktx2TranscodeTargets;
+  }
+
+  std::move(loaded)
       .thenInWorkerThread(
           [pPrepareRendererResources = this->getPrepareRendererResources(),
            pLogger = this->getLogger(),
-           rendererOptions = this->_pOwner->getOptions().rendererOptions](
-              LoadedRasterOverlayImage&& loadedImage) {
+           rendererOptions = this->_pOwner->getOptions().rendererOptions,
+           compressionTargets](LoadedRasterOverlayImage&& loadedImage) {
             return createLoadResultFromLoadedImage(
                 pPrepareRendererResources,
                 pLogger,
                 std::move(loadedImage),
-                rendererOptions);
+                rendererOptions,
+                compressionTargets);
           })
       .thenInMainThread(
-          [thiz, pTile, isThrottledLoad](LoadResult&& result) noexcept {
+          [thiz, pTile, pSourceTile, isThrottledLoad](
+              LoadResult&& result) noexcept {
             pTile->_rectangle = result.rectangle;
             pTile->_pRendererResources = result.pRendererResources;
             pTile->_image = std::move(result.image);
@@ -346,7 +572,8 @@ void RasterOverlayTileProvider::doLoad(
             thiz->finalizeTileLoad(isThrottledLoad);
           })
       .catchInMainThread(
-          [thiz, pTile, isThrottledLoad](const std::exception& /*e*/) {
+          [thiz, pTile, pSourceTile, isThrottledLoad](
+              const std::exception& /*e*/) {
             pTile->_pRendererResources = nullptr;
             pTile->_image = {};
             pTile->_tileCredits = {};
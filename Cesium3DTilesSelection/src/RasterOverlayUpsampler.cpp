@@ -51,7 +51,7 @@ RasterOverlayUpsampler::loadTileContent(const TileLoadInput& loadInput) {
   for (const RasterMappedTo3DTile& mapped : pParent->getMappedRasterTiles()) {
     if (mapped.isMoreDetailAvailable()) {
       const CesiumGeospatial::Projection& projection =
-          mapped.getReadyTile()->getTileProvider().getProjection();
+          mapped.getReadyTile()->getTileProvider().getTileProjection();
       auto it = std::find(
           parentProjections.begin(),
           parentProjections.end(),
@@ -0,0 +1,252 @@
+#include "RasterReprojection.h"
+
+#include <CesiumGeospatial/Cartographic.h>
+#include <CesiumUtility/Tracing.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace CesiumGeometry;
+using namespace CesiumGeospatial;
+using namespace CesiumGltf;
+
+namespace Cesium3DTilesSelection {
+
+namespace {
+// Bilinear weights are fixed point with this many fractional bits, so that a
+// channel value resampled in one direction still fits in 16 bits.
+constexpr uint32_t weightBits = 8;
+constexpr uint32_t weightOne = 1U << weightBits;
+constexpr uint32_t rounding = 1U << (2 * weightBits - 1);
+
+// The two source pixels blended for a target pixel along one axis.
+struct Sample {
+  size_t first;
+  size_t second;
+  // The weight of the second pixel, out of weightOne.
+  uint32_t weight;
+};
+
+Sample computeSample(double sourcePixel, int32_t sourceSize) noexcept {
+  // Pixel centers are halfway between integer pixel coordinates.
+  const double position =
+      std::clamp(sourcePixel - 0.5, 0.0, double(sourceSize - 1));
+  const double first = std::floor(position);
+
+  Sample sample;
+  sample.first = size_t(first);
+  sample.second = std::min(sample.first + 1, size_t(sourceSize - 1));
+  sample.weight = uint32_t(std::lround((position - first) * weightOne));
+  return sample;
+}
+} // namespace
+
+std::optional<ImageCesium> reprojectImage(
+    const ImageCesium& sourceImage,
+    const Projection& sourceProjection,
+    const Rectangle& sourceRectangle,
+    const Projection& targetProjection,
+    const Rectangle& targetRectangle,
+    int32_t targetWidth,
+    int32_t targetHeight) {
+  CESIUM_TRACE("reprojectImage");
+
+  if (sourceImage.compressedPixelFormat != GpuCompressedPixelFormat::NONE ||
+      sourceImage.bytesPerChannel != 1 || sourceImage.channels <= 0 ||
+      sourceImage.width <= 0 || sourceImage.height <= 0 || targetWidth <= 0 ||
+      targetHeight <= 0) {
+    return std::nullopt;
+  }
+
+  const size_t channels = size_t(sourceImage.channels);
+  const size_t sourceRowBytes = size_t(sourceImage.width) * channels;
+  const size_t sourceOffset = sourceImage.mipPositions.empty()
+                                  ? 0
+                                  : sourceImage.mipPositions[0].byteOffset;
+  if (sourceImage.pixelData.size() <
+      sourceOffset + sourceRowBytes * size_t(sourceImage.height)) {
+    return std::nullopt;
+  }
+  const uint8_t* pSource = reinterpret_cast<const uint8_t*>(
+      sourceImage.pixelData.data() + sourceOffset);
+
+  // The projected x of a position depends only on its longitude, so the
+  // source column of each target column can be found at any latitude.
+  const glm::dvec2 targetCenter = targetRectangle.getCenter();
+  const double targetPixelWidth = targetRectangle.computeWidth() / targetWidth;
+  std::vector<Sample> columns(static_cast<size_t>(targetWidth));
+  for (size_t i = 0; i < columns.size(); ++i) {
+    const double x =
+        targetRectangle.minimumX + (double(i) + 0.5) * targetPixelWidth;
+    const Cartographic position =
+        unprojectPosition(targetProjection, glm::dvec3(x, targetCenter.y, 0.0));
+    const double sourceX = projectPosition(sourceProjection, position).x;
+    columns[i] = computeSample(
+        (sourceX - sourceRectangle.minimumX) / sourceRectangle.computeWidth() *
+            sourceImage.width,
+        sourceImage.width);
+  }
+
+  // Likewise, the projected y depends only on the latitude. Rows are stored
+  // from the top down.
+  const double targetPixelHeight =
+      targetRectangle.computeHeight() / targetHeight;
+  std::vector<Sample> rows(static_cast<size_t>(targetHeight));
+  for (size_t j = 0; j < rows.size(); ++j) {
+    const double y =
+        targetRectangle.maximumY - (double(j) + 0.5) * targetPixelHeight;
+    const Cartographic position =
+        unprojectPosition(targetProjection, glm::dvec3(targetCenter.x, y, 0.0));
+    const double sourceY = projectPosition(sourceProjection, position).y;
+    rows[j] = computeSample(
+        (sourceRectangle.maximumY - sourceY) / sourceRectangle.computeHeight() *
+            sourceImage.height,
+        sourceImage.height);
+  }
+
+  ImageCesium target;
+  target.width = targetWidth;
+  target.height = targetHeight;
+  target.channels = sourceImage.channels;
+  target.bytesPerChannel = 1;
+  const size_t targetRowBytes = size_t(targetWidth) * channels;
+  target.pixelData.resize(targetRowBytes * size_t(targetHeight));
+  uint8_t* pTarget = reinterpret_cast<uint8_t*>(target.pixelData.data());
+
+  auto resampleRow = [&columns, channels, pSource, sourceRowBytes](
+                         size_t sourceRow,
+                         std::vector<uint16_t>& resampled) {
+    const uint8_t* pRow = pSource + sourceRow * sourceRowBytes;
+    uint16_t* pResampled = resampled.data();
+    for (const Sample& column : columns) {
+      const uint8_t* pFirst = pRow + column.first * channels;
+      const uint8_t* pSecond = pRow + column.second * channels;
+      const uint32_t secondWeight = column.weight;
+      const uint32_t firstWeight = weightOne - secondWeight;
+      for (size_t c = 0; c < channels; ++c) {
+        *pResampled++ = uint16_t(
+            uint32_t(pFirst[c]) * firstWeight +
+            uint32_t(pSecond[c]) * secondWeight);
+      }
+    }
+  };
+
+  // Successive target rows usually blend the same or adjacent source rows, so
+  // keep the two most recently resampled source rows.
+  constexpr size_t noRow = std::numeric_limits<size_t>::max();
+  std::vector<uint16_t> firstRow(targetRowBytes);
+  std::vector<uint16_t> secondRow(targetRowBytes);
+  size_t firstRowIndex = noRow;
+  size_t secondRowIndex = noRow;
+
+  for (size_t j = 0; j < rows.size(); ++j) {
+    const Sample& row = rows[j];
+    if (row.first != firstRowIndex) {
+      if (row.first == secondRowIndex) {
+        std::swap(firstRow, secondRow);
+        std::swap(firstRowIndex, secondRowIndex);
+      } else {
+        resampleRow(row.first, firstRow);
+        firstRowIndex = row.first;
+      }
+    }
+    if (row.second != secondRowIndex) {
+      resampleRow(row.second, secondRow);
+      secondRowIndex = row.second;
+    }
+
+    const uint32_t secondWeight = row.weight;
+    const uint32_t firstWeight = weightOne - secondWeight;
+    const uint16_t* pFirst = firstRow.data();
+    const uint16_t* pSecond = secondRow.data();
+    uint8_t* pTargetRow = pTarget + j * targetRowBytes;
+    for (size_t k = 0; k < targetRowBytes; ++k) {
+      pTargetRow[k] = uint8_t(
+          (uint32_t(pFirst[k]) * firstWeight +
+           uint32_t(pSecond[k]) * secondWeight + rounding) >>
+          (2 * weightBits));
+    }
+  }
+
+  return target;
+}
+
+ReprojectedImageCache::ReprojectedImageCache(int64_t maximumBytes) noexcept
+    : _mutex(),
+      _maximumBytes(maximumBytes),
+      _bytes(0),
+      _entriesOldToRecent(),
+      _lookup() {}
+
+std::optional<LoadedRasterOverlayImage> ReprojectedImageCache::find(
+    const Rectangle& rectangle,
+    const glm::dvec2& targetScreenPixels) {
+  std::lock_guard<std::mutex> lock(this->_mutex);
+
+  auto lookupIt =
+      this->_lookup.find(createKey(rectangle, targetScreenPixels));
+  if (lookupIt == this->_lookup.end()) {
+    return std::nullopt;
+  }
+
+  // Move this entry to the end, indicating it's most recently used.
+  this->_entriesOldToRecent.splice(
+      this->_entriesOldToRecent.end(),
+      this->_entriesOldToRecent,
+      lookupIt->second);
+
+  return lookupIt->second->image;
+}
+
+void ReprojectedImageCache::add(
+    const Rectangle& rectangle,
+    const glm::dvec2& targetScreenPixels,
+    LoadedRasterOverlayImage&& image) {
+  const Key key = createKey(rectangle, targetScreenPixels);
+  const int64_t bytes =
+      image.image ? int64_t(image.image->pixelData.size()) : 0;
+
+  std::lock_guard<std::mutex> lock(this->_mutex);
+
+  auto lookupIt = this->_lookup.find(key);
+  if (lookupIt != this->_lookup.end()) {
+    this->_bytes -= lookupIt->second->bytes;
+    this->_entriesOldToRecent.erase(lookupIt->second);
+    this->_lookup.erase(lookupIt);
+  }
+
+  auto entryIt = this->_entriesOldToRecent.emplace(
+      this->_entriesOldToRecent.end(),
+      Entry{key, std::move(image), bytes});
+  this->_lookup.emplace(key, entryIt);
+  this->_bytes += bytes;
+
+  while (this->_bytes > this->_maximumBytes &&
+         !this->_entriesOldToRecent.empty()) {
+    const Entry& oldest = this->_entriesOldToRecent.front();
+    this->_bytes -= oldest.bytes;
+    this->_lookup.erase(oldest.key);
+    this->_entriesOldToRecent.pop_front();
+  }
+}
+
+int64_t ReprojectedImageCache::getBytes() const noexcept {
+  std::lock_guard<std::mutex> lock(this->_mutex);
+  return this->_bytes;
+}
+
+/*static*/ ReprojectedImageCache::Key ReprojectedImageCache::createKey(
+    const Rectangle& rectangle,
+    const glm::dvec2& targetScreenPixels) noexcept {
+  return Key{
+      rectangle.minimumX,
+      rectangle.minimumY,
+      rectangle.maximumX,
+      rectangle.maximumY,
+      targetScreenPixels.x,
+      targetScreenPixels.y};
+}
+
+} // namespace Cesium3DTilesSelection
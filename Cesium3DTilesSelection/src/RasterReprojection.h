@@ -0,0 +1,117 @@
+#pragma once
+
+#include <Cesium3DTilesSelection/RasterOverlayTileProvider.h>
+#include <CesiumGeometry/Rectangle.h>
+#include <CesiumGeospatial/Projection.h>
+#include <CesiumGltf/ImageCesium.h>
+
+#include <glm/vec2.hpp>
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+
+namespace Cesium3DTilesSelection {
+
+/**
+ * @brief Resamples an image from one projection into another with bilinear
+ * filtering.
+ *
+ * Every supported projection maps longitude only to x and latitude only to y,
+ * so the source column of each target column and the source row of each
+ * target row are computed once rather than for every pixel. Each target row is
+ * then blended from two source rows that have been resampled horizontally,
+ * using integer weights in a loop over contiguous channel values.
+ *
+ * Only uncompressed images with one byte per channel can be resampled. Only
+ * the most detailed mip level is used, and the result has no mip levels.
+ *
+ * @param sourceImage The image to resample.
+ * @param sourceProjection The projection of the source image.
+ * @param sourceRectangle The rectangle covered by the source image, in the
+ * source projection, from the outer edges of its outermost pixels.
+ * @param targetProjection The projection of the resampled image.
+ * @param targetRectangle The rectangle to be covered by the resampled image,
+ * in the target projection. Parts of it outside the source rectangle repeat
+ * the pixels at the edge of the source image.
+ * @param targetWidth The width of the resampled image, in pixels.
+ * @param targetHeight The height of the resampled image, in pixels.
+ * @return The resampled image, or `std::nullopt` if the source image can't be
+ * resampled.
+ */
+std::optional<CesiumGltf::ImageCesium> reprojectImage(
+    const CesiumGltf::ImageCesium& sourceImage,
+    const CesiumGeospatial::Projection& sourceProjection,
+    const CesiumGeometry::Rectangle& sourceRectangle,
+    const CesiumGeospatial::Projection& targetProjection,
+    const CesiumGeometry::Rectangle& targetRectangle,
+    int32_t targetWidth,
+    int32_t targetHeight);
+
+/**
+ * @brief The reprojected images of a {@link RasterOverlayTileProvider}, keyed
+ * by the rectangle and target screen pixels of the tile they were made for.
+ *
+ * When the images take more than the maximum number of bytes, the least
+ * recently used ones are removed. Images are added from worker threads and
+ * found from the main thread, so all access is synchronized.
+ */
+class ReprojectedImageCache {
+public:
+  /**
+   * @brief Creates an empty cache.
+   *
+   * @param maximumBytes The maximum number of bytes of pixel data to keep.
+   */
+  explicit ReprojectedImageCache(int64_t maximumBytes) noexcept;
+
+  /**
+   * @brief Finds the image for a tile and marks it as recently used.
+   *
+   * @return A copy of the image, or `std::nullopt` if there is none.
+   */
+  std::optional<LoadedRasterOverlayImage> find(
+      const CesiumGeometry::Rectangle& rectangle,
+      const glm::dvec2& targetScreenPixels);
+
+  /**
+   * @brief Adds the image for a tile, replacing any previous image for it,
+   * and removes least recently used images until the cache is within its
+   * maximum size.
+   */
+  void add(
+      const CesiumGeometry::Rectangle& rectangle,
+      const glm::dvec2& targetScreenPixels,
+      LoadedRasterOverlayImage&& image);
+
+  /**
+   * @brief Gets the number of bytes of pixel data in the cache.
+   */
+  int64_t getBytes() const noexcept;
+
+private:
+  using Key = std::array<double, 6>;
+
+  struct Entry {
+    Key key;
+    LoadedRasterOverlayImage image;
+    int64_t bytes;
+  };
+
+  static Key createKey(
+      const CesiumGeometry::Rectangle& rectangle,
+      const glm::dvec2& targetScreenPixels) noexcept;
+
+  mutable std::mutex _mutex;
+  int64_t _maximumBytes;
+  int64_t _bytes;
+
+  // Entries at the beginning of this list are the least recently used.
+  std::list<Entry> _entriesOldToRecent;
+  std::map<Key, std::list<Entry>::iterator> _lookup;
+};
+
+} // namespace Cesium3DTilesSelection
@@ -5,21 +5,57 @@
 #include "TileUtilities.h"
 
 using namespace Cesium3DTilesSelection;
+using namespace CesiumGeospatial;
+
+namespace {
+// The cache is cleared when it reaches this many tiles, so that it does not
+// grow without bound as tiles are created and destroyed.
+const size_t maximumCachedTiles = 100000;
+
+bool equals(const GlobeRectangle& a, const GlobeRectangle& b) noexcept {
+  return a.getWest() == b.getWest() && a.getSouth() == b.getSouth() &&
+         a.getEast() == b.getEast() && a.getNorth() == b.getNorth();
+}
+} // namespace
 
 RasterizedPolygonsTileExcluder::RasterizedPolygonsTileExcluder(
     const CesiumUtility::IntrusivePointer<const RasterizedPolygonsOverlay>&
         pOverlay) noexcept
-    : _pOverlay(pOverlay) {}
+    : _pOverlay(pOverlay), _cache() {}
 
 bool RasterizedPolygonsTileExcluder::shouldExclude(
     const Tile& tile) const noexcept {
+  const std::optional<GlobeRectangle> maybeRectangle =
+      estimateGlobeRectangle(tile.getBoundingVolume());
+  if (!maybeRectangle) {
+    return false;
+  }
+
+  auto it = this->_cache.find(&tile);
+  if (it != this->_cache.end() &&
+      equals(it->second.rectangle, *maybeRectangle)) {
+    return it->second.exclude;
+  }
+
+  bool exclude;
   if (this->_pOverlay->getInvertSelection()) {
-    return Cesium3DTilesSelection::CesiumImpl::outsidePolygons(
-        tile.getBoundingVolume(),
+    exclude = Cesium3DTilesSelection::CesiumImpl::outsidePolygons(
+        *maybeRectangle,
         this->_pOverlay->getPolygons());
   } else {
-    return Cesium3DTilesSelection::CesiumImpl::withinPolygons(
-        tile.getBoundingVolume(),
+    exclude = Cesium3DTilesSelection::CesiumImpl::withinPolygons(
+        *maybeRectangle,
         this->_pOverlay->getPolygons());
   }
+
+  if (it != this->_cache.end()) {
+    it->second = CachedResult{*maybeRectangle, exclude};
+  } else {
+    if (this->_cache.size() >= maximumCachedTiles) {
+      this->_cache.clear();
+    }
+    this->_cache.emplace(&tile, CachedResult{*maybeRectangle, exclude});
+  }
+
+  return exclude;
 }
@@ -0,0 +1,345 @@
+#include "HierarchicalDepthBuffer.h"
+
+#include <Cesium3DTilesSelection/GltfUtilities.h>
+#include <Cesium3DTilesSelection/SoftwareTileOcclusionProxyPool.h>
+#include <Cesium3DTilesSelection/Tile.h>
+#include <CesiumGltf/AccessorView.h>
+
+#include <glm/geometric.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+using namespace CesiumGeometry;
+using namespace CesiumGeospatial;
+using namespace CesiumGltf;
+
+namespace Cesium3DTilesSelection {
+
+namespace {
+// Anything nearer to the eye than this, in meters, is treated as crossing the
+// eye plane: such triangles don't occlude, and such bounding volumes aren't
+// occluded.
+constexpr double minimumDepth = 0.1;
+
+std::array<glm::dvec3, 8>
+computeCorners(const glm::dvec3& center, const glm::dmat3& halfAxes) {
+  std::array<glm::dvec3, 8> corners;
+  for (size_t i = 0; i < corners.size(); ++i) {
+    corners[i] = center + halfAxes[0] * ((i & 1) ? 1.0 : -1.0) +
+                 halfAxes[1] * ((i & 2) ? 1.0 : -1.0) +
+                 halfAxes[2] * ((i & 4) ? 1.0 : -1.0);
+  }
+  return corners;
+}
+
+std::array<glm::dvec3, 8> computeCorners(const BoundingVolume& boundingVolume) {
+  struct Operation {
+    std::array<glm::dvec3, 8>
+    operator()(const OrientedBoundingBox& boundingBox) noexcept {
+      return computeCorners(boundingBox.getCenter(), boundingBox.getHalfAxes());
+    }
+
+    std::array<glm::dvec3, 8>
+    operator()(const BoundingRegion& boundingRegion) noexcept {
+      return (*this)(boundingRegion.getBoundingBox());
+    }
+
+    std::array<glm::dvec3, 8>
+    operator()(const BoundingSphere& boundingSphere) noexcept {
+      return computeCorners(
+          boundingSphere.getCenter(),
+          glm::dmat3(boundingSphere.getRadius()));
+    }
+
+    std::array<glm::dvec3, 8> operator()(
+        const BoundingRegionWithLooseFittingHeights& boundingRegion) noexcept {
+      return (*this)(boundingRegion.getBoundingRegion());
+    }
+
+    std::array<glm::dvec3, 8>
+    operator()(const S2CellBoundingVolume& s2Cell) noexcept {
+      std::array<glm::dvec3, 8> corners;
+      const gsl::span<const glm::dvec3> vertices = s2Cell.getVertices();
+      std::copy(vertices.begin(), vertices.end(), corners.begin());
+      return corners;
+    }
+  };
+
+  return std::visit(Operation{}, boundingVolume);
+}
+
+/**
+ * @brief Projects positions into normalized device coordinates for a view,
+ * with the distance along the view direction as z.
+ */
+class ViewProjection {
+public:
+  explicit ViewProjection(const ViewState& viewState) noexcept
+      : _position(viewState.getPosition()),
+        _direction(glm::normalize(viewState.getDirection())),
+        _right(glm::normalize(glm::cross(_direction, viewState.getUp()))),
+        _up(glm::cross(_right, _direction)),
+        _xScale(1.0 / glm::tan(0.5 * viewState.getHorizontalFieldOfView())),
+        _yScale(1.0 / glm::tan(0.5 * viewState.getVerticalFieldOfView())) {}
+
+  glm::dvec3 project(const glm::dvec3& cartesian) const noexcept {
+    const glm::dvec3 offset = cartesian - this->_position;
+    const double depth = glm::dot(offset, this->_direction);
+    return glm::dvec3(
+        glm::dot(offset, this->_right) * this->_xScale / depth,
+        glm::dot(offset, this->_up) * this->_yScale / depth,
+        depth);
+  }
+
+private:
+  glm::dvec3 _position;
+  glm::dvec3 _direction;
+  glm::dvec3 _right;
+  glm::dvec3 _up;
+  double _xScale;
+  double _yScale;
+};
+} // namespace
+
+struct SoftwareTileOcclusionProxyPool::OccluderView {
+  OccluderView(
+      const ViewState& viewState,
+      uint32_t depthBufferWidth,
+      uint32_t depthBufferHeight)
+      : projection(viewState),
+        depthBuffer(depthBufferWidth, depthBufferHeight) {}
+
+  ViewProjection projection;
+  HierarchicalDepthBuffer depthBuffer;
+};
+
+class SoftwareTileOcclusionProxyPool::Proxy final
+    : public TileOcclusionRendererProxy {
+public:
+  explicit Proxy(const SoftwareTileOcclusionProxyPool& pool) noexcept
+      : _pool(pool), _pTile(nullptr) {}
+
+  TileOcclusionState getOcclusionState() const override {
+    if (this->_pTile &&
+        this->_pool.isOccluded(this->_pTile->getBoundingVolume())) {
+      return TileOcclusionState::Occluded;
+    }
+
+    // Occlusion is always known immediately, so never report it as
+    // unavailable.
+    return TileOcclusionState::NotOccluded;
+  }
+
+protected:
+  void reset(const Tile* pTile) override { this->_pTile = pTile; }
+
+private:
+  const SoftwareTileOcclusionProxyPool& _pool;
+  const Tile* _pTile;
+};
+
+namespace {
+template <typename TIndex>
+void rasterizeIndexedTriangles(
+    HierarchicalDepthBuffer& depthBuffer,
+    const std::vector<glm::dvec3>& projected,
+    const AccessorView<TIndex>& indices) {
+  for (int64_t i = 0; i + 2 < indices.size(); i += 3) {
+    const size_t a = static_cast<size_t>(indices[i]);
+    const size_t b = static_cast<size_t>(indices[i + 1]);
+    const size_t c = static_cast<size_t>(indices[i + 2]);
+    if (a >= projected.size() || b >= projected.size() ||
+        c >= projected.size()) {
+      continue;
+    }
+    if (projected[a].z < minimumDepth || projected[b].z < minimumDepth ||
+        projected[c].z < minimumDepth) {
+      continue;
+    }
+    depthBuffer.addTriangle(projected[a], projected[b], projected[c]);
+  }
+}
+
+void rasterizeTile(
+    HierarchicalDepthBuffer& depthBuffer,
+    const ViewProjection& projection,
+    const Tile& tile,
+    std::vector<glm::dvec3>& projected) {
+  const TileRenderContent* pRenderContent =
+      tile.getContent().getRenderContent();
+  if (!pRenderContent) {
+    return;
+  }
+
+  const Model& model = pRenderContent->getModel();
+  glm::dmat4 rootTransform = tile.getTransform();
+  rootTransform = GltfUtilities::applyRtcCenter(model, rootTransform);
+  rootTransform =
+      GltfUtilities::applyGltfUpAxisTransform(model, rootTransform);
+
+  // Rasterize all of the tile's triangles as one mesh, so that texels covered
+  // by several of them together are written too.
+  depthBuffer.beginMesh();
+  model.forEachPrimitiveInScene(
+      -1,
+      [&depthBuffer, &projection, &projected, &rootTransform](
+          const Model& gltf,
+          const Node& /*node*/,
+          const Mesh& /*mesh*/,
+          const MeshPrimitive& primitive,
+          const glm::dmat4& nodeTransform) {
+        if (primitive.mode != MeshPrimitive::Mode::TRIANGLES) {
+          return;
+        }
+
+        auto positionIt = primitive.attributes.find("POSITION");
+        if (positionIt == primitive.attributes.end()) {
+          return;
+        }
+
+        const AccessorView<glm::vec3> positions(gltf, positionIt->second);
+        if (positions.status() != AccessorViewStatus::Valid) {
+          return;
+        }
+
+        // Project each vertex once, rather than once per triangle.
+        const glm::dmat4 fullTransform = rootTransform * nodeTransform;
+        projected.resize(static_cast<size_t>(positions.size()));
+        for (int64_t i = 0; i < positions.size(); ++i) {
+          projected[static_cast<size_t>(i)] = projection.project(glm::dvec3(
+              fullTransform * glm::dvec4(glm::dvec3(positions[i]), 1.0)));
+        }
+
+        if (primitive.indices < 0 ||
+            primitive.indices >= static_cast<int32_t>(gltf.accessors.size())) {
+          for (size_t i = 0; i + 2 < projected.size(); i += 3) {
+            if (projected[i].z < minimumDepth ||
+                projected[i + 1].z < minimumDepth ||
+                projected[i + 2].z < minimumDepth) {
+              continue;
+            }
+            depthBuffer.addTriangle(
+                projected[i],
+                projected[i + 1],
+                projected[i + 2]);
+          }
+          return;
+        }
+
+        const Accessor& indexAccessor =
+            gltf.accessors[static_cast<size_t>(primitive.indices)];
+        if (indexAccessor.componentType ==
+            Accessor::ComponentType::UNSIGNED_BYTE) {
+          rasterizeIndexedTriangles(
+              depthBuffer,
+              projected,
+              AccessorView<uint8_t>(gltf, primitive.indices));
+        } else if (
+            indexAccessor.componentType ==
+            Accessor::ComponentType::UNSIGNED_SHORT) {
+          rasterizeIndexedTriangles(
+              depthBuffer,
+              projected,
+              AccessorView<uint16_t>(gltf, primitive.indices));
+        } else if (
+            indexAccessor.componentType ==
+            Accessor::ComponentType::UNSIGNED_INT) {
+          rasterizeIndexedTriangles(
+              depthBuffer,
+              projected,
+              AccessorView<uint32_t>(gltf, primitive.indices));
+        }
+      });
+  depthBuffer.endMesh();
+}
+} // namespace
+
+SoftwareTileOcclusionProxyPool::SoftwareTileOcclusionProxyPool(
+    int32_t maximumPoolSize,
+    uint32_t depthBufferWidth,
+    uint32_t depthBufferHeight)
+    : TileOcclusionRendererProxyPool(maximumPoolSize),
+      _depthBufferWidth(depthBufferWidth),
+      _depthBufferHeight(depthBufferHeight),
+      _views() {}
+
+SoftwareTileOcclusionProxyPool::~SoftwareTileOcclusionProxyPool() noexcept {
+  // The base class destructor can't call our destroyProxy, so destroy the
+  // proxies now.
+  this->destroyPool();
+}
+
+void SoftwareTileOcclusionProxyPool::updateOccluders(
+    const std::vector<ViewState>& frustums,
+    const std::vector<Tile*>& occluders) {
+  this->_views.resize(frustums.size());
+
+  std::vector<glm::dvec3> projected;
+  for (size_t i = 0; i < frustums.size(); ++i) {
+    // Reuse the depth buffer that this view had last time, if any.
+    std::unique_ptr<OccluderView>& pView = this->_views[i];
+    if (pView) {
+      pView->projection = ViewProjection(frustums[i]);
+      pView->depthBuffer.clear();
+    } else {
+      pView = std::make_unique<OccluderView>(
+          frustums[i],
+          this->_depthBufferWidth,
+          this->_depthBufferHeight);
+    }
+    OccluderView& view = *pView;
+
+    for (const Tile* pTile : occluders) {
+      if (pTile) {
+        rasterizeTile(view.depthBuffer, view.projection, *pTile, projected);
+      }
+    }
+
+    view.depthBuffer.buildHierarchy();
+  }
+}
+
+bool SoftwareTileOcclusionProxyPool::isOccluded(
+    const BoundingVolume& boundingVolume) const noexcept {
+  if (this->_views.empty()) {
+    return false;
+  }
+
+  const std::array<glm::dvec3, 8> corners = computeCorners(boundingVolume);
+
+  for (const std::unique_ptr<OccluderView>& pView : this->_views) {
+    glm::dvec2 minimum(std::numeric_limits<double>::max());
+    glm::dvec2 maximum(std::numeric_limits<double>::lowest());
+    double nearest = std::numeric_limits<double>::max();
+
+    for (const glm::dvec3& corner : corners) {
+      const glm::dvec3 projected = pView->projection.project(corner);
+      if (!(projected.z >= minimumDepth)) {
+        return false;
+      }
+      minimum = glm::min(minimum, glm::dvec2(projected));
+      maximum = glm::max(maximum, glm::dvec2(projected));
+      nearest = std::min(nearest, projected.z);
+    }
+
+    if (!pView->depthBuffer.isHidden(minimum, maximum, nearest)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+TileOcclusionRendererProxy* SoftwareTileOcclusionProxyPool::createProxy() {
+  return new Proxy(*this);
+}
+
+void SoftwareTileOcclusionProxyPool::destroyProxy(
+    TileOcclusionRendererProxy* pProxy) {
+  delete static_cast<Proxy*>(pProxy);
+}
+
+} // namespace Cesium3DTilesSelection
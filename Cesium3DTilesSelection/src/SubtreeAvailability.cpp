@@ -6,6 +6,8 @@
 #include <gsl/span>
 #include <rapidjson/document.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <optional>
 #include <string>
 
@@ -457,10 +459,49 @@ SubtreeAvailability::SubtreeAvailability(
       _tileAvailability{tileAvailability},
       _subtreeAvailability{subtreeAvailability},
       _contentAvailability{std::move(contentAvailability)},
-      _buffers{std::move(buffers)} {
+      _buffer{} {
   assert(
       (this->_childCount == 4 || this->_childCount == 8) &&
       "Only support quadtree and octree");
+
+  // Copy the bitstreams out of the buffers, which may also hold metadata and
+  // are often much larger than the bitstreams themselves. The buffer is sized
+  // up front so that it isn't reallocated while the views are re-pointed.
+  std::vector<AvailabilityView*> views;
+  views.reserve(2 + this->_contentAvailability.size());
+  views.emplace_back(&this->_tileAvailability);
+  views.emplace_back(&this->_subtreeAvailability);
+  for (AvailabilityView& view : this->_contentAvailability) {
+    views.emplace_back(&view);
+  }
+
+  size_t totalLength = 0;
+  for (const AvailabilityView* pView : views) {
+    const SubtreeBufferViewAvailability* pBufferView =
+        std::get_if<SubtreeBufferViewAvailability>(pView);
+    if (pBufferView) {
+      totalLength += pBufferView->view.size();
+    }
+  }
+
+  this->_buffer.resize(totalLength);
+  size_t offset = 0;
+  for (AvailabilityView* pView : views) {
+    SubtreeBufferViewAvailability* pBufferView =
+        std::get_if<SubtreeBufferViewAvailability>(pView);
+    if (pBufferView) {
+      const size_t length = pBufferView->view.size();
+      std::copy(
+          pBufferView->view.begin(),
+          pBufferView->view.end(),
+          this->_buffer.begin() + static_cast<std::ptrdiff_t>(offset));
+      pBufferView->view =
+          gsl::span<const std::byte>(this->_buffer.data() + offset, length);
+      offset += length;
+    }
+  }
+
+  buffers.clear();
 }
 
 bool SubtreeAvailability::isTileAvailable(
@@ -496,6 +537,12 @@ bool SubtreeAvailability::isSubtreeAvailable(
       this->_subtreeAvailability);
 }
 
+int64_t SubtreeAvailability::computeByteSize() const noexcept {
+  return static_cast<int64_t>(
+      sizeof(SubtreeAvailability) + this->_buffer.capacity() +
+      this->_contentAvailability.capacity() * sizeof(AvailabilityView));
+}
+
 CesiumAsync::Future<std::optional<SubtreeAvailability>>
 SubtreeAvailability::loadSubtree(
     uint32_t powerOf2,
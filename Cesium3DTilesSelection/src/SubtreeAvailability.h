@@ -20,6 +20,14 @@ using AvailabilityView =
 
 class SubtreeAvailability {
 public:
+  /**
+   * @brief Creates an instance from availability views into the given
+   * buffers.
+   *
+   * Only the bytes that the views refer to are kept, copied together into a
+   * single allocation. The rest of the buffers, such as metadata, is
+   * released.
+   */
   SubtreeAvailability(
       uint32_t powerOf2,
       AvailabilityView tileAvailability,
@@ -27,6 +35,13 @@ public:
       std::vector<AvailabilityView>&& contentAvailability,
       std::vector<std::vector<std::byte>>&& buffers);
 
+  // The views point into this instance's buffer, so it can be moved but not
+  // copied.
+  SubtreeAvailability(const SubtreeAvailability&) = delete;
+  SubtreeAvailability& operator=(const SubtreeAvailability&) = delete;
+  SubtreeAvailability(SubtreeAvailability&&) noexcept = default;
+  SubtreeAvailability& operator=(SubtreeAvailability&&) noexcept = default;
+
   bool isTileAvailable(
       uint32_t relativeTileLevel,
       uint64_t relativeTileMortonId) const noexcept;
@@ -38,6 +53,12 @@ public:
 
   bool isSubtreeAvailable(uint64_t relativeSubtreeMortonId) const noexcept;
 
+  /**
+   * @brief Gets the approximate number of bytes of memory used by this
+   * instance.
+   */
+  int64_t computeByteSize() const noexcept;
+
   static CesiumAsync::Future<std::optional<SubtreeAvailability>> loadSubtree(
       uint32_t powerOf2,
       const CesiumAsync::AsyncSystem& asyncSystem,
@@ -62,6 +83,6 @@ private:
   AvailabilityView _tileAvailability;
   AvailabilityView _subtreeAvailability;
   std::vector<AvailabilityView> _contentAvailability;
-  std::vector<std::vector<std::byte>> _buffers;
+  std::vector<std::byte> _buffer;
 };
 } // namespace Cesium3DTilesSelection
@@ -0,0 +1,115 @@
+#include "SubtreeAvailabilityCache.h"
+
+#include <CesiumUtility/Metrics.h>
+
+namespace Cesium3DTilesSelection {
+namespace {
+CesiumUtility::MetricGauge& getSubtreeBytesGauge() {
+  static CesiumUtility::MetricGauge& gauge =
+      CesiumUtility::MetricsRegistry::getDefault().gauge(
+          "implicitTiling.subtreeBytes");
+  return gauge;
+}
+} // namespace
+
+size_t SubtreeAvailabilityCache::KeyHash::operator()(
+    const Key& key) const noexcept {
+  // Subtrees at the same level have distinct Morton indices, so mixing the
+  // level in is enough to keep levels apart.
+  return std::hash<uint64_t>()(
+      key.mortonIndex ^ (uint64_t(key.levelIndex) * 0x9E3779B97F4A7C15ULL));
+}
+
+SubtreeAvailabilityCache::Entry::Entry(
+    const Key& key_,
+    SubtreeAvailability&& subtree_) noexcept
+    : key(key_),
+      subtree(std::move(subtree_)),
+      byteSize(this->subtree.computeByteSize()),
+      links() {}
+
+SubtreeAvailabilityCache::SubtreeAvailabilityCache() noexcept
+    : _entries(),
+      _loading(),
+      _recentlyUsed(),
+      _sizeBytes(0),
+      _maximumBytes(16 * 1024 * 1024) {}
+
+SubtreeAvailabilityCache::~SubtreeAvailabilityCache() noexcept {
+  getSubtreeBytesGauge().add(-this->_sizeBytes);
+}
+
+const SubtreeAvailability* SubtreeAvailabilityCache::find(
+    uint32_t levelIndex,
+    uint64_t mortonIndex) noexcept {
+  auto it = this->_entries.find(Key{levelIndex, mortonIndex});
+  if (it == this->_entries.end()) {
+    return nullptr;
+  }
+
+  Entry& entry = *it->second;
+  this->_recentlyUsed.remove(entry);
+  this->_recentlyUsed.insertAtTail(entry);
+  return &entry.subtree;
+}
+
+void SubtreeAvailabilityCache::insert(
+    uint32_t levelIndex,
+    uint64_t mortonIndex,
+    SubtreeAvailability&& subtree) {
+  const Key key{levelIndex, mortonIndex};
+  std::unique_ptr<Entry> pEntry =
+      std::make_unique<Entry>(key, std::move(subtree));
+
+  std::unique_ptr<Entry>& pSlot = this->_entries[key];
+  if (pSlot) {
+    this->_recentlyUsed.remove(*pSlot);
+    this->_sizeBytes -= pSlot->byteSize;
+    getSubtreeBytesGauge().add(-pSlot->byteSize);
+  }
+
+  pSlot = std::move(pEntry);
+  this->_recentlyUsed.insertAtTail(*pSlot);
+  this->_sizeBytes += pSlot->byteSize;
+  getSubtreeBytesGauge().add(pSlot->byteSize);
+
+  this->unloadLeastRecentlyUsed();
+}
+
+bool SubtreeAvailabilityCache::beginLoading(
+    uint32_t levelIndex,
+    uint64_t mortonIndex) {
+  return this->_loading.insert(Key{levelIndex, mortonIndex}).second;
+}
+
+void SubtreeAvailabilityCache::endLoading(
+    uint32_t levelIndex,
+    uint64_t mortonIndex) noexcept {
+  this->_loading.erase(Key{levelIndex, mortonIndex});
+}
+
+void SubtreeAvailabilityCache::setMaximumBytes(int64_t maximumBytes) noexcept {
+  this->_maximumBytes = maximumBytes;
+  this->unloadLeastRecentlyUsed();
+}
+
+void SubtreeAvailabilityCache::unloadLeastRecentlyUsed() noexcept {
+  // Never unload the most recently used subtree, which the caller is about to
+  // use, or the root subtree, which every tile depends on.
+  Entry* pEntry = this->_recentlyUsed.head();
+  while (this->_sizeBytes > this->_maximumBytes && pEntry &&
+         pEntry != this->_recentlyUsed.tail()) {
+    Entry* pNext = this->_recentlyUsed.next(*pEntry);
+    if (pEntry->key.levelIndex != 0) {
+      this->_recentlyUsed.remove(*pEntry);
+      this->_sizeBytes -= pEntry->byteSize;
+      getSubtreeBytesGauge().add(-pEntry->byteSize);
+
+      // The entry owns its key, so copy it before the entry is destroyed.
+      const Key key = pEntry->key;
+      this->_entries.erase(key);
+    }
+    pEntry = pNext;
+  }
+}
+} // namespace Cesium3DTilesSelection
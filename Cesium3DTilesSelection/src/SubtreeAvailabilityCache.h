@@ -0,0 +1,121 @@
+#pragma once
+
+#include "SubtreeAvailability.h"
+
+#include <CesiumUtility/DoublyLinkedList.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Cesium3DTilesSelection {
+/**
+ * @brief The loaded subtrees of an implicit tileset, keyed by the index of
+ * the subtree's level and the Morton index of its root tile within that
+ * level.
+ *
+ * When the subtrees take more than the maximum number of bytes, the least
+ * recently used ones are unloaded. A loader must therefore be prepared to
+ * request a subtree again. The root subtree is never unloaded.
+ */
+class SubtreeAvailabilityCache {
+public:
+  SubtreeAvailabilityCache() noexcept;
+
+  SubtreeAvailabilityCache(const SubtreeAvailabilityCache&) = delete;
+  SubtreeAvailabilityCache&
+  operator=(const SubtreeAvailabilityCache&) = delete;
+
+  ~SubtreeAvailabilityCache() noexcept;
+
+  /**
+   * @brief Finds a loaded subtree, marking it as the most recently used.
+   *
+   * The returned pointer is invalidated by the next call to {@link insert}
+   * or {@link setMaximumBytes}.
+   */
+  const SubtreeAvailability*
+  find(uint32_t levelIndex, uint64_t mortonIndex) noexcept;
+
+  /**
+   * @brief Adds or replaces a subtree, then unloads the least recently used
+   * subtrees if the cache is over budget.
+   */
+  void insert(
+      uint32_t levelIndex,
+      uint64_t mortonIndex,
+      SubtreeAvailability&& subtree);
+
+  /**
+   * @brief Records that a subtree is being requested.
+   *
+   * @return `false` if the subtree is already being requested, in which case
+   * it should not be requested again.
+   */
+  bool beginLoading(uint32_t levelIndex, uint64_t mortonIndex);
+
+  /**
+   * @brief Records that a request for a subtree has completed, whether or
+   * not it succeeded.
+   */
+  void endLoading(uint32_t levelIndex, uint64_t mortonIndex) noexcept;
+
+  /**
+   * @brief Gets the maximum number of bytes of subtrees to keep loaded.
+   */
+  int64_t getMaximumBytes() const noexcept { return this->_maximumBytes; }
+
+  /**
+   * @brief Sets the maximum number of bytes of subtrees to keep loaded, and
+   * unloads subtrees if the cache is now over budget.
+   */
+  void setMaximumBytes(int64_t maximumBytes) noexcept;
+
+  /**
+   * @brief Gets the number of bytes used by the loaded subtrees.
+   */
+  int64_t getSizeBytes() const noexcept { return this->_sizeBytes; }
+
+  /**
+   * @brief Gets the number of loaded subtrees.
+   */
+  size_t size() const noexcept { return this->_entries.size(); }
+
+private:
+  struct Key {
+    uint32_t levelIndex;
+    uint64_t mortonIndex;
+
+    bool operator==(const Key& rhs) const noexcept {
+      return this->levelIndex == rhs.levelIndex &&
+             this->mortonIndex == rhs.mortonIndex;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const noexcept;
+  };
+
+  struct Entry {
+    Entry(const Key& key_, SubtreeAvailability&& subtree_) noexcept;
+
+    Key key;
+    SubtreeAvailability subtree;
+    int64_t byteSize;
+    CesiumUtility::DoublyLinkedListPointers<Entry> links;
+  };
+
+  void unloadLeastRecentlyUsed() noexcept;
+
+  std::unordered_map<Key, std::unique_ptr<Entry>, KeyHash> _entries;
+  std::unordered_set<Key, KeyHash> _loading;
+
+  // The head is the least recently used subtree.
+  CesiumUtility::DoublyLinkedList<Entry, &Entry::links> _recentlyUsed;
+
+  int64_t _sizeBytes;
+  int64_t _maximumBytes;
+};
+} // namespace Cesium3DTilesSelection
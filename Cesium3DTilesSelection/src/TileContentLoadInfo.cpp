@@ -21,5 +21,11 @@ TileContentLoadInfo::TileContentLoadInfo(
       tileRefine(tile.getRefine()),
       tileGeometricError(tile.getGeometricError()),
       tileTransform(tile.getTransform()),
-      contentOptions(contentOptions_) {}
+      contentOptions(contentOptions_) {
+  if (contentOptions_.computeTightBoundingVolumes) {
+    for (const Tile& child : tile.getChildren()) {
+      this->tileChildBoundingVolumes.emplace_back(child.getBoundingVolume());
+    }
+  }
+}
 } // namespace Cesium3DTilesSelection
@@ -15,6 +15,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 namespace Cesium3DTilesSelection {
 struct TileContentLoadInfo {
@@ -45,8 +46,14 @@ struct TileContentLoadInfo {
 
   double tileGeometricError;
 
+  // The bounding volumes of the tile's children, if the tile has any and
+  // TilesetContentOptions::computeTightBoundingVolumes is set.
+  std::vector<BoundingVolume> tileChildBoundingVolumes;
+
   glm::dmat4 tileTransform;
 
   TilesetContentOptions contentOptions;
+
+  int32_t maximumImageDimension = 0;
 };
 } // namespace Cesium3DTilesSelection
@@ -11,33 +11,6 @@ using namespace CesiumGeospatial;
 namespace Cesium3DTilesSelection {
 namespace CesiumImpl {
 
-bool withinTriangle(
-    const glm::dvec2& point,
-    const glm::dvec2& triangleVertA,
-    const glm::dvec2& triangleVertB,
-    const glm::dvec2& triangleVertC) noexcept {
-
-  const glm::dvec2 ab = triangleVertB - triangleVertA;
-  const glm::dvec2 ab_perp(-ab.y, ab.x);
-  const glm::dvec2 bc = triangleVertC - triangleVertB;
-  const glm::dvec2 bc_perp(-bc.y, bc.x);
-  const glm::dvec2 ca = triangleVertA - triangleVertC;
-  const glm::dvec2 ca_perp(-ca.y, ca.x);
-
-  const glm::dvec2 av = point - triangleVertA;
-  const glm::dvec2 cv = point - triangleVertC;
-
-  const double v_proj_ab_perp = glm::dot(av, ab_perp);
-  const double v_proj_bc_perp = glm::dot(cv, bc_perp);
-  const double v_proj_ca_perp = glm::dot(cv, ca_perp);
-
-  // This will determine in or out, irrespective of winding.
-  return (v_proj_ab_perp >= 0.0 && v_proj_ca_perp >= 0.0 &&
-          v_proj_bc_perp >= 0.0) ||
-         (v_proj_ab_perp <= 0.0 && v_proj_ca_perp <= 0.0 &&
-          v_proj_bc_perp <= 0.0);
-}
-
 bool withinPolygons(
     const BoundingVolume& boundingVolume,
     const std::vector<CartographicPolygon>& cartographicPolygons) noexcept {
@@ -55,17 +28,7 @@ bool withinPolygons(
     const CesiumGeospatial::GlobeRectangle& rectangle,
     const std::vector<CartographicPolygon>& cartographicPolygons) noexcept {
 
-  glm::dvec2 rectangleCorners[] = {
-      glm::dvec2(rectangle.getWest(), rectangle.getSouth()),
-      glm::dvec2(rectangle.getWest(), rectangle.getNorth()),
-      glm::dvec2(rectangle.getEast(), rectangle.getNorth()),
-      glm::dvec2(rectangle.getEast(), rectangle.getSouth())};
-
-  glm::dvec2 rectangleEdges[] = {
-      rectangleCorners[1] - rectangleCorners[0],
-      rectangleCorners[2] - rectangleCorners[1],
-      rectangleCorners[3] - rectangleCorners[2],
-      rectangleCorners[0] - rectangleCorners[3]};
+  const glm::dvec2 southwest(rectangle.getWest(), rectangle.getSouth());
 
   // Iterate through all polygons.
   for (size_t i = 0; i < cartographicPolygons.size(); ++i) {
@@ -78,63 +41,16 @@ bool withinPolygons(
       continue;
     }
 
-    const std::vector<glm::dvec2>& vertices = selection.getVertices();
-    const std::vector<uint32_t>& indices = selection.getIndices();
-
     // First check if an arbitrary point on the bounding globe rectangle is
-    // inside the polygon.
-    bool inside = false;
-    for (size_t j = 2; j < indices.size(); j += 3) {
-      if (withinTriangle(
-              rectangleCorners[0],
-              vertices[indices[j - 2]],
-              vertices[indices[j - 1]],
-              vertices[indices[j]])) {
-        inside = true;
-        break;
-      }
-    }
-
-    // If the arbitrary point was outside, then this polygon does not entirely
-    // cull the tile.
-    if (!inside) {
+    // inside the polygon. If it is outside, then this polygon does not
+    // entirely cull the tile.
+    if (!selection.contains(southwest)) {
       continue;
     }
 
-    // Check if the polygon perimeter intersects the bounding globe rectangle
-    // edges.
-    bool intersectionFound = false;
-    for (size_t j = 0; j < vertices.size(); ++j) {
-      const glm::dvec2& a = vertices[j];
-      const glm::dvec2& b = vertices[(j + 1) % vertices.size()];
-
-      const glm::dvec2 ba = a - b;
-
-      // Check each rectangle edge.
-      for (size_t k = 0; k < 4; ++k) {
-        const glm::dvec2& cd = rectangleEdges[k];
-        const glm::dmat2 lineSegmentMatrix(cd, ba);
-        const glm::dvec2 ca = a - rectangleCorners[k];
-
-        // s and t are calculated such that:
-        // line_intersection = a + t * ab = c + s * cd
-        const glm::dvec2 st = glm::inverse(lineSegmentMatrix) * ca;
-
-        // check that the intersection is within the line segments
-        if (st.x <= 1.0 && st.x >= 0.0 && st.y <= 1.0 && st.y >= 0.0) {
-          intersectionFound = true;
-          break;
-        }
-      }
-
-      if (intersectionFound) {
-        break;
-      }
-    }
-
     // There is no intersection with the perimeter and at least one point is
     // inside the polygon so the tile is completely inside this polygon.
-    if (!intersectionFound) {
+    if (!selection.intersectsEdges(rectangle)) {
       return true;
     }
   }
@@ -167,12 +83,6 @@ bool outsidePolygons(
       glm::dvec2(rectangle.getEast(), rectangle.getNorth()),
       glm::dvec2(rectangle.getEast(), rectangle.getSouth())};
 
-  glm::dvec2 rectangleEdges[] = {
-      rectangleCorners[1] - rectangleCorners[0],
-      rectangleCorners[2] - rectangleCorners[1],
-      rectangleCorners[3] - rectangleCorners[2],
-      rectangleCorners[0] - rectangleCorners[3]};
-
   // Iterate through all polygons.
   for (size_t i = 0; i < cartographicPolygons.size(); ++i) {
     const CartographicPolygon& selection = cartographicPolygons[i];
@@ -185,15 +95,14 @@ bool outsidePolygons(
     }
 
     const std::vector<glm::dvec2>& vertices = selection.getVertices();
-    const std::vector<uint32_t>& indices = selection.getIndices();
 
     // Check if an arbitrary point on the polygon is in the globe rectangle.
-    if (withinTriangle(
+    if (CartographicPolygon::withinTriangle(
             vertices[0],
             rectangleCorners[0],
             rectangleCorners[1],
             rectangleCorners[2]) ||
-        withinTriangle(
+        CartographicPolygon::withinTriangle(
             vertices[0],
             rectangleCorners[0],
             rectangleCorners[2],
@@ -203,40 +112,15 @@ bool outsidePolygons(
 
     // Check if an arbitrary point on the bounding globe rectangle is
     // inside the polygon.
-    for (size_t j = 2; j < indices.size(); j += 3) {
-      if (withinTriangle(
-              rectangleCorners[0],
-              vertices[indices[j - 2]],
-              vertices[indices[j - 1]],
-              vertices[indices[j]])) {
-        return false;
-      }
+    if (selection.contains(rectangleCorners[0])) {
+      return false;
     }
 
     // Now we know the rectangle does not fully contain the polygon and the
     // polygon does not fully contain the rectangle. Now check if the polygon
     // perimeter intersects the bounding globe rectangle edges.
-    for (size_t j = 0; j < vertices.size(); ++j) {
-      const glm::dvec2& a = vertices[j];
-      const glm::dvec2& b = vertices[(j + 1) % vertices.size()];
-
-      const glm::dvec2 ba = a - b;
-
-      // Check each rectangle edge.
-      for (size_t k = 0; k < 4; ++k) {
-        const glm::dvec2& cd = rectangleEdges[k];
-        const glm::dmat2 lineSegmentMatrix(cd, ba);
-        const glm::dvec2 ca = a - rectangleCorners[k];
-
-        // s and t are calculated such that:
-        // line_intersection = a + t * ab = c + s * cd
-        const glm::dvec2 st = glm::inverse(lineSegmentMatrix) * ca;
-
-        // check that the intersection is within the line segments
-        if (st.x <= 1.0 && st.x >= 0.0 && st.y <= 1.0 && st.y >= 0.0) {
-          return false;
-        }
-      }
+    if (selection.intersectsEdges(rectangle)) {
+      return false;
     }
   }
 
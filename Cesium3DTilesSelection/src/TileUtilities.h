@@ -10,21 +10,6 @@
 namespace Cesium3DTilesSelection {
 namespace CesiumImpl {
 
-/**
- * @brief Returns whether the point is completely inside the triangle.
- *
- * @param point The point to check.
- * @param triangleVertA The first vertex of the triangle.
- * @param triangleVertB The second vertex of the triangle.
- * @param triangleVertC The third vertex of the triangle.
- * @return Whether the point is within the triangle.
- */
-bool withinTriangle(
-    const glm::dvec2& point,
-    const glm::dvec2& triangleVertA,
-    const glm::dvec2& triangleVertB,
-    const glm::dvec2& triangleVertC) noexcept;
-
 /**
  * @brief Returns whether the tile is completely inside a polygon.
  *
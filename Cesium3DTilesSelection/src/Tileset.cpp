@@ -12,6 +12,7 @@
 #include <CesiumGeospatial/Cartographic.h>
 #include <CesiumGeospatial/GlobeRectangle.h>
 #include <CesiumUtility/Math.h>
+#include <CesiumUtility/Metrics.h>
 #include <CesiumUtility/ScopeGuard.h>
 #include <CesiumUtility/Tracing.h>
 #include <CesiumUtility/joinToString.h>
@@ -274,9 +275,64 @@ Tileset::updateViewOffline(const std::vector<ViewState>& frustums) {
   return this->_updateResult;
 }
 
+void Tileset::updateViewsOffline(
+    const std::vector<std::vector<ViewState>>& viewSets,
+    const std::function<void(size_t, const ViewUpdateResult&)>& callback,
+    const OfflineViewUpdateOptions& options) {
+  CESIUM_TRACE("Tileset::updateViewsOffline");
+
+  // Nothing is rendered in real time while this runs, so allow more loads to
+  // be in flight than usual.
+  const uint32_t originalMaximumTileLoads =
+      this->_options.maximumSimultaneousTileLoads;
+  CesiumUtility::ScopeGuard restoreMaximumTileLoads{
+      [this, originalMaximumTileLoads]() {
+        this->_options.maximumSimultaneousTileLoads = originalMaximumTileLoads;
+      }};
+  this->_options.maximumSimultaneousTileLoads = std::max(
+      originalMaximumTileLoads,
+      options.maximumSimultaneousTileLoads);
+
+  const size_t batchSize = std::max(options.viewSetsPerBatch, size_t(1));
+  std::vector<ViewState> batchFrustums;
+
+  for (size_t batchBegin = 0; batchBegin < viewSets.size();
+       batchBegin += batchSize) {
+    const size_t batchEnd = std::min(batchBegin + batchSize, viewSets.size());
+
+    // Traversing with every frustum in the batch at once selects, and so
+    // loads, the union of the tiles that each view set needs, with each tile
+    // requested only once.
+    batchFrustums.clear();
+    for (size_t i = batchBegin; i < batchEnd; ++i) {
+      for (const ViewState& frustum : viewSets[i]) {
+        batchFrustums.push_back(frustum);
+      }
+    }
+
+    if (!batchFrustums.empty()) {
+      this->updateView(batchFrustums, 0.0f);
+      while (this->_pTilesetContentManager->getNumberOfTilesLoading() > 0) {
+        this->_externals.pAssetAccessor->tick();
+        this->updateView(batchFrustums, 0.0f);
+      }
+    }
+
+    // Now each view set's own selection is almost entirely loaded already.
+    for (size_t i = batchBegin; i < batchEnd; ++i) {
+      callback(i, this->updateViewOffline(viewSets[i]));
+    }
+  }
+}
+
 const ViewUpdateResult&
 Tileset::updateView(const std::vector<ViewState>& frustums, float deltaTime) {
   CESIUM_TRACE("Tileset::updateView");
+  static CesiumUtility::MetricHistogram& updateViewTime =
+      CesiumUtility::MetricsRegistry::getDefault().histogram(
+          "tileset.updateViewMicroseconds");
+  CesiumUtility::ScopedMetricTimer timer(updateViewTime);
+
   // Fixup TilesetOptions to ensure lod transitions works correctly.
   _options.enableFrustumCulling =
       _options.enableFrustumCulling && !_options.enableLodTransitionPeriod;
@@ -680,7 +736,7 @@ void computeDistances(
       frustums.begin(),
       frustums.end(),
       distances.begin(),
-      [boundingVolume](const ViewState& frustum) -> double {
+      [&boundingVolume](const ViewState& frustum) -> double {
         return glm::sqrt(glm::max(
             frustum.computeDistanceSquaredToBoundingVolume(boundingVolume),
             0.0));
@@ -1392,6 +1448,7 @@ Tileset::TraversalDetails Tileset::_visitVisibleChildrenNearToFar(
 void Tileset::_processLoadQueue() {
   CESIUM_TRACE("Tileset::_processLoadQueue");
 
+  this->_processRasterOverlayLoadQueue();
   this->processQueue(
       this->_loadQueueHigh,
       static_cast<int32_t>(this->_options.maximumSimultaneousTileLoads));
@@ -1403,6 +1460,33 @@ void Tileset::_processLoadQueue() {
       static_cast<int32_t>(this->_options.maximumSimultaneousTileLoads));
 }
 
+void Tileset::_processRasterOverlayLoadQueue() {
+  CESIUM_TRACE("Tileset::_processRasterOverlayLoadQueue");
+
+  // Raster overlay tiles load in the same order as the geometry tiles they are
+  // draped on: the high priority queue first, and each queue by priority. The
+  // priorities of different queues aren't comparable, so each raster overlay
+  // tile is given the rank of its geometry tile in that order instead.
+  double rank = 0.0;
+  for (std::vector<LoadRecord>* pQueue :
+       {&this->_loadQueueHigh, &this->_loadQueueMedium, &this->_loadQueueLow}) {
+    std::sort(pQueue->begin(), pQueue->end());
+    for (const LoadRecord& record : *pQueue) {
+      for (RasterMappedTo3DTile& mapped :
+           record.pTile->getMappedRasterTiles()) {
+        mapped.queueLoad(rank);
+      }
+      rank += 1.0;
+    }
+  }
+
+  const RasterOverlayCollection& overlayCollection =
+      this->_pTilesetContentManager->getRasterOverlayCollection();
+  for (const auto& pTileProvider : overlayCollection.getTileProviders()) {
+    pTileProvider->processTileLoadQueue();
+  }
+}
+
 void Tileset::_unloadCachedTiles(double timeBudget) noexcept {
   const int64_t maxBytes = this->getOptions().maximumCachedBytes;
 
@@ -12,17 +12,50 @@
 #include <Cesium3DTilesSelection/RasterOverlayTileProvider.h>
 #include <CesiumAsync/IAssetRequest.h>
 #include <CesiumAsync/IAssetResponse.h>
+#include <CesiumGeospatial/Transforms.h>
 #include <CesiumGltfReader/GltfReader.h>
 #include <CesiumUtility/IntrusivePointer.h>
+#include <CesiumUtility/Metrics.h>
 #include <CesiumUtility/joinToString.h>
 
 #include <rapidjson/document.h>
 #include <spdlog/logger.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <limits>
 
 namespace Cesium3DTilesSelection {
 namespace {
+struct TilesetMetrics {
+  CesiumUtility::MetricGauge& tilesLoading;
+  CesiumUtility::MetricGauge& tileDataBytes;
+  CesiumUtility::MetricHistogram& loadTimeMicroseconds;
+  CesiumUtility::MetricHistogram& fetchTimeMicroseconds;
+  CesiumUtility::MetricHistogram& mainThreadLoadingMicroseconds;
+  CesiumUtility::MetricCounter& mainThreadBudgetExceeded;
+};
+
+const TilesetMetrics& getMetrics() {
+  CesiumUtility::MetricsRegistry& registry =
+      CesiumUtility::MetricsRegistry::getDefault();
+  static const TilesetMetrics metrics{
+      registry.gauge("tileset.tilesLoading"),
+      registry.gauge("tileset.tileDataBytes"),
+      registry.histogram("tileset.tileLoadMicroseconds"),
+      registry.histogram("tileset.tileFetchMicroseconds"),
+      registry.histogram("tileset.mainThreadLoadingMicroseconds"),
+      registry.counter("tileset.mainThreadBudgetExceeded")};
+  return metrics;
+}
+
+int64_t microsecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
 struct RegionAndCenter {
   CesiumGeospatial::BoundingRegion region;
   CesiumGeospatial::Cartographic center;
@@ -103,7 +136,7 @@ getTileBoundingRegionForUpsampling(const Tile& parent) {
   for (const RasterMappedTo3DTile& mapped : parent.getMappedRasterTiles()) {
     if (mapped.isMoreDetailAvailable()) {
       const CesiumGeospatial::Projection& projection =
-          mapped.getReadyTile()->getTileProvider().getProjection();
+          mapped.getReadyTile()->getTileProvider().getTileProjection();
       glm::dvec2 centerProjected =
           details.findRectangleForOverlayProjection(projection)->getCenter();
       CesiumGeospatial::Cartographic center =
@@ -448,6 +481,178 @@ void calcFittestBoundingRegionForLooseTile(
   }
 }
 
+// Finds the axes to fit a box to content along, and the volume of the given
+// bounding volume. Only boxes and spheres are supported.
+bool computeFitAxesAndVolume(
+    const BoundingVolume& boundingVolume,
+    glm::dmat3& axes,
+    double& volume) {
+  if (const auto* pBox =
+          std::get_if<CesiumGeometry::OrientedBoundingBox>(&boundingVolume)) {
+    // Keep the orientation of the authored box, which is usually a good fit
+    // for the content.
+    const glm::dmat3& halfAxes = pBox->getHalfAxes();
+    const glm::dvec3 lengths(
+        glm::length(halfAxes[0]),
+        glm::length(halfAxes[1]),
+        glm::length(halfAxes[2]));
+    if (lengths.x <= 0.0 || lengths.y <= 0.0 || lengths.z <= 0.0) {
+      return false;
+    }
+    axes = glm::dmat3(
+        halfAxes[0] / lengths.x,
+        halfAxes[1] / lengths.y,
+        halfAxes[2] / lengths.z);
+    volume = 8.0 * lengths.x * lengths.y * lengths.z;
+    return true;
+  }
+
+  if (const auto* pSphere =
+          std::get_if<CesiumGeometry::BoundingSphere>(&boundingVolume)) {
+    // Align the box with the local horizon at the center of the sphere.
+    axes = glm::dmat3(CesiumGeospatial::Transforms::eastNorthUpToFixedFrame(
+        pSphere->getCenter()));
+    const double radius = pSphere->getRadius();
+    volume = 4.0 / 3.0 * CesiumUtility::Math::OnePi * radius * radius * radius;
+    return true;
+  }
+
+  return false;
+}
+
+// Expands the range of the projections onto each of the given unit axes to
+// include the bounding volume. Returns false for a region with loose fitting
+// heights, which may not contain its content.
+bool expandAlongAxes(
+    const BoundingVolume& boundingVolume,
+    const glm::dmat3& axes,
+    glm::dvec3& minimum,
+    glm::dvec3& maximum) {
+  if (const auto* pSphere =
+          std::get_if<CesiumGeometry::BoundingSphere>(&boundingVolume)) {
+    const glm::dvec3 center = glm::transpose(axes) * pSphere->getCenter();
+    minimum = glm::min(minimum, center - pSphere->getRadius());
+    maximum = glm::max(maximum, center + pSphere->getRadius());
+    return true;
+  }
+
+  CesiumGeometry::OrientedBoundingBox box(glm::dvec3(0.0), glm::dmat3(0.0));
+  if (const auto* pBox =
+          std::get_if<CesiumGeometry::OrientedBoundingBox>(&boundingVolume)) {
+    box = *pBox;
+  } else if (
+      const auto* pRegion =
+          std::get_if<CesiumGeospatial::BoundingRegion>(&boundingVolume)) {
+    box = pRegion->getBoundingBox();
+  } else if (
+      const auto* pS2Cell =
+          std::get_if<CesiumGeospatial::S2CellBoundingVolume>(
+              &boundingVolume)) {
+    box = pS2Cell->computeBoundingRegion().getBoundingBox();
+  } else {
+    return false;
+  }
+
+  const glm::dvec3 center = glm::transpose(axes) * box.getCenter();
+  const glm::dmat3 halfAxes = glm::transpose(axes) * box.getHalfAxes();
+  const glm::dvec3 halfExtents =
+      glm::abs(halfAxes[0]) + glm::abs(halfAxes[1]) + glm::abs(halfAxes[2]);
+  minimum = glm::min(minimum, center - halfExtents);
+  maximum = glm::max(maximum, center + halfExtents);
+  return true;
+}
+
+double computeBoxVolume(const CesiumGeometry::OrientedBoundingBox& box) {
+  const glm::dmat3& halfAxes = box.getHalfAxes();
+  return 8.0 * glm::length(halfAxes[0]) * glm::length(halfAxes[1]) *
+         glm::length(halfAxes[2]);
+}
+
+void calcTightBoundingVolume(
+    TileLoadResult& result,
+    const TileContentLoadInfo& tileLoadInfo) {
+  const CesiumGltf::Model& model =
+      std::get<CesiumGltf::Model>(result.contentKind);
+
+  // Only boxes and spheres are tightened. Regions are also used to map raster
+  // overlays and upsample tiles, so they need to stay regions, and loose
+  // regions have already been fit to the content above.
+  const BoundingVolume boundingVolume = getEffectiveBoundingVolume(
+      tileLoadInfo.tileBoundingVolume,
+      result.updatedBoundingVolume,
+      result.updatedContentBoundingVolume);
+
+  glm::dmat3 axes;
+  double volume;
+  if (!computeFitAxesAndVolume(boundingVolume, axes, volume)) {
+    return;
+  }
+
+  std::optional<CesiumGeometry::OrientedBoundingBox> maybeContentBox =
+      GltfUtilities::computeBoundingBox(
+          model,
+          tileLoadInfo.tileTransform,
+          axes);
+  if (!maybeContentBox) {
+    return;
+  }
+
+  // The content bounding volume only has to contain this tile's own content,
+  // so the fitted box can always replace a larger one.
+  const BoundingVolume& contentBoundingVolume =
+      getEffectiveContentBoundingVolume(
+          tileLoadInfo.tileBoundingVolume,
+          tileLoadInfo.tileContentBoundingVolume,
+          result.updatedBoundingVolume,
+          result.updatedContentBoundingVolume);
+  glm::dmat3 contentAxes;
+  double contentVolume;
+  if (computeFitAxesAndVolume(
+          contentBoundingVolume,
+          contentAxes,
+          contentVolume) &&
+      computeBoxVolume(*maybeContentBox) < contentVolume) {
+    result.updatedContentBoundingVolume = *maybeContentBox;
+  }
+
+  // The tile's bounding volume must also contain the content of all of its
+  // descendants, which is only known to be inside the bounding volumes of its
+  // children. So the tile's box is fit around the content and the children's
+  // bounding volumes. It is left alone if the children aren't known yet, or
+  // if any of them has loose fitting heights.
+  glm::dvec3 minimum(std::numeric_limits<double>::max());
+  glm::dvec3 maximum(std::numeric_limits<double>::lowest());
+  expandAlongAxes(*maybeContentBox, axes, minimum, maximum);
+  bool childrenBounded = !tileLoadInfo.tileChildBoundingVolumes.empty();
+  for (const BoundingVolume& childBoundingVolume :
+       tileLoadInfo.tileChildBoundingVolumes) {
+    if (!expandAlongAxes(childBoundingVolume, axes, minimum, maximum)) {
+      childrenBounded = false;
+      break;
+    }
+  }
+
+  if (childrenBounded) {
+    const glm::dvec3 center = axes * ((minimum + maximum) * 0.5);
+    const glm::dvec3 halfExtents = (maximum - minimum) * 0.5;
+    const CesiumGeometry::OrientedBoundingBox tileBox(
+        center,
+        glm::dmat3(
+            axes[0] * halfExtents.x,
+            axes[1] * halfExtents.y,
+            axes[2] * halfExtents.z));
+    if (computeBoxVolume(tileBox) < volume) {
+      result.updatedBoundingVolume = tileBox;
+    }
+  }
+
+  if (result.updatedContentBoundingVolume && !result.updatedBoundingVolume) {
+    // An updated content bounding volume must come with an updated tile
+    // bounding volume.
+    result.updatedBoundingVolume = boundingVolume;
+  }
+}
+
 void postProcessGltfInWorkerThread(
     TileLoadResult& result,
     std::vector<CesiumGeospatial::Projection>&& projections,
@@ -472,6 +677,11 @@ void postProcessGltfInWorkerThread(
   // If our tile bounding region has loose fitting heights, find the real ones.
   calcFittestBoundingRegionForLooseTile(result, tileLoadInfo);
 
+  // Replace a loose box or sphere with one that fits the content.
+  if (tileLoadInfo.contentOptions.computeTightBoundingVolumes) {
+    calcTightBoundingVolume(result, tileLoadInfo);
+  }
+
   // generate missing smooth normal
   if (tileLoadInfo.contentOptions.generateMissingNormalsSmooth) {
     model.generateMissingNormalsSmooth();
@@ -503,6 +713,7 @@ postProcessContentInWorkerThread(
   CesiumGltfReader::GltfReaderOptions gltfOptions;
   gltfOptions.ktx2TranscodeTargets =
       tileLoadInfo.contentOptions.ktx2TranscodeTargets;
+  gltfOptions.maximumImageDimension = tileLoadInfo.maximumImageDimension;
 
   auto asyncSystem = tileLoadInfo.asyncSystem;
   auto pAssetAccessor = tileLoadInfo.pAssetAccessor;
@@ -572,6 +783,94 @@ postProcessContentInWorkerThread(
                 rendererOptions);
           });
 }
+
+CesiumAsync::Future<TileLoadResultAndRenderResources>
+addRasterOverlayProjectionsInWorkerThread(
+    TileLoadResult&& result,
+    std::vector<CesiumGeospatial::Projection>&& projections,
+    TileContentLoadInfo&& tileLoadInfo,
+    const std::any& rendererOptions) {
+  CESIUM_TRACE("addRasterOverlayProjectionsInWorkerThread");
+
+  // The existing texture coordinates are kept, so the indices of the overlays
+  // that are already attached don't change.
+  calcRasterOverlayDetailsInWorkerThread(
+      result,
+      std::move(projections),
+      tileLoadInfo);
+
+  return tileLoadInfo.pPrepareRendererResources->prepareInLoadThread(
+      tileLoadInfo.asyncSystem,
+      std::move(result),
+      tileLoadInfo.tileTransform,
+      rendererOptions);
+}
+
+bool isUpsamplingChildren(const Tile& tile) noexcept {
+  for (const Tile& child : tile.getChildren()) {
+    if (child.getState() == TileLoadState::ContentLoading &&
+        std::holds_alternative<CesiumGeometry::UpsampledQuadtreeNode>(
+            child.getTileID())) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+double computeBoundingVolumeRadius(const BoundingVolume& boundingVolume) {
+  struct Operation {
+    double operator()(const CesiumGeometry::OrientedBoundingBox& box) {
+      return 0.5 * glm::length(box.getLengths());
+    }
+
+    double operator()(const CesiumGeospatial::BoundingRegion& region) {
+      return (*this)(region.getBoundingBox());
+    }
+
+    double operator()(const CesiumGeometry::BoundingSphere& sphere) noexcept {
+      return sphere.getRadius();
+    }
+
+    double operator()(
+        const CesiumGeospatial::BoundingRegionWithLooseFittingHeights&
+            region) {
+      return (*this)(region.getBoundingRegion());
+    }
+
+    double operator()(const CesiumGeospatial::S2CellBoundingVolume& s2Cell) {
+      return (*this)(s2Cell.computeBoundingRegion());
+    }
+  };
+
+  return std::visit(Operation{}, boundingVolume);
+}
+
+// A tile that is refined by replacement is only displayed until its
+// screen-space error exceeds the maximum, so it never covers more pixels than
+// its diameter at the pixels per meter of that error. Its images are allowed
+// twice that size, because they are not spread evenly over the tile. Returns
+// 0 if the images of the tile's content should not be limited.
+int32_t computeMaximumImageDimension(
+    const Tile& tile,
+    const TilesetOptions& tilesetOptions) {
+  if (!tilesetOptions.contentOptions.limitImageResolutionToScreenSize ||
+      tile.getRefine() != TileRefine::Replace || tile.getChildren().empty() ||
+      tile.getGeometricError() <= 0.0) {
+    return 0;
+  }
+
+  const double pixelsPerMeter =
+      tilesetOptions.maximumScreenSpaceError / tile.getGeometricError();
+  const double diameter =
+      2.0 * computeBoundingVolumeRadius(tile.getBoundingVolume());
+  const double maximumDimension = std::ceil(2.0 * diameter * pixelsPerMeter);
+  if (!(maximumDimension < double(std::numeric_limits<int32_t>::max()))) {
+    return 0;
+  }
+
+  return std::max(int32_t(maximumDimension), 1);
+}
 } // namespace
 
 TilesetContentManager::TilesetContentManager(
@@ -596,6 +895,8 @@ TilesetContentManager::TilesetContentManager(
       _tilesLoadOnProgress{0},
       _loadedTilesCount{0},
       _tilesDataUsed{0},
+      _rasterOverlayProjectionUpdates{},
+      _lastRasterOverlayProjectionUpdateID{0},
       _destructionCompletePromise{externals.asyncSystem.createPromise<void>()},
       _destructionCompleteFuture{
           this->_destructionCompletePromise.getFuture().share()} {}
@@ -620,6 +921,8 @@ TilesetContentManager::TilesetContentManager(
       _tilesLoadOnProgress{0},
       _loadedTilesCount{0},
       _tilesDataUsed{0},
+      _rasterOverlayProjectionUpdates{},
+      _lastRasterOverlayProjectionUpdateID{0},
       _destructionCompletePromise{externals.asyncSystem.createPromise<void>()},
       _destructionCompleteFuture{
           this->_destructionCompletePromise.getFuture().share()} {
@@ -755,6 +1058,8 @@ TilesetContentManager::TilesetContentManager(
       _tilesLoadOnProgress{0},
       _loadedTilesCount{0},
       _tilesDataUsed{0},
+      _rasterOverlayProjectionUpdates{},
+      _lastRasterOverlayProjectionUpdateID{0},
       _destructionCompletePromise{externals.asyncSystem.createPromise<void>()},
       _destructionCompleteFuture{
           this->_destructionCompletePromise.getFuture().share()} {
@@ -829,12 +1134,8 @@ void TilesetContentManager::loadTileContent(
 
   if (tile.getState() != TileLoadState::Unloaded &&
       tile.getState() != TileLoadState::FailedTemporarily) {
-    // No need to load geometry, but give previously-throttled
-    // raster overlay tiles a chance to load.
-    for (RasterMappedTo3DTile& rasterTile : tile.getMappedRasterTiles()) {
-      rasterTile.loadThrottled();
-    }
-
+    // No need to load geometry. Previously-throttled raster overlay tiles are
+    // loaded in priority order by RasterMappedTo3DTile::queueLoad.
     return;
   }
 
@@ -880,6 +1181,8 @@ void TilesetContentManager::loadTileContent(
       this->_externals.pLogger,
       tilesetOptions.contentOptions,
       tile};
+  tileLoadInfo.maximumImageDimension =
+      computeMaximumImageDimension(tile, tilesetOptions);
 
   TilesetContentLoader* pLoader;
   if (tile.getLoader() == &this->_upsampler) {
@@ -895,15 +1198,22 @@ void TilesetContentManager::loadTileContent(
       this->_externals.pAssetAccessor,
       this->_externals.pLogger,
       this->_requestHeaders};
+  loadInput.maximumImageDimension = tileLoadInfo.maximumImageDimension;
 
   // Keep the manager alive while the load is in progress.
   CesiumUtility::IntrusivePointer<TilesetContentManager> thiz = this;
 
+  const std::chrono::steady_clock::time_point loadStart =
+      std::chrono::steady_clock::now();
+
   pLoader->loadTileContent(loadInput)
       .thenImmediately([tileLoadInfo = std::move(tileLoadInfo),
                         projections = std::move(projections),
-                        rendererOptions = tilesetOptions.rendererOptions](
-                           TileLoadResult&& result) mutable {
+                        rendererOptions = tilesetOptions.rendererOptions,
+                        loadStart](TileLoadResult&& result) mutable {
+        getMetrics().fetchTimeMicroseconds.record(
+            microsecondsSince(loadStart));
+
         // the reason we run immediate continuation, instead of in the
         // worker thread, is that the loader may run the task in the main
         // thread. And most often than not, those main thread task is very
@@ -932,10 +1242,12 @@ void TilesetContentManager::loadTileContent(
             .createResolvedFuture<TileLoadResultAndRenderResources>(
                 {std::move(result), nullptr});
       })
-      .thenInMainThread([&tile, thiz](TileLoadResultAndRenderResources&& pair) {
+      .thenInMainThread([&tile, thiz, loadStart](
+                            TileLoadResultAndRenderResources&& pair) {
         setTileContent(tile, std::move(pair.result), pair.pRenderResources);
 
         thiz->notifyTileDoneLoading(&tile);
+        getMetrics().loadTimeMicroseconds.record(microsecondsSince(loadStart));
       })
       .catchInMainThread([pLogger = this->_externals.pLogger, &tile, thiz](
                              std::exception&& e) {
@@ -993,6 +1305,10 @@ bool TilesetContentManager::unloadTileContent(Tile& tile) {
     return false;
   }
 
+  // Texture coordinates still being added to the model are for content that is
+  // going away, so they will be discarded when they are ready.
+  this->_rasterOverlayProjectionUpdates.erase(&tile);
+
   // Unload the renderer resources and clear any raster overlay tiles. We can do
   // this even if the tile can't be fully unloaded because this tile's geometry
   // is being using by an async upsample operation (checked below).
@@ -1010,17 +1326,13 @@ bool TilesetContentManager::unloadTileContent(Tile& tile) {
   tile.getMappedRasterTiles().clear();
 
   // Are any children currently being upsampled from this tile?
-  for (const Tile& child : tile.getChildren()) {
-    if (child.getState() == TileLoadState::ContentLoading &&
-        std::holds_alternative<CesiumGeometry::UpsampledQuadtreeNode>(
-            child.getTileID())) {
-      // Yes, a child is upsampling from this tile, so it may be using the
-      // tile's content from another thread via lambda capture. We can't unload
-      // it right now. So mark the tile as in the process of unloading and stop
-      // here.
-      tile.setState(TileLoadState::Unloading);
-      return false;
-    }
+  if (isUpsamplingChildren(tile)) {
+    // Yes, a child is upsampling from this tile, so it may be using the
+    // tile's content from another thread via lambda capture. We can't unload
+    // it right now. So mark the tile as in the process of unloading and stop
+    // here.
+    tile.setState(TileLoadState::Unloading);
+    return false;
   }
 
   // If we make it this far, the tile's content will be fully unloaded.
@@ -1139,6 +1451,10 @@ void TilesetContentManager::tickMainThreadLoading(
 
   std::sort(this->_finishLoadingQueue.begin(), this->_finishLoadingQueue.end());
 
+  const TilesetMetrics& metrics = getMetrics();
+  CesiumUtility::ScopedMetricTimer timer(
+      metrics.mainThreadLoadingMicroseconds);
+
   auto start = std::chrono::system_clock::now();
   auto end =
       start + std::chrono::milliseconds(static_cast<long long>(timeBudget));
@@ -1146,6 +1462,7 @@ void TilesetContentManager::tickMainThreadLoading(
     finishLoading(*task.pTile, tilesetOptions);
     auto time = std::chrono::system_clock::now();
     if (time >= end) {
+      metrics.mainThreadBudgetExceeded.increment();
       break;
     }
   }
@@ -1300,9 +1617,14 @@ void TilesetContentManager::updateDoneState(
   if (pRenderContent) {
     bool moreRasterDetailAvailable = false;
     bool skippedUnknown = false;
+    std::vector<CesiumGeospatial::Projection> missingProjections;
     std::vector<RasterMappedTo3DTile>& rasterTiles =
         tile.getMappedRasterTiles();
-    for (size_t i = 0; i < rasterTiles.size(); ++i) {
+
+    // Mappings that replace placeholders are added to the end, and are updated
+    // on the next pass.
+    size_t mappedCount = rasterTiles.size();
+    for (size_t i = 0; i < mappedCount; ++i) {
       RasterMappedTo3DTile& mappedRasterTile = rasterTiles[i];
 
       RasterOverlayTile* pLoadingTile = mappedRasterTile.getLoadingTile();
@@ -1323,25 +1645,17 @@ void TilesetContentManager::updateDoneState(
               static_cast<std::vector<RasterMappedTo3DTile>::difference_type>(
                   i));
           --i;
+          --mappedCount;
 
-          // Add a new mapping.
-          std::vector<CesiumGeospatial::Projection> missingProjections;
+          // Add a new mapping. If the mesh doesn't have texture coordinates
+          // for this overlay's projection, the mapping stays a placeholder
+          // until they are added below.
           RasterMappedTo3DTile::mapOverlayToTile(
               tilesetOptions.maximumScreenSpaceError,
               *pProvider,
               *pPlaceholder,
               tile,
               missingProjections);
-
-          if (!missingProjections.empty()) {
-            // The mesh doesn't have the right texture coordinates for this
-            // overlay's projection, so we need to kick it back to the unloaded
-            // state to fix that.
-            // In the future, we could add the ability to add the required
-            // texture coordinates without starting over from scratch.
-            unloadTileContent(tile);
-            return;
-          }
         }
 
         continue;
@@ -1362,6 +1676,15 @@ void TilesetContentManager::updateDoneState(
           moreDetailAvailable == RasterOverlayTile::MoreDetailAvailable::Yes;
     }
 
+    if (!missingProjections.empty()) {
+      // The mesh was loaded before these overlays' projections were needed.
+      // Add their texture coordinates without reloading the tile.
+      addRasterOverlayProjections(
+          tile,
+          std::move(missingProjections),
+          tilesetOptions);
+    }
+
     // If this tile still has no children after it's done loading, but it does
     // have raster tiles that are not the most detailed available, create fake
     // children to hang more detailed rasters on by subdividing this tile.
@@ -1377,6 +1700,177 @@ void TilesetContentManager::updateDoneState(
   }
 }
 
+void TilesetContentManager::addRasterOverlayProjections(
+    Tile& tile,
+    std::vector<CesiumGeospatial::Projection>&& projections,
+    const TilesetOptions& tilesetOptions) {
+  if (this->_rasterOverlayProjectionUpdates.find(&tile) !=
+      this->_rasterOverlayProjectionUpdates.end()) {
+    // Texture coordinates are already being added to this tile. Projections
+    // that are still missing once they are ready will be added after that.
+    return;
+  }
+
+  const TileRenderContent* pRenderContent =
+      tile.getContent().getRenderContent();
+  assert(pRenderContent && "Tile must have render content to add overlays");
+
+  CESIUM_TRACE("TilesetContentManager::addRasterOverlayProjections");
+
+  const uint64_t updateID = ++this->_lastRasterOverlayProjectionUpdateID;
+  this->_rasterOverlayProjectionUpdates[&tile] = updateID;
+
+  // The tile keeps rendering its current model, and children may be upsampled
+  // from it, while the texture coordinates are added to a copy. The up axis is
+  // already recorded in the model's extras.
+  const RasterOverlayDetails& overlayDetails =
+      pRenderContent->getRasterOverlayDetails();
+  TileLoadResult result{
+      pRenderContent->getModel(),
+      CesiumGeometry::Axis::Y,
+      std::nullopt,
+      std::nullopt,
+      std::nullopt,
+      nullptr,
+      {},
+      TileLoadResultState::Success};
+  if (!overlayDetails.rasterOverlayProjections.empty()) {
+    result.rasterOverlayDetails = overlayDetails;
+  }
+
+  notifyTileStartLoading(&tile);
+
+  TileContentLoadInfo tileLoadInfo{
+      this->_externals.asyncSystem,
+      this->_externals.pAssetAccessor,
+      this->_externals.pPrepareRendererResources,
+      this->_externals.pLogger,
+      tilesetOptions.contentOptions,
+      tile};
+
+  // Keep the manager alive while the texture coordinates are added.
+  CesiumUtility::IntrusivePointer<TilesetContentManager> thiz = this;
+
+  std::vector<CesiumGeospatial::Projection> requestedProjections = projections;
+  this->_externals.asyncSystem
+      .runInWorkerThread([result = std::move(result),
+                          projections = std::move(projections),
+                          tileLoadInfo = std::move(tileLoadInfo),
+                          rendererOptions =
+                              tilesetOptions.rendererOptions]() mutable {
+        return addRasterOverlayProjectionsInWorkerThread(
+            std::move(result),
+            std::move(projections),
+            std::move(tileLoadInfo),
+            rendererOptions);
+      })
+      .thenInMainThread(
+          [&tile,
+           thiz,
+           updateID,
+           requestedProjections = std::move(requestedProjections)](
+              TileLoadResultAndRenderResources&& pair) {
+            thiz->finishAddingRasterOverlayProjections(
+                tile,
+                updateID,
+                requestedProjections,
+                std::move(pair));
+          })
+      .catchInMainThread([pLogger = this->_externals.pLogger,
+                          &tile,
+                          thiz,
+                          updateID](std::exception&& e) {
+        // Don't try again until the tile is reloaded.
+        auto it = thiz->_rasterOverlayProjectionUpdates.find(&tile);
+        if (it != thiz->_rasterOverlayProjectionUpdates.end() &&
+            it->second == updateID) {
+          it->second = 0;
+        }
+
+        thiz->notifyTileDoneLoading(nullptr);
+        thiz->notifyTileUnloading(nullptr);
+        SPDLOG_LOGGER_ERROR(
+            pLogger,
+            "An unexpected error occurs when adding raster overlay texture "
+            "coordinates to a tile: {}",
+            e.what());
+      });
+}
+
+void TilesetContentManager::finishAddingRasterOverlayProjections(
+    Tile& tile,
+    uint64_t updateID,
+    const std::vector<CesiumGeospatial::Projection>& projections,
+    TileLoadResultAndRenderResources&& pair) {
+  auto it = this->_rasterOverlayProjectionUpdates.find(&tile);
+  TileRenderContent* pRenderContent = tile.getContent().getRenderContent();
+  const bool isCurrent = it != this->_rasterOverlayProjectionUpdates.end() &&
+                         it->second == updateID &&
+                         tile.getState() == TileLoadState::Done &&
+                         pRenderContent != nullptr;
+
+  // The model can't be replaced while a child is being upsampled from it in a
+  // worker thread. The projections will be found missing again on a later
+  // update, so try again then.
+  if (!isCurrent || isUpsamplingChildren(tile)) {
+    this->_externals.pPrepareRendererResources->free(
+        tile,
+        pair.pRenderResources,
+        nullptr);
+    if (isCurrent) {
+      this->_rasterOverlayProjectionUpdates.erase(it);
+    }
+
+    // The tile's content didn't change.
+    notifyTileDoneLoading(nullptr);
+    notifyTileUnloading(nullptr);
+    return;
+  }
+
+  // Overlay textures are attached to the renderer resources that are being
+  // replaced. They are attached to the new ones when the mapped raster tiles
+  // are next updated.
+  for (RasterMappedTo3DTile& mappedRasterTile : tile.getMappedRasterTiles()) {
+    mappedRasterTile.detachFromTile(
+        *this->_externals.pPrepareRendererResources,
+        tile);
+  }
+
+  notifyTileUnloading(&tile);
+  unloadDoneState(tile);
+
+  TileLoadResult& result = pair.result;
+  pRenderContent->setModel(
+      std::move(std::get<CesiumGltf::Model>(result.contentKind)));
+  if (result.rasterOverlayDetails) {
+    pRenderContent->setRasterOverlayDetails(
+        std::move(*result.rasterOverlayDetails));
+  }
+
+  pRenderContent->setRenderResources(
+      this->_externals.pPrepareRendererResources->prepareInMainThread(
+          tile,
+          pair.pRenderResources));
+  notifyTileDoneLoading(&tile);
+
+  // If texture coordinates couldn't be generated for a projection, don't try
+  // again until the tile is reloaded. Its overlay will not be drawn.
+  const RasterOverlayDetails& overlayDetails =
+      pRenderContent->getRasterOverlayDetails();
+  const bool allAdded = std::all_of(
+      projections.begin(),
+      projections.end(),
+      [&overlayDetails](const CesiumGeospatial::Projection& projection) {
+        return overlayDetails.findRectangleForOverlayProjection(projection) !=
+               nullptr;
+      });
+  if (allAdded) {
+    this->_rasterOverlayProjectionUpdates.erase(it);
+  } else {
+    it->second = 0;
+  }
+}
+
 void TilesetContentManager::unloadContentLoadedState(Tile& tile) {
   TileContent& content = tile.getContent();
   TileRenderContent* pRenderContent = content.getRenderContent();
@@ -1406,6 +1900,7 @@ void TilesetContentManager::unloadDoneState(Tile& tile) {
 void TilesetContentManager::notifyTileStartLoading(
     [[maybe_unused]] const Tile* pTile) noexcept {
   ++this->_tilesLoadOnProgress;
+  getMetrics().tilesLoading.add(1);
 }
 
 void TilesetContentManager::notifyTileDoneLoading(const Tile* pTile) noexcept {
@@ -1415,14 +1910,21 @@ void TilesetContentManager::notifyTileDoneLoading(const Tile* pTile) noexcept {
   --this->_tilesLoadOnProgress;
   ++this->_loadedTilesCount;
 
+  const TilesetMetrics& metrics = getMetrics();
+  metrics.tilesLoading.add(-1);
+
   if (pTile) {
-    this->_tilesDataUsed += pTile->computeByteSize();
+    const int64_t bytes = pTile->computeByteSize();
+    this->_tilesDataUsed += bytes;
+    metrics.tileDataBytes.add(bytes);
   }
 }
 
 void TilesetContentManager::notifyTileUnloading(const Tile* pTile) noexcept {
   if (pTile) {
-    this->_tilesDataUsed -= pTile->computeByteSize();
+    const int64_t bytes = pTile->computeByteSize();
+    this->_tilesDataUsed -= bytes;
+    getMetrics().tileDataBytes.add(-bytes);
   }
 
   --this->_loadedTilesCount;
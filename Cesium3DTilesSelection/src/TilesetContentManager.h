@@ -4,6 +4,7 @@
 #include "TilesetContentLoaderResult.h"
 
 #include <Cesium3DTilesSelection/CreditSystem.h>
+#include <Cesium3DTilesSelection/IPrepareRendererResources.h>
 #include <Cesium3DTilesSelection/RasterOverlayCollection.h>
 #include <Cesium3DTilesSelection/Tile.h>
 #include <Cesium3DTilesSelection/TileContent.h>
@@ -14,6 +15,7 @@
 #include <CesiumAsync/IAssetAccessor.h>
 #include <CesiumUtility/ReferenceCountedNonThreadSafe.h>
 
+#include <unordered_map>
 #include <vector>
 
 namespace Cesium3DTilesSelection {
@@ -116,6 +118,17 @@ private:
 
   void finishLoading(Tile& tile, const TilesetOptions& tilesetOptions);
 
+  void addRasterOverlayProjections(
+      Tile& tile,
+      std::vector<CesiumGeospatial::Projection>&& projections,
+      const TilesetOptions& tilesetOptions);
+
+  void finishAddingRasterOverlayProjections(
+      Tile& tile,
+      uint64_t updateID,
+      const std::vector<CesiumGeospatial::Projection>& projections,
+      TileLoadResultAndRenderResources&& pair);
+
   void unloadContentLoadedState(Tile& tile);
 
   void unloadDoneState(Tile& tile);
@@ -162,6 +175,16 @@ private:
 
   std::vector<MainThreadLoadTask> _finishLoadingQueue;
 
+  /**
+   * @brief The tiles whose models are having texture coordinates added for
+   * more raster overlay projections, and the ID of that update.
+   *
+   * An ID of zero means the texture coordinates could not be added, so they
+   * aren't tried again until the tile is reloaded.
+   */
+  std::unordered_map<Tile*, uint64_t> _rasterOverlayProjectionUpdates;
+  uint64_t _lastRasterOverlayProjectionUpdateID;
+
   CesiumAsync::Promise<void> _destructionCompletePromise;
   CesiumAsync::SharedFuture<void> _destructionCompleteFuture;
 };
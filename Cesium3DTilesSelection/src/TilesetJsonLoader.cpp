@@ -778,6 +778,7 @@ TilesetJsonLoader::loadTileContent(const TileLoadInput& loadInput) {
       .thenInWorkerThread(
           [pLogger,
            contentOptions,
+           maximumImageDimension = loadInput.maximumImageDimension,
            tileTransform,
            tileRefine,
            upAxis = _upAxis,
@@ -818,6 +819,7 @@ TilesetJsonLoader::loadTileContent(const TileLoadInput& loadInput) {
               CesiumGltfReader::GltfReaderOptions gltfOptions;
               gltfOptions.ktx2TranscodeTargets =
                   contentOptions.ktx2TranscodeTargets;
+              gltfOptions.maximumImageDimension = maximumImageDimension;
               GltfConverterResult result = converter(responseData, gltfOptions);
 
               // Report any errors if there are any
@@ -14,6 +14,7 @@
 
 #include <cstddef>
 #include <iostream>
+#include <map>
 using namespace CesiumUtility;
 
 
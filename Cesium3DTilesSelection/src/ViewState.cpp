@@ -137,7 +137,10 @@ double ViewState::computeDistanceSquaredToBoundingVolume(
             viewState._positionCartographic.value(),
             viewState._position);
       }
-      return boundingRegion.computeDistanceSquaredToPosition(
+      // The camera is too close to the center of the ellipsoid to have a
+      // cartographic position, so don't try to compute one again for every
+      // tile. This is what the region would fall back to anyway.
+      return boundingRegion.getBoundingBox().computeDistanceSquaredToPosition(
           viewState._position);
     }
 
@@ -153,8 +156,9 @@ double ViewState::computeDistanceSquaredToBoundingVolume(
             viewState._positionCartographic.value(),
             viewState._position);
       }
-      return boundingRegion.computeConservativeDistanceSquaredToPosition(
-          viewState._position);
+      return boundingRegion.getBoundingRegion()
+          .getBoundingBox()
+          .computeDistanceSquaredToPosition(viewState._position);
     }
 
     double operator()(const S2CellBoundingVolume& s2Cell) noexcept {
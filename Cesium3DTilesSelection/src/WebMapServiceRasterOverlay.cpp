@@ -16,6 +16,7 @@
 #include <CesiumUtility/Uri.h>
 
 #include <cstddef>
+#include <map>
 #include <sstream>
 
 using namespace CesiumAsync;
@@ -1,6 +1,8 @@
 #include "B3dmToGltfConverter.h"
 #include "BinaryToGltfConverter.h"
 #include "CmptToGltfConverter.h"
+#include "I3dmToGltfConverter.h"
+#include "PntsToGltfConverter.h"
 
 #include <Cesium3DTilesSelection/GltfConverters.h>
 #include <Cesium3DTilesSelection/registerAllTileContentTypes.h>
@@ -11,6 +13,8 @@ void registerAllTileContentTypes() {
   GltfConverters::registerMagic("glTF", BinaryToGltfConverter::convert);
   GltfConverters::registerMagic("b3dm", B3dmToGltfConverter::convert);
   GltfConverters::registerMagic("cmpt", CmptToGltfConverter::convert);
+  GltfConverters::registerMagic("i3dm", I3dmToGltfConverter::convert);
+  GltfConverters::registerMagic("pnts", PntsToGltfConverter::convert);
 
   GltfConverters::registerFileExtension(
       ".gltf",
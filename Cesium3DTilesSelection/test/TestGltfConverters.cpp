@@ -0,0 +1,87 @@
+#include <Cesium3DTilesSelection/GltfConverters.h>
+#include <CesiumUtility/Metrics.h>
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Cesium3DTilesSelection;
+using namespace CesiumUtility;
+
+namespace {
+std::vector<std::byte> createContent(const std::string& value) {
+  std::vector<std::byte> result(value.size());
+  std::memcpy(result.data(), value.data(), value.size());
+  return result;
+}
+
+GltfConverterResult convertInner(
+    const gsl::span<const std::byte>&,
+    const CesiumGltfReader::GltfReaderOptions&) {
+  return GltfConverterResult{CesiumGltf::Model(), {}};
+}
+
+// Converts the content after its 8-byte header as an inner tile, like a
+// composite tile does.
+GltfConverterResult convertOuter(
+    const gsl::span<const std::byte>& content,
+    const CesiumGltfReader::GltfReaderOptions& options) {
+  return GltfConverters::convert(content.subspan(8), options);
+}
+} // namespace
+
+TEST_CASE("GltfConverters records metrics per format") {
+  GltfConverters::registerMagic("tst1", convertInner);
+  GltfConverters::registerMagic("tst2", convertOuter);
+  GltfConverters::registerFileExtension(".TST3", convertInner);
+
+  MetricsRegistry& registry = MetricsRegistry::getDefault();
+  MetricCounter& innerBytes = registry.counter("tileContent.tst1.bytesDecoded");
+  MetricHistogram& innerTime =
+      registry.histogram("tileContent.tst1.decodeMicroseconds");
+  MetricCounter& outerBytes = registry.counter("tileContent.tst2.bytesDecoded");
+  MetricHistogram& outerTime =
+      registry.histogram("tileContent.tst2.decodeMicroseconds");
+  MetricCounter& extensionBytes =
+      registry.counter("tileContent.tst3.bytesDecoded");
+
+  const int64_t innerBytesBefore = innerBytes.getValue();
+  const int64_t innerCountBefore = innerTime.getCount();
+  const int64_t outerBytesBefore = outerBytes.getValue();
+  const int64_t outerCountBefore = outerTime.getCount();
+  const int64_t extensionBytesBefore = extensionBytes.getValue();
+
+  SECTION("records the bytes and time of each conversion") {
+    const std::vector<std::byte> content = createContent("tst1 content");
+    GltfConverterResult result = GltfConverters::convert(content, {});
+    CHECK(result.model);
+
+    CHECK(innerBytes.getValue() - innerBytesBefore == int64_t(content.size()));
+    CHECK(innerTime.getCount() - innerCountBefore == 1);
+  }
+
+  SECTION("records conversions by file extension") {
+    const std::vector<std::byte> content = createContent("unknown");
+    GltfConverterResult result =
+        GltfConverters::convert("tile.tst3?v=1", content, {});
+    CHECK(result.model);
+
+    CHECK(
+        extensionBytes.getValue() - extensionBytesBefore ==
+        int64_t(content.size()));
+  }
+
+  SECTION("records only the outermost of nested conversions") {
+    const std::vector<std::byte> content =
+        createContent("tst2 hdrtst1 content");
+    GltfConverterResult result = GltfConverters::convert(content, {});
+    CHECK(result.model);
+
+    CHECK(outerBytes.getValue() - outerBytesBefore == int64_t(content.size()));
+    CHECK(outerTime.getCount() - outerCountBefore == 1);
+    CHECK(innerBytes.getValue() == innerBytesBefore);
+    CHECK(innerTime.getCount() == innerCountBefore);
+  }
+}
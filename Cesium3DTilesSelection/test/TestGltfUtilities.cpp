@@ -0,0 +1,96 @@
+#include <Cesium3DTilesSelection/GltfUtilities.h>
+#include <CesiumGeometry/Axis.h>
+#include <CesiumUtility/Math.h>
+
+#include <catch2/catch.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cstring>
+#include <vector>
+
+using namespace Cesium3DTilesSelection;
+using namespace CesiumGeometry;
+using namespace CesiumGltf;
+using namespace CesiumUtility;
+
+namespace {
+Model createModel(const std::vector<glm::vec3>& positions) {
+  Model model;
+  model.extras["gltfUpAxis"] = static_cast<int>(Axis::Z);
+
+  const size_t byteLength = positions.size() * sizeof(glm::vec3);
+  Buffer& buffer = model.buffers.emplace_back();
+  buffer.cesium.data.resize(byteLength);
+  std::memcpy(buffer.cesium.data.data(), positions.data(), byteLength);
+
+  BufferView& bufferView = model.bufferViews.emplace_back();
+  bufferView.buffer = 0;
+  bufferView.byteLength = static_cast<int64_t>(byteLength);
+
+  Accessor& accessor = model.accessors.emplace_back();
+  accessor.bufferView = 0;
+  accessor.count = static_cast<int64_t>(positions.size());
+  accessor.componentType = Accessor::ComponentType::FLOAT;
+  accessor.type = Accessor::Type::VEC3;
+
+  Mesh& mesh = model.meshes.emplace_back();
+  MeshPrimitive& primitive = mesh.primitives.emplace_back();
+  primitive.attributes["POSITION"] = 0;
+
+  return model;
+}
+} // namespace
+
+TEST_CASE("GltfUtilities::computeBoundingBox") {
+  const Model model = createModel(
+      {glm::vec3(1.0f, 2.0f, 3.0f),
+       glm::vec3(-3.0f, 0.0f, 1.0f),
+       glm::vec3(0.0f, -2.0f, 5.0f)});
+
+  SECTION("fits the positions along the given axes") {
+    const std::optional<OrientedBoundingBox> maybeBox =
+        GltfUtilities::computeBoundingBox(
+            model,
+            glm::translate(glm::dmat4(1.0), glm::dvec3(10.0, 0.0, 0.0)),
+            glm::dmat3(1.0));
+    REQUIRE(maybeBox);
+
+    const glm::dvec3& center = maybeBox->getCenter();
+    CHECK(Math::equalsEpsilon(center.x, 9.0, Math::Epsilon12));
+    CHECK(Math::equalsEpsilon(center.y, 0.0, Math::Epsilon12));
+    CHECK(Math::equalsEpsilon(center.z, 3.0, Math::Epsilon12));
+
+    const glm::dmat3& halfAxes = maybeBox->getHalfAxes();
+    CHECK(Math::equalsEpsilon(halfAxes[0].x, 2.0, Math::Epsilon12));
+    CHECK(Math::equalsEpsilon(halfAxes[1].y, 2.0, Math::Epsilon12));
+    CHECK(Math::equalsEpsilon(halfAxes[2].z, 2.0, Math::Epsilon12));
+  }
+
+  SECTION("keeps the orientation of rotated axes") {
+    // X and Y swapped, with Z flipped to keep the axes right-handed.
+    const glm::dmat3 axes(
+        glm::dvec3(0.0, 1.0, 0.0),
+        glm::dvec3(1.0, 0.0, 0.0),
+        glm::dvec3(0.0, 0.0, -1.0));
+    const std::optional<OrientedBoundingBox> maybeBox =
+        GltfUtilities::computeBoundingBox(model, glm::dmat4(1.0), axes);
+    REQUIRE(maybeBox);
+
+    const glm::dvec3& center = maybeBox->getCenter();
+    CHECK(Math::equalsEpsilon(center.x, -1.0, Math::Epsilon12));
+    CHECK(Math::equalsEpsilon(center.y, 0.0, Math::Epsilon12));
+    CHECK(Math::equalsEpsilon(center.z, 3.0, Math::Epsilon12));
+
+    const glm::dmat3& halfAxes = maybeBox->getHalfAxes();
+    CHECK(Math::equalsEpsilon(halfAxes[0].y, 2.0, Math::Epsilon12));
+    CHECK(Math::equalsEpsilon(halfAxes[1].x, 2.0, Math::Epsilon12));
+    CHECK(Math::equalsEpsilon(halfAxes[2].z, -2.0, Math::Epsilon12));
+  }
+
+  SECTION("returns nothing for a model without geometry") {
+    CHECK(!GltfUtilities::computeBoundingBox(
+        Model(),
+        glm::dmat4(1.0),
+        glm::dmat3(1.0)));
+  }
+}
@@ -0,0 +1,190 @@
+#include "HierarchicalDepthBuffer.h"
+
+#include <catch2/catch.hpp>
+
+using namespace Cesium3DTilesSelection;
+
+TEST_CASE("HierarchicalDepthBuffer") {
+  HierarchicalDepthBuffer depthBuffer(64, 32);
+  CHECK(depthBuffer.getWidth() == 64);
+  CHECK(depthBuffer.getHeight() == 32);
+
+  SECTION("hides nothing when empty") {
+    depthBuffer.buildHierarchy();
+    CHECK(!depthBuffer.isHidden(
+        glm::dvec2(-0.1, -0.1),
+        glm::dvec2(0.1, 0.1),
+        1000.0));
+  }
+
+  // A triangle covering the left half of the viewport at a depth of 10.
+  depthBuffer.rasterizeTriangle(
+      glm::dvec3(0.0, -3.0, 10.0),
+      glm::dvec3(0.0, 3.0, 10.0),
+      glm::dvec3(-3.0, 0.0, 10.0));
+  depthBuffer.buildHierarchy();
+
+  SECTION("hides rectangles behind the occluder") {
+    CHECK(depthBuffer.isHidden(
+        glm::dvec2(-0.9, -0.9),
+        glm::dvec2(-0.1, 0.9),
+        20.0));
+    CHECK(depthBuffer.isHidden(
+        glm::dvec2(-0.6, 0.2),
+        glm::dvec2(-0.5, 0.3),
+        20.0));
+  }
+
+  SECTION("does not hide rectangles in front of the occluder") {
+    CHECK(!depthBuffer.isHidden(
+        glm::dvec2(-0.9, -0.9),
+        glm::dvec2(-0.1, 0.9),
+        5.0));
+  }
+
+  SECTION("does not hide rectangles that extend past the occluder") {
+    CHECK(!depthBuffer.isHidden(
+        glm::dvec2(-0.5, -0.5),
+        glm::dvec2(0.2, 0.5),
+        20.0));
+    CHECK(!depthBuffer.isHidden(
+        glm::dvec2(0.2, -0.5),
+        glm::dvec2(0.5, 0.5),
+        20.0));
+  }
+
+  SECTION("does not hide rectangles outside the viewport") {
+    CHECK(!depthBuffer.isHidden(
+        glm::dvec2(-3.0, -0.5),
+        glm::dvec2(-2.0, 0.5),
+        20.0));
+  }
+
+  SECTION("uses the farthest vertex of a triangle") {
+    depthBuffer.clear();
+    depthBuffer.rasterizeTriangle(
+        glm::dvec3(-1.0, -1.0, 10.0),
+        glm::dvec3(1.0, -1.0, 10.0),
+        glm::dvec3(-1.0, 1.0, 30.0));
+    depthBuffer.buildHierarchy();
+
+    CHECK(!depthBuffer.isHidden(
+        glm::dvec2(-0.9, -0.9),
+        glm::dvec2(-0.8, -0.8),
+        20.0));
+    CHECK(depthBuffer.isHidden(
+        glm::dvec2(-0.9, -0.9),
+        glm::dvec2(-0.8, -0.8),
+        40.0));
+  }
+
+  SECTION("does not close gaps narrower than a texel") {
+    // A texel is 0.03125 wide. Split the occluder with a gap of 0.01 that
+    // runs through the middle of a column of texels.
+    depthBuffer.clear();
+    depthBuffer.rasterizeTriangle(
+        glm::dvec3(-0.505, -3.0, 10.0),
+        glm::dvec3(-0.505, 3.0, 10.0),
+        glm::dvec3(-3.5, 0.0, 10.0));
+    depthBuffer.rasterizeTriangle(
+        glm::dvec3(-0.495, -3.0, 10.0),
+        glm::dvec3(2.5, 0.0, 10.0),
+        glm::dvec3(-0.495, 3.0, 10.0));
+    depthBuffer.buildHierarchy();
+
+    CHECK(!depthBuffer.isHidden(
+        glm::dvec2(-0.6, -0.1),
+        glm::dvec2(-0.4, 0.1),
+        20.0));
+    CHECK(depthBuffer.isHidden(
+        glm::dvec2(-0.9, -0.1),
+        glm::dvec2(-0.7, 0.1),
+        20.0));
+  }
+
+  SECTION("does not hide behind texels that are only partly covered") {
+    depthBuffer.clear();
+
+    // A triangle that covers about half of a single texel.
+    depthBuffer.rasterizeTriangle(
+        glm::dvec3(0.0, 0.0, 10.0),
+        glm::dvec3(0.03125, 0.0, 10.0),
+        glm::dvec3(0.0, 0.0625, 10.0));
+    depthBuffer.buildHierarchy();
+
+    CHECK(!depthBuffer.isHidden(
+        glm::dvec2(0.001, 0.001),
+        glm::dvec2(0.002, 0.002),
+        20.0));
+  }
+
+  SECTION("combines the triangles of a finely tessellated mesh") {
+    // A square made of triangles much smaller than a texel.
+    const size_t cells = 100;
+    const double cellSize = 1.0 / double(cells);
+    const auto corner = [cellSize](size_t column, size_t row) {
+      return glm::dvec3(
+          -0.5 + double(column) * cellSize,
+          -0.5 + double(row) * cellSize,
+          10.0);
+    };
+
+    depthBuffer.clear();
+    depthBuffer.beginMesh();
+    for (size_t row = 0; row < cells; ++row) {
+      for (size_t column = 0; column < cells; ++column) {
+        const glm::dvec3 a = corner(column, row);
+        const glm::dvec3 b = corner(column + 1, row);
+        const glm::dvec3 c = corner(column + 1, row + 1);
+        const glm::dvec3 d = corner(column, row + 1);
+        depthBuffer.addTriangle(a, b, c);
+        depthBuffer.addTriangle(a, c, d);
+      }
+    }
+    depthBuffer.endMesh();
+    depthBuffer.buildHierarchy();
+
+    CHECK(depthBuffer.isHidden(
+        glm::dvec2(-0.4, -0.4),
+        glm::dvec2(0.4, 0.4),
+        20.0));
+    CHECK(!depthBuffer.isHidden(
+        glm::dvec2(-0.4, -0.4),
+        glm::dvec2(0.4, 0.4),
+        5.0));
+    CHECK(!depthBuffer.isHidden(
+        glm::dvec2(0.4, -0.4),
+        glm::dvec2(0.6, 0.4),
+        20.0));
+
+    // Each triangle on its own covers no texel entirely.
+    depthBuffer.clear();
+    for (size_t row = 0; row < cells; ++row) {
+      for (size_t column = 0; column < cells; ++column) {
+        depthBuffer.rasterizeTriangle(
+            corner(column, row),
+            corner(column + 1, row),
+            corner(column + 1, row + 1));
+        depthBuffer.rasterizeTriangle(
+            corner(column, row),
+            corner(column + 1, row + 1),
+            corner(column, row + 1));
+      }
+    }
+    depthBuffer.buildHierarchy();
+
+    CHECK(!depthBuffer.isHidden(
+        glm::dvec2(-0.1, -0.1),
+        glm::dvec2(0.1, 0.1),
+        20.0));
+  }
+
+  SECTION("clear removes occluders") {
+    depthBuffer.clear();
+    depthBuffer.buildHierarchy();
+    CHECK(!depthBuffer.isHidden(
+        glm::dvec2(-0.9, -0.9),
+        glm::dvec2(-0.1, 0.9),
+        20.0));
+  }
+}
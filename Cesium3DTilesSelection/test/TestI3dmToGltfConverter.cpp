@@ -0,0 +1,214 @@
+#include "I3dmToGltfConverter.h"
+
+#include <Cesium3DTilesSelection/GltfUtilities.h>
+#include <CesiumGltf/AccessorView.h>
+#include <CesiumGltf/ExtensionCesiumRTC.h>
+#include <CesiumGltf/ExtensionExtMeshGpuInstancing.h>
+#include <CesiumUtility/Math.h>
+
+#include <catch2/catch.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace CesiumGltf;
+using namespace Cesium3DTilesSelection;
+using namespace CesiumUtility;
+
+namespace {
+std::string padTo(std::string value, size_t headerLength, size_t alignment) {
+  while ((headerLength + value.size()) % alignment != 0) {
+    value += ' ';
+  }
+  return value;
+}
+
+// Creates a GLB with one mesh, which has the given positions if there are
+// any.
+std::vector<std::byte> createGlb(const std::vector<glm::vec3>& positions) {
+  const size_t binaryLength = positions.size() * sizeof(glm::vec3);
+  std::string meshJson = R"("meshes":[{"primitives":[{"attributes":{}}]}],)";
+  if (!positions.empty()) {
+    meshJson = R"("buffers":[{"byteLength":)" + std::to_string(binaryLength) +
+               R"(}],"bufferViews":[{"buffer":0,"byteLength":)" +
+               std::to_string(binaryLength) +
+               R"(}],"accessors":[{"bufferView":0,"componentType":5126,)"
+               R"("type":"VEC3","count":)" +
+               std::to_string(positions.size()) +
+               R"(}],"meshes":[{"primitives":[{"attributes":)"
+               R"({"POSITION":0}}]}],)";
+  }
+
+  const std::string json = padTo(
+      R"({"asset":{"version":"2.0"},)" + meshJson +
+          R"("nodes":[{"children":[1]},{"mesh":0}],)"
+          R"("scenes":[{"nodes":[0]}],"scene":0})",
+      0,
+      4);
+  const size_t binaryChunkLength = positions.empty() ? 0 : 8 + binaryLength;
+
+  const uint32_t header[5] = {
+      0,
+      2,
+      uint32_t(20 + json.size() + binaryChunkLength),
+      uint32_t(json.size()),
+      0x4E4F534A};
+
+  std::vector<std::byte> result(header[2]);
+  std::memcpy(result.data(), header, sizeof(header));
+  std::memcpy(result.data(), "glTF", 4);
+  std::memcpy(result.data() + 20, json.data(), json.size());
+  if (!positions.empty()) {
+    const uint32_t binaryHeader[2] = {uint32_t(binaryLength), 0x004E4942};
+    std::byte* pBinaryChunk = result.data() + 20 + json.size();
+    std::memcpy(pBinaryChunk, binaryHeader, sizeof(binaryHeader));
+    std::memcpy(pBinaryChunk + 8, positions.data(), binaryLength);
+  }
+  return result;
+}
+
+std::vector<std::byte> createI3dm(
+    const std::string& featureTableJson,
+    const std::vector<float>& featureTableBinary,
+    const std::vector<glm::vec3>& positions = {}) {
+  const std::string json = padTo(featureTableJson, 32, 8);
+  const size_t binaryLength = featureTableBinary.size() * sizeof(float);
+  const std::vector<std::byte> glb = createGlb(positions);
+
+  const uint32_t header[8] = {
+      0,
+      1,
+      uint32_t(32 + json.size() + binaryLength + glb.size()),
+      uint32_t(json.size()),
+      uint32_t(binaryLength),
+      0,
+      0,
+      1};
+
+  std::vector<std::byte> result(header[2]);
+  std::memcpy(result.data(), header, sizeof(header));
+  std::memcpy(result.data(), "i3dm", 4);
+  std::memcpy(result.data() + 32, json.data(), json.size());
+  std::memcpy(
+      result.data() + 32 + json.size(),
+      featureTableBinary.data(),
+      binaryLength);
+  std::memcpy(
+      result.data() + 32 + json.size() + binaryLength,
+      glb.data(),
+      glb.size());
+  return result;
+}
+} // namespace
+
+TEST_CASE("Converts instanced model to EXT_mesh_gpu_instancing") {
+  const std::vector<std::byte> i3dm = createI3dm(
+      R"({"INSTANCES_LENGTH":2,"RTC_CENTER":[10,20,30],)"
+      R"("POSITION":{"byteOffset":0},"SCALE":{"byteOffset":24}})",
+      {1.0f, 2.0f, 3.0f, -1.0f, 0.0f, 0.0f, 2.0f, 0.5f});
+
+  GltfConverterResult result = I3dmToGltfConverter::convert(i3dm, {});
+  REQUIRE(!result.errors);
+  REQUIRE(result.model);
+
+  const Model& gltf = *result.model;
+  const ExtensionCesiumRTC* pRtc = gltf.getExtension<ExtensionCesiumRTC>();
+  REQUIRE(pRtc);
+  CHECK(pRtc->center == std::vector<double>{10.0, 20.0, 30.0});
+
+  CHECK(
+      std::find(
+          gltf.extensionsRequired.begin(),
+          gltf.extensionsRequired.end(),
+          ExtensionExtMeshGpuInstancing::ExtensionName) !=
+      gltf.extensionsRequired.end());
+
+  // The default scene holds one instanced node per mesh node, with the mesh
+  // node's transform folded into the instance transforms.
+  const Scene& scene = gltf.scenes[size_t(gltf.scene)];
+  REQUIRE(scene.nodes.size() == 1);
+  const Node& node = gltf.nodes[size_t(scene.nodes[0])];
+  CHECK(node.mesh == 0);
+  CHECK(node.children.empty());
+
+  const ExtensionExtMeshGpuInstancing* pInstancing =
+      node.getExtension<ExtensionExtMeshGpuInstancing>();
+  REQUIRE(pInstancing);
+
+  // Instance translations are given Z-up, but applied inside the Y-up glTF.
+  AccessorView<glm::vec3> translations(
+      gltf,
+      pInstancing->attributes.at("TRANSLATION"));
+  REQUIRE(translations.size() == 2);
+  CHECK(translations[0] == glm::vec3(1.0f, 3.0f, -2.0f));
+  CHECK(translations[1] == glm::vec3(-1.0f, 0.0f, 0.0f));
+
+  AccessorView<glm::vec4> rotations(
+      gltf,
+      pInstancing->attributes.at("ROTATION"));
+  CHECK(rotations[0] == glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+  AccessorView<glm::vec3> scales(gltf, pInstancing->attributes.at("SCALE"));
+  CHECK(scales[0] == glm::vec3(2.0f));
+  CHECK(scales[1] == glm::vec3(0.5f));
+}
+
+TEST_CASE("Fits a bounding box to all instances of an instanced model") {
+  // A triangle in the Y-up glTF, which lies in the XZ plane once it is Z-up.
+  const std::vector<std::byte> i3dm = createI3dm(
+      R"({"INSTANCES_LENGTH":2,)"
+      R"("POSITION":{"byteOffset":0},"SCALE":{"byteOffset":24}})",
+      {100.0f, 0.0f, 0.0f, -100.0f, 0.0f, 0.0f, 1.0f, 2.0f},
+      {glm::vec3(-1.0f, 0.0f, 0.0f),
+       glm::vec3(1.0f, 0.0f, 0.0f),
+       glm::vec3(0.0f, 1.0f, 0.0f)});
+
+  GltfConverterResult result = I3dmToGltfConverter::convert(i3dm, {});
+  REQUIRE(!result.errors);
+  REQUIRE(result.model);
+
+  const std::optional<CesiumGeometry::OrientedBoundingBox> maybeBox =
+      GltfUtilities::computeBoundingBox(
+          *result.model,
+          glm::dmat4(1.0),
+          glm::dmat3(1.0));
+  REQUIRE(maybeBox);
+
+  // The instances span x from -102 to 101, and z from 0 to 2.
+  const glm::dvec3& center = maybeBox->getCenter();
+  CHECK(Math::equalsEpsilon(center.x, -0.5, 0.0, Math::Epsilon5));
+  CHECK(Math::equalsEpsilon(center.y, 0.0, 0.0, Math::Epsilon5));
+  CHECK(Math::equalsEpsilon(center.z, 1.0, 0.0, Math::Epsilon5));
+
+  const glm::dmat3& halfAxes = maybeBox->getHalfAxes();
+  CHECK(Math::equalsEpsilon(halfAxes[0].x, 101.5, 0.0, Math::Epsilon5));
+  CHECK(Math::equalsEpsilon(halfAxes[1].y, 0.0, 0.0, Math::Epsilon5));
+  CHECK(Math::equalsEpsilon(halfAxes[2].z, 1.0, 0.0, Math::Epsilon5));
+}
+
+TEST_CASE("Rejects instanced models without instance positions") {
+  const std::vector<std::byte> i3dm =
+      createI3dm(R"({"INSTANCES_LENGTH":1})", {});
+
+  GltfConverterResult result = I3dmToGltfConverter::convert(i3dm, {});
+  CHECK(result.errors.hasErrors());
+  CHECK(!result.model);
+}
+
+TEST_CASE("Rejects instanced models that reference an external glTF") {
+  std::vector<std::byte> i3dm =
+      createI3dm(R"({"INSTANCES_LENGTH":0})", {});
+
+  // Set gltfFormat to 0, so the glTF is interpreted as a URI.
+  const uint32_t gltfFormat = 0;
+  std::memcpy(i3dm.data() + 28, &gltfFormat, sizeof(gltfFormat));
+
+  GltfConverterResult result = I3dmToGltfConverter::convert(i3dm, {});
+  REQUIRE(result.errors.errors.size() == 1);
+  CHECK(result.errors.errors[0].find("external glTF") != std::string::npos);
+  CHECK(!result.model);
+}
@@ -15,6 +15,7 @@
 #include <catch2/catch.hpp>
 
 #include <filesystem>
+#include <map>
 
 using namespace Cesium3DTilesSelection;
 using namespace CesiumGeospatial;
@@ -0,0 +1,150 @@
+#include "PntsToGltfConverter.h"
+
+#include <CesiumGltf/AccessorView.h>
+#include <CesiumGltf/ExtensionCesiumRTC.h>
+#include <CesiumGltf/ExtensionKhrMaterialsUnlit.h>
+
+#include <catch2/catch.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace CesiumGltf;
+using namespace Cesium3DTilesSelection;
+
+namespace {
+std::vector<std::byte> createPnts(
+    std::string featureTableJson,
+    const std::vector<std::byte>& featureTableBinary) {
+  // The feature table binary must start on an 8-byte boundary.
+  while ((28 + featureTableJson.size()) % 8 != 0) {
+    featureTableJson += ' ';
+  }
+
+  const uint32_t header[7] = {
+      0,
+      1,
+      uint32_t(28 + featureTableJson.size() + featureTableBinary.size()),
+      uint32_t(featureTableJson.size()),
+      uint32_t(featureTableBinary.size()),
+      0,
+      0};
+
+  std::vector<std::byte> result(header[2]);
+  std::memcpy(result.data(), header, sizeof(header));
+  std::memcpy(result.data(), "pnts", 4);
+  std::memcpy(
+      result.data() + 28,
+      featureTableJson.data(),
+      featureTableJson.size());
+  std::memcpy(
+      result.data() + 28 + featureTableJson.size(),
+      featureTableBinary.data(),
+      featureTableBinary.size());
+  return result;
+}
+
+template <typename T>
+void append(std::vector<std::byte>& data, const std::vector<T>& values) {
+  const size_t offset = data.size();
+  data.resize(offset + values.size() * sizeof(T));
+  std::memcpy(data.data() + offset, values.data(), values.size() * sizeof(T));
+}
+} // namespace
+
+TEST_CASE("Converts quantized point cloud to glTF points") {
+  std::vector<std::byte> binary;
+  append<uint16_t>(binary, {0, 0, 0, 65535, 65535, 65535});
+  append<uint8_t>(binary, {255, 0, 0, 0, 0, 0});
+
+  const std::vector<std::byte> pnts = createPnts(
+      R"({"POINTS_LENGTH":2,)"
+      R"("POSITION_QUANTIZED":{"byteOffset":0},)"
+      R"("QUANTIZED_VOLUME_OFFSET":[100,200,300],)"
+      R"("QUANTIZED_VOLUME_SCALE":[10,20,30],)"
+      R"("RGB":{"byteOffset":12}})",
+      binary);
+
+  GltfConverterResult result = PntsToGltfConverter::convert(pnts, {});
+  REQUIRE(!result.errors);
+  REQUIRE(result.model);
+
+  const Model& gltf = *result.model;
+  REQUIRE(gltf.meshes.size() == 1);
+  const MeshPrimitive& primitive = gltf.meshes[0].primitives[0];
+  CHECK(primitive.mode == MeshPrimitive::Mode::POINTS);
+
+  // Positions are relative to the center of the quantized volume.
+  const ExtensionCesiumRTC* pRtc = gltf.getExtension<ExtensionCesiumRTC>();
+  REQUIRE(pRtc);
+  CHECK(pRtc->center == std::vector<double>{105.0, 210.0, 315.0});
+
+  AccessorView<glm::vec3> positions(gltf, primitive.attributes.at("POSITION"));
+  REQUIRE(positions.size() == 2);
+  CHECK(positions[0].x == Approx(-5.0f));
+  CHECK(positions[0].y == Approx(-10.0f));
+  CHECK(positions[0].z == Approx(-15.0f));
+  CHECK(positions[1].x == Approx(5.0f));
+  CHECK(positions[1].y == Approx(10.0f));
+  CHECK(positions[1].z == Approx(15.0f));
+
+  const Accessor& colorAccessor =
+      gltf.accessors[size_t(primitive.attributes.at("COLOR_0"))];
+  CHECK(colorAccessor.componentType == Accessor::ComponentType::UNSIGNED_SHORT);
+  CHECK(colorAccessor.normalized);
+  AccessorView<AccessorTypes::VEC3<uint16_t>> colors(
+      gltf,
+      primitive.attributes.at("COLOR_0"));
+  CHECK(colors[0].value[0] == 65535);
+  CHECK(colors[0].value[1] == 0);
+  CHECK(colors[1].value[0] == 0);
+
+  // Without normals, points are unlit.
+  CHECK(primitive.attributes.find("NORMAL") == primitive.attributes.end());
+  CHECK(gltf.materials[0].hasExtension<ExtensionKhrMaterialsUnlit>());
+}
+
+TEST_CASE("Decodes oct-encoded point cloud normals") {
+  std::vector<std::byte> binary;
+  append<float>(binary, {1.0f, 2.0f, 3.0f});
+  // (255, 128) decodes to approximately +X.
+  append<uint8_t>(binary, {255, 128});
+
+  const std::vector<std::byte> pnts = createPnts(
+      R"({"POINTS_LENGTH":1,"RTC_CENTER":[1,2,3],)"
+      R"("POSITION":{"byteOffset":0},)"
+      R"("NORMAL_OCT16P":{"byteOffset":12}})",
+      binary);
+
+  GltfConverterResult result = PntsToGltfConverter::convert(pnts, {});
+  REQUIRE(!result.errors);
+  REQUIRE(result.model);
+
+  const Model& gltf = *result.model;
+  const MeshPrimitive& primitive = gltf.meshes[0].primitives[0];
+
+  AccessorView<glm::vec3> positions(gltf, primitive.attributes.at("POSITION"));
+  CHECK(positions[0] == glm::vec3(1.0f, 2.0f, 3.0f));
+
+  AccessorView<glm::vec3> normals(gltf, primitive.attributes.at("NORMAL"));
+  REQUIRE(normals.size() == 1);
+  CHECK(normals[0].x == Approx(1.0f).epsilon(1e-2));
+  CHECK(normals[0].y == Approx(0.0f).margin(1e-2));
+  CHECK(normals[0].z == Approx(0.0f).margin(1e-2));
+  CHECK(!gltf.materials[0].hasExtension<ExtensionKhrMaterialsUnlit>());
+}
+
+TEST_CASE("Rejects point clouds whose properties don't fit") {
+  std::vector<std::byte> binary;
+  append<float>(binary, {1.0f, 2.0f, 3.0f});
+
+  const std::vector<std::byte> pnts = createPnts(
+      R"({"POINTS_LENGTH":2,"POSITION":{"byteOffset":0}})",
+      binary);
+
+  GltfConverterResult result = PntsToGltfConverter::convert(pnts, {});
+  CHECK(result.errors.hasErrors());
+  CHECK(!result.model);
+}
@@ -1,3 +1,4 @@
+#include "Cesium3DTilesSelection/CompositeRasterOverlay.h"
 #include "Cesium3DTilesSelection/QuadtreeRasterOverlayTileProvider.h"
 #include "Cesium3DTilesSelection/RasterOverlay.h"
 #include "SimpleAssetAccessor.h"
@@ -6,6 +7,8 @@
 
 #include <catch2/catch.hpp>
 
+#include <map>
+
 using namespace Cesium3DTilesSelection;
 using namespace CesiumAsync;
 using namespace CesiumGeometry;
@@ -50,8 +53,37 @@ public:
   // The tiles that will return an error from loadQuadtreeTileImage.
   std::vector<QuadtreeTileID> errorTiles;
 
+  // Whether loadQuadtreeTileImages loads its tiles with one request.
+  bool loadInBatches = false;
+
+  // The tiles requested by each call to loadQuadtreeTileImage, and by each
+  // batched call to loadQuadtreeTileImages.
+  mutable std::vector<QuadtreeTileID> singleRequests;
+  mutable std::vector<std::vector<QuadtreeTileID>> batchRequests;
+
   virtual CesiumAsync::Future<LoadedRasterOverlayImage>
   loadQuadtreeTileImage(const QuadtreeTileID& tileID) const {
+    singleRequests.emplace_back(tileID);
+    return this->getAsyncSystem().createResolvedFuture(createImage(tileID));
+  }
+
+  virtual CesiumAsync::Future<std::vector<LoadedRasterOverlayImage>>
+  loadQuadtreeTileImages(const std::vector<QuadtreeTileID>& tileIDs) const {
+    if (!loadInBatches) {
+      return QuadtreeRasterOverlayTileProvider::loadQuadtreeTileImages(
+          tileIDs);
+    }
+
+    batchRequests.emplace_back(tileIDs);
+    std::vector<LoadedRasterOverlayImage> results;
+    for (const QuadtreeTileID& tileID : tileIDs) {
+      results.emplace_back(createImage(tileID));
+    }
+    return this->getAsyncSystem().createResolvedFuture(std::move(results));
+  }
+
+private:
+  LoadedRasterOverlayImage createImage(const QuadtreeTileID& tileID) const {
     LoadedRasterOverlayImage result;
     result.rectangle = this->getTilingScheme().tileToRectangle(tileID);
 
@@ -71,7 +103,7 @@ public:
           std::byte(tileID.level));
     }
 
-    return this->getAsyncSystem().createResolvedFuture(std::move(result));
+    return result;
   }
 };
 
@@ -241,3 +273,460 @@ TEST_CASE("QuadtreeRasterOverlayTileProvider getTile") {
         [](std::byte b) { return b == std::byte(8); }));
   }
 }
+
+TEST_CASE("QuadtreeRasterOverlayTileProvider loads tiles in batches") {
+  auto pTaskProcessor = std::make_shared<MockTaskProcessor>();
+  auto pAssetAccessor = std::make_shared<SimpleAssetAccessor>(
+      std::map<std::string, std::shared_ptr<SimpleAssetRequest>>());
+
+  AsyncSystem asyncSystem(pTaskProcessor);
+  IntrusivePointer<TestRasterOverlay> pOverlay = new TestRasterOverlay("Test");
+
+  IntrusivePointer<RasterOverlayTileProvider> pProvider = nullptr;
+
+  pOverlay
+      ->createTileProvider(
+          asyncSystem,
+          pAssetAccessor,
+          nullptr,
+          nullptr,
+          spdlog::default_logger(),
+          nullptr)
+      .thenInMainThread(
+          [&pProvider](RasterOverlay::CreateTileProviderResult&& created) {
+            CHECK(created);
+            pProvider = *created;
+          });
+
+  asyncSystem.dispatchMainThreadTasks();
+
+  REQUIRE(pProvider);
+  REQUIRE(!pProvider->isPlaceholder());
+
+  TestTileProvider* pTestProvider =
+      static_cast<TestTileProvider*>(pProvider.get());
+  pTestProvider->loadInBatches = true;
+
+  // Select a rectangle that covers two by two tiles at tile level 8.
+  const uint32_t expectedLevel = 8;
+  std::optional<QuadtreeTileID> southwestTileID =
+      pTestProvider->getTilingScheme().positionToTile(
+          glm::dvec2(0.1, 0.2),
+          expectedLevel);
+  REQUIRE(southwestTileID);
+
+  const Rectangle southwestRectangle =
+      pTestProvider->getTilingScheme().tileToRectangle(*southwestTileID);
+  const double width = southwestRectangle.computeWidth();
+  const double height = southwestRectangle.computeHeight();
+  const Rectangle tileRectangle(
+      southwestRectangle.minimumX + width * 0.01,
+      southwestRectangle.minimumY + height * 0.01,
+      southwestRectangle.maximumX + width * 0.99,
+      southwestRectangle.maximumY + height * 0.99);
+
+  uint32_t rasterSSE = 2;
+  glm::dvec2 targetScreenPixels = glm::dvec2(
+      pTestProvider->getWidth() * 2 * rasterSSE,
+      pTestProvider->getHeight() * 2 * rasterSSE);
+
+  SECTION("requests the uncached tiles of an overlay tile together") {
+    IntrusivePointer<RasterOverlayTile> pTile =
+        pProvider->getTile(tileRectangle, targetScreenPixels);
+    pProvider->loadTile(*pTile);
+
+    while (pTile->getState() != RasterOverlayTile::LoadState::Loaded) {
+      asyncSystem.dispatchMainThreadTasks();
+    }
+
+    CHECK(pTestProvider->singleRequests.empty());
+    REQUIRE(pTestProvider->batchRequests.size() == 1);
+    CHECK(pTestProvider->batchRequests[0].size() == 4);
+
+    const ImageCesium& image = pTile->getImage();
+    CHECK(image.pixelData.size() > 0);
+    CHECK(std::all_of(
+        image.pixelData.begin(),
+        image.pixelData.end(),
+        [](std::byte b) { return b == std::byte(expectedLevel); }));
+
+    // The eastern half of the next tile is already cached, so only its
+    // western half is requested.
+    const Rectangle eastRectangle(
+        tileRectangle.minimumX + width,
+        tileRectangle.minimumY,
+        tileRectangle.maximumX + width,
+        tileRectangle.maximumY);
+    IntrusivePointer<RasterOverlayTile> pEast =
+        pProvider->getTile(eastRectangle, targetScreenPixels);
+    pProvider->loadTile(*pEast);
+
+    while (pEast->getState() != RasterOverlayTile::LoadState::Loaded) {
+      asyncSystem.dispatchMainThreadTasks();
+    }
+
+    CHECK(pTestProvider->singleRequests.empty());
+    REQUIRE(pTestProvider->batchRequests.size() == 2);
+    REQUIRE(pTestProvider->batchRequests[1].size() == 2);
+    for (const QuadtreeTileID& tileID : pTestProvider->batchRequests[1]) {
+      CHECK(
+          std::find(
+              pTestProvider->batchRequests[0].begin(),
+              pTestProvider->batchRequests[0].end(),
+              tileID) == pTestProvider->batchRequests[0].end());
+    }
+  }
+
+  SECTION("uses the tiles of a batch even if they are evicted from the cache") {
+    pOverlay->getOptions().subTileCacheBytes = 0;
+
+    IntrusivePointer<RasterOverlayTile> pTile =
+        pProvider->getTile(tileRectangle, targetScreenPixels);
+    pProvider->loadTile(*pTile);
+
+    while (pTile->getState() != RasterOverlayTile::LoadState::Loaded) {
+      asyncSystem.dispatchMainThreadTasks();
+    }
+
+    CHECK(pTestProvider->singleRequests.empty());
+    CHECK(pTestProvider->batchRequests.size() == 1);
+
+    const ImageCesium& image = pTile->getImage();
+    CHECK(image.pixelData.size() > 0);
+    CHECK(std::all_of(
+        image.pixelData.begin(),
+        image.pixelData.end(),
+        [](std::byte b) { return b == std::byte(expectedLevel); }));
+  }
+
+  SECTION("loads the parent of a tile that fails in a batch") {
+    const QuadtreeTileID southeastID(
+        expectedLevel,
+        southwestTileID->x + 1,
+        southwestTileID->y);
+    pTestProvider->errorTiles.emplace_back(southeastID);
+
+    IntrusivePointer<RasterOverlayTile> pTile =
+        pProvider->getTile(tileRectangle, targetScreenPixels);
+    pProvider->loadTile(*pTile);
+
+    while (pTile->getState() != RasterOverlayTile::LoadState::Loaded) {
+      asyncSystem.dispatchMainThreadTasks();
+    }
+
+    REQUIRE(pTestProvider->batchRequests.size() == 1);
+    REQUIRE(pTestProvider->singleRequests.size() == 1);
+    CHECK(pTestProvider->singleRequests[0] == southeastID.getParent());
+
+    const ImageCesium& image = pTile->getImage();
+    CHECK(std::any_of(
+        image.pixelData.begin(),
+        image.pixelData.end(),
+        [](std::byte b) { return b == std::byte(expectedLevel - 1); }));
+  }
+}
+
+TEST_CASE("QuadtreeRasterOverlayTileProvider shares quadtree tiles") {
+  auto pTaskProcessor = std::make_shared<MockTaskProcessor>();
+  auto pAssetAccessor = std::make_shared<SimpleAssetAccessor>(
+      std::map<std::string, std::shared_ptr<SimpleAssetRequest>>());
+
+  AsyncSystem asyncSystem(pTaskProcessor);
+  RasterOverlayOptions options;
+  options.shareQuadtreeTiles = true;
+  IntrusivePointer<TestRasterOverlay> pOverlay =
+      new TestRasterOverlay("Test", options);
+
+  IntrusivePointer<RasterOverlayTileProvider> pProvider = nullptr;
+
+  pOverlay
+      ->createTileProvider(
+          asyncSystem,
+          pAssetAccessor,
+          nullptr,
+          nullptr,
+          spdlog::default_logger(),
+          nullptr)
+      .thenInMainThread(
+          [&pProvider](RasterOverlay::CreateTileProviderResult&& created) {
+            CHECK(created);
+            pProvider = *created;
+          });
+
+  asyncSystem.dispatchMainThreadTasks();
+
+  REQUIRE(pProvider);
+  REQUIRE(!pProvider->isPlaceholder());
+
+  TestTileProvider* pTestProvider =
+      static_cast<TestTileProvider*>(pProvider.get());
+
+  // Two rectangles inside the west and east halves of one level 8 tile.
+  const uint32_t expectedLevel = 8;
+  std::optional<QuadtreeTileID> tileID =
+      pTestProvider->getTilingScheme().positionToTile(
+          glm::dvec2(0.1, 0.2),
+          expectedLevel);
+  REQUIRE(tileID);
+
+  const Rectangle tileRectangle =
+      pTestProvider->getTilingScheme().tileToRectangle(*tileID);
+  const double width = tileRectangle.computeWidth();
+  const double height = tileRectangle.computeHeight();
+  const Rectangle westRectangle(
+      tileRectangle.minimumX + width * 0.01,
+      tileRectangle.minimumY + height * 0.01,
+      tileRectangle.minimumX + width * 0.49,
+      tileRectangle.maximumY - height * 0.01);
+  const Rectangle eastRectangle(
+      tileRectangle.minimumX + width * 0.51,
+      tileRectangle.minimumY + height * 0.01,
+      tileRectangle.maximumX - width * 0.01,
+      tileRectangle.maximumY - height * 0.01);
+
+  // Enough screen pixels for each half to select the level 8 tile.
+  uint32_t rasterSSE = 2;
+  glm::dvec2 targetScreenPixels = glm::dvec2(
+      pTestProvider->getWidth() * rasterSSE / 2,
+      pTestProvider->getHeight() * rasterSSE);
+
+  IntrusivePointer<RasterOverlayTile> pWest =
+      pProvider->getTile(westRectangle, targetScreenPixels);
+  IntrusivePointer<RasterOverlayTile> pEast =
+      pProvider->getTile(eastRectangle, targetScreenPixels);
+  REQUIRE(pWest);
+  CHECK(pWest == pEast);
+  CHECK(pWest->getRectangle().minimumX == tileRectangle.minimumX);
+  CHECK(pWest->getRectangle().minimumY == tileRectangle.minimumY);
+  CHECK(pWest->getRectangle().maximumX == tileRectangle.maximumX);
+  CHECK(pWest->getRectangle().maximumY == tileRectangle.maximumY);
+
+  pProvider->loadTile(*pWest);
+
+  while (pWest->getState() != RasterOverlayTile::LoadState::Loaded) {
+    asyncSystem.dispatchMainThreadTasks();
+  }
+
+  const ImageCesium& image = pWest->getImage();
+  CHECK(image.width == int32_t(pTestProvider->getWidth()));
+  CHECK(image.height == int32_t(pTestProvider->getHeight()));
+  CHECK(std::all_of(
+      image.pixelData.begin(),
+      image.pixelData.end(),
+      [](std::byte b) { return b == std::byte(expectedLevel); }));
+
+  // A rectangle that needs several quadtree tiles gets its own tile.
+  const Rectangle largeRectangle(
+      tileRectangle.minimumX - width * 0.5,
+      tileRectangle.minimumY - height * 0.5,
+      tileRectangle.maximumX + width * 0.5,
+      tileRectangle.maximumY + height * 0.5);
+  IntrusivePointer<RasterOverlayTile> pLarge = pProvider->getTile(
+      largeRectangle,
+      targetScreenPixels * 2.0);
+  REQUIRE(pLarge);
+  CHECK(pLarge != pWest);
+  CHECK(pLarge->getRectangle().minimumX == largeRectangle.minimumX);
+  CHECK(pLarge->getRectangle().maximumX == largeRectangle.maximumX);
+}
+
+TEST_CASE("RasterOverlayTileProvider loads queued tiles in priority order") {
+  auto pTaskProcessor = std::make_shared<MockTaskProcessor>();
+  auto pAssetAccessor = std::make_shared<SimpleAssetAccessor>(
+      std::map<std::string, std::shared_ptr<SimpleAssetRequest>>());
+
+  AsyncSystem asyncSystem(pTaskProcessor);
+  RasterOverlayOptions options;
+  options.maximumSimultaneousTileLoads = 1;
+  IntrusivePointer<TestRasterOverlay> pOverlay =
+      new TestRasterOverlay("Test", options);
+
+  IntrusivePointer<RasterOverlayTileProvider> pProvider = nullptr;
+
+  pOverlay
+      ->createTileProvider(
+          asyncSystem,
+          pAssetAccessor,
+          nullptr,
+          nullptr,
+          spdlog::default_logger(),
+          nullptr)
+      .thenInMainThread(
+          [&pProvider](RasterOverlay::CreateTileProviderResult&& created) {
+            CHECK(created);
+            pProvider = *created;
+          });
+
+  asyncSystem.dispatchMainThreadTasks();
+
+  REQUIRE(pProvider);
+  REQUIRE(!pProvider->isPlaceholder());
+
+  const glm::dvec2 targetScreenPixels(256.0, 256.0);
+  IntrusivePointer<RasterOverlayTile> pNear =
+      pProvider->getTile(Rectangle(0.0, 0.0, 1.0, 1.0), targetScreenPixels);
+  IntrusivePointer<RasterOverlayTile> pMiddle =
+      pProvider->getTile(Rectangle(1.0, 0.0, 2.0, 1.0), targetScreenPixels);
+  IntrusivePointer<RasterOverlayTile> pFar =
+      pProvider->getTile(Rectangle(2.0, 0.0, 3.0, 1.0), targetScreenPixels);
+  REQUIRE(pNear);
+  REQUIRE(pMiddle);
+  REQUIRE(pFar);
+
+  auto waitForLoad = [&asyncSystem](const RasterOverlayTile& tile) {
+    while (tile.getState() == RasterOverlayTile::LoadState::Loading) {
+      asyncSystem.dispatchMainThreadTasks();
+    }
+  };
+
+  pProvider->queueTileLoad(*pFar, 2.0);
+  pProvider->queueTileLoad(*pNear, 0.0);
+  pProvider->queueTileLoad(*pMiddle, 1.0);
+  pProvider->processTileLoadQueue();
+
+  CHECK(pNear->getState() == RasterOverlayTile::LoadState::Loading);
+  CHECK(pMiddle->getState() == RasterOverlayTile::LoadState::Unloaded);
+  CHECK(pFar->getState() == RasterOverlayTile::LoadState::Unloaded);
+
+  waitForLoad(*pNear);
+  CHECK(pNear->getState() == RasterOverlayTile::LoadState::Loaded);
+
+  // Requests that could not be started were discarded.
+  pProvider->processTileLoadQueue();
+  CHECK(pMiddle->getState() == RasterOverlayTile::LoadState::Unloaded);
+  CHECK(pFar->getState() == RasterOverlayTile::LoadState::Unloaded);
+
+  // Requested again, the far tile is now the most important.
+  pProvider->queueTileLoad(*pMiddle, 1.0);
+  pProvider->queueTileLoad(*pFar, 0.5);
+  pProvider->processTileLoadQueue();
+
+  CHECK(pMiddle->getState() == RasterOverlayTile::LoadState::Unloaded);
+  CHECK(pFar->getState() == RasterOverlayTile::LoadState::Loading);
+
+  waitForLoad(*pFar);
+}
+
+TEST_CASE("RasterOverlayTileProvider compresses images when requested") {
+  auto pTaskProcessor = std::make_shared<MockTaskProcessor>();
+  auto pAssetAccessor = std::make_shared<SimpleAssetAccessor>(
+      std::map<std::string, std::shared_ptr<SimpleAssetRequest>>());
+
+  AsyncSystem asyncSystem(pTaskProcessor);
+  RasterOverlayOptions options;
+  options.compressImages = true;
+  options.ktx2TranscodeTargets.ETC1S_RGB = GpuCompressedPixelFormat::BC7_RGBA;
+  options.ktx2TranscodeTargets.ETC1S_RGBA = GpuCompressedPixelFormat::BC7_RGBA;
+  IntrusivePointer<TestRasterOverlay> pOverlay =
+      new TestRasterOverlay("Test", options);
+
+  IntrusivePointer<RasterOverlayTileProvider> pProvider = nullptr;
+
+  pOverlay
+      ->createTileProvider(
+          asyncSystem,
+          pAssetAccessor,
+          nullptr,
+          nullptr,
+          spdlog::default_logger(),
+          nullptr)
+      .thenInMainThread(
+          [&pProvider](RasterOverlay::CreateTileProviderResult&& created) {
+            CHECK(created);
+            pProvider = *created;
+          });
+
+  asyncSystem.dispatchMainThreadTasks();
+
+  REQUIRE(pProvider);
+  REQUIRE(!pProvider->isPlaceholder());
+
+  IntrusivePointer<RasterOverlayTile> pTile = pProvider->getTile(
+      WebMercatorProjection::computeMaximumProjectedRectangle(),
+      glm::dvec2(256));
+  REQUIRE(pTile);
+  pProvider->loadTile(*pTile);
+
+  while (pTile->getState() == RasterOverlayTile::LoadState::Loading) {
+    asyncSystem.dispatchMainThreadTasks();
+  }
+
+  REQUIRE(pTile->getState() == RasterOverlayTile::LoadState::Loaded);
+
+  // The test images aren't opaque, so they use the format with alpha, and
+  // every mip level down to 1x1 is compressed.
+  const ImageCesium& image = pTile->getImage();
+  CHECK(image.compressedPixelFormat == GpuCompressedPixelFormat::BC3_RGBA);
+  REQUIRE(image.width > 0);
+  REQUIRE(image.height > 0);
+  REQUIRE(image.mipPositions.size() > 1);
+  CHECK(
+      image.mipPositions.front().byteSize ==
+      size_t((image.width + 3) / 4 * ((image.height + 3) / 4) * 16));
+  CHECK(image.mipPositions.back().byteSize == 16);
+  CHECK(pProvider->getTileDataBytes() == int64_t(image.pixelData.size()));
+}
+
+TEST_CASE("CompositeRasterOverlay blends the images of its layers") {
+  auto pTaskProcessor = std::make_shared<MockTaskProcessor>();
+  auto pAssetAccessor = std::make_shared<SimpleAssetAccessor>(
+      std::map<std::string, std::shared_ptr<SimpleAssetRequest>>());
+
+  AsyncSystem asyncSystem(pTaskProcessor);
+  std::vector<CompositeRasterOverlayLayer> layers(2);
+  layers[0].pOverlay = new TestRasterOverlay("Bottom");
+  layers[1].pOverlay = new TestRasterOverlay("Top");
+  IntrusivePointer<CompositeRasterOverlay> pOverlay =
+      new CompositeRasterOverlay("Composite", layers);
+
+  IntrusivePointer<RasterOverlayTileProvider> pProvider = nullptr;
+
+  pOverlay
+      ->createTileProvider(
+          asyncSystem,
+          pAssetAccessor,
+          nullptr,
+          nullptr,
+          spdlog::default_logger(),
+          nullptr)
+      .thenInMainThread(
+          [&pProvider](RasterOverlay::CreateTileProviderResult&& created) {
+            CHECK(created);
+            pProvider = *created;
+          });
+
+  asyncSystem.dispatchMainThreadTasks();
+
+  REQUIRE(pProvider);
+  REQUIRE(!pProvider->isPlaceholder());
+  CHECK(pProvider->getProjection() == Projection(WebMercatorProjection()));
+
+  IntrusivePointer<RasterOverlayTile> pTile = pProvider->getTile(
+      WebMercatorProjection::computeMaximumProjectedRectangle(),
+      glm::dvec2(2048));
+  REQUIRE(pTile);
+  pProvider->loadTile(*pTile);
+
+  while (pTile->getState() == RasterOverlayTile::LoadState::Loading) {
+    asyncSystem.dispatchMainThreadTasks();
+  }
+
+  REQUIRE(pTile->getState() == RasterOverlayTile::LoadState::Loaded);
+
+  // Every component of each layer's pixels is equal to the tile level, so the
+  // color is unchanged and the alpha of the two layers is combined.
+  const ImageCesium& image = pTile->getImage();
+  REQUIRE(image.channels == 4);
+  REQUIRE(image.width > 0);
+  REQUIRE(image.height > 0);
+  const int32_t level = int32_t(image.pixelData[0]);
+  CHECK(level > 0);
+  const double alpha = level / 255.0;
+  const int32_t expectedAlpha =
+      int32_t(std::lround((alpha + alpha * (1.0 - alpha)) * 255.0));
+  for (size_t i = 0; i < image.pixelData.size(); i += 4) {
+    CHECK(int32_t(image.pixelData[i + 1]) == level);
+    CHECK(int32_t(image.pixelData[i + 2]) == level);
+    CHECK(std::abs(int32_t(image.pixelData[i + 3]) - expectedAlpha) <= 1);
+  }
+}
@@ -0,0 +1,189 @@
+#include "RasterCompositing.h"
+
+#include <CesiumGeospatial/GeographicProjection.h>
+
+#include <catch2/catch.hpp>
+
+#include <array>
+
+using namespace Cesium3DTilesSelection;
+using namespace CesiumGeometry;
+using namespace CesiumGeospatial;
+using namespace CesiumGltf;
+
+namespace {
+
+ImageCesium createSolidImage(
+    int32_t width,
+    int32_t height,
+    const std::vector<uint8_t>& pixel) {
+  ImageCesium image;
+  image.width = width;
+  image.height = height;
+  image.channels = int32_t(pixel.size());
+  image.bytesPerChannel = 1;
+  image.pixelData.resize(size_t(width * height) * pixel.size());
+  for (size_t i = 0; i < image.pixelData.size(); ++i) {
+    image.pixelData[i] = std::byte(pixel[i % pixel.size()]);
+  }
+  return image;
+}
+
+std::array<int32_t, 4>
+getPixel(const ImageCesium& image, int32_t x, int32_t y) {
+  const size_t offset = size_t(y * image.width + x) * 4;
+  return {
+      int32_t(image.pixelData[offset]),
+      int32_t(image.pixelData[offset + 1]),
+      int32_t(image.pixelData[offset + 2]),
+      int32_t(image.pixelData[offset + 3])};
+}
+
+bool isClose(
+    const std::array<int32_t, 4>& actual,
+    const std::array<int32_t, 4>& expected) {
+  for (size_t i = 0; i < actual.size(); ++i) {
+    if (std::abs(actual[i] - expected[i]) > 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+TEST_CASE("blendImage") {
+  const GeographicProjection projection;
+  const Rectangle rectangle(0.0, 0.0, 1.0, 1.0);
+
+  SECTION("draws an opaque image over a transparent one") {
+    ImageCesium target = createSolidImage(4, 4, {0, 0, 0, 0});
+    const ImageCesium source = createSolidImage(2, 2, {255, 0, 0, 255});
+    REQUIRE(blendImage(
+        target,
+        rectangle,
+        source,
+        rectangle,
+        projection,
+        RasterOverlayBlendMode::Normal,
+        1.0f));
+    CHECK(isClose(getPixel(target, 0, 0), {255, 0, 0, 255}));
+    CHECK(isClose(getPixel(target, 3, 3), {255, 0, 0, 255}));
+  }
+
+  SECTION("applies the opacity of the layer") {
+    ImageCesium target = createSolidImage(4, 4, {255, 0, 0, 255});
+    const ImageCesium source = createSolidImage(4, 4, {0, 0, 255, 255});
+    REQUIRE(blendImage(
+        target,
+        rectangle,
+        source,
+        rectangle,
+        projection,
+        RasterOverlayBlendMode::Normal,
+        0.5f));
+    CHECK(isClose(getPixel(target, 1, 2), {128, 0, 128, 255}));
+  }
+
+  SECTION("combines straight alpha") {
+    ImageCesium target = createSolidImage(1, 1, {255, 0, 0, 128});
+    const ImageCesium source = createSolidImage(1, 1, {0, 0, 255, 128});
+    REQUIRE(blendImage(
+        target,
+        rectangle,
+        source,
+        rectangle,
+        projection,
+        RasterOverlayBlendMode::Normal,
+        1.0f));
+
+    // The source covers half, and the target half of the remaining half.
+    CHECK(isClose(getPixel(target, 0, 0), {85, 0, 170, 192}));
+  }
+
+  SECTION("multiplies and screens colors") {
+    ImageCesium multiplied = createSolidImage(2, 2, {200, 100, 50, 255});
+    ImageCesium screened = createSolidImage(2, 2, {200, 100, 50, 255});
+    const ImageCesium gray = createSolidImage(2, 2, {128});
+    REQUIRE(blendImage(
+        multiplied,
+        rectangle,
+        gray,
+        rectangle,
+        projection,
+        RasterOverlayBlendMode::Multiply,
+        1.0f));
+    REQUIRE(blendImage(
+        screened,
+        rectangle,
+        gray,
+        rectangle,
+        projection,
+        RasterOverlayBlendMode::Screen,
+        1.0f));
+    CHECK(isClose(getPixel(multiplied, 1, 1), {100, 50, 25, 255}));
+    CHECK(isClose(getPixel(screened, 1, 1), {228, 178, 153, 255}));
+  }
+
+  SECTION("blends with a transparent target as if drawn normally") {
+    ImageCesium target = createSolidImage(2, 2, {0, 0, 0, 0});
+    const ImageCesium source = createSolidImage(2, 2, {100, 150, 200, 255});
+    REQUIRE(blendImage(
+        target,
+        rectangle,
+        source,
+        rectangle,
+        projection,
+        RasterOverlayBlendMode::Multiply,
+        1.0f));
+    CHECK(isClose(getPixel(target, 0, 1), {100, 150, 200, 255}));
+  }
+
+  SECTION("only changes the pixels covered by the source") {
+    ImageCesium target = createSolidImage(4, 4, {0, 0, 0, 0});
+    const ImageCesium source = createSolidImage(1, 1, {0, 255, 0, 255});
+    REQUIRE(blendImage(
+        target,
+        rectangle,
+        source,
+        Rectangle(0.0, 0.5, 0.5, 1.0),
+        projection,
+        RasterOverlayBlendMode::Normal,
+        1.0f));
+
+    // The top left quarter is covered.
+    for (int32_t j = 0; j < target.height; ++j) {
+      for (int32_t i = 0; i < target.width; ++i) {
+        const bool covered = i < 2 && j < 2;
+        CHECK(
+            getPixel(target, i, j)[3] ==
+            (covered ? 255 : 0));
+      }
+    }
+  }
+
+  SECTION("does not blend unsupported images") {
+    ImageCesium target = createSolidImage(2, 2, {0, 0, 0, 0});
+    ImageCesium source = createSolidImage(2, 2, {0, 0, 0, 0});
+    source.bytesPerChannel = 2;
+    source.width = 1;
+    CHECK(!blendImage(
+        target,
+        rectangle,
+        source,
+        rectangle,
+        projection,
+        RasterOverlayBlendMode::Normal,
+        1.0f));
+
+    ImageCesium rgbTarget = createSolidImage(2, 2, {0, 0, 0});
+    CHECK(!blendImage(
+        rgbTarget,
+        rectangle,
+        createSolidImage(2, 2, {0, 0, 0, 0}),
+        rectangle,
+        projection,
+        RasterOverlayBlendMode::Normal,
+        1.0f));
+  }
+}
@@ -0,0 +1,349 @@
+#include "RasterCompression.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+using namespace Cesium3DTilesSelection;
+using namespace CesiumGltf;
+
+namespace {
+
+using Pixel = std::array<int32_t, 4>;
+
+// An RGBA image that gets brighter from left to right and, optionally, more
+// opaque from top to bottom.
+ImageCesium createImage(int32_t width, int32_t height, bool opaque) {
+  ImageCesium image;
+  image.width = width;
+  image.height = height;
+  image.channels = 4;
+  image.bytesPerChannel = 1;
+  image.pixelData.resize(size_t(width * height * 4));
+  for (int32_t y = 0; y < height; ++y) {
+    for (int32_t x = 0; x < width; ++x) {
+      std::byte* pPixel = &image.pixelData[size_t((y * width + x) * 4)];
+      const int32_t brightness = x * 127 / std::max(width - 1, 1);
+      pPixel[0] = std::byte(brightness + 96);
+      pPixel[1] = std::byte(brightness + 64);
+      pPixel[2] = std::byte(brightness);
+      pPixel[3] = opaque ? std::byte(255)
+                         : std::byte(y * 255 / std::max(height - 1, 1));
+    }
+  }
+  return image;
+}
+
+Pixel getPixel(const ImageCesium& image, int32_t x, int32_t y) {
+  const std::byte* pPixel =
+      &image.pixelData[size_t((y * image.width + x) * image.channels)];
+  return {
+      int32_t(pPixel[0]),
+      int32_t(pPixel[1]),
+      int32_t(pPixel[2]),
+      int32_t(pPixel[3])};
+}
+
+uint32_t readLittleEndian(const std::byte* pData, size_t bytes) {
+  uint32_t value = 0;
+  for (size_t i = 0; i < bytes; ++i) {
+    value |= uint32_t(pData[i]) << (8 * i);
+  }
+  return value;
+}
+
+Pixel unpackRgb565(uint32_t color) {
+  const int32_t r = int32_t(color >> 11) & 31;
+  const int32_t g = int32_t(color >> 5) & 63;
+  const int32_t b = int32_t(color) & 31;
+  return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255};
+}
+
+// Decodes pixel i, numbered row by row, of a four-color BC1 block.
+Pixel decodeBc1(const std::byte* pBlock, size_t i) {
+  const Pixel color0 = unpackRgb565(readLittleEndian(pBlock, 2));
+  const Pixel color1 = unpackRgb565(readLittleEndian(pBlock + 2, 2));
+  const uint32_t index = (readLittleEndian(pBlock + 4, 4) >> (2 * i)) & 3;
+  Pixel result = color0;
+  for (size_t c = 0; c < 3; ++c) {
+    switch (index) {
+    case 1:
+      result[c] = color1[c];
+      break;
+    case 2:
+      result[c] = (2 * color0[c] + color1[c]) / 3;
+      break;
+    case 3:
+      result[c] = (color0[c] + 2 * color1[c]) / 3;
+      break;
+    }
+  }
+  return result;
+}
+
+int32_t decodeBc3Alpha(const std::byte* pBlock, size_t i) {
+  const int32_t alpha0 = int32_t(pBlock[0]);
+  const int32_t alpha1 = int32_t(pBlock[1]);
+  uint64_t indices = 0;
+  for (size_t j = 0; j < 6; ++j) {
+    indices |= uint64_t(pBlock[2 + j]) << (8 * j);
+  }
+  const int32_t index = int32_t((indices >> (3 * i)) & 7);
+  if (index == 0) {
+    return alpha0;
+  }
+  if (index == 1) {
+    return alpha1;
+  }
+  return ((8 - index) * alpha0 + (index - 1) * alpha1) / 7;
+}
+
+// Decodes pixel i, numbered row by row, of an ETC1 block.
+Pixel decodeEtc1(const std::byte* pBlock, size_t i) {
+  static const int32_t modifiers[8][2] = {
+      {2, 8},
+      {5, 17},
+      {9, 29},
+      {13, 42},
+      {18, 60},
+      {24, 80},
+      {33, 106},
+      {47, 183}};
+
+  const uint32_t control = uint32_t(pBlock[3]);
+  const bool differential = (control & 2) != 0;
+  const bool flip = (control & 1) != 0;
+  const size_t x = i & 3;
+  const size_t y = i >> 2;
+  const bool second = flip ? y >= 2 : x >= 2;
+
+  Pixel result{0, 0, 0, 255};
+  for (size_t c = 0; c < 3; ++c) {
+    const int32_t byte = int32_t(pBlock[c]);
+    if (differential) {
+      int32_t base = byte >> 3;
+      if (second) {
+        int32_t delta = byte & 7;
+        if (delta >= 4) {
+          delta -= 8;
+        }
+        base += delta;
+      }
+      result[c] = (base << 3) | (base >> 2);
+    } else {
+      result[c] = (second ? byte & 15 : byte >> 4) * 17;
+    }
+  }
+
+  const uint32_t table = second ? (control >> 2) & 7 : control >> 5;
+  uint32_t indices = 0;
+  for (size_t j = 0; j < 4; ++j) {
+    indices = (indices << 8) | uint32_t(pBlock[4 + j]);
+  }
+  const size_t bit = x * 4 + y;
+  const uint32_t mostSignificant = (indices >> (16 + bit)) & 1;
+  const uint32_t leastSignificant = (indices >> bit) & 1;
+  int32_t modifier = modifiers[table][leastSignificant];
+  if (mostSignificant) {
+    modifier = -modifier;
+  }
+  for (size_t c = 0; c < 3; ++c) {
+    result[c] = std::clamp(result[c] + modifier, 0, 255);
+  }
+  return result;
+}
+
+int32_t decodeEacAlpha(const std::byte* pBlock, size_t i) {
+  static const int32_t modifiers[16][8] = {
+      {-3, -6, -9, -15, 2, 5, 8, 14},
+      {-3, -7, -10, -13, 2, 6, 9, 12},
+      {-2, -5, -8, -13, 1, 4, 7, 12},
+      {-2, -4, -6, -13, 1, 3, 5, 12},
+      {-3, -6, -8, -12, 2, 5, 7, 11},
+      {-3, -7, -9, -11, 2, 6, 8, 10},
+      {-4, -7, -8, -11, 3, 6, 7, 10},
+      {-3, -5, -8, -11, 2, 4, 7, 10},
+      {-2, -6, -8, -10, 1, 5, 7, 9},
+      {-2, -5, -8, -10, 1, 4, 7, 9},
+      {-2, -4, -8, -10, 1, 3, 7, 9},
+      {-2, -5, -7, -10, 1, 4, 6, 9},
+      {-3, -4, -7, -10, 2, 3, 6, 9},
+      {-1, -2, -3, -10, 0, 1, 2, 9},
+      {-4, -6, -8, -9, 3, 5, 7, 8},
+      {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+  const int32_t base = int32_t(pBlock[0]);
+  const int32_t multiplier = int32_t(pBlock[1]) >> 4;
+  const size_t table = size_t(pBlock[1]) & 15;
+  uint64_t indices = 0;
+  for (size_t j = 0; j < 6; ++j) {
+    indices = (indices << 8) | uint64_t(pBlock[2 + j]);
+  }
+  const size_t bit = (i & 3) * 4 + (i >> 2);
+  const size_t index = size_t(indices >> (45 - 3 * bit)) & 7;
+  return std::clamp(base + modifiers[table][index] * multiplier, 0, 255);
+}
+
+// Decodes the base level of a compressed image and returns the largest
+// difference from the original in any color channel and in alpha.
+std::pair<int32_t, int32_t>
+computeMaximumError(const ImageCesium& original, const ImageCesium& image) {
+  const size_t blockBytes =
+      image.compressedPixelFormat == GpuCompressedPixelFormat::BC3_RGBA ||
+              image.compressedPixelFormat ==
+                  GpuCompressedPixelFormat::ETC2_RGBA
+          ? 16
+          : 8;
+  const int32_t blocksX = (image.width + 3) / 4;
+
+  int32_t colorError = 0;
+  int32_t alphaError = 0;
+  for (int32_t y = 0; y < image.height; ++y) {
+    for (int32_t x = 0; x < image.width; ++x) {
+      const std::byte* pBlock =
+          &image.pixelData[size_t((y / 4) * blocksX + x / 4) * blockBytes];
+      const size_t i = size_t((y % 4) * 4 + x % 4);
+
+      Pixel decoded;
+      switch (image.compressedPixelFormat) {
+      case GpuCompressedPixelFormat::BC1_RGB:
+        decoded = decodeBc1(pBlock, i);
+        break;
+      case GpuCompressedPixelFormat::BC3_RGBA:
+        decoded = decodeBc1(pBlock + 8, i);
+        decoded[3] = decodeBc3Alpha(pBlock, i);
+        break;
+      case GpuCompressedPixelFormat::ETC1_RGB:
+        decoded = decodeEtc1(pBlock, i);
+        break;
+      default:
+        decoded = decodeEtc1(pBlock + 8, i);
+        decoded[3] = decodeEacAlpha(pBlock, i);
+        break;
+      }
+
+      const Pixel expected = getPixel(original, x, y);
+      for (size_t c = 0; c < 3; ++c) {
+        colorError = std::max(colorError, std::abs(decoded[c] - expected[c]));
+      }
+      alphaError = std::max(alphaError, std::abs(decoded[3] - expected[3]));
+    }
+  }
+
+  return {colorError, alphaError};
+}
+
+} // namespace
+
+TEST_CASE("compressImage") {
+  SECTION("encodes each format within a small error") {
+    const ImageCesium opaque = createImage(16, 16, true);
+    const ImageCesium transparent = createImage(16, 16, false);
+
+    const std::array<GpuCompressedPixelFormat, 4> formats{
+        GpuCompressedPixelFormat::BC1_RGB,
+        GpuCompressedPixelFormat::BC3_RGBA,
+        GpuCompressedPixelFormat::ETC1_RGB,
+        GpuCompressedPixelFormat::ETC2_RGBA};
+    for (const GpuCompressedPixelFormat format : formats) {
+      const bool hasAlpha = format == GpuCompressedPixelFormat::BC3_RGBA ||
+                            format == GpuCompressedPixelFormat::ETC2_RGBA;
+      const ImageCesium& original = hasAlpha ? transparent : opaque;
+
+      std::optional<ImageCesium> maybeCompressed =
+          compressImage(original, format);
+      REQUIRE(maybeCompressed);
+      CHECK(maybeCompressed->compressedPixelFormat == format);
+      CHECK(maybeCompressed->width == 16);
+      CHECK(maybeCompressed->height == 16);
+      CHECK(
+          maybeCompressed->pixelData.size() ==
+          original.pixelData.size() / (hasAlpha ? 4 : 8));
+
+      const auto [colorError, alphaError] =
+          computeMaximumError(original, *maybeCompressed);
+      CHECK(colorError <= 8);
+      CHECK(alphaError <= (hasAlpha ? 4 : 0));
+    }
+  }
+
+  SECTION("encodes a uniform block exactly") {
+    ImageCesium image;
+    image.width = 4;
+    image.height = 4;
+    image.channels = 4;
+    image.bytesPerChannel = 1;
+    for (size_t i = 0; i < 16; ++i) {
+      image.pixelData.insert(
+          image.pixelData.end(),
+          {std::byte(255), std::byte(0), std::byte(0), std::byte(96)});
+    }
+
+    std::optional<ImageCesium> maybeCompressed =
+        compressImage(image, GpuCompressedPixelFormat::BC3_RGBA);
+    REQUIRE(maybeCompressed);
+    const auto [colorError, alphaError] =
+        computeMaximumError(image, *maybeCompressed);
+    CHECK(colorError == 0);
+    CHECK(alphaError == 0);
+  }
+
+  SECTION("compresses every mip level and pads partial blocks") {
+    ImageCesium image = createImage(6, 3, true);
+    image.mipPositions = {{0, 6 * 3 * 4}, {6 * 3 * 4, 3 * 1 * 4}};
+    image.pixelData.resize(image.pixelData.size() + 3 * 1 * 4);
+
+    std::optional<ImageCesium> maybeCompressed =
+        compressImage(image, GpuCompressedPixelFormat::BC1_RGB);
+    REQUIRE(maybeCompressed);
+    REQUIRE(maybeCompressed->mipPositions.size() == 2);
+    CHECK(maybeCompressed->mipPositions[0].byteOffset == 0);
+    CHECK(maybeCompressed->mipPositions[0].byteSize == 2 * 8);
+    CHECK(maybeCompressed->mipPositions[1].byteOffset == 2 * 8);
+    CHECK(maybeCompressed->mipPositions[1].byteSize == 8);
+    CHECK(maybeCompressed->pixelData.size() == 3 * 8);
+  }
+
+  SECTION("does not compress unsupported images or formats") {
+    ImageCesium image = createImage(4, 4, true);
+    CHECK(!compressImage(image, GpuCompressedPixelFormat::BC7_RGBA));
+
+    image.compressedPixelFormat = GpuCompressedPixelFormat::BC1_RGB;
+    CHECK(!compressImage(image, GpuCompressedPixelFormat::BC1_RGB));
+  }
+}
+
+TEST_CASE("selectCompressedPixelFormat") {
+  const ImageCesium opaque = createImage(4, 4, true);
+  const ImageCesium transparent = createImage(4, 4, false);
+
+  Ktx2TranscodeTargets targets;
+  CHECK(
+      selectCompressedPixelFormat(opaque, targets) ==
+      GpuCompressedPixelFormat::NONE);
+
+  targets.ETC1S_RGB = GpuCompressedPixelFormat::ETC1_RGB;
+  targets.ETC1S_RGBA = GpuCompressedPixelFormat::ETC2_RGBA;
+  CHECK(
+      selectCompressedPixelFormat(opaque, targets) ==
+      GpuCompressedPixelFormat::ETC1_RGB);
+  CHECK(
+      selectCompressedPixelFormat(transparent, targets) ==
+      GpuCompressedPixelFormat::ETC2_RGBA);
+
+  targets.ETC1S_RGB = GpuCompressedPixelFormat::BC7_RGBA;
+  targets.ETC1S_RGBA = GpuCompressedPixelFormat::BC7_RGBA;
+  CHECK(
+      selectCompressedPixelFormat(opaque, targets) ==
+      GpuCompressedPixelFormat::BC1_RGB);
+  CHECK(
+      selectCompressedPixelFormat(transparent, targets) ==
+      GpuCompressedPixelFormat::BC3_RGBA);
+
+  targets.ETC1S_RGBA = GpuCompressedPixelFormat::PVRTC1_4_RGBA;
+  CHECK(
+      selectCompressedPixelFormat(transparent, targets) ==
+      GpuCompressedPixelFormat::NONE);
+}
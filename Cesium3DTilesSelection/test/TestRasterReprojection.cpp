@@ -0,0 +1,167 @@
+#include "RasterReprojection.h"
+
+#include <CesiumGeospatial/GeographicProjection.h>
+#include <CesiumGeospatial/GlobeRectangle.h>
+#include <CesiumGeospatial/WebMercatorProjection.h>
+
+#include <catch2/catch.hpp>
+
+using namespace Cesium3DTilesSelection;
+using namespace CesiumGeometry;
+using namespace CesiumGeospatial;
+using namespace CesiumGltf;
+
+namespace {
+
+// A single-channel image in which every pixel is equal to its row index.
+ImageCesium createRowImage(int32_t width, int32_t height) {
+  ImageCesium image;
+  image.width = width;
+  image.height = height;
+  image.channels = 1;
+  image.bytesPerChannel = 1;
+  image.pixelData.resize(size_t(width * height));
+  for (int32_t j = 0; j < height; ++j) {
+    for (int32_t i = 0; i < width; ++i) {
+      image.pixelData[size_t(j * width + i)] = std::byte(j);
+    }
+  }
+  return image;
+}
+
+uint8_t getPixel(const ImageCesium& image, int32_t x, int32_t y) {
+  return uint8_t(image.pixelData[size_t(y * image.width + x)]);
+}
+
+} // namespace
+
+TEST_CASE("reprojectImage") {
+  const GlobeRectangle globeRectangle(-0.5, -1.0, 0.5, 1.0);
+
+  SECTION("leaves an image unchanged within the same projection") {
+    const GeographicProjection geographic;
+    const Rectangle rectangle = geographic.project(globeRectangle);
+    const ImageCesium source = createRowImage(16, 256);
+
+    std::optional<ImageCesium> maybeTarget = reprojectImage(
+        source,
+        geographic,
+        rectangle,
+        geographic,
+        rectangle,
+        16,
+        256);
+    REQUIRE(maybeTarget);
+    CHECK(maybeTarget->width == 16);
+    CHECK(maybeTarget->height == 256);
+    CHECK(maybeTarget->channels == 1);
+    CHECK(maybeTarget->pixelData == source.pixelData);
+  }
+
+  SECTION("resamples Web Mercator rows into geographic rows") {
+    const WebMercatorProjection webMercator;
+    const GeographicProjection geographic;
+    const ImageCesium source = createRowImage(16, 256);
+
+    std::optional<ImageCesium> maybeTarget = reprojectImage(
+        source,
+        webMercator,
+        webMercator.project(globeRectangle),
+        geographic,
+        geographic.project(globeRectangle),
+        8,
+        256);
+    REQUIRE(maybeTarget);
+    const ImageCesium& target = *maybeTarget;
+    CHECK(target.width == 8);
+    CHECK(target.height == 256);
+
+    // Longitude is linear in both projections, so every column is the same,
+    // and rows get farther away from the equator in Web Mercator.
+    for (int32_t j = 0; j < target.height; ++j) {
+      for (int32_t i = 1; i < target.width; ++i) {
+        CHECK(getPixel(target, i, j) == getPixel(target, 0, j));
+      }
+      if (j > 0) {
+        CHECK(getPixel(target, 0, j) >= getPixel(target, 0, j - 1));
+      }
+    }
+
+    CHECK(getPixel(target, 0, 0) == 0);
+    CHECK(getPixel(target, 0, 255) == 255);
+    CHECK(getPixel(target, 0, 127) == 127);
+    CHECK(getPixel(target, 0, 128) == 128);
+
+    // Halfway from the top to the equator in latitude is about 73.4 source
+    // rows from the top in Web Mercator.
+    CHECK(getPixel(target, 0, 64) == 73);
+    CHECK(getPixel(target, 0, 191) == 182);
+  }
+
+  SECTION("repeats edge pixels outside the source rectangle") {
+    const GeographicProjection geographic;
+    const ImageCesium source = createRowImage(4, 4);
+
+    std::optional<ImageCesium> maybeTarget = reprojectImage(
+        source,
+        geographic,
+        Rectangle(0.0, 0.0, 1.0, 1.0),
+        geographic,
+        Rectangle(0.0, -1.0, 1.0, 2.0),
+        4,
+        12);
+    REQUIRE(maybeTarget);
+    CHECK(getPixel(*maybeTarget, 0, 0) == 0);
+    CHECK(getPixel(*maybeTarget, 0, 11) == 3);
+  }
+
+  SECTION("does not resample images with more than one byte per channel") {
+    const GeographicProjection geographic;
+    ImageCesium source = createRowImage(4, 4);
+    source.bytesPerChannel = 2;
+    source.width = 2;
+
+    const Rectangle rectangle(0.0, 0.0, 1.0, 1.0);
+    CHECK(!reprojectImage(
+        source,
+        geographic,
+        rectangle,
+        geographic,
+        rectangle,
+        4,
+        4));
+  }
+}
+
+TEST_CASE("ReprojectedImageCache") {
+  const Rectangle first(0.0, 0.0, 1.0, 1.0);
+  const Rectangle second(1.0, 0.0, 2.0, 1.0);
+  const Rectangle third(2.0, 0.0, 3.0, 1.0);
+  const glm::dvec2 pixels(256.0, 256.0);
+
+  auto createImage = []() {
+    LoadedRasterOverlayImage loaded;
+    loaded.image = createRowImage(10, 10);
+    return loaded;
+  };
+
+  ReprojectedImageCache cache(250);
+  CHECK(!cache.find(first, pixels));
+
+  cache.add(first, pixels, createImage());
+  cache.add(second, pixels, createImage());
+  CHECK(cache.getBytes() == 200);
+
+  std::optional<LoadedRasterOverlayImage> found = cache.find(first, pixels);
+  REQUIRE(found);
+  REQUIRE(found->image);
+  CHECK(found->image->width == 10);
+  CHECK(!cache.find(first, glm::dvec2(128.0, 256.0)));
+
+  // The first image was used more recently, so the second one is evicted.
+  cache.add(third, pixels, createImage());
+  CHECK(cache.getBytes() == 200);
+  CHECK(cache.find(first, pixels));
+  CHECK(!cache.find(second, pixels));
+  CHECK(cache.find(third, pixels));
+}
@@ -0,0 +1,159 @@
+#include <Cesium3DTilesSelection/SoftwareTileOcclusionProxyPool.h>
+#include <Cesium3DTilesSelection/Tile.h>
+#include <Cesium3DTilesSelection/TileContent.h>
+#include <CesiumGeometry/Axis.h>
+#include <CesiumGltf/Model.h>
+#include <CesiumUtility/Math.h>
+
+#include <catch2/catch.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace Cesium3DTilesSelection;
+using namespace CesiumGeometry;
+using namespace CesiumGltf;
+using namespace CesiumUtility;
+
+namespace {
+// The camera is on the x-axis, looking toward the origin. Occluders are
+// placed in the plane that is this far in front of it.
+const glm::dvec3 cameraPosition(10000000.0, 0.0, 0.0);
+constexpr double wallDistance = 100.0;
+
+// Creates a tile whose content is the given triangles, given as (y, z) pairs
+// in the plane of the wall.
+std::unique_ptr<Tile> createWallTile(const std::vector<glm::vec2>& vertices) {
+  std::vector<glm::vec3> positions;
+  for (const glm::vec2& vertex : vertices) {
+    positions.emplace_back(0.0f, vertex.x, vertex.y);
+  }
+
+  Model model;
+  model.extras["gltfUpAxis"] = static_cast<int64_t>(Axis::Z);
+
+  Buffer& buffer = model.buffers.emplace_back();
+  buffer.byteLength = int64_t(positions.size() * sizeof(glm::vec3));
+  buffer.cesium.data.resize(size_t(buffer.byteLength));
+  std::memcpy(
+      buffer.cesium.data.data(),
+      positions.data(),
+      size_t(buffer.byteLength));
+
+  BufferView& bufferView = model.bufferViews.emplace_back();
+  bufferView.buffer = 0;
+  bufferView.byteLength = buffer.byteLength;
+
+  Accessor& accessor = model.accessors.emplace_back();
+  accessor.bufferView = 0;
+  accessor.componentType = Accessor::ComponentType::FLOAT;
+  accessor.type = Accessor::Type::VEC3;
+  accessor.count = int64_t(positions.size());
+
+  Mesh& mesh = model.meshes.emplace_back();
+  mesh.primitives.emplace_back().attributes["POSITION"] = 0;
+
+  model.nodes.emplace_back().mesh = 0;
+  model.scenes.emplace_back().nodes.emplace_back(0);
+
+  auto pTile = std::make_unique<Tile>(nullptr);
+  pTile->setTransform(glm::translate(
+      glm::dmat4(1.0),
+      cameraPosition - glm::dvec3(wallDistance, 0.0, 0.0)));
+  pTile->getContent().setContentKind(
+      std::make_unique<TileRenderContent>(std::move(model)));
+  return pTile;
+}
+
+// A box centered on the line of sight, at the given distance from the camera.
+BoundingVolume createBox(double distance, double halfSize) {
+  return OrientedBoundingBox(
+      cameraPosition - glm::dvec3(distance, 0.0, 0.0),
+      glm::dmat3(halfSize));
+}
+} // namespace
+
+TEST_CASE("SoftwareTileOcclusionProxyPool") {
+  SoftwareTileOcclusionProxyPool pool(16, 64, 64);
+
+  const std::vector<ViewState> views{ViewState::create(
+      cameraPosition,
+      glm::dvec3(-1.0, 0.0, 0.0),
+      glm::dvec3(0.0, 0.0, 1.0),
+      glm::dvec2(500.0, 500.0),
+      Math::PiOverTwo,
+      Math::PiOverTwo)};
+
+  SECTION("does not occlude anything without views") {
+    CHECK(!pool.isOccluded(createBox(300.0, 10.0)));
+  }
+
+  SECTION("occludes volumes behind a triangle that covers the view") {
+    // At the wall, the view spans -100 to 100 along both axes.
+    std::unique_ptr<Tile> pWall = createWallTile(
+        {glm::vec2(-100.0f, -100.0f),
+         glm::vec2(300.0f, -100.0f),
+         glm::vec2(-100.0f, 300.0f)});
+    pool.updateOccluders(views, {pWall.get()});
+
+    CHECK(pool.isOccluded(createBox(300.0, 10.0)));
+    CHECK(!pool.isOccluded(createBox(50.0, 10.0)));
+
+    // A box that straddles the wall is not occluded either.
+    CHECK(!pool.isOccluded(createBox(wallDistance, 10.0)));
+
+    // Updating the occluders again replaces the wall.
+    pool.updateOccluders(views, {});
+    CHECK(!pool.isOccluded(createBox(300.0, 10.0)));
+  }
+
+  SECTION("does not occlude volumes behind a gap narrower than a texel") {
+    // A texel is 3.125 across at the wall. Leave a gap of 0.5 down the middle.
+    std::unique_ptr<Tile> pWall = createWallTile(
+        {glm::vec2(-0.25f, -300.0f),
+         glm::vec2(-0.25f, 300.0f),
+         glm::vec2(-300.0f, 0.0f),
+         glm::vec2(0.25f, -300.0f),
+         glm::vec2(300.0f, 0.0f),
+         glm::vec2(0.25f, 300.0f)});
+    pool.updateOccluders(views, {pWall.get()});
+
+    CHECK(!pool.isOccluded(createBox(300.0, 1.0)));
+
+    // Away from the gap, the triangles still occlude.
+    CHECK(pool.isOccluded(OrientedBoundingBox(
+        cameraPosition - glm::dvec3(300.0, 150.0, 0.0),
+        glm::dmat3(1.0))));
+  }
+
+  SECTION("occludes volumes behind a finely tessellated tile") {
+    // Cells of two triangles, each smaller than a texel, that together cover
+    // the view.
+    std::vector<glm::vec2> vertices;
+    for (float y = -150.0f; y < 150.0f; y += 2.0f) {
+      for (float z = -150.0f; z < 150.0f; z += 2.0f) {
+        vertices.insert(
+            vertices.end(),
+            {glm::vec2(y, z),
+             glm::vec2(y + 2.0f, z),
+             glm::vec2(y + 2.0f, z + 2.0f),
+             glm::vec2(y, z),
+             glm::vec2(y + 2.0f, z + 2.0f),
+             glm::vec2(y, z + 2.0f)});
+      }
+    }
+    std::unique_ptr<Tile> pWall = createWallTile(vertices);
+    pool.updateOccluders(views, {pWall.get()});
+
+    CHECK(pool.isOccluded(createBox(300.0, 10.0)));
+    CHECK(!pool.isOccluded(createBox(50.0, 10.0)));
+  }
+
+  SECTION("ignores tiles without render content") {
+    Tile emptyTile(nullptr);
+    pool.updateOccluders(views, {&emptyTile});
+    CHECK(!pool.isOccluded(createBox(300.0, 10.0)));
+  }
+}
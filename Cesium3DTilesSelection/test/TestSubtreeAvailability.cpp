@@ -12,6 +12,7 @@
 #include <rapidjson/writer.h>
 
 #include <cstddef>
+#include <map>
 #include <vector>
 
 using namespace Cesium3DTilesSelection;
@@ -0,0 +1,96 @@
+#include "SubtreeAvailabilityCache.h"
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <vector>
+
+using namespace Cesium3DTilesSelection;
+
+namespace {
+SubtreeAvailability createSubtree(size_t bitstreamLength) {
+  std::vector<std::vector<std::byte>> buffers{
+      std::vector<std::byte>(bitstreamLength, std::byte(0xFF))};
+  gsl::span<const std::byte> view(buffers[0].data(), buffers[0].size());
+  return SubtreeAvailability{
+      2,
+      SubtreeBufferViewAvailability{view},
+      SubtreeConstantAvailability{false},
+      {SubtreeConstantAvailability{false}},
+      std::move(buffers)};
+}
+} // namespace
+
+TEST_CASE("Test SubtreeAvailabilityCache") {
+  SubtreeAvailabilityCache cache;
+
+  SECTION("Finds inserted subtrees") {
+    cache.insert(0, 0, createSubtree(8));
+    cache.insert(1, 3, createSubtree(8));
+
+    const SubtreeAvailability* pRoot = cache.find(0, 0);
+    REQUIRE(pRoot != nullptr);
+    CHECK(pRoot->isTileAvailable(0, 0));
+    CHECK(cache.find(1, 3) != nullptr);
+    CHECK(cache.find(1, 2) == nullptr);
+    CHECK(cache.find(2, 3) == nullptr);
+    CHECK(cache.size() == 2);
+    CHECK(
+        cache.getSizeBytes() ==
+        cache.find(0, 0)->computeByteSize() +
+            cache.find(1, 3)->computeByteSize());
+  }
+
+  SECTION("Keeps only the bitstream bytes of a subtree") {
+    std::vector<std::vector<std::byte>> buffers{
+        std::vector<std::byte>(1024, std::byte(0xFF))};
+    gsl::span<const std::byte> view(buffers[0].data(), 16);
+    SubtreeAvailability subtree{
+        2,
+        SubtreeBufferViewAvailability{view},
+        SubtreeConstantAvailability{false},
+        {SubtreeConstantAvailability{false}},
+        std::move(buffers)};
+    CHECK(subtree.isTileAvailable(0, 0));
+    CHECK(subtree.computeByteSize() < 1024);
+  }
+
+  SECTION("Unloads least recently used subtrees when over budget") {
+    cache.insert(0, 0, createSubtree(64));
+    const int64_t subtreeBytes = cache.getSizeBytes();
+    cache.setMaximumBytes(3 * subtreeBytes);
+
+    cache.insert(1, 0, createSubtree(64));
+    cache.insert(1, 1, createSubtree(64));
+    CHECK(cache.size() == 3);
+
+    // Use subtree (1, 0) so that (1, 1) becomes the least recently used.
+    CHECK(cache.find(1, 0) != nullptr);
+    cache.insert(1, 2, createSubtree(64));
+    CHECK(cache.size() == 3);
+    CHECK(cache.find(1, 1) == nullptr);
+    CHECK(cache.find(1, 0) != nullptr);
+    CHECK(cache.find(1, 2) != nullptr);
+    CHECK(cache.getSizeBytes() <= cache.getMaximumBytes());
+
+    // The root subtree is never unloaded.
+    cache.setMaximumBytes(0);
+    CHECK(cache.find(0, 0) != nullptr);
+    CHECK(cache.find(1, 0) == nullptr);
+  }
+
+  SECTION("Replaces a subtree that is inserted again") {
+    cache.insert(1, 0, createSubtree(8));
+    cache.insert(1, 0, createSubtree(8));
+    CHECK(cache.size() == 1);
+    CHECK(cache.getSizeBytes() == cache.find(1, 0)->computeByteSize());
+  }
+
+  SECTION("Tracks subtrees that are loading") {
+    CHECK(cache.beginLoading(1, 0));
+    CHECK(!cache.beginLoading(1, 0));
+    CHECK(cache.beginLoading(1, 1));
+    cache.endLoading(1, 0);
+    CHECK(cache.beginLoading(1, 0));
+  }
+}
@@ -22,6 +22,7 @@
 #include <glm/glm.hpp>
 
 #include <filesystem>
+#include <map>
 #include <vector>
 
 using namespace Cesium3DTilesSelection;
@@ -36,6 +37,7 @@ class SimpleTilesetContentLoader : public TilesetContentLoader {
 public:
   CesiumAsync::Future<TileLoadResult>
   loadTileContent(const TileLoadInput& input) override {
+    lastMaximumImageDimension = input.maximumImageDimension;
     return input.asyncSystem.createResolvedFuture(
         std::move(mockLoadTileContent));
   }
@@ -47,6 +49,7 @@ public:
 
   TileLoadResult mockLoadTileContent;
   TileChildrenResult mockCreateTileChildren;
+  int32_t lastMaximumImageDimension = -1;
 };
 
 std::shared_ptr<SimpleAssetRequest>
@@ -705,6 +708,81 @@ TEST_CASE("Test tile state machine") {
   }
 }
 
+TEST_CASE("Test the maximum image dimension passed to the loader") {
+  auto pMockedAssetAccessor = std::make_shared<SimpleAssetAccessor>(
+      std::map<std::string, std::shared_ptr<SimpleAssetRequest>>{});
+  auto pMockedPrepareRendererResources =
+      std::make_shared<SimplePrepareRendererResource>();
+  CesiumAsync::AsyncSystem asyncSystem{std::make_shared<SimpleTaskProcessor>()};
+  auto pMockedCreditSystem = std::make_shared<CreditSystem>();
+
+  TilesetExternals externals{
+      pMockedAssetAccessor,
+      pMockedPrepareRendererResources,
+      asyncSystem,
+      pMockedCreditSystem};
+
+  TilesetOptions options;
+  options.contentOptions.limitImageResolutionToScreenSize = true;
+  options.maximumScreenSpaceError = 16.0;
+
+  // Loads a tile with a bounding sphere of radius 10 and a geometric error of
+  // 16, and returns the maximum image dimension the loader was given.
+  const auto load = [&](TileRefine refine, bool hasChildren) {
+    auto pMockedLoader = std::make_unique<SimpleTilesetContentLoader>();
+    pMockedLoader->mockLoadTileContent = {
+        TileEmptyContent(),
+        CesiumGeometry::Axis::Y,
+        std::nullopt,
+        std::nullopt,
+        std::nullopt,
+        nullptr,
+        {},
+        TileLoadResultState::Success};
+    SimpleTilesetContentLoader* pLoader = pMockedLoader.get();
+
+    auto pRootTile = std::make_unique<Tile>(pLoader);
+    pRootTile->setBoundingVolume(BoundingSphere(glm::dvec3(0.0), 10.0));
+    pRootTile->setGeometricError(16.0);
+    pRootTile->setRefine(refine);
+    if (hasChildren) {
+      std::vector<Tile> children;
+      children.emplace_back(pLoader);
+      pRootTile->createChildTiles(std::move(children));
+    }
+
+    Tile::LoadedLinkedList loadedTiles;
+    IntrusivePointer<TilesetContentManager> pManager =
+        new TilesetContentManager{
+            externals,
+            options,
+            RasterOverlayCollection{loadedTiles, externals},
+            {},
+            std::move(pMockedLoader),
+            std::move(pRootTile)};
+    Tile& tile = *pManager->getRootTile();
+    pManager->loadTileContent(tile, options);
+    pManager->waitUntilIdle();
+    pManager->unloadTileContent(tile);
+    return pLoader->lastMaximumImageDimension;
+  };
+
+  SECTION("limits images to twice the tile's diameter at the maximum error") {
+    // The tile is 20 across and the error allows one pixel per meter.
+    CHECK(load(TileRefine::Replace, true) == 40);
+  }
+
+  SECTION("does not limit images of tiles that are not replaced") {
+    CHECK(load(TileRefine::Add, true) == 0);
+    CHECK(load(TileRefine::Replace, false) == 0);
+  }
+
+  SECTION("does not limit images unless enabled") {
+    options.contentOptions.limitImageResolutionToScreenSize = false;
+    CHECK(load(TileRefine::Replace, true) == 0);
+  }
+}
+
 TEST_CASE("Test the tileset content manager's post processing for gltf") {
   Cesium3DTilesSelection::registerAllTileContentTypes();
 
@@ -878,6 +956,103 @@ TEST_CASE("Test the tileset content manager's post processing for gltf") {
     pManager->unloadTileContent(tile);
   }
 
+  SECTION("Fit tight bounding volumes to the content") {
+    // The box spans -0.5 to 0.5 along every axis.
+    CesiumGltfReader::GltfReader gltfReader;
+    std::vector<std::byte> gltfBoxFile =
+        readFile(testDataPath / "gltf" / "embedded_box" / "Box.glb");
+    auto modelReadResult = gltfReader.readGltf(gltfBoxFile);
+    REQUIRE(modelReadResult.model);
+
+    auto pMockedLoader = std::make_unique<SimpleTilesetContentLoader>();
+    pMockedLoader->mockLoadTileContent = {
+        std::move(*modelReadResult.model),
+        CesiumGeometry::Axis::Y,
+        std::nullopt,
+        std::nullopt,
+        std::nullopt,
+        nullptr,
+        {},
+        TileLoadResultState::Success};
+    pMockedLoader->mockCreateTileChildren = {{}, TileLoadResultState::Failed};
+
+    auto pRootTile = std::make_unique<Tile>(pMockedLoader.get());
+    pRootTile->setBoundingVolume(
+        OrientedBoundingBox(glm::dvec3(0.0), glm::dmat3(10.0)));
+
+    TilesetOptions options;
+    options.contentOptions.computeTightBoundingVolumes = true;
+
+    // Loads the tile, and returns the half lengths of the tile's box and
+    // content box.
+    const auto load = [&]() {
+      Tile::LoadedLinkedList loadedTiles;
+      IntrusivePointer<TilesetContentManager> pManager =
+          new TilesetContentManager{
+              externals,
+              options,
+              RasterOverlayCollection{loadedTiles, externals},
+              {},
+              std::move(pMockedLoader),
+              std::move(pRootTile)};
+      Tile& tile = *pManager->getRootTile();
+      pManager->loadTileContent(tile, options);
+      pManager->waitUntilIdle();
+      CHECK(tile.getState() == TileLoadState::ContentLoaded);
+
+      const auto getHalfLengths = [](const BoundingVolume& boundingVolume) {
+        const auto* pBox = std::get_if<OrientedBoundingBox>(&boundingVolume);
+        REQUIRE(pBox);
+        const glm::dmat3& halfAxes = pBox->getHalfAxes();
+        return glm::dvec3(
+            glm::length(halfAxes[0]),
+            glm::length(halfAxes[1]),
+            glm::length(halfAxes[2]));
+      };
+
+      const glm::dvec3 tileHalfLengths =
+          getHalfLengths(tile.getBoundingVolume());
+      REQUIRE(tile.getContentBoundingVolume());
+      const glm::dvec3 contentHalfLengths =
+          getHalfLengths(*tile.getContentBoundingVolume());
+
+      pManager->unloadTileContent(tile);
+      return std::make_pair(tileHalfLengths, contentHalfLengths);
+    };
+
+    // Gives the tile one child with the given box.
+    const auto addChild = [&](const OrientedBoundingBox& box) {
+      std::vector<Tile> children;
+      children.emplace_back(pMockedLoader.get());
+      children.back().setBoundingVolume(box);
+      pRootTile->createChildTiles(std::move(children));
+    };
+
+    SECTION("fits the tile's box around its content and children") {
+      addChild(OrientedBoundingBox(glm::dvec3(2.0, 0.0, 0.0), glm::dmat3(1.0)));
+      const auto [tileHalfLengths, contentHalfLengths] = load();
+      CHECK(tileHalfLengths.x == Approx(1.75));
+      CHECK(tileHalfLengths.y == Approx(1.0));
+      CHECK(tileHalfLengths.z == Approx(1.0));
+      CHECK(contentHalfLengths.x == Approx(0.5));
+      CHECK(contentHalfLengths.y == Approx(0.5));
+      CHECK(contentHalfLengths.z == Approx(0.5));
+    }
+
+    SECTION("keeps the tile's box if the fitted box is not smaller") {
+      addChild(OrientedBoundingBox(glm::dvec3(0.0), glm::dmat3(10.0)));
+      const auto [tileHalfLengths, contentHalfLengths] = load();
+      CHECK(tileHalfLengths.x == Approx(10.0));
+      CHECK(contentHalfLengths.x == Approx(0.5));
+    }
+
+    SECTION("only tightens the content box of a tile without children") {
+      const auto [tileHalfLengths, contentHalfLengths] = load();
+      CHECK(tileHalfLengths.x == Approx(10.0));
+      CHECK(contentHalfLengths.x == Approx(0.5));
+    }
+  }
+
   SECTION("Embed gltf up axis to extra") {
     // create mock loader
     auto pMockedLoader = std::make_unique<SimpleTilesetContentLoader>();
@@ -1217,4 +1392,93 @@ TEST_CASE("Test the tileset content manager's post processing for gltf") {
 
     pManager->unloadTileContent(tile);
   }
+
+  SECTION("Add raster overlay projections to a loaded tile without reloading "
+          "it") {
+    // create mock loader
+    auto pMockedLoader = std::make_unique<SimpleTilesetContentLoader>();
+    Cartographic beginCarto{glm::radians(32.0), glm::radians(48.0), 100.0};
+    pMockedLoader->mockLoadTileContent = {
+        createGlobeGrid(beginCarto, 10, 10, 0.01),
+        CesiumGeometry::Axis::Z,
+        std::nullopt,
+        std::nullopt,
+        std::nullopt,
+        nullptr,
+        {},
+        TileLoadResultState::Success};
+    pMockedLoader->mockCreateTileChildren = {{}, TileLoadResultState::Failed};
+
+    // create tile
+    auto pRootTile = std::make_unique<Tile>(pMockedLoader.get());
+
+    // create manager without any raster overlay
+    Tile::LoadedLinkedList loadedTiles;
+    IntrusivePointer<TilesetContentManager> pManager =
+        new TilesetContentManager{
+            externals,
+            {},
+            RasterOverlayCollection{loadedTiles, externals},
+            {},
+            std::move(pMockedLoader),
+            std::move(pRootTile)};
+
+    Tile& tile = *pManager->getRootTile();
+    pManager->loadTileContent(tile, {});
+    pManager->waitUntilIdle();
+    pManager->updateTileContent(tile, 0.0, {});
+    REQUIRE(tile.getState() == TileLoadState::Done);
+    REQUIRE(tile.getContent()
+                .getRenderContent()
+                ->getRasterOverlayDetails()
+                .rasterOverlayProjections.empty());
+    loadedTiles.insertAtTail(tile);
+
+    // add a raster overlay that needs a projection the tile doesn't have
+    pManager->getRasterOverlayCollection().add(
+        new DebugColorizeTilesRasterOverlay("DebugOverlay"));
+    asyncSystem.dispatchMainThreadTasks();
+
+    // the tile keeps its content while texture coordinates are added
+    pManager->updateTileContent(tile, 0.0, {});
+    CHECK(tile.getState() == TileLoadState::Done);
+    CHECK(tile.getContent().isRenderContent());
+    CHECK(pManager->getNumberOfTilesLoading() == 1);
+
+    pManager->waitUntilIdle();
+    CHECK(tile.getState() == TileLoadState::Done);
+    CHECK(pManager->getNumberOfTilesLoading() == 0);
+    CHECK(pManager->getNumberOfTilesLoaded() == 1);
+
+    const TileRenderContent* pRenderContent =
+        tile.getContent().getRenderContent();
+    REQUIRE(pRenderContent);
+    CHECK(pRenderContent->getRenderResources());
+    const RasterOverlayDetails& rasterOverlayDetails =
+        pRenderContent->getRasterOverlayDetails();
+    REQUIRE(rasterOverlayDetails.rasterOverlayProjections.size() == 1);
+    CHECK(
+        rasterOverlayDetails.rasterOverlayProjections.front() ==
+        Projection{GeographicProjection{}});
+
+    const CesiumGltf::MeshPrimitive& meshPrimitive =
+        pRenderContent->getModel().meshes.front().primitives.front();
+    CHECK(
+        meshPrimitive.attributes.find("_CESIUMOVERLAY_0") !=
+        meshPrimitive.attributes.end());
+
+    // the overlay is now mapped to the new texture coordinates
+    pManager->updateTileContent(tile, 0.0, {});
+    const std::vector<RasterMappedTo3DTile>& mappedRasterTiles =
+        tile.getMappedRasterTiles();
+    REQUIRE(mappedRasterTiles.size() == 1);
+    CHECK(mappedRasterTiles.front().getTextureCoordinateID() == 0);
+    REQUIRE(mappedRasterTiles.front().getLoadingTile());
+    CHECK(
+        mappedRasterTiles.front().getLoadingTile()->getState() !=
+        RasterOverlayTile::LoadState::Placeholder);
+
+    loadedTiles.remove(tile);
+    pManager->unloadTileContent(tile);
+  }
 }
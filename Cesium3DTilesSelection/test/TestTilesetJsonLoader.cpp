@@ -11,6 +11,7 @@
 #include <catch2/catch.hpp>
 
 #include <cstddef>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <filesystem>
 #include <fstream>
+#include <map>
 
 using namespace CesiumAsync;
 using namespace Cesium3DTilesSelection;
@@ -942,6 +943,99 @@ TEST_CASE("Test multiple frustums") {
   }
 }
 
+TEST_CASE("Test updating many views offline") {
+  Cesium3DTilesSelection::registerAllTileContentTypes();
+
+  std::filesystem::path testDataPath = Cesium3DTilesSelection_TEST_DATA_DIR;
+  testDataPath = testDataPath / "ReplaceTileset";
+  std::vector<std::string> files{
+      "tileset.json",
+      "parent.b3dm",
+      "ll.b3dm",
+      "lr.b3dm",
+      "ul.b3dm",
+      "ur.b3dm",
+      "ll_ll.b3dm",
+  };
+
+  std::map<std::string, std::shared_ptr<SimpleAssetRequest>>
+      mockCompletedRequests;
+  for (const auto& file : files) {
+    std::unique_ptr<SimpleAssetResponse> mockCompletedResponse =
+        std::make_unique<SimpleAssetResponse>(
+            static_cast<uint16_t>(200),
+            "doesn't matter",
+            CesiumAsync::HttpHeaders{},
+            readFile(testDataPath / file));
+    mockCompletedRequests.insert(
+        {file,
+         std::make_shared<SimpleAssetRequest>(
+             "GET",
+             file,
+             CesiumAsync::HttpHeaders{},
+             std::move(mockCompletedResponse))});
+  }
+
+  std::shared_ptr<SimpleAssetAccessor> mockAssetAccessor =
+      std::make_shared<SimpleAssetAccessor>(std::move(mockCompletedRequests));
+  TilesetExternals tilesetExternals{
+      mockAssetAccessor,
+      std::make_shared<SimplePrepareRendererResource>(),
+      AsyncSystem(std::make_shared<SimpleTaskProcessor>()),
+      nullptr};
+
+  Tileset tileset(tilesetExternals, "tileset.json");
+  initializeTileset(tileset);
+
+  const Tile* root = tileset.getRootTile();
+  REQUIRE(root != nullptr);
+
+  // The root meets the SSE when zoomed out, but not when zoomed in.
+  ViewState zoomInViewState = zoomToTileset(tileset);
+  ViewState zoomOutViewState = ViewState::create(
+      zoomInViewState.getPosition() - zoomInViewState.getDirection() * 2500.0,
+      zoomInViewState.getDirection(),
+      zoomInViewState.getUp(),
+      zoomInViewState.getViewportSize(),
+      zoomInViewState.getHorizontalFieldOfView(),
+      zoomInViewState.getVerticalFieldOfView());
+
+  std::vector<std::vector<ViewState>> viewSets{
+      {zoomOutViewState},
+      {zoomInViewState},
+      {}};
+
+  OfflineViewUpdateOptions options;
+  options.viewSetsPerBatch = 2;
+  options.maximumSimultaneousTileLoads = 50;
+
+  std::vector<size_t> reportedViewSets;
+  tileset.updateViewsOffline(
+      viewSets,
+      [&](size_t viewSetIndex, const ViewUpdateResult& result) {
+        reportedViewSets.push_back(viewSetIndex);
+
+        for (const Tile* pTile : result.tilesToRenderThisFrame) {
+          CHECK(pTile->getState() == TileLoadState::Done);
+        }
+
+        if (viewSetIndex == 0) {
+          REQUIRE(result.tilesToRenderThisFrame.size() == 1);
+          CHECK(result.tilesToRenderThisFrame.front() == root);
+        } else if (viewSetIndex == 1) {
+          CHECK(result.tilesToRenderThisFrame.size() == 4);
+        } else {
+          CHECK(result.tilesToRenderThisFrame.empty());
+        }
+      },
+      options);
+
+  CHECK(reportedViewSets == std::vector<size_t>{0, 1, 2});
+
+  // The load limit is restored afterward.
+  CHECK(tileset.getOptions().maximumSimultaneousTileLoads == 20);
+}
+
 TEST_CASE("Can load example tileset.json from 3DTILES_bounding_volume_S2 "
           "documentation") {
   std::string s = R"(
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "IAssetAccessor.h"
+#include "Library.h"
+#include "ThreadPool.h"
+
+#include <spdlog/fwd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace CesiumAsync {
+class AsyncSystem;
+
+/**
+ * @brief Options for a {@link HttpAssetAccessor}.
+ */
+struct HttpAssetAccessorOptions {
+  /**
+   * @brief The maximum number of requests that may be in flight at once,
+   * across all hosts.
+   *
+   * Further requests are queued until an earlier one completes. This is also
+   * the number of threads dedicated to network I/O and to decoding
+   * compressed response bodies.
+   */
+  int32_t maximumSimultaneousRequests = 16;
+
+  /**
+   * @brief The maximum number of idle keep-alive connections kept open to
+   * each host.
+   *
+   * Connections beyond this limit are closed once their request completes.
+   */
+  size_t maximumIdleConnectionsPerHost = 6;
+
+  /**
+   * @brief The number of seconds to wait for a connection to be established.
+   */
+  int32_t connectionTimeoutSeconds = 10;
+
+  /**
+   * @brief The number of seconds to wait for data on an established
+   * connection before giving up on the request.
+   */
+  int32_t readTimeoutSeconds = 30;
+
+  /**
+   * @brief Headers that are added to every request, unless the request
+   * specifies a header with the same name.
+   */
+  std::vector<IAssetAccessor::THeader> defaultHeaders;
+};
+
+/**
+ * @brief An {@link IAssetAccessor} that downloads assets over HTTP.
+ *
+ * Connections are kept alive and pooled per host, so that consecutive
+ * requests to the same server reuse an open socket instead of paying for a
+ * new TCP handshake each time. Requests run on a dedicated thread pool whose
+ * size bounds the number of simultaneous requests.
+ *
+ * When cesium-native is built with the `CESIUM_HTTP_COMPRESSION_ENABLED`
+ * CMake option, which requires zlib and Brotli, requests send an
+ * `Accept-Encoding` header listing the encodings that can be decoded, and
+ * compressed responses are decoded on the request threads. The response
+ * then omits the `Content-Encoding` and `Content-Length` headers, which
+ * describe the encoded body. The option is off by default.
+ *
+ * Requests that fail before a response is received, for example because the
+ * host could not be reached, complete with an {@link IAssetRequest} whose
+ * {@link IAssetRequest::response} is `nullptr`.
+ *
+ * Only `http` URLs are supported unless the underlying HTTP library is built
+ * with OpenSSL support.
+ */
+class CESIUMASYNC_API HttpAssetAccessor : public IAssetAccessor {
+public:
+  /**
+   * @brief Constructs a new instance.
+   *
+   * @param pLogger The logger that receives messages about failed requests.
+   * @param options The {@link HttpAssetAccessorOptions} for this instance.
+   */
+  HttpAssetAccessor(
+      const std::shared_ptr<spdlog::logger>& pLogger,
+      const HttpAssetAccessorOptions& options = {});
+
+  virtual ~HttpAssetAccessor() noexcept override;
+
+  /** @copydoc IAssetAccessor::get */
+  virtual Future<std::shared_ptr<IAssetRequest>>
+  get(const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers) override;
+
+  /** @copydoc IAssetAccessor::request */
+  virtual Future<std::shared_ptr<IAssetRequest>> request(
+      const AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override;
+
+  /** @copydoc IAssetAccessor::tick */
+  virtual void tick() noexcept override;
+
+private:
+  class ConnectionPool;
+
+  std::shared_ptr<spdlog::logger> _pLogger;
+  std::shared_ptr<ConnectionPool> _pConnectionPool;
+  ThreadPool _requestThreadPool;
+};
+} // namespace CesiumAsync
@@ -1,7 +1,13 @@
 #pragma once
 
-#include <map>
+#include "Library.h"
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace CesiumAsync {
 
@@ -19,6 +25,168 @@ struct CaseInsensitiveCompare {
 
 /**
  * @brief Http Headers that maps case-insensitive header key with header value.
+ *
+ * The headers are stored in a single flat array sorted by key, which is much
+ * cheaper to build and search than a node-based map for the handful of
+ * headers a typical request or response carries. Copies share the same
+ * array. An instance modifies its array in place when no copy shares it, and
+ * otherwise modifies a new copy of it. So building headers one at a time
+ * does not copy them, passing the same headers to many requests, possibly on
+ * other threads, does not allocate, and reading one copy is never affected by
+ * modifying another.
+ *
+ * The interface mirrors the subset of `std::map` that is useful for headers.
+ * Headers are read through constant iterators, and changed with
+ * {@link insert_or_assign} or {@link operator[]}. Modifying an instance
+ * invalidates its iterators.
  */
-using HttpHeaders = std::map<std::string, std::string, CaseInsensitiveCompare>;
+class CESIUMASYNC_API HttpHeaders {
+public:
+  /**
+   * @brief A header represented as a key/value pair.
+   */
+  using value_type = std::pair<std::string, std::string>;
+
+  /**
+   * @brief A constant iterator over the headers, in case-insensitive key
+   * order.
+   */
+  using const_iterator = std::vector<value_type>::const_iterator;
+
+  /**
+   * @brief An iterator over the headers, in case-insensitive key order. The
+   * headers cannot be modified through it.
+   */
+  using iterator = const_iterator;
+
+  /**
+   * @brief Creates an empty set of headers. This does not allocate.
+   */
+  HttpHeaders() noexcept = default;
+
+  /**
+   * @brief Creates headers from a list of key/value pairs.
+   *
+   * If a key appears more than once, ignoring case, only its first value is
+   * kept.
+   */
+  HttpHeaders(std::initializer_list<value_type> headers);
+
+  /**
+   * @brief Creates headers from a range of key/value pairs, such as a
+   * `std::vector<IAssetAccessor::THeader>`.
+   *
+   * If a key appears more than once, ignoring case, only its first value is
+   * kept.
+   */
+  template <typename InputIt>
+  HttpHeaders(InputIt first, InputIt last)
+      : HttpHeaders(std::vector<value_type>(first, last)) {}
+
+  /**
+   * @brief Creates headers from an array of key/value pairs, taking ownership
+   * of the array.
+   *
+   * This is the cheapest way to build many headers at once. If a key appears
+   * more than once, ignoring case, only its first value is kept.
+   */
+  explicit HttpHeaders(std::vector<value_type>&& headers);
+
+  /** @brief Returns an iterator to the first header. */
+  const_iterator begin() const noexcept;
+
+  /** @brief Returns an iterator past the last header. */
+  const_iterator end() const noexcept;
+
+  /** @brief Returns the number of headers. */
+  size_t size() const noexcept;
+
+  /** @brief Returns `true` if there are no headers. */
+  bool empty() const noexcept;
+
+  /**
+   * @brief Finds the header with the given key, ignoring case.
+   *
+   * @return An iterator to the header, or {@link end} if there is none.
+   */
+  const_iterator find(const std::string& key) const;
+
+  /**
+   * @brief Returns `1` if there is a header with the given key, ignoring
+   * case, and `0` otherwise.
+   */
+  size_t count(const std::string& key) const;
+
+  /**
+   * @brief Gets the value of the header with the given key, ignoring case.
+   *
+   * @throws std::out_of_range If there is no such header.
+   */
+  const std::string& at(const std::string& key) const;
+
+  /**
+   * @brief Adds a header, unless a header with the same key already exists.
+   *
+   * @return An iterator to the header with the key, and whether the header
+   * was added.
+   */
+  std::pair<const_iterator, bool> emplace(std::string key, std::string value);
+
+  /** @copydoc emplace */
+  std::pair<const_iterator, bool> insert(const value_type& header);
+
+  /**
+   * @brief Adds a header, or replaces the value of the existing header with
+   * the same key.
+   *
+   * @return An iterator to the header with the key, and whether the header
+   * was added.
+   */
+  std::pair<const_iterator, bool>
+  insert_or_assign(const std::string& key, std::string value);
+
+  /**
+   * @brief Gets the value of the header with the given key, ignoring case,
+   * adding a header with an empty value if there is none.
+   *
+   * The returned reference must not be used once this instance is modified or
+   * copied.
+   */
+  std::string& operator[](const std::string& key);
+
+  /**
+   * @brief Removes the header with the given key, ignoring case.
+   *
+   * @return The number of headers removed, either `0` or `1`.
+   */
+  size_t erase(const std::string& key);
+
+  /** @brief Removes all headers. */
+  void clear() noexcept;
+
+  /**
+   * @brief Compares two sets of headers. Keys are compared case-sensitively,
+   * like a `std::map`.
+   */
+  bool operator==(const HttpHeaders& rhs) const noexcept;
+
+  /** @copydoc operator== */
+  bool operator!=(const HttpHeaders& rhs) const noexcept {
+    return !(*this == rhs);
+  }
+
+private:
+  // Adds a header to a sorted array, unless the key is already there, and
+  // returns the index of the header with the key and whether it was added.
+  static std::pair<size_t, bool> emplaceSorted(
+      std::vector<value_type>& headers,
+      std::string key,
+      std::string value);
+
+  // Returns the array to modify, which is this instance's own array if no
+  // copy shares it, and otherwise a new copy of it.
+  std::vector<value_type>& modify();
+
+  std::shared_ptr<std::vector<value_type>> _pHeaders;
+};
 } // namespace CesiumAsync
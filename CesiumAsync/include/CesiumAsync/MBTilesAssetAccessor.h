@@ -0,0 +1,128 @@
+#pragma once
+
+#include "IAssetAccessor.h"
+#include "Library.h"
+#include "ThreadPool.h"
+
+#include <spdlog/fwd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace CesiumAsync {
+class AsyncSystem;
+
+/**
+ * @brief Options for a {@link MBTilesAssetAccessor}.
+ */
+struct MBTilesAssetAccessorOptions {
+  /**
+   * @brief The prefix of the URLs that are read from the archive.
+   *
+   * The rest of such a URL is a path ending in `{z}/{x}/{y}`, optionally
+   * followed by a file extension, for example `mbtiles://tiles/3/5/2.png`.
+   * Requests for other URLs are passed on to the fallback asset accessor.
+   */
+  std::string urlPrefix = "mbtiles://";
+
+  /**
+   * @brief The maximum number of tiles that may be read at once.
+   *
+   * This is the number of threads dedicated to reading the archive, each of
+   * which uses its own read-only database connection.
+   */
+  int32_t maximumSimultaneousReads = 4;
+
+  /**
+   * @brief The maximum number of bytes of the archive that each connection
+   * maps into memory.
+   *
+   * Reads within the mapped part of the file are served from the operating
+   * system's page cache instead of being copied through SQLite's own cache.
+   * Zero disables memory mapping.
+   */
+  int64_t memoryMapBytes = 256 * 1024 * 1024;
+};
+
+/**
+ * @brief An {@link IAssetAccessor} that reads tiles from a local
+ * [MBTiles](https://github.com/mapbox/mbtiles-spec) archive.
+ *
+ * An MBTiles archive is a SQLite database holding a whole tileset, which is
+ * far cheaper to ship and to open than a directory of many small files. The
+ * tile at `{z}/{x}/{y}` is looked up by `zoom_level`, `tile_column` and
+ * `tile_row` respectively. MBTiles numbers rows from the south, as does the
+ * `{y}` placeholder of a `UrlTemplateRasterOverlay`, so the archive can be
+ * used as the source of such an overlay, as well as of the content of an
+ * implicitly tiled tileset.
+ *
+ * Reads run on a dedicated thread pool, each with its own read-only
+ * connection, so that they do not block each other or the worker threads.
+ *
+ * A tile that is in the archive completes with status code 200 and a
+ * `Content-Type` derived from the `format` in the archive's metadata. A tile
+ * that is not completes with status code 404. A request that fails to read
+ * the archive completes with an {@link IAssetRequest} whose
+ * {@link IAssetRequest::response} is `nullptr`.
+ */
+class CESIUMASYNC_API MBTilesAssetAccessor : public IAssetAccessor {
+public:
+  /**
+   * @brief Constructs a new instance.
+   *
+   * @param pLogger The logger that receives messages about failed reads.
+   * @param databaseName The file name of the MBTiles archive.
+   * @param pFallbackAssetAccessor The asset accessor that receives the
+   * requests for URLs that do not start with
+   * {@link MBTilesAssetAccessorOptions::urlPrefix}, or `nullptr` if such
+   * requests fail.
+   * @param options The {@link MBTilesAssetAccessorOptions} for this instance.
+   * @throws std::runtime_error If the archive cannot be opened.
+   */
+  MBTilesAssetAccessor(
+      const std::shared_ptr<spdlog::logger>& pLogger,
+      const std::string& databaseName,
+      const std::shared_ptr<IAssetAccessor>& pFallbackAssetAccessor = nullptr,
+      const MBTilesAssetAccessorOptions& options = {});
+
+  virtual ~MBTilesAssetAccessor() noexcept override;
+
+  /**
+   * @brief Gets the name-value pairs in the `metadata` table of the archive.
+   */
+  const std::map<std::string, std::string>& getMetadata() const noexcept {
+    return this->_metadata;
+  }
+
+  /** @copydoc IAssetAccessor::get */
+  virtual Future<std::shared_ptr<IAssetRequest>>
+  get(const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers) override;
+
+  /** @copydoc IAssetAccessor::request */
+  virtual Future<std::shared_ptr<IAssetRequest>> request(
+      const AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override;
+
+  /** @copydoc IAssetAccessor::tick */
+  virtual void tick() noexcept override;
+
+private:
+  class ConnectionPool;
+
+  std::shared_ptr<spdlog::logger> _pLogger;
+  std::shared_ptr<IAssetAccessor> _pFallbackAssetAccessor;
+  std::string _urlPrefix;
+  std::map<std::string, std::string> _metadata;
+  std::shared_ptr<ConnectionPool> _pConnectionPool;
+  ThreadPool _readThreadPool;
+};
+} // namespace CesiumAsync
@@ -361,16 +361,18 @@ std::time_t calculateExpiryTime(
 
 std::unique_ptr<IAssetRequest>
 updateCacheItem(CacheItem&& cacheItem, const IAssetRequest& request) {
-  for (const std::pair<const std::string, std::string>& header :
-       request.headers()) {
-    cacheItem.cacheRequest.headers[header.first] = header.second;
+  for (const HttpHeaders::value_type& header : request.headers()) {
+    cacheItem.cacheRequest.headers.insert_or_assign(
+        header.first,
+        header.second);
   }
 
   const IAssetResponse* pResponse = request.response();
   if (pResponse) {
-    for (const std::pair<const std::string, std::string>& header :
-         pResponse->headers()) {
-      cacheItem.cacheResponse.headers[header.first] = header.second;
+    for (const HttpHeaders::value_type& header : pResponse->headers()) {
+      cacheItem.cacheResponse.headers.insert_or_assign(
+          header.first,
+          header.second);
     }
   }
 
@@ -0,0 +1,357 @@
+#include "CesiumAsync/HttpAssetAccessor.h"
+
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/IAssetResponse.h"
+
+#include <httplib.h>
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace CesiumAsync {
+namespace {
+class HttpAssetResponse : public IAssetResponse {
+public:
+  HttpAssetResponse(
+      uint16_t statusCode,
+      HttpHeaders&& headers,
+      std::vector<std::byte>&& data) noexcept
+      : _statusCode(statusCode),
+        _headers(std::move(headers)),
+        _data(std::move(data)) {}
+
+  virtual uint16_t statusCode() const noexcept override {
+    return this->_statusCode;
+  }
+
+  virtual std::string contentType() const override {
+    auto it = this->_headers.find("Content-Type");
+    if (it == this->_headers.end()) {
+      return std::string();
+    }
+    return it->second;
+  }
+
+  virtual const HttpHeaders& headers() const noexcept override {
+    return this->_headers;
+  }
+
+  virtual gsl::span<const std::byte> data() const noexcept override {
+    return gsl::span<const std::byte>(this->_data.data(), this->_data.size());
+  }
+
+private:
+  uint16_t _statusCode;
+  HttpHeaders _headers;
+  std::vector<std::byte> _data;
+};
+
+class HttpAssetRequest : public IAssetRequest {
+public:
+  HttpAssetRequest(
+      const std::string& method,
+      const std::string& url,
+      HttpHeaders&& headers,
+      std::unique_ptr<HttpAssetResponse>&& pResponse) noexcept
+      : _method(method),
+        _url(url),
+        _headers(std::move(headers)),
+        _pResponse(std::move(pResponse)) {}
+
+  virtual const std::string& method() const noexcept override {
+    return this->_method;
+  }
+
+  virtual const std::string& url() const noexcept override {
+    return this->_url;
+  }
+
+  virtual const HttpHeaders& headers() const noexcept override {
+    return this->_headers;
+  }
+
+  virtual const IAssetResponse* response() const noexcept override {
+    return this->_pResponse.get();
+  }
+
+private:
+  std::string _method;
+  std::string _url;
+  HttpHeaders _headers;
+  std::unique_ptr<HttpAssetResponse> _pResponse;
+};
+
+struct SplitUrl {
+  /** @brief The scheme, host and port, e.g. `http://example.com:8080` */
+  std::string origin;
+
+  /** @brief The path and query, always starting with a `/`. */
+  std::string path;
+};
+
+std::optional<SplitUrl> splitUrl(const std::string& url) {
+  const size_t schemeEnd = url.find("://");
+  if (schemeEnd == std::string::npos) {
+    return std::nullopt;
+  }
+
+  const size_t pathStart = url.find_first_of("/?#", schemeEnd + 3);
+  if (pathStart == std::string::npos) {
+    return SplitUrl{url, "/"};
+  }
+
+  std::string path = url.substr(pathStart);
+  const size_t fragmentStart = path.find('#');
+  if (fragmentStart != std::string::npos) {
+    path.erase(fragmentStart);
+  }
+  if (path.empty() || path[0] != '/') {
+    path.insert(0, "/");
+  }
+
+  return SplitUrl{url.substr(0, pathStart), std::move(path)};
+}
+
+// The content codings that httplib can decode, for the Accept-Encoding
+// header. Empty if httplib is built without zlib and brotli.
+const std::string& getAcceptedEncodings() {
+  static const std::string encodings = []() {
+    std::string result;
+#ifdef CPPHTTPLIB_BROTLI_SUPPORT
+    result += "br";
+#endif
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+    result += result.empty() ? "gzip, deflate" : ", gzip, deflate";
+#endif
+    return result;
+  }();
+  return encodings;
+}
+
+bool isHeader(const std::string& name, const std::string& expected) {
+  const CaseInsensitiveCompare compare;
+  return !compare(name, expected) && !compare(expected, name);
+}
+
+std::unique_ptr<HttpAssetResponse>
+createResponse(httplib::Response& response) {
+  // If httplib has already decoded the body, the headers that describe the
+  // encoded body no longer apply to it.
+  const std::string encoding = response.get_header_value("Content-Encoding");
+  bool decoded = false;
+#ifdef CPPHTTPLIB_BROTLI_SUPPORT
+  decoded = decoded || encoding == "br";
+#endif
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+  decoded = decoded || encoding == "gzip" || encoding == "deflate";
+#endif
+
+  HttpHeaders headers;
+  for (const auto& header : response.headers) {
+    if (decoded && (isHeader(header.first, "Content-Encoding") ||
+                    isHeader(header.first, "Content-Length"))) {
+      continue;
+    }
+
+    // Repeated headers are folded into a single comma-separated value, as
+    // permitted by RFC 7230 section 3.2.2.
+    HttpHeaders::const_iterator it = headers.find(header.first);
+    if (it == headers.end()) {
+      headers.emplace(header.first, header.second);
+    } else {
+      headers.insert_or_assign(header.first, it->second + ", " + header.second);
+    }
+  }
+
+  std::vector<std::byte> data(response.body.size());
+  std::memcpy(data.data(), response.body.data(), response.body.size());
+
+  return std::make_unique<HttpAssetResponse>(
+      static_cast<uint16_t>(response.status),
+      std::move(headers),
+      std::move(data));
+}
+} // namespace
+
+/**
+ * @brief Keeps idle keep-alive connections, keyed on the origin they are
+ * connected to, so they can be reused by later requests to the same host.
+ */
+class HttpAssetAccessor::ConnectionPool {
+public:
+  ConnectionPool(const HttpAssetAccessorOptions& options)
+      : _options(options) {}
+
+  std::shared_ptr<IAssetRequest> send(
+      const std::shared_ptr<spdlog::logger>& pLogger,
+      const std::string& verb,
+      const std::string& url,
+      HttpHeaders&& headers,
+      const std::vector<std::byte>& contentPayload) {
+    for (const THeader& header : this->_options.defaultHeaders) {
+      headers.emplace(header.first, header.second);
+    }
+    if (!getAcceptedEncodings().empty()) {
+      headers.emplace("Accept-Encoding", getAcceptedEncodings());
+    }
+
+    std::unique_ptr<HttpAssetResponse> pResponse;
+
+    std::optional<SplitUrl> maybeSplitUrl = splitUrl(url);
+    if (!maybeSplitUrl) {
+      SPDLOG_LOGGER_ERROR(
+          pLogger,
+          "Cannot request {} because it is not an absolute URL.",
+          url);
+      return std::make_shared<HttpAssetRequest>(
+          verb,
+          url,
+          std::move(headers),
+          std::move(pResponse));
+    }
+
+    std::unique_ptr<httplib::Client> pClient =
+        this->acquire(maybeSplitUrl->origin);
+    if (!pClient->is_valid()) {
+      SPDLOG_LOGGER_ERROR(
+          pLogger,
+          "Cannot request {} because its scheme is not supported.",
+          url);
+      return std::make_shared<HttpAssetRequest>(
+          verb,
+          url,
+          std::move(headers),
+          std::move(pResponse));
+    }
+
+    httplib::Request request;
+    request.method = verb;
+    request.path = std::move(maybeSplitUrl->path);
+    for (const auto& header : headers) {
+      request.headers.emplace(header.first, header.second);
+    }
+    if (!contentPayload.empty()) {
+      request.body.assign(
+          reinterpret_cast<const char*>(contentPayload.data()),
+          contentPayload.size());
+    }
+
+    httplib::Result result = pClient->send(request);
+    if (result) {
+      pResponse = createResponse(*result);
+      this->release(maybeSplitUrl->origin, std::move(pClient));
+    } else {
+      // Don't return a connection in an unknown state to the pool.
+      SPDLOG_LOGGER_ERROR(
+          pLogger,
+          "Request for {} failed: {}",
+          url,
+          httplib::to_string(result.error()));
+    }
+
+    return std::make_shared<HttpAssetRequest>(
+        verb,
+        url,
+        std::move(headers),
+        std::move(pResponse));
+  }
+
+private:
+  std::unique_ptr<httplib::Client> acquire(const std::string& origin) {
+    {
+      std::lock_guard<std::mutex> lock(this->_mutex);
+      auto it = this->_idleConnections.find(origin);
+      if (it != this->_idleConnections.end() && !it->second.empty()) {
+        std::unique_ptr<httplib::Client> pClient = std::move(it->second.back());
+        it->second.pop_back();
+        return pClient;
+      }
+    }
+
+    std::unique_ptr<httplib::Client> pClient =
+        std::make_unique<httplib::Client>(origin);
+    pClient->set_keep_alive(true);
+    pClient->set_follow_location(true);
+    pClient->set_decompress(true);
+    pClient->set_connection_timeout(
+        static_cast<time_t>(this->_options.connectionTimeoutSeconds),
+        0);
+    pClient->set_read_timeout(
+        static_cast<time_t>(this->_options.readTimeoutSeconds),
+        0);
+    return pClient;
+  }
+
+  void release(
+      const std::string& origin,
+      std::unique_ptr<httplib::Client>&& pClient) {
+    std::unique_ptr<httplib::Client> pDiscarded;
+    {
+      std::lock_guard<std::mutex> lock(this->_mutex);
+      std::vector<std::unique_ptr<httplib::Client>>& idle =
+          this->_idleConnections[origin];
+      if (idle.size() < this->_options.maximumIdleConnectionsPerHost) {
+        idle.emplace_back(std::move(pClient));
+      } else {
+        pDiscarded = std::move(pClient);
+      }
+    }
+
+    // pDiscarded closes its connection here, outside the lock.
+  }
+
+  HttpAssetAccessorOptions _options;
+  std::mutex _mutex;
+  std::unordered_map<std::string, std::vector<std::unique_ptr<httplib::Client>>>
+      _idleConnections;
+};
+
+HttpAssetAccessor::HttpAssetAccessor(
+    const std::shared_ptr<spdlog::logger>& pLogger,
+    const HttpAssetAccessorOptions& options)
+    : _pLogger(pLogger),
+      _pConnectionPool(std::make_shared<ConnectionPool>(options)),
+      _requestThreadPool(options.maximumSimultaneousRequests) {}
+
+HttpAssetAccessor::~HttpAssetAccessor() noexcept {}
+
+Future<std::shared_ptr<IAssetRequest>> HttpAssetAccessor::get(
+    const AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<THeader>& headers) {
+  return this->request(asyncSystem, "GET", url, headers, {});
+}
+
+Future<std::shared_ptr<IAssetRequest>> HttpAssetAccessor::request(
+    const AsyncSystem& asyncSystem,
+    const std::string& verb,
+    const std::string& url,
+    const std::vector<THeader>& headers,
+    const gsl::span<const std::byte>& contentPayload) {
+  // The payload span is only valid for the duration of this call.
+  std::vector<std::byte> payload(contentPayload.begin(), contentPayload.end());
+
+  return asyncSystem.runInThreadPool(
+      this->_requestThreadPool,
+      [pLogger = this->_pLogger,
+       pConnectionPool = this->_pConnectionPool,
+       verb,
+       url,
+       requestHeaders = HttpHeaders(headers.begin(), headers.end()),
+       payload = std::move(payload)]() mutable {
+        return pConnectionPool->send(
+            pLogger,
+            verb,
+            url,
+            std::move(requestHeaders),
+            payload);
+      });
+}
+
+void HttpAssetAccessor::tick() noexcept {}
+} // namespace CesiumAsync
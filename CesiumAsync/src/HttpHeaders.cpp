@@ -1,14 +1,52 @@
 #include "CesiumAsync/HttpHeaders.h"
 
 #include <algorithm>
+#include <atomic>
+#include <stdexcept>
 
 namespace CesiumAsync {
+namespace {
+unsigned char toLowerAscii(unsigned char c) noexcept {
+  return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + ('a' - 'A'))
+                                : c;
+}
+
 struct NocaseCompare {
   bool operator()(const unsigned char& c1, const unsigned char& c2) const {
-    return tolower(c1) < tolower(c2);
+    return toLowerAscii(c1) < toLowerAscii(c2);
   }
 };
 
+bool equalsIgnoringCase(const std::string& s1, const std::string& s2) {
+  return s1.size() == s2.size() &&
+         std::equal(
+             s1.begin(),
+             s1.end(),
+             s2.begin(),
+             [](unsigned char c1, unsigned char c2) {
+               return toLowerAscii(c1) == toLowerAscii(c2);
+             });
+}
+
+// Iterators into this vector stand in for the iterators of an instance that
+// has never allocated storage.
+const std::vector<HttpHeaders::value_type>& emptyHeaders() {
+  static const std::vector<HttpHeaders::value_type> empty;
+  return empty;
+}
+
+template <typename Iterator>
+Iterator lowerBound(Iterator begin, Iterator end, const std::string& key) {
+  return std::lower_bound(
+      begin,
+      end,
+      key,
+      [](const HttpHeaders::value_type& header, const std::string& value) {
+        return CaseInsensitiveCompare()(header.first, value);
+      });
+}
+} // namespace
+
 bool CaseInsensitiveCompare::operator()(
     const std::string& s1,
     const std::string& s2) const {
@@ -19,4 +57,146 @@ bool CaseInsensitiveCompare::operator()(
       s2.end(),
       NocaseCompare());
 }
+
+HttpHeaders::HttpHeaders(std::initializer_list<value_type> headers)
+    : HttpHeaders(headers.begin(), headers.end()) {}
+
+HttpHeaders::HttpHeaders(std::vector<value_type>&& headers) {
+  if (headers.empty()) {
+    return;
+  }
+
+  // Sort stably and then drop the later headers with each key, so the first
+  // value of each key is kept.
+  std::stable_sort(
+      headers.begin(),
+      headers.end(),
+      [](const value_type& lhs, const value_type& rhs) {
+        return CaseInsensitiveCompare()(lhs.first, rhs.first);
+      });
+  headers.erase(
+      std::unique(
+          headers.begin(),
+          headers.end(),
+          [](const value_type& lhs, const value_type& rhs) {
+            return equalsIgnoringCase(lhs.first, rhs.first);
+          }),
+      headers.end());
+  this->_pHeaders =
+      std::make_shared<std::vector<value_type>>(std::move(headers));
+}
+
+HttpHeaders::const_iterator HttpHeaders::begin() const noexcept {
+  return this->_pHeaders ? this->_pHeaders->cbegin() : emptyHeaders().cbegin();
+}
+
+HttpHeaders::const_iterator HttpHeaders::end() const noexcept {
+  return this->_pHeaders ? this->_pHeaders->cend() : emptyHeaders().cend();
+}
+
+size_t HttpHeaders::size() const noexcept {
+  return this->_pHeaders ? this->_pHeaders->size() : 0;
+}
+
+bool HttpHeaders::empty() const noexcept { return this->size() == 0; }
+
+HttpHeaders::const_iterator HttpHeaders::find(const std::string& key) const {
+  const_iterator it = lowerBound(this->begin(), this->end(), key);
+  if (it != this->end() && equalsIgnoringCase(it->first, key)) {
+    return it;
+  }
+  return this->end();
+}
+
+size_t HttpHeaders::count(const std::string& key) const {
+  return this->find(key) == this->end() ? 0 : 1;
+}
+
+const std::string& HttpHeaders::at(const std::string& key) const {
+  const_iterator it = this->find(key);
+  if (it == this->end()) {
+    throw std::out_of_range("No HTTP header named " + key);
+  }
+  return it->second;
+}
+
+std::pair<HttpHeaders::const_iterator, bool>
+HttpHeaders::emplace(std::string key, std::string value) {
+  const_iterator it = this->find(key);
+  if (it != this->end()) {
+    return {it, false};
+  }
+
+  const size_t index =
+      emplaceSorted(this->modify(), std::move(key), std::move(value)).first;
+  return {this->begin() + std::ptrdiff_t(index), true};
+}
+
+std::pair<HttpHeaders::const_iterator, bool>
+HttpHeaders::insert(const value_type& header) {
+  return this->emplace(header.first, header.second);
+}
+
+std::pair<HttpHeaders::const_iterator, bool>
+HttpHeaders::insert_or_assign(const std::string& key, std::string value) {
+  std::vector<value_type>& headers = this->modify();
+  const std::pair<size_t, bool> result =
+      emplaceSorted(headers, key, std::string());
+  headers[result.first].second = std::move(value);
+  return {this->begin() + std::ptrdiff_t(result.first), result.second};
+}
+
+std::string& HttpHeaders::operator[](const std::string& key) {
+  std::vector<value_type>& headers = this->modify();
+  return headers[emplaceSorted(headers, key, std::string()).first].second;
+}
+
+size_t HttpHeaders::erase(const std::string& key) {
+  const_iterator it = this->find(key);
+  if (it == this->end()) {
+    return 0;
+  }
+
+  const std::ptrdiff_t index = it - this->begin();
+  std::vector<value_type>& headers = this->modify();
+  headers.erase(headers.begin() + index);
+  return 1;
+}
+
+void HttpHeaders::clear() noexcept { this->_pHeaders.reset(); }
+
+bool HttpHeaders::operator==(const HttpHeaders& rhs) const noexcept {
+  return this->_pHeaders == rhs._pHeaders ||
+         std::equal(this->begin(), this->end(), rhs.begin(), rhs.end());
+}
+
+/*static*/ std::pair<size_t, bool> HttpHeaders::emplaceSorted(
+    std::vector<value_type>& headers,
+    std::string key,
+    std::string value) {
+  auto it = lowerBound(headers.begin(), headers.end(), key);
+  const size_t index = size_t(it - headers.begin());
+  if (it != headers.end() && equalsIgnoringCase(it->first, key)) {
+    return {index, false};
+  }
+  headers.emplace(it, std::move(key), std::move(value));
+  return {index, true};
+}
+
+std::vector<HttpHeaders::value_type>& HttpHeaders::modify() {
+  if (!this->_pHeaders) {
+    this->_pHeaders = std::make_shared<std::vector<value_type>>();
+    // Most requests and responses carry only a few headers.
+    this->_pHeaders->reserve(8);
+  } else if (this->_pHeaders.use_count() != 1) {
+    this->_pHeaders =
+        std::make_shared<std::vector<value_type>>(*this->_pHeaders);
+  } else {
+    // Copies on other threads may have just released the array. Their
+    // release synchronizes with this fence, so their reads of the array
+    // happen before it is modified.
+    std::atomic_thread_fence(std::memory_order_acquire);
+  }
+  return *this->_pHeaders;
+}
 } // namespace CesiumAsync
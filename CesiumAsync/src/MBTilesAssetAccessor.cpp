@@ -0,0 +1,471 @@
+#include "CesiumAsync/MBTilesAssetAccessor.h"
+
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/IAssetResponse.h"
+
+#include <CesiumUtility/Tracing.h>
+#include <cesium-sqlite3.h>
+
+#include <spdlog/spdlog.h>
+#include <sqlite3.h>
+
+#include <charconv>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace CesiumAsync {
+namespace {
+const std::string GET_TILE_SQL =
+    "SELECT tile_data FROM tiles WHERE zoom_level = ? AND tile_column = ? AND "
+    "tile_row = ?";
+
+const std::string GET_METADATA_SQL = "SELECT name, value FROM metadata";
+
+struct DeleteSqliteConnection {
+  void operator()(CESIUM_SQLITE(sqlite3*) pConnection) noexcept {
+    CESIUM_SQLITE(sqlite3_close_v2)(pConnection);
+  }
+};
+
+struct DeleteSqliteStatement {
+  void operator()(CESIUM_SQLITE(sqlite3_stmt*) pStatement) noexcept {
+    CESIUM_SQLITE(sqlite3_finalize)(pStatement);
+  }
+};
+
+using SqliteConnectionPtr =
+    std::unique_ptr<CESIUM_SQLITE(sqlite3), DeleteSqliteConnection>;
+using SqliteStatementPtr =
+    std::unique_ptr<CESIUM_SQLITE(sqlite3_stmt), DeleteSqliteStatement>;
+
+void throwIfFailed(int status, int expected) {
+  if (status != expected) {
+    throw std::runtime_error(CESIUM_SQLITE(sqlite3_errstr)(status));
+  }
+}
+
+SqliteStatementPtr prepareStatement(
+    const SqliteConnectionPtr& pConnection,
+    const std::string& sql) {
+  CESIUM_SQLITE(sqlite3_stmt*) pStmt;
+  const int status = CESIUM_SQLITE(sqlite3_prepare_v2)(
+      pConnection.get(),
+      sql.c_str(),
+      int(sql.size()),
+      &pStmt,
+      nullptr);
+  throwIfFailed(status, SQLITE_OK);
+  return SqliteStatementPtr(pStmt);
+}
+
+std::string getTextColumn(const SqliteStatementPtr& pStatement, int column) {
+  const char* pText = reinterpret_cast<const char*>(
+      CESIUM_SQLITE(sqlite3_column_text)(pStatement.get(), column));
+  return pText ? std::string(pText) : std::string();
+}
+
+std::string getContentType(const std::map<std::string, std::string>& metadata) {
+  auto it = metadata.find("format");
+  if (it == metadata.end()) {
+    return std::string();
+  }
+
+  const std::string& format = it->second;
+  if (format == "png") {
+    return "image/png";
+  } else if (format == "jpg" || format == "jpeg") {
+    return "image/jpeg";
+  } else if (format == "webp") {
+    return "image/webp";
+  } else if (format == "pbf") {
+    return "application/x-protobuf";
+  } else if (format == "glb") {
+    return "model/gltf-binary";
+  }
+  return "application/octet-stream";
+}
+
+struct TileCoordinates {
+  int64_t level;
+  int64_t column;
+  int64_t row;
+};
+
+std::optional<int64_t> parseCoordinate(const std::string& segment) {
+  int64_t value = 0;
+  const char* pEnd = segment.data() + segment.size();
+  const std::from_chars_result result =
+      std::from_chars(segment.data(), pEnd, value);
+  if (segment.empty() || result.ec != std::errc() || result.ptr != pEnd ||
+      value < 0) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+// Parses the `{z}/{x}/{y}` at the end of the path following the URL prefix,
+// ignoring any file extension, query and fragment.
+std::optional<TileCoordinates> parseTileCoordinates(std::string path) {
+  const size_t queryStart = path.find_first_of("?#");
+  if (queryStart != std::string::npos) {
+    path.erase(queryStart);
+  }
+
+  std::optional<int64_t> coordinates[3];
+  for (size_t i = 3; i > 0; --i) {
+    const size_t separator = path.rfind('/');
+    std::string segment =
+        separator == std::string::npos ? path : path.substr(separator + 1);
+    if (i == 3) {
+      const size_t extensionStart = segment.find('.');
+      if (extensionStart != std::string::npos) {
+        segment.erase(extensionStart);
+      }
+    }
+
+    coordinates[i - 1] = parseCoordinate(segment);
+    if (!coordinates[i - 1]) {
+      return std::nullopt;
+    }
+
+    path.erase(separator == std::string::npos ? 0 : separator);
+  }
+
+  return TileCoordinates{*coordinates[0], *coordinates[1], *coordinates[2]};
+}
+
+class MBTilesAssetResponse : public IAssetResponse {
+public:
+  MBTilesAssetResponse(
+      uint16_t statusCode,
+      HttpHeaders&& headers,
+      std::vector<std::byte>&& data) noexcept
+      : _statusCode(statusCode),
+        _headers(std::move(headers)),
+        _data(std::move(data)) {}
+
+  virtual uint16_t statusCode() const noexcept override {
+    return this->_statusCode;
+  }
+
+  virtual std::string contentType() const override {
+    auto it = this->_headers.find("Content-Type");
+    if (it == this->_headers.end()) {
+      return std::string();
+    }
+    return it->second;
+  }
+
+  virtual const HttpHeaders& headers() const noexcept override {
+    return this->_headers;
+  }
+
+  virtual gsl::span<const std::byte> data() const noexcept override {
+    return gsl::span<const std::byte>(this->_data.data(), this->_data.size());
+  }
+
+private:
+  uint16_t _statusCode;
+  HttpHeaders _headers;
+  std::vector<std::byte> _data;
+};
+
+class MBTilesAssetRequest : public IAssetRequest {
+public:
+  MBTilesAssetRequest(
+      const std::string& method,
+      const std::string& url,
+      HttpHeaders&& headers,
+      std::unique_ptr<MBTilesAssetResponse>&& pResponse) noexcept
+      : _method(method),
+        _url(url),
+        _headers(std::move(headers)),
+        _pResponse(std::move(pResponse)) {}
+
+  virtual const std::string& method() const noexcept override {
+    return this->_method;
+  }
+
+  virtual const std::string& url() const noexcept override {
+    return this->_url;
+  }
+
+  virtual const HttpHeaders& headers() const noexcept override {
+    return this->_headers;
+  }
+
+  virtual const IAssetResponse* response() const noexcept override {
+    return this->_pResponse.get();
+  }
+
+private:
+  std::string _method;
+  std::string _url;
+  HttpHeaders _headers;
+  std::unique_ptr<MBTilesAssetResponse> _pResponse;
+};
+} // namespace
+
+/**
+ * @brief Keeps idle read-only connections to the archive, each with its tile
+ * query already prepared, so they can be reused by later reads.
+ *
+ * A connection is used by one thread at a time, so SQLite does not need to
+ * serialize access to it.
+ */
+class MBTilesAssetAccessor::ConnectionPool {
+public:
+  ConnectionPool(const std::string& databaseName, int64_t memoryMapBytes)
+      : _databaseName(databaseName), _memoryMapBytes(memoryMapBytes) {
+    // Open the first connection eagerly, so that a missing or invalid
+    // archive is reported by the constructor.
+    this->_idleConnections.emplace_back(this->open());
+  }
+
+  std::map<std::string, std::string> readMetadata() {
+    std::unique_ptr<Connection> pConnection = this->acquire();
+
+    std::map<std::string, std::string> metadata;
+    SqliteStatementPtr pStatement =
+        prepareStatement(pConnection->pConnection, GET_METADATA_SQL);
+    int status = CESIUM_SQLITE(sqlite3_step)(pStatement.get());
+    while (status == SQLITE_ROW) {
+      metadata[getTextColumn(pStatement, 0)] = getTextColumn(pStatement, 1);
+      status = CESIUM_SQLITE(sqlite3_step)(pStatement.get());
+    }
+    throwIfFailed(status, SQLITE_DONE);
+
+    this->_contentType = getContentType(metadata);
+    this->release(std::move(pConnection));
+    return metadata;
+  }
+
+  std::shared_ptr<IAssetRequest> read(
+      const std::shared_ptr<spdlog::logger>& pLogger,
+      const std::string& verb,
+      const std::string& url,
+      const std::string& path,
+      HttpHeaders&& headers) {
+    CESIUM_TRACE("MBTilesAssetAccessor::ConnectionPool::read");
+
+    std::unique_ptr<MBTilesAssetResponse> pResponse;
+
+    std::optional<TileCoordinates> maybeCoordinates =
+        parseTileCoordinates(path);
+    if (verb != "GET") {
+      pResponse = std::make_unique<MBTilesAssetResponse>(
+          uint16_t(405),
+          HttpHeaders(),
+          std::vector<std::byte>());
+    } else if (!maybeCoordinates) {
+      pResponse = std::make_unique<MBTilesAssetResponse>(
+          uint16_t(404),
+          HttpHeaders(),
+          std::vector<std::byte>());
+    } else {
+      try {
+        std::unique_ptr<Connection> pConnection = this->acquire();
+        pResponse = this->readTile(*pConnection, *maybeCoordinates);
+        this->release(std::move(pConnection));
+      } catch (const std::exception& e) {
+        // Don't return a connection in an unknown state to the pool.
+        SPDLOG_LOGGER_ERROR(
+            pLogger,
+            "Failed to read {} from MBTiles archive {}: {}",
+            url,
+            this->_databaseName,
+            e.what());
+      }
+    }
+
+    return std::make_shared<MBTilesAssetRequest>(
+        verb,
+        url,
+        std::move(headers),
+        std::move(pResponse));
+  }
+
+private:
+  struct Connection {
+    SqliteConnectionPtr pConnection;
+    SqliteStatementPtr pGetTile;
+  };
+
+  std::unique_ptr<Connection> open() const {
+    CESIUM_SQLITE(sqlite3*) pRawConnection = nullptr;
+    const int status = CESIUM_SQLITE(sqlite3_open_v2)(
+        this->_databaseName.c_str(),
+        &pRawConnection,
+        SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX,
+        nullptr);
+
+    // A handle is usually returned even when opening fails, and must still
+    // be closed.
+    SqliteConnectionPtr pConnection(pRawConnection);
+    throwIfFailed(status, SQLITE_OK);
+
+    if (this->_memoryMapBytes > 0) {
+      SqliteStatementPtr pMemoryMap = prepareStatement(
+          pConnection,
+          "PRAGMA mmap_size=" + std::to_string(this->_memoryMapBytes));
+      const int mmapStatus = CESIUM_SQLITE(sqlite3_step)(pMemoryMap.get());
+      if (mmapStatus != SQLITE_ROW && mmapStatus != SQLITE_DONE) {
+        throwIfFailed(mmapStatus, SQLITE_DONE);
+      }
+    }
+
+    SqliteStatementPtr pGetTile = prepareStatement(pConnection, GET_TILE_SQL);
+    return std::make_unique<Connection>(
+        Connection{std::move(pConnection), std::move(pGetTile)});
+  }
+
+  std::unique_ptr<Connection> acquire() {
+    {
+      std::lock_guard<std::mutex> lock(this->_mutex);
+      if (!this->_idleConnections.empty()) {
+        std::unique_ptr<Connection> pConnection =
+            std::move(this->_idleConnections.back());
+        this->_idleConnections.pop_back();
+        return pConnection;
+      }
+    }
+
+    return this->open();
+  }
+
+  void release(std::unique_ptr<Connection>&& pConnection) {
+    // The number of connections is bounded by the number of read threads, so
+    // every released connection is kept.
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    this->_idleConnections.emplace_back(std::move(pConnection));
+  }
+
+  std::unique_ptr<MBTilesAssetResponse>
+  readTile(Connection& connection, const TileCoordinates& coordinates) const {
+    CESIUM_SQLITE(sqlite3_stmt*) pGetTile = connection.pGetTile.get();
+    throwIfFailed(CESIUM_SQLITE(sqlite3_reset)(pGetTile), SQLITE_OK);
+    throwIfFailed(
+        CESIUM_SQLITE(sqlite3_bind_int64)(pGetTile, 1, coordinates.level),
+        SQLITE_OK);
+    throwIfFailed(
+        CESIUM_SQLITE(sqlite3_bind_int64)(pGetTile, 2, coordinates.column),
+        SQLITE_OK);
+    throwIfFailed(
+        CESIUM_SQLITE(sqlite3_bind_int64)(pGetTile, 3, coordinates.row),
+        SQLITE_OK);
+
+    const int status = CESIUM_SQLITE(sqlite3_step)(pGetTile);
+    if (status == SQLITE_DONE) {
+      CESIUM_SQLITE(sqlite3_reset)(pGetTile);
+      return std::make_unique<MBTilesAssetResponse>(
+          uint16_t(404),
+          HttpHeaders(),
+          std::vector<std::byte>());
+    }
+    throwIfFailed(status, SQLITE_ROW);
+
+    // The blob points into the memory-mapped file when the tile lies within
+    // the mapped range, so this is the only copy of the tile data.
+    const std::byte* pData = reinterpret_cast<const std::byte*>(
+        CESIUM_SQLITE(sqlite3_column_blob)(pGetTile, 0));
+    const int size = CESIUM_SQLITE(sqlite3_column_bytes)(pGetTile, 0);
+    std::vector<std::byte> data(pData, pData + size);
+
+    // Resetting the statement ends the read transaction, so it does not keep
+    // a snapshot of the archive open between reads.
+    CESIUM_SQLITE(sqlite3_reset)(pGetTile);
+
+    HttpHeaders headers;
+    if (!this->_contentType.empty()) {
+      headers.emplace("Content-Type", this->_contentType);
+    }
+    return std::make_unique<MBTilesAssetResponse>(
+        uint16_t(200),
+        std::move(headers),
+        std::move(data));
+  }
+
+  std::string _databaseName;
+  int64_t _memoryMapBytes;
+  std::string _contentType;
+  std::mutex _mutex;
+  std::vector<std::unique_ptr<Connection>> _idleConnections;
+};
+
+MBTilesAssetAccessor::MBTilesAssetAccessor(
+    const std::shared_ptr<spdlog::logger>& pLogger,
+    const std::string& databaseName,
+    const std::shared_ptr<IAssetAccessor>& pFallbackAssetAccessor,
+    const MBTilesAssetAccessorOptions& options)
+    : _pLogger(pLogger),
+      _pFallbackAssetAccessor(pFallbackAssetAccessor),
+      _urlPrefix(options.urlPrefix),
+      _metadata(),
+      _pConnectionPool(std::make_shared<ConnectionPool>(
+          databaseName,
+          options.memoryMapBytes)),
+      _readThreadPool(options.maximumSimultaneousReads) {
+  this->_metadata = this->_pConnectionPool->readMetadata();
+}
+
+MBTilesAssetAccessor::~MBTilesAssetAccessor() noexcept {}
+
+Future<std::shared_ptr<IAssetRequest>> MBTilesAssetAccessor::get(
+    const AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<THeader>& headers) {
+  if (url.compare(0, this->_urlPrefix.size(), this->_urlPrefix) != 0 &&
+      this->_pFallbackAssetAccessor) {
+    return this->_pFallbackAssetAccessor->get(asyncSystem, url, headers);
+  }
+  return this->request(asyncSystem, "GET", url, headers, {});
+}
+
+Future<std::shared_ptr<IAssetRequest>> MBTilesAssetAccessor::request(
+    const AsyncSystem& asyncSystem,
+    const std::string& verb,
+    const std::string& url,
+    const std::vector<THeader>& headers,
+    const gsl::span<const std::byte>& contentPayload) {
+  if (url.compare(0, this->_urlPrefix.size(), this->_urlPrefix) != 0) {
+    if (this->_pFallbackAssetAccessor) {
+      return this->_pFallbackAssetAccessor
+          ->request(asyncSystem, verb, url, headers, contentPayload);
+    }
+
+    SPDLOG_LOGGER_ERROR(
+        this->_pLogger,
+        "Cannot request {} because it does not start with {} and there is no "
+        "fallback asset accessor.",
+        url,
+        this->_urlPrefix);
+    return asyncSystem.createResolvedFuture<std::shared_ptr<IAssetRequest>>(
+        std::make_shared<MBTilesAssetRequest>(
+            verb,
+            url,
+            HttpHeaders(headers.begin(), headers.end()),
+            nullptr));
+  }
+
+  return asyncSystem.runInThreadPool(
+      this->_readThreadPool,
+      [pLogger = this->_pLogger,
+       pConnectionPool = this->_pConnectionPool,
+       verb,
+       url,
+       path = url.substr(this->_urlPrefix.size()),
+       requestHeaders = HttpHeaders(headers.begin(), headers.end())]() mutable
+      -> std::shared_ptr<IAssetRequest> {
+        return pConnectionPool
+            ->read(pLogger, verb, url, path, std::move(requestHeaders));
+      });
+}
+
+void MBTilesAssetAccessor::tick() noexcept {
+  if (this->_pFallbackAssetAccessor) {
+    this->_pFallbackAssetAccessor->tick();
+  }
+}
+} // namespace CesiumAsync
@@ -2,17 +2,19 @@
 
 #include "CesiumAsync/IAssetResponse.h"
 
+#include <CesiumUtility/Metrics.h>
 #include <CesiumUtility/Tracing.h>
 #include <cesium-sqlite3.h>
 
 #include <rapidjson/document.h>
-#include <rapidjson/writer.h>
 #include <spdlog/spdlog.h>
 #include <sqlite3.h>
 
 #include <cstddef>
+#include <cstring>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 using namespace CesiumAsync;
 
@@ -31,15 +33,20 @@ const std::string CACHE_TABLE_REQUEST_METHOD_COLUMN = "requestMethod";
 const std::string CACHE_TABLE_REQUEST_URL_COLUMN = "requestUrl";
 const std::string CACHE_TABLE_VIRTUAL_TOTAL_ITEMS_COLUMN = "totalItems";
 
+// The version of the cache schema, stored in the database's user_version.
+// Version 0 stored headers as JSON text. Version 1 stores them in the binary
+// encoding written by encodeHeaders.
+const int CACHE_SCHEMA_VERSION = 1;
+
 // Sql commands for setting up database
 const std::string CREATE_CACHE_TABLE_SQL =
     "CREATE TABLE IF NOT EXISTS " + CACHE_TABLE + "(" + CACHE_TABLE_KEY_COLUMN +
     " TEXT PRIMARY KEY NOT NULL," + CACHE_TABLE_EXPIRY_TIME_COLUMN +
     " DATETIME NOT NULL," + CACHE_TABLE_LAST_ACCESSED_TIME_COLUMN +
     " DATETIME NOT NULL," + CACHE_TABLE_RESPONSE_HEADER_COLUMN +
-    " TEXT NOT NULL," + CACHE_TABLE_RESPONSE_STATUS_CODE_COLUMN +
+    " BLOB NOT NULL," + CACHE_TABLE_RESPONSE_STATUS_CODE_COLUMN +
     " INTEGER NOT NULL," + CACHE_TABLE_RESPONSE_DATA_COLUMN + " BLOB," +
-    CACHE_TABLE_REQUEST_HEADER_COLUMN + " TEXT NOT NULL," +
+    CACHE_TABLE_REQUEST_HEADER_COLUMN + " BLOB NOT NULL," +
     CACHE_TABLE_REQUEST_METHOD_COLUMN + " TEXT NOT NULL," +
     CACHE_TABLE_REQUEST_URL_COLUMN + " TEXT NOT NULL)";
 
@@ -49,6 +56,25 @@ const std::string PRAGMA_SYNC_SQL = "PRAGMA synchronous=OFF";
 
 const std::string PRAGMA_PAGE_SIZE_SQL = "PRAGMA page_size=4096";
 
+// Sql commands for migrating the database from older schema versions
+const std::string GET_SCHEMA_VERSION_SQL = "PRAGMA user_version";
+
+const std::string SET_SCHEMA_VERSION_SQL =
+    "PRAGMA user_version=" + std::to_string(CACHE_SCHEMA_VERSION);
+
+const std::string DROP_CACHE_TABLE_SQL = "DROP TABLE IF EXISTS " + CACHE_TABLE;
+
+const std::string GET_ALL_HEADERS_SQL =
+    "SELECT rowid, " + CACHE_TABLE_RESPONSE_HEADER_COLUMN + ", " +
+    CACHE_TABLE_REQUEST_HEADER_COLUMN + " FROM " + CACHE_TABLE;
+
+const std::string UPDATE_HEADERS_SQL =
+    "UPDATE " + CACHE_TABLE + " SET " + CACHE_TABLE_RESPONSE_HEADER_COLUMN +
+    " = ?, " + CACHE_TABLE_REQUEST_HEADER_COLUMN + " = ? WHERE rowid = ?";
+
+const std::string DELETE_ENTRY_SQL =
+    "DELETE FROM " + CACHE_TABLE + " WHERE rowid = ?";
+
 // Sql commands for getting entry from database
 const std::string GET_ENTRY_SQL =
     "SELECT rowid, " + CACHE_TABLE_EXPIRY_TIME_COLUMN + ", " +
@@ -91,22 +117,64 @@ const std::string DELETE_LRU_ITEMS_SQL =
 // Sql commands for clean all items
 const std::string CLEAR_ALL_SQL = "DELETE FROM " + CACHE_TABLE;
 
-std::string convertHeadersToString(const HttpHeaders& headers) {
-  rapidjson::Document document;
-  rapidjson::Document::AllocatorType& allocator = document.GetAllocator();
-  rapidjson::Value root(rapidjson::kObjectType);
-  rapidjson::Value key(rapidjson::kStringType);
-  rapidjson::Value value(rapidjson::kStringType);
-  for (const std::pair<const std::string, std::string>& header : headers) {
-    key.SetString(header.first.c_str(), allocator);
-    value.SetString(header.second.c_str(), allocator);
-    root.AddMember(key, value, allocator);
-  }
-
-  rapidjson::StringBuffer buffer;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-  root.Accept(writer);
-  return buffer.GetString();
+// Headers are encoded as a sequence of length-prefixed strings, alternating
+// between key and value. Each length is a little-endian uint32_t, so that the
+// database can be read on a machine of either byte order.
+void appendEncodedString(std::vector<std::byte>& result, const std::string& s) {
+  const uint32_t length = static_cast<uint32_t>(s.size());
+  const size_t offset = result.size();
+  result.resize(offset + sizeof(length) + s.size());
+  for (size_t i = 0; i < sizeof(length); ++i) {
+    result[offset + i] = std::byte((length >> (8 * i)) & 0xFF);
+  }
+  std::memcpy(result.data() + offset + sizeof(length), s.data(), s.size());
+}
+
+std::vector<std::byte> encodeHeaders(const HttpHeaders& headers) {
+  size_t encodedSize = 0;
+  for (const HttpHeaders::value_type& header : headers) {
+    encodedSize +=
+        2 * sizeof(uint32_t) + header.first.size() + header.second.size();
+  }
+
+  std::vector<std::byte> result;
+  result.reserve(encodedSize);
+  for (const HttpHeaders::value_type& header : headers) {
+    appendEncodedString(result, header.first);
+    appendEncodedString(result, header.second);
+  }
+  return result;
+}
+
+bool readEncodedString(gsl::span<const std::byte>& data, std::string& s) {
+  uint32_t length = 0;
+  if (data.size() < sizeof(length)) {
+    return false;
+  }
+  for (size_t i = 0; i < sizeof(length); ++i) {
+    length |= uint32_t(data[i]) << (8 * i);
+  }
+  data = data.subspan(sizeof(length));
+
+  if (data.size() < length) {
+    return false;
+  }
+  s.assign(reinterpret_cast<const char*>(data.data()), length);
+  data = data.subspan(length);
+  return true;
+}
+
+std::optional<HttpHeaders> decodeHeaders(gsl::span<const std::byte> data) {
+  // Decode each header in place, and hand all of them to the headers at once.
+  std::vector<HttpHeaders::value_type> headers;
+  while (!data.empty()) {
+    HttpHeaders::value_type& header = headers.emplace_back();
+    if (!readEncodedString(data, header.first) ||
+        !readEncodedString(data, header.second)) {
+      return std::nullopt;
+    }
+  }
+  return HttpHeaders(std::move(headers));
 }
 
 std::optional<HttpHeaders> convertStringToHeaders(
@@ -163,6 +231,117 @@ SqliteStatementPtr prepareStatement(
   return SqliteStatementPtr(pStmt);
 }
 
+void executeSql(
+    const SqliteConnectionPtr& pConnection,
+    const std::string& sql) {
+  char* error = nullptr;
+  const int status = CESIUM_SQLITE(
+      sqlite3_exec)(pConnection.get(), sql.c_str(), nullptr, nullptr, &error);
+  if (status != SQLITE_OK) {
+    std::string errorStr(error);
+    CESIUM_SQLITE(sqlite3_free)(error);
+    throw std::runtime_error(errorStr);
+  }
+}
+
+int bindBlob(
+    const SqliteStatementPtr& pStatement,
+    int index,
+    const gsl::span<const std::byte>& data) {
+  // Binding a null pointer would store NULL rather than an empty blob.
+  if (data.empty()) {
+    return CESIUM_SQLITE(sqlite3_bind_zeroblob)(pStatement.get(), index, 0);
+  }
+  return CESIUM_SQLITE(sqlite3_bind_blob)(
+      pStatement.get(),
+      index,
+      data.data(),
+      static_cast<int>(data.size()),
+      SQLITE_STATIC);
+}
+
+gsl::span<const std::byte>
+getBlobColumn(const SqliteStatementPtr& pStatement, int column) {
+  const std::byte* pData = reinterpret_cast<const std::byte*>(
+      CESIUM_SQLITE(sqlite3_column_blob)(pStatement.get(), column));
+  const int size =
+      CESIUM_SQLITE(sqlite3_column_bytes)(pStatement.get(), column);
+  return gsl::span<const std::byte>(pData, static_cast<size_t>(size));
+}
+
+void throwIfFailed(int status, int expected) {
+  if (status != expected) {
+    throw std::runtime_error(CESIUM_SQLITE(sqlite3_errstr)(status));
+  }
+}
+
+void migrateHeadersFromJson(
+    const SqliteConnectionPtr& pConnection,
+    const std::shared_ptr<spdlog::logger>& pLogger) {
+  struct StoredHeaders {
+    int64_t rowid;
+    std::string responseHeaders;
+    std::string requestHeaders;
+  };
+
+  std::vector<StoredHeaders> rows;
+  {
+    SqliteStatementPtr pSelect =
+        prepareStatement(pConnection, GET_ALL_HEADERS_SQL);
+    int status;
+    while ((status = CESIUM_SQLITE(sqlite3_step)(pSelect.get())) ==
+           SQLITE_ROW) {
+      const char* pResponseHeaders = reinterpret_cast<const char*>(
+          CESIUM_SQLITE(sqlite3_column_text)(pSelect.get(), 1));
+      const char* pRequestHeaders = reinterpret_cast<const char*>(
+          CESIUM_SQLITE(sqlite3_column_text)(pSelect.get(), 2));
+      rows.push_back(StoredHeaders{
+          CESIUM_SQLITE(sqlite3_column_int64)(pSelect.get(), 0),
+          pResponseHeaders ? pResponseHeaders : "",
+          pRequestHeaders ? pRequestHeaders : ""});
+    }
+    throwIfFailed(status, SQLITE_DONE);
+  }
+
+  SqliteStatementPtr pUpdate =
+      prepareStatement(pConnection, UPDATE_HEADERS_SQL);
+  SqliteStatementPtr pDelete = prepareStatement(pConnection, DELETE_ENTRY_SQL);
+  for (const StoredHeaders& row : rows) {
+    std::optional<HttpHeaders> responseHeaders =
+        convertStringToHeaders(row.responseHeaders, pLogger);
+    std::optional<HttpHeaders> requestHeaders =
+        convertStringToHeaders(row.requestHeaders, pLogger);
+
+    if (!responseHeaders || !requestHeaders) {
+      throwIfFailed(CESIUM_SQLITE(sqlite3_reset)(pDelete.get()), SQLITE_OK);
+      throwIfFailed(
+          CESIUM_SQLITE(sqlite3_bind_int64)(pDelete.get(), 1, row.rowid),
+          SQLITE_OK);
+      throwIfFailed(CESIUM_SQLITE(sqlite3_step)(pDelete.get()), SQLITE_DONE);
+      continue;
+    }
+
+    const std::vector<std::byte> encodedResponseHeaders =
+        encodeHeaders(*responseHeaders);
+    const std::vector<std::byte> encodedRequestHeaders =
+        encodeHeaders(*requestHeaders);
+    throwIfFailed(CESIUM_SQLITE(sqlite3_reset)(pUpdate.get()), SQLITE_OK);
+    throwIfFailed(bindBlob(pUpdate, 1, encodedResponseHeaders), SQLITE_OK);
+    throwIfFailed(bindBlob(pUpdate, 2, encodedRequestHeaders), SQLITE_OK);
+    throwIfFailed(
+        CESIUM_SQLITE(sqlite3_bind_int64)(pUpdate.get(), 3, row.rowid),
+        SQLITE_OK);
+    throwIfFailed(CESIUM_SQLITE(sqlite3_step)(pUpdate.get()), SQLITE_DONE);
+  }
+}
+
+int getSchemaVersion(const SqliteConnectionPtr& pConnection) {
+  SqliteStatementPtr pStatement =
+      prepareStatement(pConnection, GET_SCHEMA_VERSION_SQL);
+  throwIfFailed(CESIUM_SQLITE(sqlite3_step)(pStatement.get()), SQLITE_ROW);
+  return CESIUM_SQLITE(sqlite3_column_int)(pStatement.get(), 0);
+}
+
 } // namespace
 
 namespace CesiumAsync {
@@ -275,6 +454,32 @@ void SqliteCache::createConnection() const {
     throw std::runtime_error(errorStr);
   }
 
+  // bring databases written by older versions up to date. A database
+  // written by a newer version is unreadable, so start over with an empty
+  // cache.
+  const int schemaVersion = getSchemaVersion(this->_pImpl->_pConnection);
+  if (schemaVersion > CACHE_SCHEMA_VERSION) {
+    SPDLOG_LOGGER_WARN(
+        this->_pImpl->_pLogger,
+        "Cache database has unsupported schema version {}, clearing it.",
+        schemaVersion);
+    executeSql(this->_pImpl->_pConnection, DROP_CACHE_TABLE_SQL);
+    executeSql(this->_pImpl->_pConnection, CREATE_CACHE_TABLE_SQL);
+    executeSql(this->_pImpl->_pConnection, SET_SCHEMA_VERSION_SQL);
+  } else if (schemaVersion < CACHE_SCHEMA_VERSION) {
+    executeSql(this->_pImpl->_pConnection, "BEGIN");
+    try {
+      migrateHeadersFromJson(
+          this->_pImpl->_pConnection,
+          this->_pImpl->_pLogger);
+      executeSql(this->_pImpl->_pConnection, SET_SCHEMA_VERSION_SQL);
+      executeSql(this->_pImpl->_pConnection, "COMMIT");
+    } catch (...) {
+      executeSql(this->_pImpl->_pConnection, "ROLLBACK");
+      throw;
+    }
+  }
+
   // get entry based on key
   this->_pImpl->_getEntryStmtWrapper =
       prepareStatement(this->_pImpl->_pConnection, GET_ENTRY_SQL);
@@ -347,6 +552,9 @@ std::optional<CacheItem> SqliteCache::getEntry(const std::string& key) const {
       CESIUM_SQLITE(sqlite3_step)(this->_pImpl->_getEntryStmtWrapper.get());
   if (status == SQLITE_DONE) {
     // Cache miss
+    static CesiumUtility::MetricCounter& misses =
+        CesiumUtility::MetricsRegistry::getDefault().counter("cache.misses");
+    misses.increment();
     return std::nullopt;
   }
 
@@ -359,6 +567,10 @@ std::optional<CacheItem> SqliteCache::getEntry(const std::string& key) const {
   }
 
   // Cache hit - unpack and return it.
+  static CesiumUtility::MetricCounter& hits =
+      CesiumUtility::MetricsRegistry::getDefault().counter("cache.hits");
+  hits.increment();
+
   const int64_t itemIndex = CESIUM_SQLITE(
       sqlite3_column_int64)(this->_pImpl->_getEntryStmtWrapper.get(), 0);
 
@@ -366,34 +578,32 @@ std::optional<CacheItem> SqliteCache::getEntry(const std::string& key) const {
   const std::time_t expiryTime = CESIUM_SQLITE(
       sqlite3_column_int64)(this->_pImpl->_getEntryStmtWrapper.get(), 1);
 
-  // parse response cache
-  std::string serializedResponseHeaders =
-      reinterpret_cast<const char*>(CESIUM_SQLITE(
-          sqlite3_column_text)(this->_pImpl->_getEntryStmtWrapper.get(), 2));
+  // parse response cache. The headers are decoded straight from the column
+  // blob, which is only valid until the statement is reset.
   std::optional<HttpHeaders> responseHeaders =
-      convertStringToHeaders(serializedResponseHeaders, this->_pImpl->_pLogger);
+      decodeHeaders(getBlobColumn(this->_pImpl->_getEntryStmtWrapper, 2));
   if (!responseHeaders) {
+    SPDLOG_LOGGER_ERROR(
+        this->_pImpl->_pLogger,
+        "Unable to decode http headers from cache.");
     return std::nullopt;
   }
   const uint16_t statusCode = static_cast<uint16_t>(CESIUM_SQLITE(
       sqlite3_column_int)(this->_pImpl->_getEntryStmtWrapper.get(), 3));
 
-  const std::byte* rawResponseData =
-      reinterpret_cast<const std::byte*>(CESIUM_SQLITE(
-          sqlite3_column_blob)(this->_pImpl->_getEntryStmtWrapper.get(), 4));
-  const int responseDataSize = CESIUM_SQLITE(
-      sqlite3_column_bytes)(this->_pImpl->_getEntryStmtWrapper.get(), 4);
+  const gsl::span<const std::byte> rawResponseData =
+      getBlobColumn(this->_pImpl->_getEntryStmtWrapper, 4);
   std::vector<std::byte> responseData(
-      rawResponseData,
-      rawResponseData + responseDataSize);
+      rawResponseData.begin(),
+      rawResponseData.end());
 
   // parse request
-  std::string serializedRequestHeaders =
-      reinterpret_cast<const char*>(CESIUM_SQLITE(
-          sqlite3_column_text)(this->_pImpl->_getEntryStmtWrapper.get(), 5));
   std::optional<HttpHeaders> requestHeaders =
-      convertStringToHeaders(serializedRequestHeaders, this->_pImpl->_pLogger);
+      decodeHeaders(getBlobColumn(this->_pImpl->_getEntryStmtWrapper, 5));
   if (!requestHeaders) {
+    SPDLOG_LOGGER_ERROR(
+        this->_pImpl->_pLogger,
+        "Unable to decode http headers from cache.");
     return std::nullopt;
   }
 
@@ -507,13 +717,12 @@ bool SqliteCache::storeEntry(
     return false;
   }
 
-  std::string responseHeaderString = convertHeadersToString(responseHeaders);
-  status = CESIUM_SQLITE(sqlite3_bind_text)(
-      this->_pImpl->_storeResponseStmtWrapper.get(),
+  const std::vector<std::byte> encodedResponseHeaders =
+      encodeHeaders(responseHeaders);
+  status = bindBlob(
+      this->_pImpl->_storeResponseStmtWrapper,
       3,
-      responseHeaderString.c_str(),
-      -1,
-      SQLITE_STATIC);
+      encodedResponseHeaders);
   if (status != SQLITE_OK) {
     SPDLOG_LOGGER_ERROR(
         this->_pImpl->_pLogger,
@@ -532,12 +741,7 @@ bool SqliteCache::storeEntry(
     return false;
   }
 
-  status = CESIUM_SQLITE(sqlite3_bind_blob)(
-      this->_pImpl->_storeResponseStmtWrapper.get(),
-      5,
-      responseData.data(),
-      static_cast<int>(responseData.size()),
-      SQLITE_STATIC);
+  status = bindBlob(this->_pImpl->_storeResponseStmtWrapper, 5, responseData);
   if (status != SQLITE_OK) {
     SPDLOG_LOGGER_ERROR(
         this->_pImpl->_pLogger,
@@ -545,13 +749,12 @@ bool SqliteCache::storeEntry(
     return false;
   }
 
-  std::string requestHeaderString = convertHeadersToString(requestHeaders);
-  status = CESIUM_SQLITE(sqlite3_bind_text)(
-      this->_pImpl->_storeResponseStmtWrapper.get(),
+  const std::vector<std::byte> encodedRequestHeaders =
+      encodeHeaders(requestHeaders);
+  status = bindBlob(
+      this->_pImpl->_storeResponseStmtWrapper,
       6,
-      requestHeaderString.c_str(),
-      -1,
-      SQLITE_STATIC);
+      encodedRequestHeaders);
   if (status != SQLITE_OK) {
     SPDLOG_LOGGER_ERROR(
         this->_pImpl->_pLogger,
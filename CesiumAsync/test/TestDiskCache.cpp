@@ -7,6 +7,7 @@
 #include <spdlog/spdlog.h>
 
 #include <cstddef>
+#include <filesystem>
 
 using namespace CesiumAsync;
 
@@ -74,6 +75,29 @@ TEST_CASE("Test disk cache with Sqlite") {
     REQUIRE(!cacheControl.has_value());
   }
 
+  SECTION("Test headers survive reopening the database") {
+    HttpHeaders responseHeaders{
+        {"Empty-Header", ""},
+        {"Cache-Control", "max-age=100, public"},
+        {"Long-Header", std::string(1000, 'x')}};
+    REQUIRE(diskCache.storeEntry(
+        "ReopenKey",
+        std::time(nullptr),
+        "test.com",
+        "GET",
+        HttpHeaders{},
+        200,
+        responseHeaders,
+        gsl::span<const std::byte>()));
+
+    SqliteCache reopenedCache(spdlog::default_logger(), "test.db", 3);
+    std::optional<CacheItem> cacheItem = reopenedCache.getEntry("ReopenKey");
+    REQUIRE(cacheItem);
+    CHECK(cacheItem->cacheRequest.headers.empty());
+    CHECK(cacheItem->cacheResponse.headers == responseHeaders);
+    CHECK(cacheItem->cacheResponse.data.empty());
+  }
+
   SECTION("Test prune") {
     // store data in the cache first
     std::time_t currentTime = std::time(nullptr);
@@ -214,3 +238,46 @@ TEST_CASE("Test disk cache with Sqlite") {
     }
   }
 }
+
+TEST_CASE("Test disk cache migrates headers from version 0 databases") {
+  // Version 0 stored headers as JSON text. Migrating modifies the database,
+  // so work on a copy.
+  const std::filesystem::path original =
+      std::filesystem::path(CesiumAsync_TEST_DATA_DIR) / "cache-v0.db";
+  const std::filesystem::path path = "test-v0.db";
+  std::filesystem::copy_file(
+      original,
+      path,
+      std::filesystem::copy_options::overwrite_existing);
+
+  for (int i = 0; i < 2; ++i) {
+    // The second time, the database is already migrated.
+    SqliteCache diskCache(spdlog::default_logger(), path.string(), 3);
+
+    std::optional<CacheItem> cacheItem = diskCache.getEntry("TestKey");
+    REQUIRE(cacheItem);
+    CHECK(cacheItem->expiryTime == 4102444800);
+    CHECK(
+        cacheItem->cacheRequest.headers ==
+        HttpHeaders{{"Request-Header", "Request-Value"}});
+    CHECK(cacheItem->cacheRequest.method == "GET");
+    CHECK(cacheItem->cacheRequest.url == "test.com");
+    CHECK(
+        cacheItem->cacheResponse.headers ==
+        HttpHeaders{
+            {"Content-Type", "text/plain"},
+            {"Cache-Control", "max-age=100, public"},
+            {"Empty-Header", ""}});
+    CHECK(cacheItem->cacheResponse.statusCode == 200);
+    CHECK(
+        cacheItem->cacheResponse.data ==
+        std::vector<std::byte>{
+            std::byte('d'),
+            std::byte('a'),
+            std::byte('t'),
+            std::byte('a')});
+
+    // Entries whose headers could not be parsed are dropped.
+    CHECK(!diskCache.getEntry("BrokenKey"));
+  }
+}
@@ -0,0 +1,238 @@
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/HttpAssetAccessor.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumAsync/ITaskProcessor.h"
+
+#include <catch2/catch.hpp>
+#include <httplib.h>
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CesiumAsync;
+
+namespace {
+
+class MockTaskProcessor : public ITaskProcessor {
+public:
+  virtual void startTask(std::function<void()> f) override {
+    std::thread(f).detach();
+  }
+};
+
+// A server on the loopback interface that stands in for a real endpoint.
+class LocalServer {
+public:
+  LocalServer() : _server(), _port(_server.bind_to_any_port("127.0.0.1")) {
+    this->_server.Get(
+        "/hello",
+        [this](const httplib::Request& request, httplib::Response& response) {
+          {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            this->_remotePorts.insert(request.remote_port);
+          }
+          response.set_header("X-Test", request.get_header_value("X-Test"));
+          response.set_content("Hello", "text/plain");
+        });
+
+    this->_server.Get(
+        "/slow",
+        [this](const httplib::Request&, httplib::Response& response) {
+          const int32_t inFlight = ++this->_inFlight;
+          int32_t previous = this->_maximumInFlight;
+          while (previous < inFlight &&
+                 !this->_maximumInFlight.compare_exchange_weak(
+                     previous,
+                     inFlight)) {
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds(50));
+          --this->_inFlight;
+          response.set_content("Slow", "text/plain");
+        });
+
+    this->_server.Post(
+        "/echo",
+        [](const httplib::Request& request, httplib::Response& response) {
+          response.status = 201;
+          response.set_content(request.body, "application/octet-stream");
+        });
+
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+    this->_server.Get(
+        "/gzip",
+        [this](const httplib::Request& request, httplib::Response& response) {
+          {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            this->_acceptEncoding = request.get_header_value("Accept-Encoding");
+          }
+
+          // The content type is one httplib doesn't compress by itself.
+          const std::string body(1000, 'x');
+          std::string compressed;
+          httplib::detail::gzip_compressor compressor;
+          compressor.compress(
+              body.data(),
+              body.size(),
+              true,
+              [&compressed](const char* data, size_t length) {
+                compressed.append(data, length);
+                return true;
+              });
+          response.set_header("Content-Encoding", "gzip");
+          response.set_content(compressed, "application/octet-stream");
+        });
+#endif
+
+    this->_thread =
+        std::thread([this]() { this->_server.listen_after_bind(); });
+  }
+
+  ~LocalServer() {
+    this->_server.stop();
+    this->_thread.join();
+  }
+
+  std::string url(const std::string& path) const {
+    return "http://127.0.0.1:" + std::to_string(this->_port) + path;
+  }
+
+  size_t distinctConnections() {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    return this->_remotePorts.size();
+  }
+
+  int32_t maximumInFlight() const { return this->_maximumInFlight; }
+
+  std::string acceptEncoding() {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    return this->_acceptEncoding;
+  }
+
+private:
+  httplib::Server _server;
+  int _port;
+  std::thread _thread;
+  std::mutex _mutex;
+  std::set<int> _remotePorts;
+  std::string _acceptEncoding;
+  std::atomic<int32_t> _inFlight = 0;
+  std::atomic<int32_t> _maximumInFlight = 0;
+};
+
+} // namespace
+
+TEST_CASE("HttpAssetAccessor") {
+  AsyncSystem asyncSystem(std::make_shared<MockTaskProcessor>());
+  LocalServer server;
+
+  HttpAssetAccessorOptions options;
+  options.maximumSimultaneousRequests = 2;
+  options.defaultHeaders.emplace_back("X-Test", "default");
+  HttpAssetAccessor accessor(spdlog::default_logger(), options);
+
+  SECTION("returns the response status, headers and body") {
+    std::shared_ptr<IAssetRequest> pRequest =
+        accessor.get(asyncSystem, server.url("/hello"), {{"x-test", "value"}})
+            .wait();
+
+    CHECK(pRequest->method() == "GET");
+    CHECK(pRequest->url() == server.url("/hello"));
+
+    const IAssetResponse* pResponse = pRequest->response();
+    REQUIRE(pResponse);
+    CHECK(pResponse->statusCode() == 200);
+    CHECK(pResponse->contentType() == "text/plain");
+    CHECK(pResponse->headers().at("x-test") == "value");
+
+    const gsl::span<const std::byte> data = pResponse->data();
+    const std::string body(
+        reinterpret_cast<const char*>(data.data()),
+        data.size());
+    CHECK(body == "Hello");
+  }
+
+  SECTION("adds default headers that the request does not specify") {
+    std::shared_ptr<IAssetRequest> pRequest =
+        accessor.get(asyncSystem, server.url("/hello"), {}).wait();
+    REQUIRE(pRequest->response());
+    CHECK(pRequest->response()->headers().at("X-Test") == "default");
+  }
+
+  SECTION("reuses connections for consecutive requests to the same host") {
+    for (int i = 0; i < 3; ++i) {
+      std::shared_ptr<IAssetRequest> pRequest =
+          accessor.get(asyncSystem, server.url("/hello"), {}).wait();
+      REQUIRE(pRequest->response());
+    }
+
+    CHECK(server.distinctConnections() == 1);
+  }
+
+  SECTION("limits the number of simultaneous requests") {
+    std::vector<Future<std::shared_ptr<IAssetRequest>>> futures;
+    for (int i = 0; i < 6; ++i) {
+      futures.emplace_back(accessor.get(asyncSystem, server.url("/slow"), {}));
+    }
+
+    for (Future<std::shared_ptr<IAssetRequest>>& future : futures) {
+      std::shared_ptr<IAssetRequest> pRequest = std::move(future).wait();
+      REQUIRE(pRequest->response());
+      CHECK(pRequest->response()->statusCode() == 200);
+    }
+
+    CHECK(server.maximumInFlight() <= 2);
+  }
+
+  SECTION("sends the content payload") {
+    const std::string payload = "payload";
+    std::shared_ptr<IAssetRequest> pRequest =
+        accessor
+            .request(
+                asyncSystem,
+                "POST",
+                server.url("/echo"),
+                {},
+                gsl::span<const std::byte>(
+                    reinterpret_cast<const std::byte*>(payload.data()),
+                    payload.size()))
+            .wait();
+
+    const IAssetResponse* pResponse = pRequest->response();
+    REQUIRE(pResponse);
+    CHECK(pResponse->statusCode() == 201);
+    CHECK(pResponse->data().size() == payload.size());
+  }
+
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+  SECTION("requests and decodes compressed responses") {
+    std::shared_ptr<IAssetRequest> pRequest =
+        accessor.get(asyncSystem, server.url("/gzip"), {}).wait();
+    CHECK(server.acceptEncoding().find("gzip") != std::string::npos);
+
+    const IAssetResponse* pResponse = pRequest->response();
+    REQUIRE(pResponse);
+    CHECK(pResponse->statusCode() == 200);
+    CHECK(
+        pResponse->headers().find("Content-Encoding") ==
+        pResponse->headers().end());
+
+    const gsl::span<const std::byte> data = pResponse->data();
+    const std::string body(
+        reinterpret_cast<const char*>(data.data()),
+        data.size());
+    CHECK(body == std::string(1000, 'x'));
+  }
+#endif
+
+  SECTION("completes without a response when the request fails") {
+    std::shared_ptr<IAssetRequest> pRequest =
+        accessor.get(asyncSystem, "not a url", {}).wait();
+    CHECK(pRequest->response() == nullptr);
+  }
+}
@@ -0,0 +1,131 @@
+#include "CesiumAsync/HttpHeaders.h"
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CesiumAsync;
+
+TEST_CASE("HttpHeaders") {
+  SECTION("finds headers regardless of case") {
+    HttpHeaders headers{{"Content-Type", "text/plain"}, {"ETag", "abc"}};
+    REQUIRE(headers.find("content-type") != headers.end());
+    CHECK(headers.find("CONTENT-TYPE")->second == "text/plain");
+    CHECK(headers.at("etag") == "abc");
+    CHECK(headers.count("Etag") == 1);
+    CHECK(headers.find("Expires") == headers.end());
+    CHECK_THROWS(headers.at("Expires"));
+  }
+
+  SECTION("iterates in case-insensitive key order") {
+    HttpHeaders headers{{"b", "2"}, {"C", "3"}, {"A", "1"}};
+    std::vector<std::string> keys;
+    for (const HttpHeaders::value_type& header : headers) {
+      keys.emplace_back(header.first);
+    }
+    CHECK(keys == std::vector<std::string>{"A", "b", "C"});
+  }
+
+  SECTION("keeps the first of duplicate keys like std::map") {
+    std::vector<std::pair<std::string, std::string>> list{
+        {"Accept", "first"},
+        {"accept", "second"}};
+    HttpHeaders headers(list.begin(), list.end());
+    CHECK(headers.size() == 1);
+    CHECK(headers.at("Accept") == "first");
+
+    CHECK(!headers.emplace("ACCEPT", "third").second);
+    CHECK(headers.insert_or_assign("ACCEPT", "fourth").second == false);
+    CHECK(headers.at("Accept") == "fourth");
+
+    CHECK(headers.insert_or_assign("X-New", "new").second);
+    CHECK(headers.size() == 2);
+    CHECK(headers.erase("x-new") == 1);
+    CHECK(headers.erase("x-new") == 0);
+  }
+
+  SECTION("modifying a copy does not affect the original") {
+    HttpHeaders original{{"Authorization", "Bearer token"}};
+    HttpHeaders copy = original;
+    CHECK(copy == original);
+
+    copy.insert_or_assign("Authorization", "Bearer other");
+    copy.emplace("Accept", "*/*");
+    CHECK(original.size() == 1);
+    CHECK(original.at("Authorization") == "Bearer token");
+    CHECK(copy.at("Authorization") == "Bearer other");
+    CHECK(copy != original);
+  }
+
+  SECTION("iterators of a copy keep reading the original headers") {
+    HttpHeaders original{{"Accept", "*/*"}};
+    HttpHeaders copy = original;
+    HttpHeaders::const_iterator it = copy.find("Accept");
+
+    original.insert_or_assign("Accept", "text/plain");
+    original.erase("Accept");
+    REQUIRE(it != copy.end());
+    CHECK(it->second == "*/*");
+  }
+
+  SECTION("copies can be modified on other threads") {
+    HttpHeaders original{{"Authorization", "Bearer token"}};
+    std::vector<std::thread> threads;
+    for (int32_t i = 0; i < 4; ++i) {
+      threads.emplace_back([original, i]() mutable {
+        for (int32_t j = 0; j < 1000; ++j) {
+          HttpHeaders copy = original;
+          copy.insert_or_assign("Authorization", std::to_string(i + j));
+          original = copy;
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    CHECK(original.at("Authorization") == "Bearer token");
+  }
+
+  SECTION("modifies headers in place when no copy shares them") {
+    HttpHeaders headers;
+    headers.emplace("A", "1");
+    const HttpHeaders::value_type* pFirst = &*headers.begin();
+    for (int32_t i = 0; i < 4; ++i) {
+      headers.insert_or_assign("A", std::to_string(i));
+    }
+    CHECK(&*headers.begin() == pFirst);
+    CHECK(headers.at("A") == "3");
+  }
+
+  SECTION("builds headers from an array in one step") {
+    HttpHeaders headers(std::vector<HttpHeaders::value_type>{
+        {"b", "2"},
+        {"A", "1"},
+        {"B", "3"}});
+    REQUIRE(headers.size() == 2);
+    CHECK(headers.begin()->first == "A");
+    CHECK(headers.at("B") == "2");
+  }
+
+  SECTION("operator[] adds or changes a header") {
+    HttpHeaders headers{{"Accept", "*/*"}};
+    HttpHeaders copy = headers;
+    headers["accept"] = "text/plain";
+    headers["ETag"] += "abc";
+    CHECK(headers.at("Accept") == "text/plain");
+    CHECK(headers.at("etag") == "abc");
+    CHECK(copy.size() == 1);
+    CHECK(copy.at("Accept") == "*/*");
+  }
+
+  SECTION("empty headers can be searched without allocating") {
+    HttpHeaders headers;
+    CHECK(headers.empty());
+    CHECK(headers.begin() == headers.end());
+    CHECK(headers.find("Accept") == headers.end());
+    CHECK(headers == HttpHeaders{});
+  }
+}
@@ -0,0 +1,176 @@
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumAsync/ITaskProcessor.h"
+#include "CesiumAsync/MBTilesAssetAccessor.h"
+#include "MockAssetRequest.h"
+#include "MockAssetResponse.h"
+
+#include <catch2/catch.hpp>
+#include <spdlog/spdlog.h>
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CesiumAsync;
+
+namespace {
+
+class MockTaskProcessor : public ITaskProcessor {
+public:
+  virtual void startTask(std::function<void()> f) override {
+    std::thread(f).detach();
+  }
+};
+
+// An asset accessor that answers every request with status code 200 and
+// records the URLs it was asked for.
+class RecordingAssetAccessor : public IAssetAccessor {
+public:
+  virtual Future<std::shared_ptr<IAssetRequest>>
+  get(const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers) override {
+    return this->request(asyncSystem, "GET", url, headers, {});
+  }
+
+  virtual Future<std::shared_ptr<IAssetRequest>> request(
+      const AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const gsl::span<const std::byte>&) override {
+    this->urls.emplace_back(url);
+    return asyncSystem.createResolvedFuture<std::shared_ptr<IAssetRequest>>(
+        std::make_shared<MockAssetRequest>(
+            verb,
+            url,
+            HttpHeaders(headers.begin(), headers.end()),
+            std::make_unique<MockAssetResponse>(
+                uint16_t(200),
+                "text/plain",
+                HttpHeaders(),
+                std::vector<std::byte>())));
+  }
+
+  virtual void tick() noexcept override { ++this->ticks; }
+
+  std::vector<std::string> urls;
+  int32_t ticks = 0;
+};
+
+std::string getBody(const IAssetResponse& response) {
+  const gsl::span<const std::byte> data = response.data();
+  return std::string(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+} // namespace
+
+TEST_CASE("MBTilesAssetAccessor") {
+  AsyncSystem asyncSystem(std::make_shared<MockTaskProcessor>());
+  std::filesystem::path archivePath = CesiumAsync_TEST_DATA_DIR;
+  archivePath /= "tiles.mbtiles";
+
+  std::shared_ptr<RecordingAssetAccessor> pFallback =
+      std::make_shared<RecordingAssetAccessor>();
+  MBTilesAssetAccessorOptions options;
+  options.maximumSimultaneousReads = 2;
+  MBTilesAssetAccessor accessor(
+      spdlog::default_logger(),
+      archivePath.string(),
+      pFallback,
+      options);
+
+  SECTION("reads the metadata of the archive") {
+    const std::map<std::string, std::string>& metadata = accessor.getMetadata();
+    CHECK(metadata.at("name") == "Test");
+    CHECK(metadata.at("format") == "png");
+    CHECK(metadata.at("maxzoom") == "1");
+  }
+
+  SECTION("returns the tile at the level, column and row in the URL") {
+    std::shared_ptr<IAssetRequest> pRequest =
+        accessor.get(asyncSystem, "mbtiles://tiles/1/1/0.png", {}).wait();
+
+    CHECK(pRequest->method() == "GET");
+    CHECK(pRequest->url() == "mbtiles://tiles/1/1/0.png");
+
+    const IAssetResponse* pResponse = pRequest->response();
+    REQUIRE(pResponse);
+    CHECK(pResponse->statusCode() == 200);
+    CHECK(pResponse->contentType() == "image/png");
+    CHECK(getBody(*pResponse) == "tile 1/1/0");
+  }
+
+  SECTION("ignores the query and fragment of the URL") {
+    std::shared_ptr<IAssetRequest> pRequest =
+        accessor.get(asyncSystem, "mbtiles://0/0/0?key=value#fragment", {})
+            .wait();
+    REQUIRE(pRequest->response());
+    CHECK(getBody(*pRequest->response()) == "tile 0/0/0");
+  }
+
+  SECTION("returns status code 404 for a tile that is not in the archive") {
+    std::shared_ptr<IAssetRequest> pMissing =
+        accessor.get(asyncSystem, "mbtiles://2/0/0.png", {}).wait();
+    REQUIRE(pMissing->response());
+    CHECK(pMissing->response()->statusCode() == 404);
+
+    std::shared_ptr<IAssetRequest> pInvalid =
+        accessor.get(asyncSystem, "mbtiles://tiles/0/zero.png", {}).wait();
+    REQUIRE(pInvalid->response());
+    CHECK(pInvalid->response()->statusCode() == 404);
+  }
+
+  SECTION("reads tiles simultaneously") {
+    std::vector<Future<std::shared_ptr<IAssetRequest>>> futures;
+    for (int32_t i = 0; i < 16; ++i) {
+      const std::string url = "mbtiles://1/" + std::to_string(i % 2) + "/" +
+                              std::to_string((i / 2) % 2);
+      futures.emplace_back(accessor.get(asyncSystem, url, {}));
+    }
+
+    for (int32_t i = 0; i < 16; ++i) {
+      std::shared_ptr<IAssetRequest> pRequest =
+          std::move(futures[size_t(i)]).wait();
+      REQUIRE(pRequest->response());
+      CHECK(
+          getBody(*pRequest->response()) ==
+          "tile 1/" + std::to_string(i % 2) + "/" +
+              std::to_string((i / 2) % 2));
+    }
+  }
+
+  SECTION("passes other URLs to the fallback asset accessor") {
+    std::shared_ptr<IAssetRequest> pRequest =
+        accessor.get(asyncSystem, "http://example.com/tileset.json", {})
+            .wait();
+    REQUIRE(pRequest->response());
+    CHECK(pRequest->response()->statusCode() == 200);
+    REQUIRE(pFallback->urls.size() == 1);
+    CHECK(pFallback->urls[0] == "http://example.com/tileset.json");
+
+    accessor.tick();
+    CHECK(pFallback->ticks == 1);
+  }
+
+  SECTION("completes without a response when there is no fallback") {
+    MBTilesAssetAccessor withoutFallback(
+        spdlog::default_logger(),
+        archivePath.string());
+    std::shared_ptr<IAssetRequest> pRequest =
+        withoutFallback.get(asyncSystem, "http://example.com/a.png", {})
+            .wait();
+    CHECK(pRequest->response() == nullptr);
+  }
+
+  SECTION("throws when the archive cannot be opened") {
+    CHECK_THROWS_AS(
+        MBTilesAssetAccessor(
+            spdlog::default_logger(),
+            (archivePath.parent_path() / "missing.mbtiles").string()),
+        std::runtime_error);
+  }
+}
@@ -4,6 +4,7 @@
 
 #include <gsl/span>
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -37,6 +38,83 @@ struct CESIUMGEOMETRY_API AvailabilitySubtree {
   std::vector<std::vector<std::byte>> buffers;
 };
 
+/**
+ * @brief One availability bitstream of an {@link AvailabilitySubtree},
+ * resolved once so that it can be queried without re-inspecting the
+ * {@link AvailabilityView}.
+ *
+ * When constructed with counts, the number of available bits preceding every
+ * 64-bit word is precomputed, so {@link countAvailableBefore} takes constant
+ * time instead of counting every byte that precedes the bit.
+ */
+class CESIUMGEOMETRY_API AvailabilityBitstream {
+public:
+  /**
+   * @brief Creates an invalid bitstream, in which nothing is available.
+   */
+  AvailabilityBitstream() noexcept = default;
+
+  /**
+   * @brief Resolves a bitstream of a subtree.
+   *
+   * The subtree's buffers must outlive this instance and must not be
+   * modified.
+   *
+   * @param view The view of the bitstream within the subtree.
+   * @param subtree The subtree that owns the bitstream's buffers.
+   * @param computeCounts Whether to precompute the counts needed by
+   * {@link countAvailableBefore}.
+   */
+  AvailabilityBitstream(
+      const AvailabilityView& view,
+      const AvailabilitySubtree& subtree,
+      bool computeCounts) noexcept;
+
+  /**
+   * @brief Returns `true` if the view is a constant or refers to a valid
+   * range of a buffer.
+   */
+  bool isValid() const noexcept { return this->_kind != Kind::Invalid; }
+
+  /**
+   * @brief Returns `true` if the view is a constant.
+   */
+  bool isConstant() const noexcept { return this->_kind == Kind::Constant; }
+
+  /**
+   * @brief Determines if the bit at the given index is set. Bits beyond the
+   * end of a buffer are not set.
+   */
+  bool isAvailable(uint32_t index) const noexcept {
+    if (this->_kind == Kind::Constant) {
+      return this->_constant;
+    }
+
+    const size_t byteIndex = index >> 3;
+    if (byteIndex >= this->_bits.size()) {
+      return false;
+    }
+    return (uint8_t(this->_bits[byteIndex]) & (1U << (index & 7U))) != 0;
+  }
+
+  /**
+   * @brief Counts the bits that are set before the given index.
+   *
+   * For a constant view this is `index` if the constant is `true`, and zero
+   * otherwise. For a buffer, this instance must have been constructed with
+   * counts.
+   */
+  uint32_t countAvailableBefore(uint32_t index) const noexcept;
+
+private:
+  enum class Kind : uint8_t { Invalid, Constant, Buffer };
+
+  Kind _kind = Kind::Invalid;
+  bool _constant = false;
+  gsl::span<const std::byte> _bits;
+  std::vector<uint32_t> _countsBeforeWord;
+};
+
 /**
  * @brief Availability nodes wrap subtree objects and link them together to
  * form a downwardly traversable availability tree.
@@ -55,6 +133,23 @@ struct CESIUMGEOMETRY_API AvailabilityNode {
    */
   std::vector<std::unique_ptr<AvailabilityNode>> childNodes;
 
+  /**
+   * @brief The resolved tile availability of the loaded subtree.
+   */
+  AvailabilityBitstream tileAvailability;
+
+  /**
+   * @brief The resolved content availability of the loaded subtree.
+   */
+  AvailabilityBitstream contentAvailability;
+
+  /**
+   * @brief The resolved child subtree availability of the loaded subtree,
+   * with counts, so that the index of a child in {@link childNodes} can be
+   * found in constant time.
+   */
+  AvailabilityBitstream childSubtreeAvailability;
+
   /**
    * @brief Creates an empty instance;
    */
@@ -8,18 +8,41 @@
 #include <gsl/span>
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace CesiumGeometry {
 
+/**
+ * @brief The known availability of the tiles in an implicit quadtree, built up
+ * from availability subtrees as they are loaded.
+ *
+ * Besides the tree of {@link AvailabilityNode}s, every subtree is indexed by
+ * the Morton code of its root tile, so the subtree containing a tile is found
+ * with a single hash lookup rather than by walking down from the root. The
+ * child subtree counts that locate a node's children are precomputed when its
+ * subtree is loaded.
+ */
 class CESIUMGEOMETRY_API QuadtreeAvailability final {
 public:
+  /**
+   * @brief The deepest level at which tiles can be available.
+   *
+   * Subtrees are indexed by a 64-bit Morton code, which has room for
+   * two bits per level below this one.
+   */
+  static constexpr uint32_t MAXIMUM_SUPPORTED_LEVEL = 31;
+
   /**
    * @brief Constructs a new instance.
    *
    * @param subtreeLevels The number of levels in each subtree.
-   * @param maximumLevel The index of the maximum level in this tileset.
+   * @param maximumLevel The index of the maximum level in this tileset. It is
+   * limited to {@link MAXIMUM_SUPPORTED_LEVEL}, and no deeper tiles are
+   * available.
    */
   QuadtreeAvailability(uint32_t subtreeLevels, uint32_t maximumLevel) noexcept;
 
@@ -34,6 +57,22 @@ public:
    */
   uint8_t computeAvailability(const QuadtreeTileID& tileID) const noexcept;
 
+  /**
+   * @brief Determines the currently known availability status of many tiles
+   * at once.
+   *
+   * This is equivalent to calling {@link computeAvailability} for each tile,
+   * but is faster when consecutive tiles fall in the same subtree, as
+   * siblings and children usually do.
+   *
+   * @param tileIDs The tiles for which to compute the availability.
+   * @param availability Receives the {@link TileAvailabilityFlags} of each
+   * tile. Must be the same size as `tileIDs`.
+   */
+  void computeAvailability(
+      const gsl::span<const QuadtreeTileID>& tileIDs,
+      const gsl::span<uint8_t>& availability) const noexcept;
+
   /**
    * @brief Attempts to add an availability subtree into the existing overall
    * availability tree.
@@ -41,7 +80,8 @@ public:
    * @param tileID The {@link CesiumGeometry::QuadtreeTileID} for the tile.
    * @param newSubtree The {@link CesiumGeometry::AvailabilitySubtree} to add.
    *
-   * @return Whether the insertion was successful.
+   * @return Whether the insertion was successful. Subtrees deeper than the
+   * maximum level are rejected.
    */
   bool addSubtree(
       const QuadtreeTileID& tileID,
@@ -78,7 +118,8 @@ public:
    * at the end of this parent subtree.
    *
    * @return The newly created node if the insertion was successful, nullptr
-   * otherwise.
+   * otherwise, including when a node for the tile already exists or is deeper
+   * than the maximum level.
    */
   AvailabilityNode*
   addNode(const QuadtreeTileID& tileID, AvailabilityNode* pParentNode) noexcept;
@@ -156,10 +197,32 @@ public:
   AvailabilityNode* getRootNode() noexcept { return this->_pRoot.get(); }
 
 private:
+  QuadtreeTileID getSubtreeRootID(const QuadtreeTileID& tileID) const noexcept;
+
+  AvailabilityNode*
+  findNode(const QuadtreeTileID& subtreeRootID) const noexcept;
+
+  void addNodeToIndex(
+      const QuadtreeTileID& subtreeRootID,
+      AvailabilityNode* pNode) noexcept;
+
+  uint8_t computeAvailabilityInSubtree(
+      const QuadtreeTileID& tileID,
+      uint32_t relativeLevel,
+      const AvailabilityNode& node) const noexcept;
+
+  std::optional<uint32_t> findChildSubtreeIndex(
+      const QuadtreeTileID& tileID,
+      const AvailabilityNode& parentNode) const noexcept;
+
   uint32_t _subtreeLevels;
   uint32_t _maximumLevel;
   uint32_t _maximumChildrenSubtrees;
   std::unique_ptr<AvailabilityNode> _pRoot;
+
+  // Every node in the tree, keyed by the Morton code of its root tile with a
+  // sentinel bit above it to distinguish levels.
+  std::unordered_map<uint64_t, AvailabilityNode*> _nodesByKey;
 };
 
 } // namespace CesiumGeometry
@@ -7,13 +7,18 @@
 
 #include <glm/vec2.hpp>
 
-#include <memory>
+#include <array>
+#include <cstddef>
 #include <vector>
 
 namespace CesiumGeometry {
 
 /**
  * @brief Manages information about the availability of tiles in a quadtree.
+ *
+ * The available ranges are indexed separately for each level with a packed
+ * R-tree, so the availability of a tile is found in time logarithmic in the
+ * number of ranges rather than linear.
  */
 class CESIUMGEOMETRY_API QuadtreeRectangleAvailability final {
 public:
@@ -31,12 +36,24 @@ public:
   /**
    * @brief Adds the specified range to the set of available tiles.
    *
+   * Adding many ranges at once with {@link addAvailableTileRanges} is
+   * faster, because the index of each level is only rebuilt once.
+   *
    * @param range The {@link QuadtreeTileRectangularRange} that describes
    * the range of available tiles.
    */
   void
   addAvailableTileRange(const QuadtreeTileRectangularRange& range) noexcept;
 
+  /**
+   * @brief Adds the specified ranges to the set of available tiles.
+   *
+   * @param ranges The {@link QuadtreeTileRectangularRange}s that describe
+   * the ranges of available tiles.
+   */
+  void addAvailableTileRanges(
+      const std::vector<QuadtreeTileRectangularRange>& ranges) noexcept;
+
   /**
    * @brief Computes the maximum level for the given 2D position.
    *
@@ -64,58 +81,60 @@ public:
    */
   uint8_t isTileAvailable(const QuadtreeTileID& id) const noexcept;
 
+  /**
+   * @brief Returns whether each of the four children of a tile is available.
+   *
+   * This gives the same results as calling {@link isTileAvailable} for each
+   * child, but searches the index of each level only once for all four.
+   *
+   * @param id The quadtree tile ID of the parent tile.
+   * @returns The {@link CesiumGeometry::TileAvailabilityFlags} for the
+   * children at (2x, 2y), (2x + 1, 2y), (2x, 2y + 1), and (2x + 1, 2y + 1),
+   * in that order.
+   */
+  std::array<uint8_t, 4>
+  areChildTilesAvailable(const QuadtreeTileID& id) const noexcept;
+
 private:
-  struct RectangleWithLevel {
-    uint32_t level;
-    Rectangle rectangle;
+  /**
+   * @brief The available rectangles of a single level.
+   *
+   * The first `indexedCount` rectangles are the leaves of a packed R-tree,
+   * and `nodes` holds the bounds of its interior nodes, one tree level after
+   * another with the root last. Rectangles added since the tree was built
+   * follow the leaves and are searched linearly until the tree is rebuilt.
+   */
+  struct LevelIndex {
+    std::vector<Rectangle> rectangles;
+    std::vector<Rectangle> nodes;
+    std::vector<size_t> nodeLevelEnds;
+    size_t indexedCount = 0;
   };
 
-  struct QuadtreeNode {
-    QuadtreeNode(
-        const QuadtreeTileID& id_,
-        const Rectangle& extent_,
-        QuadtreeNode* pParent_) noexcept
-        : id(id_),
-          extent(extent_),
-          pParent(pParent_),
-          ll(),
-          lr(),
-          ul(),
-          ur(),
-          rectangles() {}
-
-    QuadtreeTileID id;
-
-    CesiumGeometry::Rectangle extent;
-
-    QuadtreeNode* pParent;
-    std::unique_ptr<QuadtreeNode> ll;
-    std::unique_ptr<QuadtreeNode> lr;
-    std::unique_ptr<QuadtreeNode> ul;
-    std::unique_ptr<QuadtreeNode> ur;
-
-    std::vector<RectangleWithLevel> rectangles;
-  };
+  LevelIndex* addRange(const QuadtreeTileRectangularRange& range) noexcept;
 
-  QuadtreeTilingScheme _tilingScheme;
-  uint32_t _maximumLevel;
-  std::vector<std::unique_ptr<QuadtreeNode>> _rootNodes;
+  uint32_t findAvailablePositions(
+      uint32_t minimumLevel,
+      const glm::dvec2* positions,
+      size_t count) const noexcept;
 
-  static void putRectangleInQuadtree(
-      const QuadtreeTilingScheme& tilingScheme,
-      uint32_t maximumLevel,
-      QuadtreeRectangleAvailability::QuadtreeNode& node,
-      const QuadtreeRectangleAvailability::RectangleWithLevel&
-          rectangle) noexcept;
-  static bool rectangleLevelComparator(
-      const QuadtreeRectangleAvailability::RectangleWithLevel& a,
-      const QuadtreeRectangleAvailability::RectangleWithLevel& b) noexcept;
-  static uint32_t findMaxLevelFromNode(
-      QuadtreeNode* pStopNode,
-      QuadtreeNode& node,
-      const glm::dvec2& position) noexcept;
-  static void createNodeChildrenIfNecessary(
-      QuadtreeNode& node,
-      const QuadtreeTilingScheme& tilingScheme) noexcept;
+  static void buildIndex(LevelIndex& index) noexcept;
+
+  static uint32_t findContainingRectangles(
+      const LevelIndex& index,
+      const glm::dvec2* positions,
+      size_t count,
+      uint32_t mask) noexcept;
+
+  static uint32_t searchNode(
+      const LevelIndex& index,
+      size_t treeLevel,
+      size_t nodeIndex,
+      const glm::dvec2* positions,
+      size_t count,
+      uint32_t mask) noexcept;
+
+  QuadtreeTilingScheme _tilingScheme;
+  std::vector<LevelIndex> _levels;
 };
 } // namespace CesiumGeometry
@@ -1,6 +1,8 @@
 
 #include "CesiumGeometry/Availability.h"
 
+#include <algorithm>
+
 namespace CesiumGeometry {
 
 namespace AvailabilityUtilities {
@@ -28,6 +30,65 @@ uint32_t countOnesInBuffer(gsl::span<const std::byte> buffer) {
 }
 } // namespace AvailabilityUtilities
 
+AvailabilityBitstream::AvailabilityBitstream(
+    const AvailabilityView& view,
+    const AvailabilitySubtree& subtree,
+    bool computeCounts) noexcept {
+  AvailabilityAccessor accessor(view, subtree);
+  if (accessor.isConstant()) {
+    this->_kind = Kind::Constant;
+    this->_constant = accessor.getConstant();
+    return;
+  }
+
+  if (!accessor.isBufferView()) {
+    return;
+  }
+
+  this->_kind = Kind::Buffer;
+  this->_bits = accessor.getBufferAccessor();
+
+  if (computeCounts) {
+    const size_t wordCount = (this->_bits.size() + 7) / 8;
+    this->_countsBeforeWord.resize(wordCount + 1);
+    uint32_t count = 0;
+    for (size_t i = 0; i < wordCount; ++i) {
+      this->_countsBeforeWord[i] = count;
+      const size_t start = i * 8;
+      count += AvailabilityUtilities::countOnesInBuffer(this->_bits.subspan(
+          start,
+          std::min<size_t>(8, this->_bits.size() - start)));
+    }
+    this->_countsBeforeWord[wordCount] = count;
+  }
+}
+
+uint32_t
+AvailabilityBitstream::countAvailableBefore(uint32_t index) const noexcept {
+  if (this->_kind == Kind::Constant) {
+    return this->_constant ? index : 0;
+  }
+
+  if (this->_countsBeforeWord.empty()) {
+    return 0;
+  }
+
+  const size_t byteIndex = index >> 3;
+  if (byteIndex >= this->_bits.size()) {
+    return this->_countsBeforeWord.back();
+  }
+
+  const size_t wordStart = byteIndex & ~size_t(7);
+  const uint8_t bitIndex = static_cast<uint8_t>(index & 7);
+  const uint8_t byte = static_cast<uint8_t>(this->_bits[byteIndex]);
+
+  return this->_countsBeforeWord[wordStart >> 3] +
+         AvailabilityUtilities::countOnesInBuffer(
+             this->_bits.subspan(wordStart, byteIndex - wordStart)) +
+         AvailabilityUtilities::countOnesInByte(
+             static_cast<uint8_t>(byte & ((1U << bitIndex) - 1U)));
+}
+
 AvailabilityNode::AvailabilityNode() noexcept
     : subtree(std::nullopt), childNodes() {}
 
@@ -36,23 +97,26 @@ void AvailabilityNode::setLoadedSubtree(
     uint32_t maxChildrenSubtrees) noexcept {
   this->subtree = std::make_optional<AvailabilitySubtree>(std::move(subtree_));
 
-  AvailabilityAccessor subtreeAvailabilityAccessor(
+  // The bitstreams refer to the buffers now owned by this node.
+  this->tileAvailability = AvailabilityBitstream(
+      this->subtree->tileAvailability,
+      *this->subtree,
+      false);
+  this->contentAvailability = AvailabilityBitstream(
+      this->subtree->contentAvailability,
+      *this->subtree,
+      false);
+  this->childSubtreeAvailability = AvailabilityBitstream(
       this->subtree->subtreeAvailability,
-      *this->subtree);
+      *this->subtree,
+      true);
 
-  size_t childNodesCount = 0;
-  if (subtreeAvailabilityAccessor.isConstant()) {
-    if (subtreeAvailabilityAccessor.getConstant()) {
-      childNodesCount = maxChildrenSubtrees;
-    }
-  } else if (subtreeAvailabilityAccessor.isBufferView()) {
-    childNodesCount = AvailabilityUtilities::countOnesInBuffer(
-        subtreeAvailabilityAccessor.getBufferAccessor());
-  } else {
+  if (!this->childSubtreeAvailability.isValid()) {
     return;
   }
 
-  this->childNodes.resize(childNodesCount);
+  this->childNodes.resize(
+      this->childSubtreeAvailability.countAvailableBefore(maxChildrenSubtrees));
 }
 
 AvailabilityAccessor::AvailabilityAccessor(
@@ -1,5 +1,6 @@
 #include "CesiumGeometry/OctreeAvailability.h"
 
+#include <algorithm>
 #include <cassert>
 
 namespace CesiumGeometry {
@@ -32,13 +33,43 @@ static uint32_t getMortonIndex(uint32_t x, uint32_t y, uint32_t z) {
   return spread3(z) << 2 | spread3(y) << 1 | spread3(x);
 }
 
+/**
+ * @brief Inserts two 0 bits of spacing between a number's bits.
+ *
+ * @param i A 21-bit unsigned int.
+ * @return A 64-bit unsigned int.
+ */
+static uint64_t spread3Wide(uint32_t i) {
+  uint64_t result = i & 0x1FFFFFU;
+  result = (result | (result << 32)) & 0x001F00000000FFFFULL;
+  result = (result | (result << 16)) & 0x001F0000FF0000FFULL;
+  result = (result | (result << 8)) & 0x100F00F00F00F00FULL;
+  result = (result | (result << 4)) & 0x10C30C30C30C30C3ULL;
+  result = (result | (result << 2)) & 0x1249249249249249ULL;
+  return result;
+}
+
+/**
+ * @brief Gets the key of a subtree's node in the index of nodes.
+ *
+ * The key is the tile's Morton index at its level with a 1 bit above it, so
+ * that tiles at different levels with the same Morton index have different
+ * keys.
+ */
+static uint64_t getNodeKey(const OctreeTileID& tileID) {
+  assert(tileID.level <= OctreeAvailability::MAXIMUM_SUPPORTED_LEVEL);
+  return (uint64_t(1) << (3U * tileID.level)) | spread3Wide(tileID.x) |
+         (spread3Wide(tileID.y) << 1U) | (spread3Wide(tileID.z) << 2U);
+}
+
 OctreeAvailability::OctreeAvailability(
     uint32_t subtreeLevels,
     uint32_t maximumLevel) noexcept
     : _subtreeLevels(subtreeLevels),
-      _maximumLevel(maximumLevel),
+      _maximumLevel(std::min(maximumLevel, MAXIMUM_SUPPORTED_LEVEL)),
       _maximumChildrenSubtrees(1U << (3U * subtreeLevels)),
-      _pRoot(nullptr) {}
+      _pRoot(nullptr),
+      _nodesByKey() {}
 
 uint8_t OctreeAvailability::computeAvailability(
     const OctreeTileID& tileID) const noexcept {
@@ -53,118 +84,50 @@ uint8_t OctreeAvailability::computeAvailability(
     return 0;
   }
 
+  // Usually the subtree containing the tile is already loaded, so look it up
+  // directly. A node is only ever added beneath an available parent subtree,
+  // so finding it also means the tile is reachable.
+  const OctreeTileID subtreeRootID = this->getSubtreeRootID(tileID);
+  const AvailabilityNode* pSubtreeNode = this->findNode(subtreeRootID);
+  if (pSubtreeNode && pSubtreeNode->subtree) {
+    return this->computeAvailabilityInSubtree(
+        tileID,
+        tileID.level - subtreeRootID.level,
+        *pSubtreeNode);
+  }
+
+  // Otherwise, walk down from the root to find out how far the tile's
+  // ancestors are known to be available.
   uint32_t level = 0;
-  AvailabilityNode* pNode = this->_pRoot.get();
+  const AvailabilityNode* pNode = this->_pRoot.get();
 
   while (pNode && pNode->subtree && tileID.level >= level) {
-    const AvailabilitySubtree& subtree = *pNode->subtree;
-
-    AvailabilityAccessor tileAvailabilityAccessor(
-        subtree.tileAvailability,
-        subtree);
-    AvailabilityAccessor contentAvailabilityAccessor(
-        subtree.contentAvailability,
-        subtree);
-    AvailabilityAccessor subtreeAvailabilityAccessor(
-        subtree.subtreeAvailability,
-        subtree);
-
     uint32_t levelsLeft = tileID.level - level;
-    uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << levelsLeft);
 
     if (levelsLeft < this->_subtreeLevels) {
       // The availability info is within this subtree.
-      uint8_t availability = TileAvailabilityFlags::REACHABLE;
-
-      uint32_t relativeMortonIndex = getMortonIndex(
-          tileID.x & subtreeRelativeMask,
-          tileID.y & subtreeRelativeMask,
-          tileID.z & subtreeRelativeMask);
-
-      // For reference:
-      // https://github.com/CesiumGS/3d-tiles/tree/3d-tiles-next/extensions/3DTILES_implicit_tiling#availability-bitstream-lengths
-      // The below is identical to:
-      // (8^levelRelativeToSubtree - 1) / 7
-      uint32_t offset = ((1U << (3U * levelsLeft)) - 1U) / 7U;
-
-      uint32_t availabilityIndex = relativeMortonIndex + offset;
-      uint32_t byteIndex = availabilityIndex >> 3;
-      uint8_t bitIndex = static_cast<uint8_t>(availabilityIndex & 7);
-      uint8_t bitMask = static_cast<uint8_t>(1 << bitIndex);
-
-      // Check tile availability.
-      if ((tileAvailabilityAccessor.isConstant() &&
-           tileAvailabilityAccessor.getConstant()) ||
-          (tileAvailabilityAccessor.isBufferView() &&
-           (uint8_t)tileAvailabilityAccessor[byteIndex] & bitMask)) {
-        availability |= TileAvailabilityFlags::TILE_AVAILABLE;
-      }
-
-      // Check content availability.
-      if ((contentAvailabilityAccessor.isConstant() &&
-           contentAvailabilityAccessor.getConstant()) ||
-          (contentAvailabilityAccessor.isBufferView() &&
-           (uint8_t)contentAvailabilityAccessor[byteIndex] & bitMask)) {
-        availability |= TileAvailabilityFlags::CONTENT_AVAILABLE;
-      }
-
-      // If this is the 0th level within the subtree, we know this tile's
-      // subtree is available and loaded.
-      if (levelsLeft == 0) {
-        availability |= TileAvailabilityFlags::SUBTREE_AVAILABLE;
-        availability |= TileAvailabilityFlags::SUBTREE_LOADED;
-      }
-
-      return availability;
+      return this->computeAvailabilityInSubtree(tileID, levelsLeft, *pNode);
     }
 
-    uint32_t levelsLeftAfterNextLevel = levelsLeft - this->_subtreeLevels;
-    uint32_t childSubtreeMortonIndex = getMortonIndex(
-        (tileID.x & subtreeRelativeMask) >> levelsLeftAfterNextLevel,
-        (tileID.y & subtreeRelativeMask) >> levelsLeftAfterNextLevel,
-        (tileID.z & subtreeRelativeMask) >> levelsLeftAfterNextLevel);
-
-    // Check if the needed child subtree exists.
-    bool childSubtreeAvailable = false;
-    uint32_t childSubtreeIndex = 0;
-
-    if (subtreeAvailabilityAccessor.isConstant()) {
-      childSubtreeAvailable = subtreeAvailabilityAccessor.getConstant();
-      childSubtreeIndex = childSubtreeMortonIndex;
-
-    } else if (subtreeAvailabilityAccessor.isBufferView()) {
-      uint32_t byteIndex = childSubtreeMortonIndex >> 3;
-      uint8_t bitIndex = static_cast<uint8_t>(childSubtreeMortonIndex & 7);
-      uint8_t bitMask = static_cast<uint8_t>(1 << bitIndex);
-
-      gsl::span<const std::byte> clippedSubtreeAvailability =
-          subtreeAvailabilityAccessor.getBufferAccessor().subspan(0, byteIndex);
-      uint8_t availabilityByte =
-          (uint8_t)subtreeAvailabilityAccessor[byteIndex];
-
-      childSubtreeAvailable = availabilityByte & bitMask;
-      // Calculte the index the child subtree is stored in.
-      if (childSubtreeAvailable) {
-        childSubtreeIndex =
-            // TODO: maybe partial sums should be precomputed in the subtree
-            // availability, instead of iterating through the buffer each time.
-            AvailabilityUtilities::countOnesInBuffer(
-                clippedSubtreeAvailability) +
-            AvailabilityUtilities::countOnesInByte(
-                static_cast<uint8_t>(availabilityByte << (8 - bitIndex)));
-      }
-    } else {
+    if (!pNode->childSubtreeAvailability.isValid()) {
       // INVALID AVAILABILITY ACCESSOR
       return 0;
     }
 
-    if (childSubtreeAvailable) {
-      pNode = pNode->childNodes[childSubtreeIndex].get();
-      level += this->_subtreeLevels;
-    } else {
+    level += this->_subtreeLevels;
+    const uint32_t levelsBelowChild = tileID.level - level;
+    const OctreeTileID childID(
+        level,
+        tileID.x >> levelsBelowChild,
+        tileID.y >> levelsBelowChild,
+        tileID.z >> levelsBelowChild);
+
+    if (!this->findChildSubtreeIndex(childID, *pNode)) {
       // The child subtree containing the tile id is not available.
       return TileAvailabilityFlags::REACHABLE;
     }
+
+    pNode = this->findNode(childID);
   }
 
   // This is the only case where execution should reach here. It means that a
@@ -183,6 +146,52 @@ uint8_t OctreeAvailability::computeAvailability(
   return 0;
 }
 
+void OctreeAvailability::computeAvailability(
+    const gsl::span<const OctreeTileID>& tileIDs,
+    const gsl::span<uint8_t>& availability) const noexcept {
+  assert(tileIDs.size() == availability.size());
+  const size_t count = std::min(tileIDs.size(), availability.size());
+
+  // The loaded subtree that contained the previous tile, if any.
+  const AvailabilityNode* pLastNode = nullptr;
+  OctreeTileID lastRootID(0, 0, 0, 0);
+
+  for (size_t i = 0; i < count; ++i) {
+    const OctreeTileID& tileID = tileIDs[i];
+    if (!this->_pRoot || tileID.level > this->_maximumLevel) {
+      availability[i] = this->computeAvailability(tileID);
+      continue;
+    }
+
+    if (pLastNode && tileID.level >= lastRootID.level &&
+        tileID.level - lastRootID.level < this->_subtreeLevels) {
+      const uint32_t relativeLevel = tileID.level - lastRootID.level;
+      if ((tileID.x >> relativeLevel) == lastRootID.x &&
+          (tileID.y >> relativeLevel) == lastRootID.y &&
+          (tileID.z >> relativeLevel) == lastRootID.z) {
+        availability[i] = this->computeAvailabilityInSubtree(
+            tileID,
+            relativeLevel,
+            *pLastNode);
+        continue;
+      }
+    }
+
+    const OctreeTileID subtreeRootID = this->getSubtreeRootID(tileID);
+    const AvailabilityNode* pNode = this->findNode(subtreeRootID);
+    if (pNode && pNode->subtree) {
+      pLastNode = pNode;
+      lastRootID = subtreeRootID;
+      availability[i] = this->computeAvailabilityInSubtree(
+          tileID,
+          tileID.level - subtreeRootID.level,
+          *pNode);
+    } else {
+      availability[i] = this->computeAvailability(tileID);
+    }
+  }
+}
+
 bool OctreeAvailability::addSubtree(
     const OctreeTileID& tileID,
     AvailabilitySubtree&& newSubtree) noexcept {
@@ -197,104 +206,51 @@ bool OctreeAvailability::addSubtree(
       this->_pRoot->setLoadedSubtree(
           std::move(newSubtree),
           this->_maximumChildrenSubtrees);
+      this->addNodeToIndex(tileID, this->_pRoot.get());
       return true;
     }
   }
 
-  if (!this->_pRoot) {
+  // The given subtree to add must fall exactly at the end of an existing
+  // subtree.
+  if (!this->_pRoot || tileID.level < this->_subtreeLevels ||
+      tileID.level > this->_maximumLevel ||
+      (tileID.level % this->_subtreeLevels) != 0) {
     return false;
   }
 
-  AvailabilityNode* pNode = this->_pRoot.get();
-  uint32_t level = 0;
-
-  while (pNode && pNode->subtree && tileID.level > level) {
-    AvailabilitySubtree& subtree = *pNode->subtree;
-
-    AvailabilityAccessor subtreeAvailabilityAccessor(
-        subtree.subtreeAvailability,
-        subtree);
-
-    uint32_t levelsLeft = tileID.level - level;
-
-    // The given subtree to add must fall exactly at the end of an existing
-    // subtree.
-    if (levelsLeft < this->_subtreeLevels) {
-      return false;
-    }
+  const OctreeTileID parentID(
+      tileID.level - this->_subtreeLevels,
+      tileID.x >> this->_subtreeLevels,
+      tileID.y >> this->_subtreeLevels,
+      tileID.z >> this->_subtreeLevels);
+  AvailabilityNode* pParentNode = this->findNode(parentID);
+  if (!pParentNode || !pParentNode->subtree) {
+    return false;
+  }
 
-    // TODO: consolidate duplicated code here...
-
-    uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << levelsLeft);
-    uint32_t levelsLeftAfterChildren = levelsLeft - this->_subtreeLevels;
-    uint32_t childSubtreeMortonIndex = getMortonIndex(
-        (tileID.x & subtreeRelativeMask) >> levelsLeftAfterChildren,
-        (tileID.y & subtreeRelativeMask) >> levelsLeftAfterChildren,
-        (tileID.z & subtreeRelativeMask) >> levelsLeftAfterChildren);
-
-    // Check if the needed child subtree exists.
-    bool childSubtreeAvailable = false;
-    uint32_t childSubtreeIndex = 0;
-
-    if (subtreeAvailabilityAccessor.isConstant()) {
-      childSubtreeAvailable = subtreeAvailabilityAccessor.getConstant();
-      childSubtreeIndex = childSubtreeMortonIndex;
-    } else if (subtreeAvailabilityAccessor.isBufferView()) {
-      uint32_t byteIndex = childSubtreeMortonIndex >> 3;
-      uint8_t bitIndex = static_cast<uint8_t>(childSubtreeMortonIndex & 7);
-      uint8_t bitMask = static_cast<uint8_t>(1 << bitIndex);
-
-      gsl::span<const std::byte> clippedSubtreeAvailability =
-          subtreeAvailabilityAccessor.getBufferAccessor().subspan(0, byteIndex);
-      uint8_t availabilityByte =
-          (uint8_t)subtreeAvailabilityAccessor[byteIndex];
-
-      childSubtreeAvailable = availabilityByte & bitMask;
-      // Calculte the index the child subtree is stored in.
-      if (childSubtreeAvailable) {
-        childSubtreeIndex =
-            // TODO: maybe partial sums should be precomputed in the subtree
-            // availability, instead of iterating through the buffer each time.
-            AvailabilityUtilities::countOnesInBuffer(
-                clippedSubtreeAvailability) +
-            AvailabilityUtilities::countOnesInByte(
-                static_cast<uint8_t>(availabilityByte << (8 - bitIndex)));
-      }
-    } else {
-      // INVALID AVAILABILITY ACCESSOR
-      return false;
-    }
+  std::optional<uint32_t> childIndex =
+      this->findChildSubtreeIndex(tileID, *pParentNode);
+  if (!childIndex || *childIndex >= pParentNode->childNodes.size()) {
+    // This child subtree is marked as non-available.
+    // TODO: warn of invalid availability
+    return false;
+  }
 
-    if (childSubtreeAvailable) {
-      if (levelsLeftAfterChildren == 0) {
-        // This is the child that the new subtree corresponds to.
-
-        if (pNode->childNodes[childSubtreeIndex]) {
-          // This subtree was already added.
-          // TODO: warn of error
-          return false;
-        }
-
-        pNode->childNodes[childSubtreeIndex] =
-            std::make_unique<AvailabilityNode>();
-        pNode->childNodes[childSubtreeIndex]->setLoadedSubtree(
-            std::move(newSubtree),
-            this->_maximumChildrenSubtrees);
-        return true;
-      } else {
-        // We need to traverse this child subtree to find where to add the new
-        // subtree.
-        pNode = pNode->childNodes[childSubtreeIndex].get();
-        level += this->_subtreeLevels;
-      }
-    } else {
-      // This child subtree is marked as non-available.
-      // TODO: warn of invalid availability
-      return false;
-    }
+  std::unique_ptr<AvailabilityNode>& pChild =
+      pParentNode->childNodes[*childIndex];
+  if (pChild) {
+    // This subtree was already added.
+    // TODO: warn of error
+    return false;
   }
 
-  return false;
+  pChild = std::make_unique<AvailabilityNode>();
+  pChild->setLoadedSubtree(
+      std::move(newSubtree),
+      this->_maximumChildrenSubtrees);
+  this->addNodeToIndex(tileID, pChild.get());
+  return true;
 }
 
 uint8_t OctreeAvailability::computeAvailability(
@@ -314,61 +270,14 @@ uint8_t OctreeAvailability::computeAvailability(
     return 0;
   }
 
-  AvailabilityAccessor tileAvailabilityAccessor(
-      pNode->subtree->tileAvailability,
-      *pNode->subtree);
-  AvailabilityAccessor contentAvailabilityAccessor(
-      pNode->subtree->contentAvailability,
-      *pNode->subtree);
-  AvailabilityAccessor subtreeAvailability(
-      pNode->subtree->subtreeAvailability,
-      *pNode->subtree);
-
-  uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << relativeLevel);
-
   // Assume the availability info is within this subtree.
   // If this is not the case, we may return an incorrect availability.
-  uint8_t availability = TileAvailabilityFlags::REACHABLE;
-
-  uint32_t relativeMortonIndex = getMortonIndex(
-      tileID.x & subtreeRelativeMask,
-      tileID.y & subtreeRelativeMask,
-      tileID.z & subtreeRelativeMask);
-
-  // For reference:
-  // https://github.com/CesiumGS/3d-tiles/tree/3d-tiles-next/extensions/3DTILES_implicit_tiling#availability-bitstream-lengths
-  // The below is identical to:
-  // (8^levelRelativeToSubtree - 1) / 7
-  uint32_t offset = ((1U << (3U * relativeLevel)) - 1U) / 7U;
-
-  uint32_t availabilityIndex = relativeMortonIndex + offset;
-  uint32_t byteIndex = availabilityIndex >> 3;
-  uint8_t bitIndex = static_cast<uint8_t>(availabilityIndex & 7);
-  uint8_t bitMask = static_cast<uint8_t>(1 << bitIndex);
-
-  // Check tile availability.
-  if ((tileAvailabilityAccessor.isConstant() &&
-       tileAvailabilityAccessor.getConstant()) ||
-      (tileAvailabilityAccessor.isBufferView() &&
-       (uint8_t)tileAvailabilityAccessor[byteIndex] & bitMask)) {
-    availability |= TileAvailabilityFlags::TILE_AVAILABLE;
-  }
+  uint8_t availability =
+      this->computeAvailabilityInSubtree(tileID, relativeLevel, *pNode);
 
-  // Check content availability.
-  if ((contentAvailabilityAccessor.isConstant() &&
-       contentAvailabilityAccessor.getConstant()) ||
-      (contentAvailabilityAccessor.isBufferView() &&
-       (uint8_t)contentAvailabilityAccessor[byteIndex] & bitMask)) {
-    availability |= TileAvailabilityFlags::CONTENT_AVAILABLE;
-  }
-
-  // If this is the 0th level within the subtree, we know this tile's
-  // subtree is available and loaded.
   if (relativeLevel == 0) {
     // Setting TILE_AVAILABLE here may technically be redundant.
     availability |= TileAvailabilityFlags::TILE_AVAILABLE;
-    availability |= TileAvailabilityFlags::SUBTREE_AVAILABLE;
-    availability |= TileAvailabilityFlags::SUBTREE_LOADED;
   }
 
   return availability;
@@ -385,6 +294,7 @@ AvailabilityNode* OctreeAvailability::addNode(
     } else {
       // Set the root node.
       this->_pRoot = std::make_unique<AvailabilityNode>();
+      this->addNodeToIndex(OctreeTileID(0, 0, 0, 0), this->_pRoot.get());
       return this->_pRoot.get();
     }
   }
@@ -396,57 +306,28 @@ AvailabilityNode* OctreeAvailability::addNode(
   }
 
   // The tile must fall exactly after the parent subtree.
-  if ((tileID.level % this->_subtreeLevels) != 0) {
+  if (tileID.level > this->_maximumLevel ||
+      (tileID.level % this->_subtreeLevels) != 0) {
     return nullptr;
   }
 
-  uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << this->_subtreeLevels);
-  uint32_t mortonIndex = getMortonIndex(
-      tileID.x & subtreeRelativeMask,
-      tileID.y & subtreeRelativeMask,
-      tileID.z & subtreeRelativeMask);
-
-  AvailabilityAccessor subtreeAvailabilityAccessor(
-      pParentNode->subtree->subtreeAvailability,
-      *pParentNode->subtree);
-
-  bool subtreeAvailable = false;
-  uint32_t subtreeIndex = 0;
-  if (subtreeAvailabilityAccessor.isConstant()) {
-    subtreeAvailable = subtreeAvailabilityAccessor.getConstant();
-    subtreeIndex = mortonIndex;
-  } else if (subtreeAvailabilityAccessor.isBufferView()) {
-    uint32_t byteIndex = mortonIndex >> 3;
-    uint8_t bitIndex = static_cast<uint8_t>(mortonIndex & 7);
-    uint8_t bitMask = static_cast<uint8_t>(1 << bitIndex);
-
-    gsl::span<const std::byte> clippedSubtreeAvailability =
-        subtreeAvailabilityAccessor.getBufferAccessor().subspan(0, byteIndex);
-    uint8_t availabilityByte = (uint8_t)subtreeAvailabilityAccessor[byteIndex];
-
-    subtreeAvailable = availabilityByte & bitMask;
-
-    // Calculte the index the child subtree is stored in.
-    if (subtreeAvailable) {
-      subtreeIndex =
-          // TODO: maybe partial sums should be precomputed in the subtree
-          // availability, instead of iterating through the buffer each time.
-          AvailabilityUtilities::countOnesInBuffer(clippedSubtreeAvailability) +
-          AvailabilityUtilities::countOnesInByte(
-              static_cast<uint8_t>(availabilityByte << (8 - bitIndex)));
-    } else {
-      // This subtree is not supposed to be available.
-      return nullptr;
-    }
+  std::optional<uint32_t> subtreeIndex =
+      this->findChildSubtreeIndex(tileID, *pParentNode);
+  if (!subtreeIndex || *subtreeIndex >= pParentNode->childNodes.size()) {
+    // This subtree is not supposed to be available.
+    return nullptr;
   }
 
-  if (subtreeAvailable) {
-    pParentNode->childNodes[subtreeIndex] =
-        std::make_unique<AvailabilityNode>();
-    return pParentNode->childNodes[subtreeIndex].get();
+  std::unique_ptr<AvailabilityNode>& pChild =
+      pParentNode->childNodes[*subtreeIndex];
+  if (pChild) {
+    // This node was already added.
+    return nullptr;
   }
 
-  return nullptr;
+  pChild = std::make_unique<AvailabilityNode>();
+  this->addNodeToIndex(tileID, pChild.get());
+  return pChild.get();
 }
 
 bool OctreeAvailability::addLoadedSubtree(
@@ -471,48 +352,7 @@ std::optional<uint32_t> OctreeAvailability::findChildNodeIndex(
     return std::nullopt;
   }
 
-  uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << this->_subtreeLevels);
-  uint32_t mortonIndex = getMortonIndex(
-      tileID.x & subtreeRelativeMask,
-      tileID.y & subtreeRelativeMask,
-      tileID.z & subtreeRelativeMask);
-
-  AvailabilityAccessor subtreeAvailabilityAccessor(
-      pParentNode->subtree->subtreeAvailability,
-      *pParentNode->subtree);
-
-  bool subtreeAvailable = false;
-  uint32_t subtreeIndex = 0;
-  if (subtreeAvailabilityAccessor.isConstant()) {
-    subtreeAvailable = subtreeAvailabilityAccessor.getConstant();
-    subtreeIndex = mortonIndex;
-  } else if (subtreeAvailabilityAccessor.isBufferView()) {
-    uint32_t byteIndex = mortonIndex >> 3;
-    uint8_t bitIndex = static_cast<uint8_t>(mortonIndex & 7);
-    uint8_t bitMask = static_cast<uint8_t>(1 << bitIndex);
-
-    gsl::span<const std::byte> clippedSubtreeAvailability =
-        subtreeAvailabilityAccessor.getBufferAccessor().subspan(0, byteIndex);
-    uint8_t availabilityByte = (uint8_t)subtreeAvailabilityAccessor[byteIndex];
-
-    subtreeAvailable = availabilityByte & bitMask;
-
-    // Calculte the index the child subtree is stored in.
-    if (subtreeAvailable) {
-      subtreeIndex =
-          // TODO: maybe partial sums should be precomputed in the subtree
-          // availability, instead of iterating through the buffer each time.
-          AvailabilityUtilities::countOnesInBuffer(clippedSubtreeAvailability) +
-          AvailabilityUtilities::countOnesInByte(
-              static_cast<uint8_t>(availabilityByte << (8 - bitIndex)));
-    }
-  }
-
-  if (subtreeAvailable) {
-    return subtreeIndex;
-  }
-
-  return std::nullopt;
+  return this->findChildSubtreeIndex(tileID, *pParentNode);
 }
 
 AvailabilityNode* OctreeAvailability::findChildNode(
@@ -528,4 +368,84 @@ AvailabilityNode* OctreeAvailability::findChildNode(
 
   return pParentNode->childNodes[*childIndex].get();
 }
+
+OctreeTileID OctreeAvailability::getSubtreeRootID(
+    const OctreeTileID& tileID) const noexcept {
+  const uint32_t relativeLevel = tileID.level % this->_subtreeLevels;
+  return OctreeTileID(
+      tileID.level - relativeLevel,
+      tileID.x >> relativeLevel,
+      tileID.y >> relativeLevel,
+      tileID.z >> relativeLevel);
+}
+
+AvailabilityNode* OctreeAvailability::findNode(
+    const OctreeTileID& subtreeRootID) const noexcept {
+  auto it = this->_nodesByKey.find(getNodeKey(subtreeRootID));
+  return it == this->_nodesByKey.end() ? nullptr : it->second;
+}
+
+void OctreeAvailability::addNodeToIndex(
+    const OctreeTileID& subtreeRootID,
+    AvailabilityNode* pNode) noexcept {
+  this->_nodesByKey[getNodeKey(subtreeRootID)] = pNode;
+}
+
+uint8_t OctreeAvailability::computeAvailabilityInSubtree(
+    const OctreeTileID& tileID,
+    uint32_t relativeLevel,
+    const AvailabilityNode& node) const noexcept {
+  uint8_t availability = TileAvailabilityFlags::REACHABLE;
+
+  uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << relativeLevel);
+  uint32_t relativeMortonIndex = getMortonIndex(
+      tileID.x & subtreeRelativeMask,
+      tileID.y & subtreeRelativeMask,
+      tileID.z & subtreeRelativeMask);
+
+  // For reference:
+  // https://github.com/CesiumGS/3d-tiles/tree/3d-tiles-next/extensions/3DTILES_implicit_tiling#availability-bitstream-lengths
+  // The below is identical to:
+  // (8^levelRelativeToSubtree - 1) / 7
+  uint32_t offset = ((1U << (3U * relativeLevel)) - 1U) / 7U;
+
+  uint32_t availabilityIndex = relativeMortonIndex + offset;
+
+  if (node.tileAvailability.isAvailable(availabilityIndex)) {
+    availability |= TileAvailabilityFlags::TILE_AVAILABLE;
+  }
+
+  if (node.contentAvailability.isAvailable(availabilityIndex)) {
+    availability |= TileAvailabilityFlags::CONTENT_AVAILABLE;
+  }
+
+  // If this is the 0th level within the subtree, we know this tile's
+  // subtree is available and loaded.
+  if (relativeLevel == 0) {
+    availability |= TileAvailabilityFlags::SUBTREE_AVAILABLE;
+    availability |= TileAvailabilityFlags::SUBTREE_LOADED;
+  }
+
+  return availability;
+}
+
+std::optional<uint32_t> OctreeAvailability::findChildSubtreeIndex(
+    const OctreeTileID& tileID,
+    const AvailabilityNode& parentNode) const noexcept {
+  uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << this->_subtreeLevels);
+  uint32_t mortonIndex = getMortonIndex(
+      tileID.x & subtreeRelativeMask,
+      tileID.y & subtreeRelativeMask,
+      tileID.z & subtreeRelativeMask);
+
+  const AvailabilityBitstream& subtreeAvailability =
+      parentNode.childSubtreeAvailability;
+  if (!subtreeAvailability.isAvailable(mortonIndex)) {
+    return std::nullopt;
+  }
+
+  // Only available child subtrees are stored, in Morton order.
+  return subtreeAvailability.countAvailableBefore(mortonIndex);
+}
+
 } // namespace CesiumGeometry
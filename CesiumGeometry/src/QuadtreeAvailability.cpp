@@ -1,5 +1,6 @@
 #include "CesiumGeometry/QuadtreeAvailability.h"
 
+#include <algorithm>
 #include <cassert>
 
 namespace CesiumGeometry {
@@ -46,13 +47,43 @@ static uint32_t getMortonIndex(uint32_t x, uint32_t y) {
       static_cast<uint16_t>(y));
 }
 
+/**
+ * @brief Inserts a 0 bit of spacing between a number's bits.
+ *
+ * @param i A 32-bit unsigned int.
+ * @return A 64-bit unsigned int.
+ */
+static uint64_t spread2(uint32_t i) {
+  uint64_t result = i;
+  result = (result | (result << 16)) & 0x0000FFFF0000FFFFULL;
+  result = (result | (result << 8)) & 0x00FF00FF00FF00FFULL;
+  result = (result | (result << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  result = (result | (result << 2)) & 0x3333333333333333ULL;
+  result = (result | (result << 1)) & 0x5555555555555555ULL;
+  return result;
+}
+
+/**
+ * @brief Gets the key of a subtree's node in the index of nodes.
+ *
+ * The key is the tile's Morton index at its level with a 1 bit above it, so
+ * that tiles at different levels with the same Morton index have different
+ * keys.
+ */
+static uint64_t getNodeKey(const QuadtreeTileID& tileID) {
+  assert(tileID.level <= QuadtreeAvailability::MAXIMUM_SUPPORTED_LEVEL);
+  return (uint64_t(1) << (tileID.level << 1U)) | spread2(tileID.x) |
+         (spread2(tileID.y) << 1U);
+}
+
 QuadtreeAvailability::QuadtreeAvailability(
     uint32_t subtreeLevels,
     uint32_t maximumLevel) noexcept
     : _subtreeLevels(subtreeLevels),
-      _maximumLevel(maximumLevel),
+      _maximumLevel(std::min(maximumLevel, MAXIMUM_SUPPORTED_LEVEL)),
       _maximumChildrenSubtrees(1U << (subtreeLevels << 1U)),
-      _pRoot(nullptr) {}
+      _pRoot(nullptr),
+      _nodesByKey() {}
 
 uint8_t QuadtreeAvailability::computeAvailability(
     const QuadtreeTileID& tileID) const noexcept {
@@ -67,116 +98,49 @@ uint8_t QuadtreeAvailability::computeAvailability(
     return 0;
   }
 
+  // Usually the subtree containing the tile is already loaded, so look it up
+  // directly. A node is only ever added beneath an available parent subtree,
+  // so finding it also means the tile is reachable.
+  const QuadtreeTileID subtreeRootID = this->getSubtreeRootID(tileID);
+  const AvailabilityNode* pSubtreeNode = this->findNode(subtreeRootID);
+  if (pSubtreeNode && pSubtreeNode->subtree) {
+    return this->computeAvailabilityInSubtree(
+        tileID,
+        tileID.level - subtreeRootID.level,
+        *pSubtreeNode);
+  }
+
+  // Otherwise, walk down from the root to find out how far the tile's
+  // ancestors are known to be available.
   uint32_t level = 0;
-  AvailabilityNode* pNode = this->_pRoot.get();
+  const AvailabilityNode* pNode = this->_pRoot.get();
 
   while (pNode && pNode->subtree && tileID.level >= level) {
-    const AvailabilitySubtree& subtree = *pNode->subtree;
-
-    AvailabilityAccessor tileAvailabilityAccessor(
-        subtree.tileAvailability,
-        subtree);
-    AvailabilityAccessor contentAvailabilityAccessor(
-        subtree.contentAvailability,
-        subtree);
-    AvailabilityAccessor subtreeAvailabilityAccessor(
-        subtree.subtreeAvailability,
-        subtree);
-
     uint32_t levelsLeft = tileID.level - level;
-    uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << levelsLeft);
 
     if (levelsLeft < this->_subtreeLevels) {
       // The availability info is within this subtree.
-      uint8_t availability = TileAvailabilityFlags::REACHABLE;
-
-      uint32_t relativeMortonIndex = getMortonIndex(
-          tileID.x & subtreeRelativeMask,
-          tileID.y & subtreeRelativeMask);
-
-      // For reference:
-      // https://github.com/CesiumGS/3d-tiles/tree/3d-tiles-next/extensions/3DTILES_implicit_tiling#availability-bitstream-lengths
-      // The below is identical to:
-      // (4^levelRelativeToSubtree - 1) / 3
-      uint32_t offset = ((1U << (levelsLeft << 1U)) - 1U) / 3U;
-
-      uint32_t availabilityIndex = relativeMortonIndex + offset;
-      uint32_t byteIndex = availabilityIndex >> 3;
-      uint8_t bitIndex = static_cast<uint8_t>(availabilityIndex & 7);
-      uint8_t bitMask = static_cast<uint8_t>(1 << bitIndex);
-
-      // Check tile availability.
-      if ((tileAvailabilityAccessor.isConstant() &&
-           tileAvailabilityAccessor.getConstant()) ||
-          (tileAvailabilityAccessor.isBufferView() &&
-           (uint8_t)tileAvailabilityAccessor[byteIndex] & bitMask)) {
-        availability |= TileAvailabilityFlags::TILE_AVAILABLE;
-      }
-
-      // Check content availability.
-      if ((contentAvailabilityAccessor.isConstant() &&
-           contentAvailabilityAccessor.getConstant()) ||
-          (contentAvailabilityAccessor.isBufferView() &&
-           (uint8_t)contentAvailabilityAccessor[byteIndex] & bitMask)) {
-        availability |= TileAvailabilityFlags::CONTENT_AVAILABLE;
-      }
-
-      // If this is the 0th level within the subtree, we know this tile's
-      // subtree is available and loaded.
-      if (levelsLeft == 0) {
-        availability |= TileAvailabilityFlags::SUBTREE_AVAILABLE;
-        availability |= TileAvailabilityFlags::SUBTREE_LOADED;
-      }
-
-      return availability;
+      return this->computeAvailabilityInSubtree(tileID, levelsLeft, *pNode);
     }
 
-    uint32_t levelsLeftAfterNextLevel = levelsLeft - this->_subtreeLevels;
-    uint32_t childSubtreeMortonIndex = getMortonIndex(
-        (tileID.x & subtreeRelativeMask) >> levelsLeftAfterNextLevel,
-        (tileID.y & subtreeRelativeMask) >> levelsLeftAfterNextLevel);
-
-    // Check if the needed child subtree exists.
-    bool childSubtreeAvailable = false;
-    uint32_t childSubtreeIndex = 0;
-
-    if (subtreeAvailabilityAccessor.isConstant()) {
-      childSubtreeAvailable = subtreeAvailabilityAccessor.getConstant();
-      childSubtreeIndex = childSubtreeMortonIndex;
-
-    } else if (subtreeAvailabilityAccessor.isBufferView()) {
-      uint32_t byteIndex = childSubtreeMortonIndex >> 3;
-      uint8_t bitIndex = static_cast<uint8_t>(childSubtreeMortonIndex & 7);
-      uint8_t bitMask = static_cast<uint8_t>(1 << bitIndex);
-
-      gsl::span<const std::byte> clippedSubtreeAvailability =
-          subtreeAvailabilityAccessor.getBufferAccessor().subspan(0, byteIndex);
-      uint8_t availabilityByte =
-          (uint8_t)subtreeAvailabilityAccessor[byteIndex];
-
-      childSubtreeAvailable = availabilityByte & bitMask;
-      // Calculte the index the child subtree is stored in.
-      if (childSubtreeAvailable) {
-        childSubtreeIndex =
-            // TODO: maybe partial sums should be precomputed in the subtree
-            // availability, instead of iterating through the buffer each time.
-            AvailabilityUtilities::countOnesInBuffer(
-                clippedSubtreeAvailability) +
-            AvailabilityUtilities::countOnesInByte(
-                static_cast<uint8_t>(availabilityByte << (8 - bitIndex)));
-      }
-    } else {
+    if (!pNode->childSubtreeAvailability.isValid()) {
       // INVALID AVAILABILITY ACCESSOR
       return 0;
     }
 
-    if (childSubtreeAvailable) {
-      pNode = pNode->childNodes[childSubtreeIndex].get();
-      level += this->_subtreeLevels;
-    } else {
+    level += this->_subtreeLevels;
+    const uint32_t levelsBelowChild = tileID.level - level;
+    const QuadtreeTileID childID(
+        level,
+        tileID.x >> levelsBelowChild,
+        tileID.y >> levelsBelowChild);
+
+    if (!this->findChildSubtreeIndex(childID, *pNode)) {
       // The child subtree containing the tile id is not available.
       return TileAvailabilityFlags::REACHABLE;
     }
+
+    pNode = this->findNode(childID);
   }
 
   // This is the only case where execution should reach here. It means that a
@@ -195,6 +159,51 @@ uint8_t QuadtreeAvailability::computeAvailability(
   return 0;
 }
 
+void QuadtreeAvailability::computeAvailability(
+    const gsl::span<const QuadtreeTileID>& tileIDs,
+    const gsl::span<uint8_t>& availability) const noexcept {
+  assert(tileIDs.size() == availability.size());
+  const size_t count = std::min(tileIDs.size(), availability.size());
+
+  // The loaded subtree that contained the previous tile, if any.
+  const AvailabilityNode* pLastNode = nullptr;
+  QuadtreeTileID lastRootID(0, 0, 0);
+
+  for (size_t i = 0; i < count; ++i) {
+    const QuadtreeTileID& tileID = tileIDs[i];
+    if (!this->_pRoot || tileID.level > this->_maximumLevel) {
+      availability[i] = this->computeAvailability(tileID);
+      continue;
+    }
+
+    if (pLastNode && tileID.level >= lastRootID.level &&
+        tileID.level - lastRootID.level < this->_subtreeLevels) {
+      const uint32_t relativeLevel = tileID.level - lastRootID.level;
+      if ((tileID.x >> relativeLevel) == lastRootID.x &&
+          (tileID.y >> relativeLevel) == lastRootID.y) {
+        availability[i] = this->computeAvailabilityInSubtree(
+            tileID,
+            relativeLevel,
+            *pLastNode);
+        continue;
+      }
+    }
+
+    const QuadtreeTileID subtreeRootID = this->getSubtreeRootID(tileID);
+    const AvailabilityNode* pNode = this->findNode(subtreeRootID);
+    if (pNode && pNode->subtree) {
+      pLastNode = pNode;
+      lastRootID = subtreeRootID;
+      availability[i] = this->computeAvailabilityInSubtree(
+          tileID,
+          tileID.level - subtreeRootID.level,
+          *pNode);
+    } else {
+      availability[i] = this->computeAvailability(tileID);
+    }
+  }
+}
+
 bool QuadtreeAvailability::addSubtree(
     const QuadtreeTileID& tileID,
     AvailabilitySubtree&& newSubtree) noexcept {
@@ -209,103 +218,50 @@ bool QuadtreeAvailability::addSubtree(
       this->_pRoot->setLoadedSubtree(
           std::move(newSubtree),
           this->_maximumChildrenSubtrees);
+      this->addNodeToIndex(tileID, this->_pRoot.get());
       return true;
     }
   }
 
-  if (!this->_pRoot) {
+  // The given subtree to add must fall exactly at the end of an existing
+  // subtree.
+  if (!this->_pRoot || tileID.level < this->_subtreeLevels ||
+      tileID.level > this->_maximumLevel ||
+      (tileID.level % this->_subtreeLevels) != 0) {
     return false;
   }
 
-  AvailabilityNode* pNode = this->_pRoot.get();
-  uint32_t level = 0;
-
-  while (pNode && pNode->subtree && tileID.level > level) {
-    AvailabilitySubtree& subtree = *pNode->subtree;
-
-    AvailabilityAccessor subtreeAvailabilityAccessor(
-        subtree.subtreeAvailability,
-        subtree);
-
-    uint32_t levelsLeft = tileID.level - level;
-
-    // The given subtree to add must fall exactly at the end of an existing
-    // subtree.
-    if (levelsLeft < this->_subtreeLevels) {
-      return false;
-    }
+  const QuadtreeTileID parentID(
+      tileID.level - this->_subtreeLevels,
+      tileID.x >> this->_subtreeLevels,
+      tileID.y >> this->_subtreeLevels);
+  AvailabilityNode* pParentNode = this->findNode(parentID);
+  if (!pParentNode || !pParentNode->subtree) {
+    return false;
+  }
 
-    // TODO: consolidate duplicated code here...
-
-    uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << levelsLeft);
-    uint32_t levelsLeftAfterChildren = levelsLeft - this->_subtreeLevels;
-    uint32_t childSubtreeMortonIndex = getMortonIndex(
-        (tileID.x & subtreeRelativeMask) >> levelsLeftAfterChildren,
-        (tileID.y & subtreeRelativeMask) >> levelsLeftAfterChildren);
-
-    // Check if the needed child subtree exists.
-    bool childSubtreeAvailable = false;
-    uint32_t childSubtreeIndex = 0;
-
-    if (subtreeAvailabilityAccessor.isConstant()) {
-      childSubtreeAvailable = subtreeAvailabilityAccessor.getConstant();
-      childSubtreeIndex = childSubtreeMortonIndex;
-    } else if (subtreeAvailabilityAccessor.isBufferView()) {
-      uint32_t byteIndex = childSubtreeMortonIndex >> 3;
-      uint8_t bitIndex = static_cast<uint8_t>(childSubtreeMortonIndex & 7);
-      uint8_t bitMask = static_cast<uint8_t>(1 << bitIndex);
-
-      gsl::span<const std::byte> clippedSubtreeAvailability =
-          subtreeAvailabilityAccessor.getBufferAccessor().subspan(0, byteIndex);
-      uint8_t availabilityByte =
-          (uint8_t)subtreeAvailabilityAccessor[byteIndex];
-
-      childSubtreeAvailable = availabilityByte & bitMask;
-      // Calculte the index the child subtree is stored in.
-      if (childSubtreeAvailable) {
-        childSubtreeIndex =
-            // TODO: maybe partial sums should be precomputed in the subtree
-            // availability, instead of iterating through the buffer each time.
-            AvailabilityUtilities::countOnesInBuffer(
-                clippedSubtreeAvailability) +
-            AvailabilityUtilities::countOnesInByte(
-                static_cast<uint8_t>(availabilityByte << (8 - bitIndex)));
-      }
-    } else {
-      // INVALID AVAILABILITY ACCESSOR
-      return false;
-    }
+  std::optional<uint32_t> childIndex =
+      this->findChildSubtreeIndex(tileID, *pParentNode);
+  if (!childIndex || *childIndex >= pParentNode->childNodes.size()) {
+    // This child subtree is marked as non-available.
+    // TODO: warn of invalid availability
+    return false;
+  }
 
-    if (childSubtreeAvailable) {
-      if (levelsLeftAfterChildren == 0) {
-        // This is the child that the new subtree corresponds to.
-
-        if (pNode->childNodes[childSubtreeIndex]) {
-          // This subtree was already added.
-          // TODO: warn of error
-          return false;
-        }
-
-        pNode->childNodes[childSubtreeIndex] =
-            std::make_unique<AvailabilityNode>();
-        pNode->childNodes[childSubtreeIndex]->setLoadedSubtree(
-            std::move(newSubtree),
-            this->_maximumChildrenSubtrees);
-        return true;
-      } else {
-        // We need to traverse this child subtree to find where to add the new
-        // subtree.
-        pNode = pNode->childNodes[childSubtreeIndex].get();
-        level += this->_subtreeLevels;
-      }
-    } else {
-      // This child subtree is marked as non-available.
-      // TODO: warn of invalid availability
-      return false;
-    }
+  std::unique_ptr<AvailabilityNode>& pChild =
+      pParentNode->childNodes[*childIndex];
+  if (pChild) {
+    // This subtree was already added.
+    // TODO: warn of error
+    return false;
   }
 
-  return false;
+  pChild = std::make_unique<AvailabilityNode>();
+  pChild->setLoadedSubtree(
+      std::move(newSubtree),
+      this->_maximumChildrenSubtrees);
+  this->addNodeToIndex(tileID, pChild.get());
+  return true;
 }
 
 uint8_t QuadtreeAvailability::computeAvailability(
@@ -325,60 +281,14 @@ uint8_t QuadtreeAvailability::computeAvailability(
     return 0;
   }
 
-  AvailabilityAccessor tileAvailabilityAccessor(
-      pNode->subtree->tileAvailability,
-      *pNode->subtree);
-  AvailabilityAccessor contentAvailabilityAccessor(
-      pNode->subtree->contentAvailability,
-      *pNode->subtree);
-  AvailabilityAccessor subtreeAvailability(
-      pNode->subtree->subtreeAvailability,
-      *pNode->subtree);
-
-  uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << relativeLevel);
-
   // Assume the availability info is within this subtree.
   // If this is not the case, we may return an incorrect availability.
-  uint8_t availability = TileAvailabilityFlags::REACHABLE;
-
-  uint32_t relativeMortonIndex = getMortonIndex(
-      tileID.x & subtreeRelativeMask,
-      tileID.y & subtreeRelativeMask);
-
-  // For reference:
-  // https://github.com/CesiumGS/3d-tiles/tree/3d-tiles-next/extensions/3DTILES_implicit_tiling#availability-bitstream-lengths
-  // The below is identical to:
-  // (4^levelRelativeToSubtree - 1) / 3
-  uint32_t offset = ((1U << (relativeLevel << 1U)) - 1U) / 3U;
-
-  uint32_t availabilityIndex = relativeMortonIndex + offset;
-  uint32_t byteIndex = availabilityIndex >> 3;
-  uint8_t bitIndex = static_cast<uint8_t>(availabilityIndex & 7);
-  uint8_t bitMask = static_cast<uint8_t>(1 << bitIndex);
-
-  // Check tile availability.
-  if ((tileAvailabilityAccessor.isConstant() &&
-       tileAvailabilityAccessor.getConstant()) ||
-      (tileAvailabilityAccessor.isBufferView() &&
-       (uint8_t)tileAvailabilityAccessor[byteIndex] & bitMask)) {
-    availability |= TileAvailabilityFlags::TILE_AVAILABLE;
-  }
-
-  // Check content availability.
-  if ((contentAvailabilityAccessor.isConstant() &&
-       contentAvailabilityAccessor.getConstant()) ||
-      (contentAvailabilityAccessor.isBufferView() &&
-       (uint8_t)contentAvailabilityAccessor[byteIndex] & bitMask)) {
-    availability |= TileAvailabilityFlags::CONTENT_AVAILABLE;
-  }
+  uint8_t availability =
+      this->computeAvailabilityInSubtree(tileID, relativeLevel, *pNode);
 
-  // If this is the 0th level within the subtree, we know this tile's
-  // subtree is available and loaded.
   if (relativeLevel == 0) {
     // Setting TILE_AVAILABLE here may technically be redundant.
     availability |= TileAvailabilityFlags::TILE_AVAILABLE;
-    availability |= TileAvailabilityFlags::SUBTREE_AVAILABLE;
-    availability |= TileAvailabilityFlags::SUBTREE_LOADED;
   }
 
   return availability;
@@ -395,6 +305,7 @@ AvailabilityNode* QuadtreeAvailability::addNode(
     } else {
       // Set the root node.
       this->_pRoot = std::make_unique<AvailabilityNode>();
+      this->addNodeToIndex(QuadtreeTileID(0, 0, 0), this->_pRoot.get());
       return this->_pRoot.get();
     }
   }
@@ -406,56 +317,28 @@ AvailabilityNode* QuadtreeAvailability::addNode(
   }
 
   // The tile must fall exactly after the parent subtree.
-  if ((tileID.level % this->_subtreeLevels) != 0) {
+  if (tileID.level > this->_maximumLevel ||
+      (tileID.level % this->_subtreeLevels) != 0) {
     return nullptr;
   }
 
-  uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << this->_subtreeLevels);
-  uint32_t mortonIndex = getMortonIndex(
-      tileID.x & subtreeRelativeMask,
-      tileID.y & subtreeRelativeMask);
-
-  AvailabilityAccessor subtreeAvailabilityAccessor(
-      pParentNode->subtree->subtreeAvailability,
-      *pParentNode->subtree);
-
-  bool subtreeAvailable = false;
-  uint32_t subtreeIndex = 0;
-  if (subtreeAvailabilityAccessor.isConstant()) {
-    subtreeAvailable = subtreeAvailabilityAccessor.getConstant();
-    subtreeIndex = mortonIndex;
-  } else if (subtreeAvailabilityAccessor.isBufferView()) {
-    uint32_t byteIndex = mortonIndex >> 3;
-    uint8_t bitIndex = static_cast<uint8_t>(mortonIndex & 7);
-    uint8_t bitMask = static_cast<uint8_t>(1 << bitIndex);
-
-    gsl::span<const std::byte> clippedSubtreeAvailability =
-        subtreeAvailabilityAccessor.getBufferAccessor().subspan(0, byteIndex);
-    uint8_t availabilityByte = (uint8_t)subtreeAvailabilityAccessor[byteIndex];
-
-    subtreeAvailable = availabilityByte & bitMask;
-
-    // Calculte the index the child subtree is stored in.
-    if (subtreeAvailable) {
-      subtreeIndex =
-          // TODO: maybe partial sums should be precomputed in the subtree
-          // availability, instead of iterating through the buffer each time.
-          AvailabilityUtilities::countOnesInBuffer(clippedSubtreeAvailability) +
-          AvailabilityUtilities::countOnesInByte(
-              static_cast<uint8_t>(availabilityByte << (8 - bitIndex)));
-    } else {
-      // This subtree is not supposed to be available.
-      return nullptr;
-    }
+  std::optional<uint32_t> subtreeIndex =
+      this->findChildSubtreeIndex(tileID, *pParentNode);
+  if (!subtreeIndex || *subtreeIndex >= pParentNode->childNodes.size()) {
+    // This subtree is not supposed to be available.
+    return nullptr;
   }
 
-  if (subtreeAvailable) {
-    pParentNode->childNodes[subtreeIndex] =
-        std::make_unique<AvailabilityNode>();
-    return pParentNode->childNodes[subtreeIndex].get();
+  std::unique_ptr<AvailabilityNode>& pChild =
+      pParentNode->childNodes[*subtreeIndex];
+  if (pChild) {
+    // This node was already added.
+    return nullptr;
   }
 
-  return nullptr;
+  pChild = std::make_unique<AvailabilityNode>();
+  this->addNodeToIndex(tileID, pChild.get());
+  return pChild.get();
 }
 
 bool QuadtreeAvailability::addLoadedSubtree(
@@ -480,47 +363,7 @@ std::optional<uint32_t> QuadtreeAvailability::findChildNodeIndex(
     return std::nullopt;
   }
 
-  uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << this->_subtreeLevels);
-  uint32_t mortonIndex = getMortonIndex(
-      tileID.x & subtreeRelativeMask,
-      tileID.y & subtreeRelativeMask);
-
-  AvailabilityAccessor subtreeAvailabilityAccessor(
-      pParentNode->subtree->subtreeAvailability,
-      *pParentNode->subtree);
-
-  bool subtreeAvailable = false;
-  uint32_t subtreeIndex = 0;
-  if (subtreeAvailabilityAccessor.isConstant()) {
-    subtreeAvailable = subtreeAvailabilityAccessor.getConstant();
-    subtreeIndex = mortonIndex;
-  } else if (subtreeAvailabilityAccessor.isBufferView()) {
-    uint32_t byteIndex = mortonIndex >> 3;
-    uint8_t bitIndex = static_cast<uint8_t>(mortonIndex & 7);
-    uint8_t bitMask = static_cast<uint8_t>(1 << bitIndex);
-
-    gsl::span<const std::byte> clippedSubtreeAvailability =
-        subtreeAvailabilityAccessor.getBufferAccessor().subspan(0, byteIndex);
-    uint8_t availabilityByte = (uint8_t)subtreeAvailabilityAccessor[byteIndex];
-
-    subtreeAvailable = availabilityByte & bitMask;
-
-    // Calculte the index the child subtree is stored in.
-    if (subtreeAvailable) {
-      subtreeIndex =
-          // TODO: maybe partial sums should be precomputed in the subtree
-          // availability, instead of iterating through the buffer each time.
-          AvailabilityUtilities::countOnesInBuffer(clippedSubtreeAvailability) +
-          AvailabilityUtilities::countOnesInByte(
-              static_cast<uint8_t>(availabilityByte << (8 - bitIndex)));
-    }
-  }
-
-  if (subtreeAvailable) {
-    return subtreeIndex;
-  }
-
-  return std::nullopt;
+  return this->findChildSubtreeIndex(tileID, *pParentNode);
 }
 
 AvailabilityNode* QuadtreeAvailability::findChildNode(
@@ -537,4 +380,80 @@ AvailabilityNode* QuadtreeAvailability::findChildNode(
   return pParentNode->childNodes[*childIndex].get();
 }
 
+QuadtreeTileID QuadtreeAvailability::getSubtreeRootID(
+    const QuadtreeTileID& tileID) const noexcept {
+  const uint32_t relativeLevel = tileID.level % this->_subtreeLevels;
+  return QuadtreeTileID(
+      tileID.level - relativeLevel,
+      tileID.x >> relativeLevel,
+      tileID.y >> relativeLevel);
+}
+
+AvailabilityNode* QuadtreeAvailability::findNode(
+    const QuadtreeTileID& subtreeRootID) const noexcept {
+  auto it = this->_nodesByKey.find(getNodeKey(subtreeRootID));
+  return it == this->_nodesByKey.end() ? nullptr : it->second;
+}
+
+void QuadtreeAvailability::addNodeToIndex(
+    const QuadtreeTileID& subtreeRootID,
+    AvailabilityNode* pNode) noexcept {
+  this->_nodesByKey[getNodeKey(subtreeRootID)] = pNode;
+}
+
+uint8_t QuadtreeAvailability::computeAvailabilityInSubtree(
+    const QuadtreeTileID& tileID,
+    uint32_t relativeLevel,
+    const AvailabilityNode& node) const noexcept {
+  uint8_t availability = TileAvailabilityFlags::REACHABLE;
+
+  uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << relativeLevel);
+  uint32_t relativeMortonIndex = getMortonIndex(
+      tileID.x & subtreeRelativeMask,
+      tileID.y & subtreeRelativeMask);
+
+  // For reference:
+  // https://github.com/CesiumGS/3d-tiles/tree/3d-tiles-next/extensions/3DTILES_implicit_tiling#availability-bitstream-lengths
+  // The below is identical to:
+  // (4^levelRelativeToSubtree - 1) / 3
+  uint32_t offset = ((1U << (relativeLevel << 1U)) - 1U) / 3U;
+
+  uint32_t availabilityIndex = relativeMortonIndex + offset;
+
+  if (node.tileAvailability.isAvailable(availabilityIndex)) {
+    availability |= TileAvailabilityFlags::TILE_AVAILABLE;
+  }
+
+  if (node.contentAvailability.isAvailable(availabilityIndex)) {
+    availability |= TileAvailabilityFlags::CONTENT_AVAILABLE;
+  }
+
+  // If this is the 0th level within the subtree, we know this tile's
+  // subtree is available and loaded.
+  if (relativeLevel == 0) {
+    availability |= TileAvailabilityFlags::SUBTREE_AVAILABLE;
+    availability |= TileAvailabilityFlags::SUBTREE_LOADED;
+  }
+
+  return availability;
+}
+
+std::optional<uint32_t> QuadtreeAvailability::findChildSubtreeIndex(
+    const QuadtreeTileID& tileID,
+    const AvailabilityNode& parentNode) const noexcept {
+  uint32_t subtreeRelativeMask = ~(0xFFFFFFFF << this->_subtreeLevels);
+  uint32_t mortonIndex = getMortonIndex(
+      tileID.x & subtreeRelativeMask,
+      tileID.y & subtreeRelativeMask);
+
+  const AvailabilityBitstream& subtreeAvailability =
+      parentNode.childSubtreeAvailability;
+  if (!subtreeAvailability.isAvailable(mortonIndex)) {
+    return std::nullopt;
+  }
+
+  // Only available child subtrees are stored, in Morton order.
+  return subtreeAvailability.countAvailableBefore(mortonIndex);
+}
+
 } // namespace CesiumGeometry
@@ -2,59 +2,86 @@
 
 #include "CesiumGeometry/TileAvailabilityFlags.h"
 
-#include <glm/common.hpp>
-
 #include <algorithm>
+#include <cmath>
 
 namespace CesiumGeometry {
+namespace {
+// The number of children of each node of the packed R-tree.
+const size_t nodeSize = 16;
 
-QuadtreeRectangleAvailability::QuadtreeRectangleAvailability(
-    const QuadtreeTilingScheme& tilingScheme,
-    uint32_t maximumLevel) noexcept
-    : _tilingScheme(tilingScheme),
-      _maximumLevel(maximumLevel),
-      _rootNodes(
-          this->_tilingScheme.getRootTilesX() *
-          this->_tilingScheme.getRootTilesY()) {
-  for (uint32_t j = 0; j < this->_tilingScheme.getRootTilesY(); ++j) {
-    const uint32_t rowStart = j * this->_tilingScheme.getRootTilesX();
-    for (uint32_t i = 0; i < this->_tilingScheme.getRootTilesX(); ++i) {
-      QuadtreeTileID id(0, i, j);
-      Rectangle extent = tilingScheme.tileToRectangle(id);
-      this->_rootNodes[rowStart + i] =
-          std::make_unique<QuadtreeNode>(id, extent, nullptr);
+// The number of rectangles that may be added to a level before its index is
+// rebuilt, unless a quarter of the level's rectangles is more.
+const size_t minimumUnindexedCount = 16;
+
+uint32_t containedPositions(
+    const Rectangle& rectangle,
+    const glm::dvec2* positions,
+    size_t count,
+    uint32_t mask) noexcept {
+  uint32_t result = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t bit = 1U << i;
+    if ((mask & bit) && rectangle.contains(positions[i])) {
+      result |= bit;
     }
   }
+  return result;
+}
+
+bool compareCenterX(const Rectangle& a, const Rectangle& b) noexcept {
+  return a.minimumX + a.maximumX < b.minimumX + b.maximumX;
+}
+
+bool compareCenterY(const Rectangle& a, const Rectangle& b) noexcept {
+  return a.minimumY + a.maximumY < b.minimumY + b.maximumY;
 }
+} // namespace
+
+QuadtreeRectangleAvailability::QuadtreeRectangleAvailability(
+    const QuadtreeTilingScheme& tilingScheme,
+    uint32_t maximumLevel) noexcept
+    : _tilingScheme(tilingScheme), _levels(maximumLevel + 1) {}
 
 void QuadtreeRectangleAvailability::addAvailableTileRange(
     const QuadtreeTileRectangularRange& range) noexcept {
-  const Rectangle ll = this->_tilingScheme.tileToRectangle(
-      QuadtreeTileID(range.level, range.minimumX, range.minimumY));
-  const Rectangle ur = this->_tilingScheme.tileToRectangle(
-      QuadtreeTileID(range.level, range.maximumX, range.maximumY));
+  LevelIndex* pIndex = this->addRange(range);
+  if (!pIndex) {
+    return;
+  }
 
-  RectangleWithLevel rectangleWithLevel{
-      range.level,
-      Rectangle(ll.minimumX, ll.minimumY, ur.maximumX, ur.maximumY)};
-
-  for (const std::unique_ptr<QuadtreeNode>& pNode : this->_rootNodes) {
-    if (pNode->extent.overlaps(rectangleWithLevel.rectangle)) {
-      putRectangleInQuadtree(
-          this->_tilingScheme,
-          this->_maximumLevel,
-          *pNode,
-          rectangleWithLevel);
+  // Search newly-added rectangles linearly until there are enough of them to
+  // be worth rebuilding the index for.
+  const size_t unindexedCount =
+      pIndex->rectangles.size() - pIndex->indexedCount;
+  if (unindexedCount >
+      std::max(minimumUnindexedCount, pIndex->indexedCount / 4)) {
+    buildIndex(*pIndex);
+  }
+}
+
+void QuadtreeRectangleAvailability::addAvailableTileRanges(
+    const std::vector<QuadtreeTileRectangularRange>& ranges) noexcept {
+  for (const QuadtreeTileRectangularRange& range : ranges) {
+    this->addRange(range);
+  }
+
+  for (LevelIndex& index : this->_levels) {
+    if (index.indexedCount != index.rectangles.size()) {
+      buildIndex(index);
     }
   }
 }
 
 uint32_t QuadtreeRectangleAvailability::computeMaximumLevelAtPosition(
     const glm::dvec2& position) const noexcept {
-  // Find the root node that contains this position.
-  for (const std::unique_ptr<QuadtreeNode>& pNode : this->_rootNodes) {
-    if (pNode->extent.contains(position)) {
-      return findMaxLevelFromNode(nullptr, *pNode, position);
+  if (!this->_tilingScheme.getRectangle().contains(position)) {
+    return 0;
+  }
+
+  for (size_t level = this->_levels.size() - 1; level > 0; --level) {
+    if (findContainingRectangles(this->_levels[level], &position, 1, 1)) {
+      return static_cast<uint32_t>(level);
     }
   }
 
@@ -63,16 +90,14 @@ uint32_t QuadtreeRectangleAvailability::computeMaximumLevelAtPosition(
 
 uint8_t QuadtreeRectangleAvailability::isTileAvailable(
     const QuadtreeTileID& id) const noexcept {
-  // Get the center of the tile and find the maximum level at that position.
-  // Because availability is by tile, if the level is available at that point,
-  // it is sure to be available for the whole tile.  We assume that if a tile at
-  // level n exists, then all its parent tiles back to level 0 exist too.  This
-  // isn't really enforced anywhere, but Cesium would never load a tile for
-  // which this is not true.
-  const CesiumGeometry::Rectangle rectangle =
-      this->_tilingScheme.tileToRectangle(id);
-  const glm::dvec2 center = rectangle.getCenter();
-  if (this->computeMaximumLevelAtPosition(center) >= id.level) {
+  // Get the center of the tile and check whether a range at this level or
+  // deeper contains it. Because availability is by tile, if the level is
+  // available at that point, it is sure to be available for the whole tile.
+  // We assume that if a tile at level n exists, then all its parent tiles
+  // back to level 0 exist too.  This isn't really enforced anywhere, but
+  // Cesium would never load a tile for which this is not true.
+  const glm::dvec2 center = this->_tilingScheme.tileToRectangle(id).getCenter();
+  if (id.level == 0 || this->findAvailablePositions(id.level, &center, 1)) {
     return TileAvailabilityFlags::TILE_AVAILABLE |
            TileAvailabilityFlags::REACHABLE;
   }
@@ -80,159 +105,214 @@ uint8_t QuadtreeRectangleAvailability::isTileAvailable(
   return 0;
 }
 
-/*static*/ void QuadtreeRectangleAvailability::putRectangleInQuadtree(
-    const QuadtreeTilingScheme& tilingScheme,
-    uint32_t maximumLevel,
-    QuadtreeRectangleAvailability::QuadtreeNode& node,
-    const QuadtreeRectangleAvailability::RectangleWithLevel&
-        rectangle) noexcept {
-  QuadtreeNode* pNode = &node;
-
-  while (pNode->id.level < maximumLevel) {
-    createNodeChildrenIfNecessary(*pNode, tilingScheme);
-    if (pNode->ll && pNode->ll->extent.fullyContains(rectangle.rectangle)) {
-      pNode = pNode->ll.get();
-    } else if (
-        pNode->lr && pNode->lr->extent.fullyContains(rectangle.rectangle)) {
-      pNode = pNode->lr.get();
-    } else if (
-        pNode->ul && pNode->ul->extent.fullyContains(rectangle.rectangle)) {
-      pNode = pNode->ul.get();
-    } else if (
-        pNode->ur && pNode->ur->extent.fullyContains(rectangle.rectangle)) {
-      pNode = pNode->ur.get();
-    } else {
-      break;
+std::array<uint8_t, 4> QuadtreeRectangleAvailability::areChildTilesAvailable(
+    const QuadtreeTileID& id) const noexcept {
+  const QuadtreeTileID swID(id.level + 1, id.x * 2, id.y * 2);
+  const std::array<glm::dvec2, 4> centers{
+      this->_tilingScheme.tileToRectangle(swID).getCenter(),
+      this->_tilingScheme
+          .tileToRectangle(QuadtreeTileID(swID.level, swID.x + 1, swID.y))
+          .getCenter(),
+      this->_tilingScheme
+          .tileToRectangle(QuadtreeTileID(swID.level, swID.x, swID.y + 1))
+          .getCenter(),
+      this->_tilingScheme
+          .tileToRectangle(QuadtreeTileID(swID.level, swID.x + 1, swID.y + 1))
+          .getCenter()};
+
+  const uint32_t availableMask =
+      this->findAvailablePositions(swID.level, centers.data(), centers.size());
+
+  std::array<uint8_t, 4> result{};
+  for (size_t i = 0; i < result.size(); ++i) {
+    if (availableMask & (1U << i)) {
+      result[i] = TileAvailabilityFlags::TILE_AVAILABLE |
+                  TileAvailabilityFlags::REACHABLE;
     }
   }
 
-  if (pNode->rectangles.empty() ||
-      pNode->rectangles.back().level <= rectangle.level) {
-    pNode->rectangles.push_back(rectangle);
-  } else {
-    // Maintain ordering by level when inserting.
-    std::push_heap(
-        pNode->rectangles.begin(),
-        pNode->rectangles.end(),
-        QuadtreeRectangleAvailability::rectangleLevelComparator);
+  return result;
+}
+
+QuadtreeRectangleAvailability::LevelIndex*
+QuadtreeRectangleAvailability::addRange(
+    const QuadtreeTileRectangularRange& range) noexcept {
+  const Rectangle ll = this->_tilingScheme.tileToRectangle(
+      QuadtreeTileID(range.level, range.minimumX, range.minimumY));
+  const Rectangle ur = this->_tilingScheme.tileToRectangle(
+      QuadtreeTileID(range.level, range.maximumX, range.maximumY));
+  const Rectangle rectangle(
+      ll.minimumX,
+      ll.minimumY,
+      ur.maximumX,
+      ur.maximumY);
+
+  if (!this->_tilingScheme.getRectangle().overlaps(rectangle)) {
+    return nullptr;
   }
+
+  if (range.level >= this->_levels.size()) {
+    this->_levels.resize(range.level + 1);
+  }
+
+  LevelIndex& index = this->_levels[range.level];
+  index.rectangles.emplace_back(rectangle);
+  return &index;
 }
 
-/*static*/ bool QuadtreeRectangleAvailability::rectangleLevelComparator(
-    const QuadtreeRectangleAvailability::RectangleWithLevel& a,
-    const QuadtreeRectangleAvailability::RectangleWithLevel& b) noexcept {
-  return a.level < b.level;
+uint32_t QuadtreeRectangleAvailability::findAvailablePositions(
+    uint32_t minimumLevel,
+    const glm::dvec2* positions,
+    size_t count) const noexcept {
+  const uint32_t allPositions = (1U << count) - 1;
+  uint32_t found = 0;
+  for (size_t level = minimumLevel;
+       level < this->_levels.size() && found != allPositions;
+       ++level) {
+    found |= findContainingRectangles(
+        this->_levels[level],
+        positions,
+        count,
+        allPositions & ~found);
+  }
+
+  return found;
 }
 
-/*static*/ uint32_t QuadtreeRectangleAvailability::findMaxLevelFromNode(
-    QuadtreeRectangleAvailability::QuadtreeNode* pStopNode,
-    QuadtreeRectangleAvailability::QuadtreeNode& node,
-    const glm::dvec2& position) noexcept {
-  uint32_t maxLevel = 0;
-  QuadtreeRectangleAvailability::QuadtreeNode* pNode = &node;
-
-  // Find the deepest quadtree node containing this point.
-  bool found = false;
-  while (!found) {
-    const uint32_t ll =
-        pNode->ll && pNode->ll->extent.contains(position) ? 1 : 0;
-    const uint32_t lr =
-        pNode->lr && pNode->lr->extent.contains(position) ? 1 : 0;
-    const uint32_t ul =
-        pNode->ul && pNode->ul->extent.contains(position) ? 1 : 0;
-    const uint32_t ur =
-        pNode->ur && pNode->ur->extent.contains(position) ? 1 : 0;
-
-    // The common scenario is that the point is in only one quadrant and we can
-    // simply iterate down the tree.  But if the point is on a boundary between
-    // tiles, it is in multiple tiles and we need to check all of them, so use
-    // recursion.
-    if (ll + lr + ul + ur > 1) {
-      if (ll) {
-        maxLevel = glm::max(
-            maxLevel,
-            findMaxLevelFromNode(pNode, *pNode->ll, position));
-      }
-      if (lr) {
-        maxLevel = glm::max(
-            maxLevel,
-            findMaxLevelFromNode(pNode, *pNode->lr, position));
-      }
-      if (ul) {
-        maxLevel = glm::max(
-            maxLevel,
-            findMaxLevelFromNode(pNode, *pNode->ul, position));
-      }
-      if (ur) {
-        maxLevel = glm::max(
-            maxLevel,
-            findMaxLevelFromNode(pNode, *pNode->ur, position));
+/*static*/ void
+QuadtreeRectangleAvailability::buildIndex(LevelIndex& index) noexcept {
+  std::vector<Rectangle>& rectangles = index.rectangles;
+  const size_t count = rectangles.size();
+
+  index.nodes.clear();
+  index.nodeLevelEnds.clear();
+  index.indexedCount = count;
+  if (count == 0) {
+    return;
+  }
+
+  // Sort-tile-recursive packing: sort by x into vertical slices of whole
+  // nodes, then sort each slice by y, so that each node covers a compact
+  // area.
+  const size_t leafNodeCount = (count + nodeSize - 1) / nodeSize;
+  const size_t sliceCount = static_cast<size_t>(
+      std::ceil(std::sqrt(static_cast<double>(leafNodeCount))));
+  const size_t sliceSize =
+      nodeSize * ((leafNodeCount + sliceCount - 1) / sliceCount);
+
+  std::sort(rectangles.begin(), rectangles.end(), compareCenterX);
+  for (size_t start = 0; start < count; start += sliceSize) {
+    const size_t end = std::min(start + sliceSize, count);
+    std::sort(
+        rectangles.begin() + static_cast<std::ptrdiff_t>(start),
+        rectangles.begin() + static_cast<std::ptrdiff_t>(end),
+        compareCenterY);
+  }
+
+  // Build the interior nodes bottom-up until a level has a single node.
+  bool childrenAreLeaves = true;
+  size_t childBegin = 0;
+  size_t childEnd = count;
+  for (;;) {
+    for (size_t i = childBegin; i < childEnd; i += nodeSize) {
+      const size_t end = std::min(i + nodeSize, childEnd);
+      Rectangle bounds = childrenAreLeaves ? rectangles[i] : index.nodes[i];
+      for (size_t j = i + 1; j < end; ++j) {
+        bounds = bounds.computeUnion(
+            childrenAreLeaves ? rectangles[j] : index.nodes[j]);
       }
-      break;
+      index.nodes.emplace_back(bounds);
     }
-    if (ll) {
-      pNode = pNode->ll.get();
-    } else if (lr) {
-      pNode = pNode->lr.get();
-    } else if (ul) {
-      pNode = pNode->ul.get();
-    } else if (ur) {
-      pNode = pNode->ur.get();
-    } else {
-      found = true;
+
+    index.nodeLevelEnds.emplace_back(index.nodes.size());
+    childBegin = childrenAreLeaves ? 0 : childEnd;
+    childEnd = index.nodes.size();
+    childrenAreLeaves = false;
+    if (childEnd - childBegin <= 1) {
+      break;
     }
   }
+}
 
-  // Wal up the tree until we find a rectangle that contains this point.
-  while (pNode != pStopNode) {
-    const std::vector<RectangleWithLevel>& rectangles = pNode->rectangles;
+/*static*/ uint32_t QuadtreeRectangleAvailability::findContainingRectangles(
+    const LevelIndex& index,
+    const glm::dvec2* positions,
+    size_t count,
+    uint32_t mask) noexcept {
+  uint32_t found = 0;
 
-    // Rectangles are sorted by level, lowest first.
-    for (int32_t i = static_cast<int32_t>(rectangles.size()) - 1;
-         i >= 0 && rectangles[static_cast<size_t>(i)].level > maxLevel;
-         --i) {
-      const RectangleWithLevel& rectangle = rectangles[static_cast<size_t>(i)];
-      if (rectangle.rectangle.contains(position)) {
-        maxLevel = rectangle.level;
-      }
-    }
+  for (size_t i = index.indexedCount;
+       i < index.rectangles.size() && found != mask;
+       ++i) {
+    found |= containedPositions(
+        index.rectangles[i],
+        positions,
+        count,
+        mask & ~found);
+  }
 
-    pNode = pNode->pParent;
+  if (found == mask || index.nodes.empty()) {
+    return found;
   }
 
-  return maxLevel;
+  const uint32_t candidates =
+      containedPositions(index.nodes.back(), positions, count, mask & ~found);
+  if (candidates) {
+    found |= searchNode(
+        index,
+        index.nodeLevelEnds.size() - 1,
+        0,
+        positions,
+        count,
+        candidates);
+  }
+
+  return found;
 }
 
-/*static*/ void QuadtreeRectangleAvailability::createNodeChildrenIfNecessary(
-    QuadtreeRectangleAvailability::QuadtreeNode& node,
-    const QuadtreeTilingScheme& tilingScheme) noexcept {
-  if (node.ll) {
-    return;
+/*static*/ uint32_t QuadtreeRectangleAvailability::searchNode(
+    const LevelIndex& index,
+    size_t treeLevel,
+    size_t nodeIndex,
+    const glm::dvec2* positions,
+    size_t count,
+    uint32_t mask) noexcept {
+  uint32_t found = 0;
+
+  if (treeLevel == 0) {
+    const size_t begin = nodeIndex * nodeSize;
+    const size_t end = std::min(begin + nodeSize, index.indexedCount);
+    for (size_t i = begin; i < end && found != mask; ++i) {
+      found |= containedPositions(
+          index.rectangles[i],
+          positions,
+          count,
+          mask & ~found);
+    }
+    return found;
+  }
+
+  const size_t childLevel = treeLevel - 1;
+  const size_t childLevelBegin =
+      childLevel == 0 ? 0 : index.nodeLevelEnds[childLevel - 1];
+  const size_t childLevelEnd = index.nodeLevelEnds[childLevel];
+  const size_t begin = childLevelBegin + nodeIndex * nodeSize;
+  const size_t end = std::min(begin + nodeSize, childLevelEnd);
+  for (size_t i = begin; i < end && found != mask; ++i) {
+    const uint32_t candidates =
+        containedPositions(index.nodes[i], positions, count, mask & ~found);
+    if (candidates) {
+      found |= searchNode(
+          index,
+          childLevel,
+          i - childLevelBegin,
+          positions,
+          count,
+          candidates);
+    }
   }
 
-  QuadtreeTileID llID(node.id.level + 1, node.id.x * 2, node.id.y * 2);
-  node.ll = std::make_unique<QuadtreeNode>(
-      llID,
-      tilingScheme.tileToRectangle(llID),
-      &node);
-
-  QuadtreeTileID lrID(llID.level, llID.x + 1, llID.y);
-  node.lr = std::make_unique<QuadtreeNode>(
-      lrID,
-      tilingScheme.tileToRectangle(lrID),
-      &node);
-
-  QuadtreeTileID ulID(llID.level, llID.x, llID.y + 1);
-  node.ul = std::make_unique<QuadtreeNode>(
-      ulID,
-      tilingScheme.tileToRectangle(ulID),
-      &node);
-
-  QuadtreeTileID urID(llID.level, llID.x + 1, llID.y + 1);
-  node.ur = std::make_unique<QuadtreeNode>(
-      urID,
-      tilingScheme.tileToRectangle(urID),
-      &node);
+  return found;
 }
 
 } // namespace CesiumGeometry
@@ -107,6 +107,49 @@ TEST_CASE("Test AvailabilityAccessor") {
   }
 }
 
+TEST_CASE("Test AvailabilityBitstream") {
+  // Each byte is 0xFC, so bits 2 through 7 of every byte are set.
+  std::vector<std::byte> availabilityBuffer(16, static_cast<std::byte>(0xFC));
+
+  AvailabilitySubtree subtree{
+      ConstantAvailability{true},
+      SubtreeBufferView{0, 16, 0},
+      SubtreeBufferView{0, 32, 0},
+      {std::move(availabilityBuffer)}};
+
+  SECTION("Test constant availability") {
+    AvailabilityBitstream bitstream(subtree.tileAvailability, subtree, true);
+    REQUIRE(bitstream.isValid());
+    REQUIRE(bitstream.isConstant());
+    REQUIRE(bitstream.isAvailable(1000));
+    REQUIRE(bitstream.countAvailableBefore(1000) == 1000);
+  }
+
+  SECTION("Test buffer availability") {
+    AvailabilityBitstream bitstream(subtree.contentAvailability, subtree, true);
+    REQUIRE(bitstream.isValid());
+    REQUIRE(!bitstream.isConstant());
+    REQUIRE(!bitstream.isAvailable(1));
+    REQUIRE(bitstream.isAvailable(2));
+    REQUIRE(!bitstream.isAvailable(128));
+
+    REQUIRE(bitstream.countAvailableBefore(0) == 0);
+    REQUIRE(bitstream.countAvailableBefore(3) == 1);
+    REQUIRE(bitstream.countAvailableBefore(8) == 6);
+    REQUIRE(bitstream.countAvailableBefore(64) == 48);
+    REQUIRE(bitstream.countAvailableBefore(70) == 52);
+    REQUIRE(bitstream.countAvailableBefore(127) == 95);
+    REQUIRE(bitstream.countAvailableBefore(1000) == 96);
+  }
+
+  SECTION("Test invalid availability") {
+    AvailabilityBitstream bitstream(subtree.subtreeAvailability, subtree, true);
+    REQUIRE(!bitstream.isValid());
+    REQUIRE(!bitstream.isAvailable(0));
+    REQUIRE(bitstream.countAvailableBefore(10) == 0);
+  }
+}
+
 TEST_CASE("Test OctreeAvailability") {
   // We will test with an octree availability subtree with 3 levels.
 
@@ -302,6 +345,37 @@ TEST_CASE("Test OctreeAvailability") {
       }
     }
   }
+
+  SECTION("Test batch availability") {
+    octreeAvailability.addSubtree(
+        OctreeTileID(3, 0, 0, 0),
+        AvailabilitySubtree{
+            ConstantAvailability{true},
+            ConstantAvailability{false},
+            ConstantAvailability{false},
+            {}});
+
+    std::vector<OctreeTileID> ids;
+    for (uint32_t level = 0; level <= 4U; ++level) {
+      for (uint32_t z = 0; z < (1U << level); ++z) {
+        for (uint32_t y = 0; y < (1U << level); ++y) {
+          for (uint32_t x = 0; x < (1U << level); ++x) {
+            ids.emplace_back(level, x, y, z);
+          }
+        }
+      }
+    }
+
+    std::vector<uint8_t> availability(ids.size());
+    octreeAvailability.computeAvailability(
+        gsl::span<const OctreeTileID>(ids),
+        gsl::span<uint8_t>(availability));
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+      REQUIRE(
+          availability[i] == octreeAvailability.computeAvailability(ids[i]));
+    }
+  }
 }
 
 TEST_CASE("Test QuadtreeAvailability") {
@@ -491,4 +565,98 @@ TEST_CASE("Test QuadtreeAvailability") {
       }
     }
   }
+
+  SECTION("Test batch availability") {
+    quadtreeAvailability.addSubtree(
+        QuadtreeTileID(3, 0, 0),
+        AvailabilitySubtree{
+            ConstantAvailability{true},
+            ConstantAvailability{false},
+            ConstantAvailability{false},
+            {}});
+
+    std::vector<QuadtreeTileID> ids;
+    for (uint32_t level = 0; level <= 5U; ++level) {
+      for (uint32_t y = 0; y < (1U << level); ++y) {
+        for (uint32_t x = 0; x < (1U << level); ++x) {
+          ids.emplace_back(level, x, y);
+        }
+      }
+    }
+
+    std::vector<uint8_t> availability(ids.size());
+    quadtreeAvailability.computeAvailability(
+        gsl::span<const QuadtreeTileID>(ids),
+        gsl::span<uint8_t>(availability));
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+      REQUIRE(
+          availability[i] == quadtreeAvailability.computeAvailability(ids[i]));
+    }
+  }
+
+  SECTION("Test adding a node twice") {
+    QuadtreeTileID id(3, 0, 0);
+    REQUIRE(quadtreeAvailability.addNode(id, pParentNode) != nullptr);
+    REQUIRE(quadtreeAvailability.addNode(id, pParentNode) == nullptr);
+  }
+}
+
+TEST_CASE("Test availability beyond the supported levels") {
+  // Every subtree is one level deep and everything in it is available.
+  const auto allAvailable = []() {
+    return AvailabilitySubtree{
+        ConstantAvailability{true},
+        ConstantAvailability{true},
+        ConstantAvailability{true},
+        {}};
+  };
+
+  SECTION("QuadtreeAvailability") {
+    const uint32_t maximumLevel = QuadtreeAvailability::MAXIMUM_SUPPORTED_LEVEL;
+    QuadtreeAvailability availability(1, maximumLevel + 10);
+    CHECK(availability.getMaximumLevel() == maximumLevel);
+
+    REQUIRE(availability.addSubtree(QuadtreeTileID(0, 0, 0), allAvailable()));
+    AvailabilityNode* pNode = availability.getRootNode();
+    for (uint32_t level = 1; level <= maximumLevel; ++level) {
+      pNode = availability.addNode(QuadtreeTileID(level, 0, 0), pNode);
+      REQUIRE(pNode);
+      REQUIRE(availability.addLoadedSubtree(pNode, allAvailable()));
+    }
+
+    CHECK(
+        (availability.computeAvailability(QuadtreeTileID(maximumLevel, 0, 0)) &
+         TileAvailabilityFlags::TILE_AVAILABLE) != 0);
+
+    const QuadtreeTileID tooDeepID(maximumLevel + 1, 0, 0);
+    CHECK(availability.computeAvailability(tooDeepID) == 0);
+    CHECK(availability.addNode(tooDeepID, pNode) == nullptr);
+    CHECK(!availability.addSubtree(tooDeepID, allAvailable()));
+  }
+
+  SECTION("OctreeAvailability") {
+    const uint32_t maximumLevel = OctreeAvailability::MAXIMUM_SUPPORTED_LEVEL;
+    OctreeAvailability availability(1, maximumLevel + 10);
+    CHECK(availability.getMaximumLevel() == maximumLevel);
+
+    REQUIRE(
+        availability.addSubtree(OctreeTileID(0, 0, 0, 0), allAvailable()));
+    AvailabilityNode* pNode = availability.getRootNode();
+    for (uint32_t level = 1; level <= maximumLevel; ++level) {
+      pNode = availability.addNode(OctreeTileID(level, 0, 0, 0), pNode);
+      REQUIRE(pNode);
+      REQUIRE(availability.addLoadedSubtree(pNode, allAvailable()));
+    }
+
+    CHECK(
+        (availability.computeAvailability(
+             OctreeTileID(maximumLevel, 0, 0, 0)) &
+         TileAvailabilityFlags::TILE_AVAILABLE) != 0);
+
+    const OctreeTileID tooDeepID(maximumLevel + 1, 0, 0, 0);
+    CHECK(availability.computeAvailability(tooDeepID) == 0);
+    CHECK(availability.addNode(tooDeepID, pNode) == nullptr);
+    CHECK(!availability.addSubtree(tooDeepID, allAvailable()));
+  }
 }
@@ -0,0 +1,115 @@
+#include "CesiumGeometry/QuadtreeRectangleAvailability.h"
+#include "CesiumGeometry/QuadtreeTileID.h"
+#include "CesiumGeometry/QuadtreeTilingScheme.h"
+#include "CesiumGeometry/Rectangle.h"
+#include "CesiumGeometry/TileAvailabilityFlags.h"
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <vector>
+
+using namespace CesiumGeometry;
+
+namespace {
+const QuadtreeTilingScheme
+    tilingScheme(Rectangle(-180.0, -90.0, 180.0, 90.0), 2, 1);
+
+const uint8_t available =
+    TileAvailabilityFlags::TILE_AVAILABLE | TileAvailabilityFlags::REACHABLE;
+} // namespace
+
+TEST_CASE("Test QuadtreeRectangleAvailability") {
+  QuadtreeRectangleAvailability availability(tilingScheme, 10);
+
+  SECTION("Tiles at level 0 are always available") {
+    CHECK(availability.isTileAvailable(QuadtreeTileID(0, 0, 0)) == available);
+    CHECK(availability.isTileAvailable(QuadtreeTileID(1, 0, 0)) == 0);
+  }
+
+  SECTION("Finds tiles in a range and its ancestors") {
+    availability.addAvailableTileRange({3, 2, 1, 5, 3});
+
+    CHECK(availability.isTileAvailable(QuadtreeTileID(3, 2, 1)) == available);
+    CHECK(availability.isTileAvailable(QuadtreeTileID(3, 5, 3)) == available);
+    CHECK(availability.isTileAvailable(QuadtreeTileID(3, 6, 3)) == 0);
+    CHECK(availability.isTileAvailable(QuadtreeTileID(2, 1, 0)) == available);
+    CHECK(availability.isTileAvailable(QuadtreeTileID(4, 4, 2)) == 0);
+
+    const Rectangle tile = tilingScheme.tileToRectangle({3, 3, 2});
+    CHECK(availability.computeMaximumLevelAtPosition(tile.getCenter()) == 3);
+    CHECK(
+        availability.computeMaximumLevelAtPosition(glm::dvec2(170.0, 80.0)) ==
+        0);
+  }
+
+  SECTION("Does not depend on the order in which ranges are added") {
+    availability.addAvailableTileRange({5, 0, 0, 1, 1});
+    availability.addAvailableTileRange({2, 0, 0, 0, 0});
+    availability.addAvailableTileRange({4, 0, 0, 0, 0});
+
+    const glm::dvec2 center =
+        tilingScheme.tileToRectangle({2, 0, 0}).getCenter();
+    CHECK(availability.computeMaximumLevelAtPosition(center) == 2);
+    CHECK(availability.isTileAvailable(QuadtreeTileID(2, 0, 0)) == available);
+    CHECK(availability.isTileAvailable(QuadtreeTileID(5, 1, 1)) == available);
+  }
+
+  SECTION("Indexes many ranges") {
+    std::vector<QuadtreeTileRectangularRange> ranges;
+    for (uint32_t y = 0; y < 64; y += 2) {
+      for (uint32_t x = 0; x < 128; x += 2) {
+        ranges.push_back({6, x, y, x, y});
+      }
+    }
+    availability.addAvailableTileRanges(ranges);
+
+    for (uint32_t y = 0; y < 64; ++y) {
+      for (uint32_t x = 0; x < 128; ++x) {
+        const bool expected = x % 2 == 0 && y % 2 == 0;
+        CHECK(
+            (availability.isTileAvailable(QuadtreeTileID(6, x, y)) ==
+             available) == expected);
+      }
+    }
+
+    // Ranges added one at a time are found before and after the index is
+    // rebuilt.
+    for (uint32_t x = 1; x < 128; x += 2) {
+      availability.addAvailableTileRange({6, x, 1, x, 1});
+      CHECK(availability.isTileAvailable(QuadtreeTileID(6, x, 1)) == available);
+    }
+  }
+
+  SECTION("Computes the availability of all four children at once") {
+    availability.addAvailableTileRanges(
+        {{2, 0, 0, 0, 0}, {2, 1, 1, 1, 1}, {3, 6, 0, 6, 0}});
+
+    for (uint32_t y = 0; y < 2; ++y) {
+      for (uint32_t x = 0; x < 4; ++x) {
+        const QuadtreeTileID parent(1, x, y);
+        const std::array<uint8_t, 4> children =
+            availability.areChildTilesAvailable(parent);
+        CHECK(
+            children[0] ==
+            availability.isTileAvailable({2, x * 2, y * 2}));
+        CHECK(
+            children[1] ==
+            availability.isTileAvailable({2, x * 2 + 1, y * 2}));
+        CHECK(
+            children[2] ==
+            availability.isTileAvailable({2, x * 2, y * 2 + 1}));
+        CHECK(
+            children[3] ==
+            availability.isTileAvailable({2, x * 2 + 1, y * 2 + 1}));
+      }
+    }
+
+    const std::array<uint8_t, 4> children =
+        availability.areChildTilesAvailable(QuadtreeTileID(1, 0, 0));
+    CHECK(children[0] == available);
+    CHECK(children[1] == 0);
+    CHECK(children[2] == 0);
+    CHECK(children[3] == available);
+  }
+}
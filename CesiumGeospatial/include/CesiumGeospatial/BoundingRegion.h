@@ -81,6 +81,11 @@ public:
    * position and the closest point of the bounding box that is enclosed in
    * this region.
    *
+   * Converting the position to cartographic coordinates is relatively
+   * expensive. When the distance from the same position to many regions is
+   * needed, convert it once and use the overload that takes both the
+   * cartographic and Cartesian positions.
+   *
    * @param position The position.
    * @param ellipsoid The ellipsoid on which this region is defined.
    * @return The distance-squared from the position to the closest point in the
@@ -5,6 +5,7 @@
 
 #include <glm/vec2.hpp>
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <vector>
@@ -64,10 +65,71 @@ public:
     return this->_boundingRectangle;
   }
 
+  /**
+   * @brief Determines whether a point is inside one of the triangles of this
+   * polygon's triangle decomposition.
+   *
+   * Points on the edge of a triangle are inside. Only the triangles near the
+   * point are tested.
+   *
+   * @param point The longitude-latitude point in radians.
+   * @return Whether the point is inside the polygon.
+   */
+  bool contains(const glm::dvec2& point) const noexcept;
+
+  /**
+   * @brief Determines whether any edge of this polygon's perimeter touches or
+   * crosses an edge of the given rectangle.
+   *
+   * The west and east of the rectangle are used as given, without accounting
+   * for the antimeridian. Only the perimeter edges near the rectangle are
+   * tested.
+   *
+   * @param rectangle The rectangle.
+   * @return Whether the perimeter of the polygon intersects the edges of the
+   * rectangle.
+   */
+  bool intersectsEdges(
+      const CesiumGeospatial::GlobeRectangle& rectangle) const noexcept;
+
+  /**
+   * @brief Determines whether a point is inside a triangle, irrespective of
+   * the triangle's winding.
+   *
+   * Points on the edge of the triangle are inside.
+   *
+   * @param point The point to check.
+   * @param a The first vertex of the triangle.
+   * @param b The second vertex of the triangle.
+   * @param c The third vertex of the triangle.
+   * @return Whether the point is within the triangle.
+   */
+  static bool withinTriangle(
+      const glm::dvec2& point,
+      const glm::dvec2& a,
+      const glm::dvec2& b,
+      const glm::dvec2& c) noexcept;
+
 private:
+  void buildGrid();
+
   std::vector<glm::dvec2> _vertices;
   std::vector<uint32_t> _indices;
   std::optional<CesiumGeospatial::GlobeRectangle> _boundingRectangle;
+
+  // A uniform grid over the bounding box of the vertices. For each cell, the
+  // grid lists the perimeter edges and triangles whose bounding boxes overlap
+  // it, so that queries only test the edges and triangles nearby. The lists
+  // of cell i are [offsets[i], offsets[i + 1]) of the corresponding array.
+  glm::dvec2 _gridMinimum;
+  glm::dvec2 _gridMaximum;
+  glm::dvec2 _gridCellSize;
+  uint32_t _gridColumns;
+  uint32_t _gridRows;
+  std::vector<uint32_t> _cellEdgeOffsets;
+  std::vector<uint32_t> _cellEdges;
+  std::vector<uint32_t> _cellTriangleOffsets;
+  std::vector<uint32_t> _cellTriangles;
 };
 
 } // namespace CesiumGeospatial
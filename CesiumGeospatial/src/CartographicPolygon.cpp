@@ -2,7 +2,9 @@
 
 #include <mapbox/earcut.hpp>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 
 namespace CesiumGeospatial {
 
@@ -101,9 +103,327 @@ computeBoundingRectangle(const std::vector<glm::dvec2>& polygon) {
   return CesiumGeospatial::GlobeRectangle(west, south, east, north);
 }
 
+namespace {
+// The largest number of grid cells along each axis.
+const uint32_t maximumGridResolution = 256;
+
+struct Box {
+  glm::dvec2 minimum;
+  glm::dvec2 maximum;
+};
+
+Box computeBox(const glm::dvec2& a, const glm::dvec2& b) noexcept {
+  return Box{
+      glm::dvec2(glm::min(a.x, b.x), glm::min(a.y, b.y)),
+      glm::dvec2(glm::max(a.x, b.x), glm::max(a.y, b.y))};
+}
+
+bool overlaps(const Box& box, const glm::dvec2& min, const glm::dvec2& max) {
+  return box.minimum.x <= max.x && box.maximum.x >= min.x &&
+         box.minimum.y <= max.y && box.maximum.y >= min.y;
+}
+
+uint32_t computeCellCoordinate(
+    double value,
+    double minimum,
+    double cellSize,
+    uint32_t cellCount) noexcept {
+  const double cell = std::floor((value - minimum) / cellSize);
+  if (!(cell > 0.0)) {
+    return 0;
+  }
+  if (cell >= static_cast<double>(cellCount - 1)) {
+    return cellCount - 1;
+  }
+  return static_cast<uint32_t>(cell);
+}
+
+struct CellRange {
+  uint32_t minimumColumn;
+  uint32_t maximumColumn;
+  uint32_t minimumRow;
+  uint32_t maximumRow;
+};
+
+CellRange computeCellRange(
+    const Box& box,
+    const glm::dvec2& gridMinimum,
+    const glm::dvec2& cellSize,
+    uint32_t columns,
+    uint32_t rows) noexcept {
+  return CellRange{
+      computeCellCoordinate(box.minimum.x, gridMinimum.x, cellSize.x, columns),
+      computeCellCoordinate(box.maximum.x, gridMinimum.x, cellSize.x, columns),
+      computeCellCoordinate(box.minimum.y, gridMinimum.y, cellSize.y, rows),
+      computeCellCoordinate(box.maximum.y, gridMinimum.y, cellSize.y, rows)};
+}
+
+bool segmentsIntersect(
+    const glm::dvec2& c,
+    const glm::dvec2& cd,
+    const glm::dvec2& a,
+    const glm::dvec2& ba) noexcept {
+  // s and t are calculated such that:
+  // line_intersection = a + t * ab = c + s * cd
+  const double determinant = cd.x * ba.y - ba.x * cd.y;
+  if (determinant == 0.0) {
+    return false;
+  }
+
+  const double oneOverDeterminant = 1.0 / determinant;
+  const glm::dvec2 ca = a - c;
+  const double s = (ba.y * ca.x - ba.x * ca.y) * oneOverDeterminant;
+  const double t = (cd.x * ca.y - cd.y * ca.x) * oneOverDeterminant;
+
+  // check that the intersection is within the line segments
+  return s <= 1.0 && s >= 0.0 && t <= 1.0 && t >= 0.0;
+}
+} // namespace
+
 CartographicPolygon::CartographicPolygon(const std::vector<glm::dvec2>& polygon)
     : _vertices(polygon),
       _indices(triangulatePolygon(polygon)),
-      _boundingRectangle(computeBoundingRectangle(polygon)) {}
+      _boundingRectangle(computeBoundingRectangle(polygon)),
+      _gridMinimum(0.0),
+      _gridMaximum(0.0),
+      _gridCellSize(1.0),
+      _gridColumns(0),
+      _gridRows(0),
+      _cellEdgeOffsets(),
+      _cellEdges(),
+      _cellTriangleOffsets(),
+      _cellTriangles() {
+  this->buildGrid();
+}
+
+bool CartographicPolygon::withinTriangle(
+    const glm::dvec2& point,
+    const glm::dvec2& a,
+    const glm::dvec2& b,
+    const glm::dvec2& c) noexcept {
+  const glm::dvec2 ab = b - a;
+  const glm::dvec2 ab_perp(-ab.y, ab.x);
+  const glm::dvec2 bc = c - b;
+  const glm::dvec2 bc_perp(-bc.y, bc.x);
+  const glm::dvec2 ca = a - c;
+  const glm::dvec2 ca_perp(-ca.y, ca.x);
+
+  const glm::dvec2 av = point - a;
+  const glm::dvec2 cv = point - c;
+
+  const double v_proj_ab_perp = av.x * ab_perp.x + av.y * ab_perp.y;
+  const double v_proj_bc_perp = cv.x * bc_perp.x + cv.y * bc_perp.y;
+  const double v_proj_ca_perp = cv.x * ca_perp.x + cv.y * ca_perp.y;
+
+  // This will determine in or out, irrespective of winding.
+  return (v_proj_ab_perp >= 0.0 && v_proj_ca_perp >= 0.0 &&
+          v_proj_bc_perp >= 0.0) ||
+         (v_proj_ab_perp <= 0.0 && v_proj_ca_perp <= 0.0 &&
+          v_proj_bc_perp <= 0.0);
+}
+
+bool CartographicPolygon::contains(const glm::dvec2& point) const noexcept {
+  if (this->_cellTriangleOffsets.empty() || point.x < this->_gridMinimum.x ||
+      point.y < this->_gridMinimum.y || point.x > this->_gridMaximum.x ||
+      point.y > this->_gridMaximum.y) {
+    return false;
+  }
+
+  const uint32_t column = computeCellCoordinate(
+      point.x,
+      this->_gridMinimum.x,
+      this->_gridCellSize.x,
+      this->_gridColumns);
+  const uint32_t row = computeCellCoordinate(
+      point.y,
+      this->_gridMinimum.y,
+      this->_gridCellSize.y,
+      this->_gridRows);
+  const size_t cell = size_t(row) * this->_gridColumns + column;
+
+  for (uint32_t i = this->_cellTriangleOffsets[cell];
+       i < this->_cellTriangleOffsets[cell + 1];
+       ++i) {
+    const size_t triangle = this->_cellTriangles[i];
+    if (withinTriangle(
+            point,
+            this->_vertices[this->_indices[3 * triangle]],
+            this->_vertices[this->_indices[3 * triangle + 1]],
+            this->_vertices[this->_indices[3 * triangle + 2]])) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool CartographicPolygon::intersectsEdges(
+    const GlobeRectangle& rectangle) const noexcept {
+  if (this->_cellEdgeOffsets.empty()) {
+    return false;
+  }
+
+  const glm::dvec2 rectangleCorners[] = {
+      glm::dvec2(rectangle.getWest(), rectangle.getSouth()),
+      glm::dvec2(rectangle.getWest(), rectangle.getNorth()),
+      glm::dvec2(rectangle.getEast(), rectangle.getNorth()),
+      glm::dvec2(rectangle.getEast(), rectangle.getSouth())};
+
+  const glm::dvec2 rectangleEdges[] = {
+      rectangleCorners[1] - rectangleCorners[0],
+      rectangleCorners[2] - rectangleCorners[1],
+      rectangleCorners[3] - rectangleCorners[2],
+      rectangleCorners[0] - rectangleCorners[3]};
+
+  const Box rectangleBox = computeBox(rectangleCorners[0], rectangleCorners[2]);
+  if (!overlaps(rectangleBox, this->_gridMinimum, this->_gridMaximum)) {
+    return false;
+  }
+
+  const CellRange cells = computeCellRange(
+      rectangleBox,
+      this->_gridMinimum,
+      this->_gridCellSize,
+      this->_gridColumns,
+      this->_gridRows);
+
+  const size_t vertexCount = this->_vertices.size();
+  for (uint32_t row = cells.minimumRow; row <= cells.maximumRow; ++row) {
+    for (uint32_t column = cells.minimumColumn; column <= cells.maximumColumn;
+         ++column) {
+      const size_t cell = size_t(row) * this->_gridColumns + column;
+      for (uint32_t i = this->_cellEdgeOffsets[cell];
+           i < this->_cellEdgeOffsets[cell + 1];
+           ++i) {
+        const uint32_t edge = this->_cellEdges[i];
+        const glm::dvec2& a = this->_vertices[edge];
+        const glm::dvec2& b = this->_vertices[(edge + 1) % vertexCount];
+
+        // Edges that miss the rectangle's bounding box can't cross its edges.
+        if (!overlaps(
+                computeBox(a, b),
+                rectangleBox.minimum,
+                rectangleBox.maximum)) {
+          continue;
+        }
+
+        const glm::dvec2 ba = a - b;
+        for (size_t k = 0; k < 4; ++k) {
+          if (segmentsIntersect(
+                  rectangleCorners[k],
+                  rectangleEdges[k],
+                  a,
+                  ba)) {
+            return true;
+          }
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+void CartographicPolygon::buildGrid() {
+  const size_t vertexCount = this->_vertices.size();
+  if (vertexCount < 3) {
+    return;
+  }
+
+  std::vector<Box> edgeBoxes(vertexCount);
+  for (size_t i = 0; i < vertexCount; ++i) {
+    edgeBoxes[i] = computeBox(
+        this->_vertices[i],
+        this->_vertices[(i + 1) % vertexCount]);
+  }
+
+  const size_t triangleCount = this->_indices.size() / 3;
+  std::vector<Box> triangleBoxes(triangleCount);
+  for (size_t i = 0; i < triangleCount; ++i) {
+    const glm::dvec2& a = this->_vertices[this->_indices[3 * i]];
+    const glm::dvec2& b = this->_vertices[this->_indices[3 * i + 1]];
+    const glm::dvec2& c = this->_vertices[this->_indices[3 * i + 2]];
+    Box& box = triangleBoxes[i];
+    box = computeBox(a, b);
+    box.minimum = glm::dvec2(
+        glm::min(box.minimum.x, c.x),
+        glm::min(box.minimum.y, c.y));
+    box.maximum = glm::dvec2(
+        glm::max(box.maximum.x, c.x),
+        glm::max(box.maximum.y, c.y));
+  }
+
+  this->_gridMinimum = this->_vertices[0];
+  this->_gridMaximum = this->_vertices[0];
+  for (const glm::dvec2& vertex : this->_vertices) {
+    this->_gridMinimum.x = glm::min(this->_gridMinimum.x, vertex.x);
+    this->_gridMinimum.y = glm::min(this->_gridMinimum.y, vertex.y);
+    this->_gridMaximum.x = glm::max(this->_gridMaximum.x, vertex.x);
+    this->_gridMaximum.y = glm::max(this->_gridMaximum.y, vertex.y);
+  }
+
+  // Aim for about one edge per cell.
+  const uint32_t resolution = static_cast<uint32_t>(std::clamp(
+      std::ceil(std::sqrt(static_cast<double>(vertexCount))),
+      1.0,
+      static_cast<double>(maximumGridResolution)));
+  this->_gridColumns = resolution;
+  this->_gridRows = resolution;
+
+  const glm::dvec2 extent = this->_gridMaximum - this->_gridMinimum;
+  this->_gridCellSize = glm::dvec2(
+      extent.x > 0.0 ? extent.x / resolution : 1.0,
+      extent.y > 0.0 ? extent.y / resolution : 1.0);
+
+  const auto fillCells = [this](
+                             const std::vector<Box>& boxes,
+                             std::vector<uint32_t>& offsets,
+                             std::vector<uint32_t>& items) {
+    const size_t cellCount = size_t(this->_gridColumns) * this->_gridRows;
+    std::vector<CellRange> boxCells(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      boxCells[i] = computeCellRange(
+          boxes[i],
+          this->_gridMinimum,
+          this->_gridCellSize,
+          this->_gridColumns,
+          this->_gridRows);
+    }
+
+    // Count the boxes overlapping each cell, then place each box in the
+    // cells it overlaps.
+    offsets.assign(cellCount + 1, 0);
+    for (const CellRange& cells : boxCells) {
+      for (uint32_t row = cells.minimumRow; row <= cells.maximumRow; ++row) {
+        for (uint32_t column = cells.minimumColumn;
+             column <= cells.maximumColumn;
+             ++column) {
+          ++offsets[size_t(row) * this->_gridColumns + column + 1];
+        }
+      }
+    }
+
+    for (size_t i = 0; i < cellCount; ++i) {
+      offsets[i + 1] += offsets[i];
+    }
+
+    items.resize(offsets[cellCount]);
+    std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < boxCells.size(); ++i) {
+      const CellRange& cells = boxCells[i];
+      for (uint32_t row = cells.minimumRow; row <= cells.maximumRow; ++row) {
+        for (uint32_t column = cells.minimumColumn;
+             column <= cells.maximumColumn;
+             ++column) {
+          const size_t cell = size_t(row) * this->_gridColumns + column;
+          items[cursors[cell]++] = static_cast<uint32_t>(i);
+        }
+      }
+    }
+  };
+
+  fillCells(edgeBoxes, this->_cellEdgeOffsets, this->_cellEdges);
+  fillCells(triangleBoxes, this->_cellTriangleOffsets, this->_cellTriangles);
+}
 
 } // namespace CesiumGeospatial
@@ -0,0 +1,91 @@
+#include "CesiumGeospatial/CartographicPolygon.h"
+#include "CesiumGeospatial/GlobeRectangle.h"
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace CesiumGeospatial;
+
+TEST_CASE("CartographicPolygon") {
+  SECTION("contains") {
+    // An L shape with a notch in the upper right.
+    const CartographicPolygon polygon(std::vector<glm::dvec2>{
+        glm::dvec2(0.0, 0.0),
+        glm::dvec2(0.2, 0.0),
+        glm::dvec2(0.2, 0.1),
+        glm::dvec2(0.1, 0.1),
+        glm::dvec2(0.1, 0.2),
+        glm::dvec2(0.0, 0.2)});
+
+    CHECK(polygon.contains(glm::dvec2(0.05, 0.05)));
+    CHECK(polygon.contains(glm::dvec2(0.15, 0.05)));
+    CHECK(polygon.contains(glm::dvec2(0.05, 0.15)));
+    CHECK(polygon.contains(glm::dvec2(0.2, 0.0)));
+    CHECK(!polygon.contains(glm::dvec2(0.15, 0.15)));
+    CHECK(!polygon.contains(glm::dvec2(0.3, 0.05)));
+    CHECK(!polygon.contains(glm::dvec2(-0.01, 0.05)));
+  }
+
+  SECTION("intersectsEdges") {
+    const CartographicPolygon polygon(std::vector<glm::dvec2>{
+        glm::dvec2(0.0, 0.0),
+        glm::dvec2(0.2, 0.0),
+        glm::dvec2(0.2, 0.1),
+        glm::dvec2(0.1, 0.1),
+        glm::dvec2(0.1, 0.2),
+        glm::dvec2(0.0, 0.2)});
+
+    // Inside the polygon.
+    CHECK(!polygon.intersectsEdges(GlobeRectangle(0.02, 0.02, 0.08, 0.08)));
+
+    // Straddling the east edge and the edges of the notch.
+    CHECK(polygon.intersectsEdges(GlobeRectangle(0.15, 0.02, 0.25, 0.08)));
+    CHECK(polygon.intersectsEdges(GlobeRectangle(0.05, 0.05, 0.15, 0.15)));
+
+    // Inside the notch, touching its edges.
+    CHECK(polygon.intersectsEdges(GlobeRectangle(0.1, 0.1, 0.15, 0.15)));
+
+    // Away from the polygon, and containing all of it.
+    CHECK(!polygon.intersectsEdges(GlobeRectangle(0.3, 0.3, 0.4, 0.4)));
+    CHECK(!polygon.intersectsEdges(GlobeRectangle(-0.1, -0.1, 0.3, 0.3)));
+  }
+
+  SECTION("withinTriangle") {
+    const glm::dvec2 a(0.0, 0.0);
+    const glm::dvec2 b(1.0, 0.0);
+    const glm::dvec2 c(0.0, 1.0);
+
+    // Either winding.
+    CHECK(CartographicPolygon::withinTriangle(glm::dvec2(0.2, 0.2), a, b, c));
+    CHECK(CartographicPolygon::withinTriangle(glm::dvec2(0.2, 0.2), a, c, b));
+
+    // On an edge and on a vertex.
+    CHECK(CartographicPolygon::withinTriangle(glm::dvec2(0.5, 0.5), a, b, c));
+    CHECK(CartographicPolygon::withinTriangle(b, a, b, c));
+
+    CHECK(!CartographicPolygon::withinTriangle(glm::dvec2(0.6, 0.6), a, b, c));
+    CHECK(
+        !CartographicPolygon::withinTriangle(glm::dvec2(-0.1, 0.2), a, c, b));
+  }
+
+  SECTION("Polygons with many vertices") {
+    std::vector<glm::dvec2> vertices;
+    const size_t vertexCount = 1000;
+    for (size_t i = 0; i < vertexCount; ++i) {
+      const double angle =
+          2.0 * 3.141592653589793 * double(i) / double(vertexCount);
+      vertices.emplace_back(0.5 * std::cos(angle), 0.5 * std::sin(angle));
+    }
+    const CartographicPolygon polygon(vertices);
+
+    CHECK(polygon.contains(glm::dvec2(0.0, 0.0)));
+    CHECK(polygon.contains(glm::dvec2(0.3, -0.3)));
+    CHECK(!polygon.contains(glm::dvec2(0.4, 0.4)));
+
+    CHECK(!polygon.intersectsEdges(GlobeRectangle(-0.1, -0.1, 0.1, 0.1)));
+    CHECK(polygon.intersectsEdges(GlobeRectangle(0.45, -0.01, 0.55, 0.01)));
+    CHECK(!polygon.intersectsEdges(GlobeRectangle(0.4, 0.4, 0.45, 0.45)));
+  }
+}
@@ -6,6 +6,7 @@
 #include <glm/mat4x4.hpp>
 
 #include <functional>
+#include <vector>
 
 namespace CesiumGltf {
 
@@ -24,6 +25,21 @@ struct CESIUMGLTF_API Model : public ModelSpec {
    */
   void merge(Model&& rhs);
 
+  /**
+   * @brief Merges several other models into this one.
+   *
+   * This is equivalent to calling {@link merge} with each model in turn, but
+   * sizes every element array only once and moves each element exactly once.
+   * Instead of a chain of intermediate default scenes, a single new default
+   * scene is created holding the root nodes of the default scene of every
+   * model. Element indices in {@link ExtensibleObject::extras}, if any, are
+   * _not_ updated.
+   *
+   * @param models The models to merge into this one. Their elements are moved
+   * from, so the models are left in a valid but unspecified state.
+   */
+  void merge(std::vector<Model>&& models);
+
   /**
    * @brief A callback function for {@link forEachPrimitiveInScene}.
    */
@@ -9,18 +9,36 @@
 #include <gsl/span>
 
 #include <algorithm>
+#include <iterator>
 
 namespace CesiumGltf {
 namespace {
 template <typename T>
 size_t copyElements(std::vector<T>& to, std::vector<T>& from) {
   const size_t out = to.size();
-  to.resize(out + from.size());
-  for (size_t i = 0; i < from.size(); ++i) {
-    to[out + i] = std::move(from[i]);
+  to.insert(
+      to.end(),
+      std::make_move_iterator(from.begin()),
+      std::make_move_iterator(from.end()));
+  return out;
+}
+
+template <typename T>
+void reserveElements(
+    std::vector<T>& to,
+    const std::vector<Model>& models,
+    std::vector<T> ModelSpec::*pMember,
+    size_t extra = 0) {
+  size_t total = to.size() + extra;
+  for (const Model& model : models) {
+    total += (model.*pMember).size();
   }
+  to.reserve(total);
+}
 
-  return out;
+template <typename T> void sortAndRemoveDuplicates(std::vector<T>& items) {
+  std::sort(items.begin(), items.end());
+  items.erase(std::unique(items.begin(), items.end()), items.end());
 }
 
 void updateIndex(int32_t& index, size_t offset) noexcept {
@@ -29,45 +47,36 @@ void updateIndex(int32_t& index, size_t offset) noexcept {
   }
   index += int32_t(offset);
 }
-} // namespace
 
-void Model::merge(Model&& rhs) {
+// Moves all elements of `rhs` to the end of `lhs` and updates the indices in
+// the moved elements. Does not touch `lhs.scene`, and does not remove
+// duplicate extension names. Returns the index in `lhs.scenes` of the first
+// scene moved from `rhs`.
+size_t appendElements(Model& lhs, Model& rhs) {
   // TODO: we could generate this pretty easily if the glTF JSON schema made
   // it clear which index properties refer to which types of objects.
 
-  // Copy all the source data into this instance.
-  copyElements(this->extensionsUsed, rhs.extensionsUsed);
-  std::sort(this->extensionsUsed.begin(), this->extensionsUsed.end());
-  this->extensionsUsed.erase(
-      std::unique(this->extensionsUsed.begin(), this->extensionsUsed.end()),
-      this->extensionsUsed.end());
-
-  copyElements(this->extensionsRequired, rhs.extensionsRequired);
-  std::sort(this->extensionsRequired.begin(), this->extensionsRequired.end());
-  this->extensionsRequired.erase(
-      std::unique(
-          this->extensionsRequired.begin(),
-          this->extensionsRequired.end()),
-      this->extensionsRequired.end());
-
-  const size_t firstAccessor = copyElements(this->accessors, rhs.accessors);
-  const size_t firstAnimation = copyElements(this->animations, rhs.animations);
-  const size_t firstBuffer = copyElements(this->buffers, rhs.buffers);
-  const size_t firstBufferView =
-      copyElements(this->bufferViews, rhs.bufferViews);
-  const size_t firstCamera = copyElements(this->cameras, rhs.cameras);
-  const size_t firstImage = copyElements(this->images, rhs.images);
-  const size_t firstMaterial = copyElements(this->materials, rhs.materials);
-  const size_t firstMesh = copyElements(this->meshes, rhs.meshes);
-  const size_t firstNode = copyElements(this->nodes, rhs.nodes);
-  const size_t firstSampler = copyElements(this->samplers, rhs.samplers);
-  const size_t firstScene = copyElements(this->scenes, rhs.scenes);
-  const size_t firstSkin = copyElements(this->skins, rhs.skins);
-  const size_t firstTexture = copyElements(this->textures, rhs.textures);
-
-  // Update the copied indices
-  for (size_t i = firstAccessor; i < this->accessors.size(); ++i) {
-    Accessor& accessor = this->accessors[i];
+  // Move all the source data into this instance.
+  copyElements(lhs.extensionsUsed, rhs.extensionsUsed);
+  copyElements(lhs.extensionsRequired, rhs.extensionsRequired);
+
+  const size_t firstAccessor = copyElements(lhs.accessors, rhs.accessors);
+  const size_t firstAnimation = copyElements(lhs.animations, rhs.animations);
+  const size_t firstBuffer = copyElements(lhs.buffers, rhs.buffers);
+  const size_t firstBufferView = copyElements(lhs.bufferViews, rhs.bufferViews);
+  const size_t firstCamera = copyElements(lhs.cameras, rhs.cameras);
+  const size_t firstImage = copyElements(lhs.images, rhs.images);
+  const size_t firstMaterial = copyElements(lhs.materials, rhs.materials);
+  const size_t firstMesh = copyElements(lhs.meshes, rhs.meshes);
+  const size_t firstNode = copyElements(lhs.nodes, rhs.nodes);
+  const size_t firstSampler = copyElements(lhs.samplers, rhs.samplers);
+  const size_t firstScene = copyElements(lhs.scenes, rhs.scenes);
+  const size_t firstSkin = copyElements(lhs.skins, rhs.skins);
+  const size_t firstTexture = copyElements(lhs.textures, rhs.textures);
+
+  // Update the moved indices
+  for (size_t i = firstAccessor; i < lhs.accessors.size(); ++i) {
+    Accessor& accessor = lhs.accessors[i];
     updateIndex(accessor.bufferView, firstBufferView);
 
     if (accessor.sparse) {
@@ -76,8 +85,8 @@ void Model::merge(Model&& rhs) {
     }
   }
 
-  for (size_t i = firstAnimation; i < this->animations.size(); ++i) {
-    Animation& animation = this->animations[i];
+  for (size_t i = firstAnimation; i < lhs.animations.size(); ++i) {
+    Animation& animation = lhs.animations[i];
 
     for (AnimationChannel& channel : animation.channels) {
       updateIndex(channel.sampler, firstSampler);
@@ -90,18 +99,18 @@ void Model::merge(Model&& rhs) {
     }
   }
 
-  for (size_t i = firstBufferView; i < this->bufferViews.size(); ++i) {
-    BufferView& bufferView = this->bufferViews[i];
+  for (size_t i = firstBufferView; i < lhs.bufferViews.size(); ++i) {
+    BufferView& bufferView = lhs.bufferViews[i];
     updateIndex(bufferView.buffer, firstBuffer);
   }
 
-  for (size_t i = firstImage; i < this->images.size(); ++i) {
-    Image& image = this->images[i];
+  for (size_t i = firstImage; i < lhs.images.size(); ++i) {
+    Image& image = lhs.images[i];
     updateIndex(image.bufferView, firstBufferView);
   }
 
-  for (size_t i = firstMesh; i < this->meshes.size(); ++i) {
-    Mesh& mesh = this->meshes[i];
+  for (size_t i = firstMesh; i < lhs.meshes.size(); ++i) {
+    Mesh& mesh = lhs.meshes[i];
 
     for (MeshPrimitive& primitive : mesh.primitives) {
       updateIndex(primitive.indices, firstAccessor);
@@ -125,8 +134,8 @@ void Model::merge(Model&& rhs) {
     }
   }
 
-  for (size_t i = firstNode; i < this->nodes.size(); ++i) {
-    Node& node = this->nodes[i];
+  for (size_t i = firstNode; i < lhs.nodes.size(); ++i) {
+    Node& node = lhs.nodes[i];
 
     updateIndex(node.camera, firstCamera);
     updateIndex(node.skin, firstSkin);
@@ -137,15 +146,15 @@ void Model::merge(Model&& rhs) {
     }
   }
 
-  for (size_t i = firstScene; i < this->scenes.size(); ++i) {
-    Scene& currentScene = this->scenes[i];
+  for (size_t i = firstScene; i < lhs.scenes.size(); ++i) {
+    Scene& currentScene = lhs.scenes[i];
     for (int32_t& node : currentScene.nodes) {
       updateIndex(node, firstNode);
     }
   }
 
-  for (size_t i = firstSkin; i < this->skins.size(); ++i) {
-    Skin& skin = this->skins[i];
+  for (size_t i = firstSkin; i < lhs.skins.size(); ++i) {
+    Skin& skin = lhs.skins[i];
 
     updateIndex(skin.inverseBindMatrices, firstAccessor);
     updateIndex(skin.skeleton, firstNode);
@@ -155,15 +164,15 @@ void Model::merge(Model&& rhs) {
     }
   }
 
-  for (size_t i = firstTexture; i < this->textures.size(); ++i) {
-    Texture& texture = this->textures[i];
+  for (size_t i = firstTexture; i < lhs.textures.size(); ++i) {
+    Texture& texture = lhs.textures[i];
 
     updateIndex(texture.sampler, firstSampler);
     updateIndex(texture.source, firstImage);
   }
 
-  for (size_t i = firstMaterial; i < this->materials.size(); ++i) {
-    Material& material = this->materials[i];
+  for (size_t i = firstMaterial; i < lhs.materials.size(); ++i) {
+    Material& material = lhs.materials[i];
 
     if (material.normalTexture) {
       updateIndex(material.normalTexture.value().index, firstTexture);
@@ -185,6 +194,15 @@ void Model::merge(Model&& rhs) {
     }
   }
 
+  return firstScene;
+}
+} // namespace
+
+void Model::merge(Model&& rhs) {
+  const size_t firstScene = appendElements(*this, rhs);
+  sortAndRemoveDuplicates(this->extensionsUsed);
+  sortAndRemoveDuplicates(this->extensionsRequired);
+
   Scene* pThisDefaultScene = Model::getSafe(&this->scenes, this->scene);
   Scene* pRhsDefaultScene =
       Model::getSafe(&this->scenes, rhs.scene + int32_t(firstScene));
@@ -217,6 +235,70 @@ void Model::merge(Model&& rhs) {
   }
 }
 
+void Model::merge(std::vector<Model>&& models) {
+  // Size every element array once up front so that each model is moved in
+  // exactly once, instead of reallocating on every pairwise merge.
+  reserveElements(this->extensionsUsed, models, &ModelSpec::extensionsUsed);
+  reserveElements(
+      this->extensionsRequired,
+      models,
+      &ModelSpec::extensionsRequired);
+  reserveElements(this->accessors, models, &ModelSpec::accessors);
+  reserveElements(this->animations, models, &ModelSpec::animations);
+  reserveElements(this->buffers, models, &ModelSpec::buffers);
+  reserveElements(this->bufferViews, models, &ModelSpec::bufferViews);
+  reserveElements(this->cameras, models, &ModelSpec::cameras);
+  reserveElements(this->images, models, &ModelSpec::images);
+  reserveElements(this->materials, models, &ModelSpec::materials);
+  reserveElements(this->meshes, models, &ModelSpec::meshes);
+  reserveElements(this->nodes, models, &ModelSpec::nodes);
+  reserveElements(this->samplers, models, &ModelSpec::samplers);
+  // One extra scene for the combined default scene created below.
+  reserveElements(this->scenes, models, &ModelSpec::scenes, 1);
+  reserveElements(this->skins, models, &ModelSpec::skins);
+  reserveElements(this->textures, models, &ModelSpec::textures);
+
+  // The indices of the default scenes of all models, after merging.
+  std::vector<int32_t> defaultScenes;
+  defaultScenes.reserve(models.size() + 1);
+  if (Model::getSafe(&this->scenes, this->scene)) {
+    defaultScenes.emplace_back(this->scene);
+  }
+
+  for (Model& model : models) {
+    const size_t firstScene = appendElements(*this, model);
+    if (model.scene >= 0 &&
+        Model::getSafe(&this->scenes, model.scene + int32_t(firstScene))) {
+      defaultScenes.emplace_back(model.scene + int32_t(firstScene));
+    }
+  }
+
+  sortAndRemoveDuplicates(this->extensionsUsed);
+  sortAndRemoveDuplicates(this->extensionsRequired);
+
+  if (defaultScenes.size() == 1) {
+    this->scene = defaultScenes.front();
+  } else if (defaultScenes.size() > 1) {
+    // Create a single new default scene that has all the root nodes in the
+    // default scenes of every model.
+    size_t nodeCount = 0;
+    for (int32_t sceneIndex : defaultScenes) {
+      nodeCount += this->scenes[size_t(sceneIndex)].nodes.size();
+    }
+
+    Scene newScene;
+    newScene.nodes.reserve(nodeCount);
+    for (int32_t sceneIndex : defaultScenes) {
+      const std::vector<int32_t>& nodes =
+          this->scenes[size_t(sceneIndex)].nodes;
+      newScene.nodes.insert(newScene.nodes.end(), nodes.begin(), nodes.end());
+    }
+
+    this->scenes.emplace_back(std::move(newScene));
+    this->scene = int32_t(this->scenes.size() - 1);
+  }
+}
+
 namespace {
 template <typename TCallback>
 void forEachPrimitiveInMeshObject(
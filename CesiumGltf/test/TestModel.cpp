@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -481,3 +482,68 @@ TEST_CASE("Test smooth normal generation") {
         glm::epsilonEqual(vertex0Normal, expectedNormal, DEFAULT_EPSILON)));
   }
 }
+
+TEST_CASE("Model::merge with multiple models") {
+  auto makeModel = [](const std::string& extension) {
+    Model model;
+    model.extensionsUsed.emplace_back(extension);
+
+    Buffer& buffer = model.buffers.emplace_back();
+    buffer.cesium.data.resize(12);
+
+    BufferView& bufferView = model.bufferViews.emplace_back();
+    bufferView.buffer = 0;
+
+    Accessor& accessor = model.accessors.emplace_back();
+    accessor.bufferView = 0;
+
+    Mesh& mesh = model.meshes.emplace_back();
+    MeshPrimitive& primitive = mesh.primitives.emplace_back();
+    primitive.attributes["POSITION"] = 0;
+
+    Node& node = model.nodes.emplace_back();
+    node.mesh = 0;
+
+    Scene& scene = model.scenes.emplace_back();
+    scene.nodes.emplace_back(0);
+    model.scene = 0;
+
+    return model;
+  };
+
+  Model model = makeModel("A");
+
+  std::vector<Model> others;
+  others.emplace_back(makeModel("B"));
+  others.emplace_back(makeModel("A"));
+  others.emplace_back(makeModel("C"));
+
+  const std::byte* pFirstOtherBufferData =
+      others[0].buffers[0].cesium.data.data();
+
+  model.merge(std::move(others));
+
+  REQUIRE(model.buffers.size() == 4);
+  REQUIRE(model.bufferViews.size() == 4);
+  REQUIRE(model.accessors.size() == 4);
+  REQUIRE(model.meshes.size() == 4);
+  REQUIRE(model.nodes.size() == 4);
+
+  // Buffer data is moved, not copied.
+  CHECK(model.buffers[1].cesium.data.data() == pFirstOtherBufferData);
+
+  for (size_t i = 0; i < 4; ++i) {
+    const int32_t index = int32_t(i);
+    CHECK(model.bufferViews[i].buffer == index);
+    CHECK(model.accessors[i].bufferView == index);
+    CHECK(model.meshes[i].primitives[0].attributes["POSITION"] == index);
+    CHECK(model.nodes[i].mesh == index);
+  }
+
+  // A single combined default scene is added.
+  REQUIRE(model.scenes.size() == 5);
+  REQUIRE(model.scene == 4);
+  CHECK(model.scenes[4].nodes == std::vector<int32_t>{0, 1, 2, 3});
+
+  CHECK(model.extensionsUsed == std::vector<std::string>{"A", "B", "C"});
+}
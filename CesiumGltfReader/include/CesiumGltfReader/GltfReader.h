@@ -14,6 +14,7 @@
 
 #include <gsl/span>
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -106,6 +107,18 @@ struct CESIUMGLTFREADER_API GltfReaderOptions {
    * the ideal target gpu-compressed pixel format to transcode to.
    */
   CesiumGltf::Ktx2TranscodeTargets ktx2TranscodeTargets;
+
+  /**
+   * @brief The maximum width and height of decoded images, or 0 to decode
+   * images at their full resolution.
+   *
+   * Only images used by the textures of materials are downscaled. Other
+   * images, such as those of feature ID and feature property textures, hold
+   * exact values rather than colors, so they are always decoded at their full
+   * resolution. See {@link GltfReader::readImage} for how larger images are
+   * downscaled.
+   */
+  int32_t maximumImageDimension = 0;
 };
 
 /**
@@ -167,15 +180,26 @@ public:
    * The [stb_image](https://github.com/nothings/stb) library is used to decode
    * images in `JPG`, `PNG`, `TGA`, `BMP`, `PSD`, `GIF`, `HDR`, or `PIC` format.
    *
+   * An image whose width or height is larger than `maximumDimension` is
+   * downscaled by a power of two, to the size of the first of its mip levels
+   * that fits. WebP images are scaled while they are decoded, so their pixels
+   * are never held at full resolution. Other formats are decoded at full
+   * resolution and then downscaled, which still saves the memory that the
+   * full-resolution image and its mipmaps would take. KTX v2 images are not
+   * downscaled.
+   *
    * @param data The buffer from which to read the image.
    * @param ktx2TranscodeTargetFormat The compression format to transcode
    * KTX v2 textures into. If this is std::nullopt, KTX v2 textures will be
    * fully decompressed into raw pixels.
+   * @param maximumDimension The maximum width and height of the image, or 0
+   * to read the image at its full resolution.
    * @return The result of reading the image.
    */
   static ImageReaderResult readImage(
       const gsl::span<const std::byte>& data,
-      const CesiumGltf::Ktx2TranscodeTargets& ktx2TranscodeTargets);
+      const CesiumGltf::Ktx2TranscodeTargets& ktx2TranscodeTargets,
+      int32_t maximumDimension = 0);
 
   /**
    * @brief Generate mipmaps for this image.
@@ -4,6 +4,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 // Forward declarations
 namespace CesiumGltf {
@@ -37,6 +38,26 @@ struct PixelRectangle {
   int32_t height;
 };
 
+/**
+ * @brief One of the copies made by {@link ImageManipulation::blitImages}.
+ */
+struct ImageBlit {
+  /**
+   * @brief The image from which to read pixels.
+   */
+  const CesiumGltf::ImageCesium* pSource;
+
+  /**
+   * @brief The pixels to read from the source.
+   */
+  PixelRectangle sourcePixels;
+
+  /**
+   * @brief The pixels to write in the target.
+   */
+  PixelRectangle targetPixels;
+};
+
 class CESIUMGLTFREADER_API ImageManipulation {
 public:
   /**
@@ -71,7 +92,9 @@ public:
    * the target rectangle.
    *
    * The filtering algorithm for scaling is not specified, but can be assumed
-   * to provide reasonably good quality.
+   * to provide reasonably good quality. When the source is a whole multiple of
+   * the target size in both directions, each target pixel is the average of
+   * the source pixels it covers.
    *
    * The source and target images must have the same number of channels and same
    * bytes per channel. If scaling is required, they must also use exactly 1
@@ -95,6 +118,52 @@ public:
       const PixelRectangle& targetPixels,
       const CesiumGltf::ImageCesium& source,
       const PixelRectangle& sourcePixels);
+
+  /**
+   * @brief Copies pixels from many source images to a target image, as if by
+   * calling {@link blitImage} for each of them in order.
+   *
+   * This avoids repeating the work that is the same for every copy into the
+   * target, such as allocating the buffers used for scaling.
+   *
+   * @param target The image in which to write pixels.
+   * @param blits The copies to make.
+   * @returns The number of copies that were made. The others are skipped, for
+   * the reasons that {@link blitImage} returns false, and do not change any
+   * target pixels.
+   */
+  static size_t blitImages(
+      CesiumGltf::ImageCesium& target,
+      const std::vector<ImageBlit>& blits);
+
+  /**
+   * @brief Changes the number of channels of an image between three (RGB) and
+   * four (RGBA).
+   *
+   * Pixels gain an opaque alpha channel, or lose their alpha channel. The
+   * image must be uncompressed, without mipmaps, and use one byte per channel.
+   * If it is not, or if either number of channels is not three or four, this
+   * function returns false and does not change the image.
+   *
+   * @param image The image to convert.
+   * @param channels The number of channels that the image should have.
+   * @returns True if the image has the given number of channels.
+   */
+  static bool
+  convertChannels(CesiumGltf::ImageCesium& image, int32_t channels);
+
+  /**
+   * @brief Multiplies the color channels of each pixel by its alpha.
+   *
+   * The image must be uncompressed, use one byte per channel, and have two
+   * (luminance-alpha) or four (RGBA) channels, the last of which is alpha. If
+   * it does not, this function returns false and does not change the image.
+   * Mipmaps are premultiplied along with the base image.
+   *
+   * @param image The image whose pixels to premultiply.
+   * @returns True if the image was premultiplied.
+   */
+  static bool premultiplyAlpha(CesiumGltf::ImageCesium& image);
 };
 
 } // namespace CesiumGltfReader
@@ -1,6 +1,7 @@
 #include "CesiumGltfReader/GltfReader.h"
 
 #include "ModelJsonHandler.h"
+#include "computeMaximumImageDimensions.h"
 #include "decodeDataUrls.h"
 #include "decodeDraco.h"
 #include "registerExtensions.h"
@@ -228,7 +229,10 @@ void postprocess(
 
   if (options.decodeEmbeddedImages) {
     CESIUM_TRACE("CesiumGltfReader::decodeEmbeddedImages");
-    for (Image& image : model.images) {
+    const std::vector<int32_t> maximumDimensions =
+        computeMaximumImageDimensions(model, options.maximumImageDimension);
+    for (size_t i = 0; i < model.images.size(); ++i) {
+      Image& image = model.images[i];
       // Ignore external images for now.
       if (image.uri) {
         continue;
@@ -254,8 +258,10 @@ void postprocess(
       const gsl::span<const std::byte> bufferViewSpan = bufferSpan.subspan(
           static_cast<size_t>(bufferView.byteOffset),
           static_cast<size_t>(bufferView.byteLength));
-      ImageReaderResult imageResult =
-          GltfReader::readImage(bufferViewSpan, options.ktx2TranscodeTargets);
+      ImageReaderResult imageResult = GltfReader::readImage(
+          bufferViewSpan,
+          options.ktx2TranscodeTargets,
+          maximumDimensions[i]);
       readGltf.warnings.insert(
           readGltf.warnings.end(),
           imageResult.warnings.begin(),
@@ -385,14 +391,19 @@ Future<GltfReaderResult> GltfReader::resolveExternalData(
     }
   }
 
-  for (Image& image : pResult->model->images) {
+  const std::vector<int32_t> maximumDimensions = computeMaximumImageDimensions(
+      *pResult->model,
+      options.maximumImageDimension);
+  for (size_t i = 0; i < pResult->model->images.size(); ++i) {
+    Image& image = pResult->model->images[i];
     if (image.uri && image.uri->substr(0, dataPrefixLength) != dataPrefix) {
       resolvedBuffers.push_back(
           pAssetAccessor
               ->get(asyncSystem, Uri::resolve(baseUrl, *image.uri), tHeaders)
               .thenInWorkerThread(
                   [pImage = &image,
-                   ktx2TranscodeTargets = options.ktx2TranscodeTargets](
+                   ktx2TranscodeTargets = options.ktx2TranscodeTargets,
+                   maximumImageDimension = maximumDimensions[i]](
                       std::shared_ptr<IAssetRequest>&& pRequest) {
                     const IAssetResponse* pResponse = pRequest->response();
 
@@ -401,8 +412,10 @@ Future<GltfReaderResult> GltfReader::resolveExternalData(
                     if (pResponse) {
                       pImage->uri = std::nullopt;
 
-                      ImageReaderResult imageResult =
-                          readImage(pResponse->data(), ktx2TranscodeTargets);
+                      ImageReaderResult imageResult = readImage(
+                          pResponse->data(),
+                          ktx2TranscodeTargets,
+                          maximumImageDimension);
                       if (imageResult.image) {
                         pImage->cesium = std::move(*imageResult.image);
                         return ExternalBufferLoadResult{true, imageUri};
@@ -450,10 +463,27 @@ bool isWebP(const gsl::span<const std::byte>& data) {
   return magic1 == 0x46464952 && magic2 == 0x50424557;
 }
 
+// Halves the given size, as each mip level does, until neither dimension is
+// larger than the maximum. A maximum of 0 leaves the size unchanged.
+void downscaleToMaximumDimension(
+    int32_t maximumDimension,
+    int32_t& width,
+    int32_t& height) noexcept {
+  if (maximumDimension <= 0) {
+    return;
+  }
+
+  while (width > maximumDimension || height > maximumDimension) {
+    width = std::max(width >> 1, 1);
+    height = std::max(height >> 1, 1);
+  }
+}
+
 /*static*/
 ImageReaderResult GltfReader::readImage(
     const gsl::span<const std::byte>& data,
-    const Ktx2TranscodeTargets& ktx2TranscodeTargets) {
+    const Ktx2TranscodeTargets& ktx2TranscodeTargets,
+    int32_t maximumDimension) {
   CESIUM_TRACE("CesiumGltfReader::readImage");
 
   ImageReaderResult result;
@@ -621,16 +651,35 @@ ImageReaderResult GltfReader::readImage(
             &image.height)) {
       image.channels = 4;
       image.bytesPerChannel = 1;
-      uint8_t* pImage = NULL;
+      const int32_t fullWidth = image.width;
+      const int32_t fullHeight = image.height;
+      downscaleToMaximumDimension(maximumDimension, image.width, image.height);
       const auto bufferSize = image.width * image.height * image.channels;
       image.pixelData.resize(static_cast<std::size_t>(bufferSize));
-      pImage = WebPDecodeRGBAInto(
-          reinterpret_cast<const uint8_t*>(data.data()),
-          data.size(),
-          reinterpret_cast<uint8_t*>(image.pixelData.data()),
-          image.pixelData.size(),
-          image.width * image.channels);
-      if (!pImage) {
+
+      // libwebp scales the image while decoding it, so it never holds the
+      // full-resolution pixels.
+      WebPDecoderConfig config;
+      bool decoded = false;
+      if (WebPInitDecoderConfig(&config)) {
+        if (image.width != fullWidth || image.height != fullHeight) {
+          config.options.use_scaling = 1;
+          config.options.scaled_width = image.width;
+          config.options.scaled_height = image.height;
+        }
+        config.output.colorspace = MODE_RGBA;
+        config.output.is_external_memory = 1;
+        config.output.u.RGBA.rgba =
+            reinterpret_cast<uint8_t*>(image.pixelData.data());
+        config.output.u.RGBA.stride = image.width * image.channels;
+        config.output.u.RGBA.size = image.pixelData.size();
+        decoded = WebPDecode(
+                      reinterpret_cast<const uint8_t*>(data.data()),
+                      data.size(),
+                      &config) == VP8_STATUS_OK;
+        WebPFreeDecBuffer(&config.output);
+      }
+      if (!decoded) {
         result.image.reset();
         result.errors.emplace_back("Unable to decode WebP");
       }
@@ -653,10 +702,10 @@ ImageReaderResult GltfReader::readImage(
         &channelsInFile,
         image.channels);
     if (pImage) {
-      CESIUM_TRACE(
-          "copy image " + std::to_string(image.width) + "x" +
-          std::to_string(image.height) + "x" + std::to_string(image.channels) +
-          "x" + std::to_string(image.bytesPerChannel));
+      const int32_t fullWidth = image.width;
+      const int32_t fullHeight = image.height;
+      downscaleToMaximumDimension(maximumDimension, image.width, image.height);
+
       // std::uint8_t is not implicitly convertible to std::byte, so we must use
       // reinterpret_cast to (safely) force the conversion.
       const auto lastByte =
@@ -664,7 +713,36 @@ ImageReaderResult GltfReader::readImage(
       image.pixelData.resize(static_cast<std::size_t>(lastByte));
       std::uint8_t* u8Pointer =
           reinterpret_cast<std::uint8_t*>(image.pixelData.data());
-      std::copy(pImage, pImage + lastByte, u8Pointer);
+
+      if (image.width == fullWidth && image.height == fullHeight) {
+        CESIUM_TRACE(
+            "copy image " + std::to_string(image.width) + "x" +
+            std::to_string(image.height) + "x" +
+            std::to_string(image.channels) + "x" +
+            std::to_string(image.bytesPerChannel));
+        std::copy(pImage, pImage + lastByte, u8Pointer);
+      } else {
+        // stb_image cannot decode at a reduced scale, so the full-resolution
+        // pixels are resized into the image instead of being copied.
+        CESIUM_TRACE(
+            "downscale image " + std::to_string(fullWidth) + "x" +
+            std::to_string(fullHeight) + " to " +
+            std::to_string(image.width) + "x" +
+            std::to_string(image.height));
+        if (!stbir_resize_uint8(
+                pImage,
+                fullWidth,
+                fullHeight,
+                0,
+                u8Pointer,
+                image.width,
+                image.height,
+                0,
+                image.channels)) {
+          result.image.reset();
+          result.errors.emplace_back("Unable to downscale image");
+        }
+      }
       stbi_image_free(pImage);
     } else {
       result.image.reset();
@@ -2,8 +2,10 @@
 
 #include <CesiumGltf/ImageCesium.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <utility>
 
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 #include <stb_image_resize.h>
@@ -34,11 +36,162 @@ void ImageManipulation::unsafeBlitImage(
   }
 }
 
-bool ImageManipulation::blitImage(
+namespace {
+// Averages each factorX by factorY block of source pixels into one target
+// pixel. For each row of target pixels, the factorY source rows are first
+// summed value by value, and then each run of factorX summed pixels is
+// reduced to one target pixel. The number of channels is a template
+// parameter so that the per-pixel loops are fully unrolled.
+template <size_t Channels>
+void boxDownscale(
+    uint8_t* pTarget,
+    size_t targetRowStride,
+    const uint8_t* pSource,
+    size_t sourceRowStride,
+    size_t targetWidth,
+    size_t targetHeight,
+    size_t factorX,
+    size_t factorY,
+    std::vector<uint32_t>& sums) {
+  const size_t sourceValuesPerRow = targetWidth * factorX * Channels;
+  const uint32_t count = uint32_t(factorX * factorY);
+  const uint32_t half = count / 2;
+  sums.resize(sourceValuesPerRow);
+  uint32_t* pSums = sums.data();
+
+  for (size_t j = 0; j < targetHeight; ++j) {
+    const uint8_t* pSourceRow = pSource + j * factorY * sourceRowStride;
+    for (size_t i = 0; i < sourceValuesPerRow; ++i) {
+      pSums[i] = pSourceRow[i];
+    }
+    for (size_t k = 1; k < factorY; ++k) {
+      pSourceRow += sourceRowStride;
+      for (size_t i = 0; i < sourceValuesPerRow; ++i) {
+        pSums[i] += pSourceRow[i];
+      }
+    }
+
+    uint8_t* pTargetRow = pTarget + j * targetRowStride;
+    const uint32_t* pBlock = pSums;
+    for (size_t i = 0; i < targetWidth; ++i) {
+      uint32_t pixel[Channels] = {};
+      for (size_t p = 0; p < factorX; ++p) {
+        for (size_t c = 0; c < Channels; ++c) {
+          pixel[c] += pBlock[c];
+        }
+        pBlock += Channels;
+      }
+      for (size_t c = 0; c < Channels; ++c) {
+        pTargetRow[i * Channels + c] = uint8_t((pixel[c] + half) / count);
+      }
+    }
+  }
+}
+
+bool boxDownscale(
+    uint8_t* pTarget,
+    size_t targetRowStride,
+    const uint8_t* pSource,
+    size_t sourceRowStride,
+    size_t targetWidth,
+    size_t targetHeight,
+    size_t channels,
+    size_t factorX,
+    size_t factorY,
+    std::vector<uint32_t>& sums) {
+  switch (channels) {
+  case 1:
+    boxDownscale<1>(
+        pTarget,
+        targetRowStride,
+        pSource,
+        sourceRowStride,
+        targetWidth,
+        targetHeight,
+        factorX,
+        factorY,
+        sums);
+    return true;
+  case 2:
+    boxDownscale<2>(
+        pTarget,
+        targetRowStride,
+        pSource,
+        sourceRowStride,
+        targetWidth,
+        targetHeight,
+        factorX,
+        factorY,
+        sums);
+    return true;
+  case 3:
+    boxDownscale<3>(
+        pTarget,
+        targetRowStride,
+        pSource,
+        sourceRowStride,
+        targetWidth,
+        targetHeight,
+        factorX,
+        factorY,
+        sums);
+    return true;
+  case 4:
+    boxDownscale<4>(
+        pTarget,
+        targetRowStride,
+        pSource,
+        sourceRowStride,
+        targetWidth,
+        targetHeight,
+        factorX,
+        factorY,
+        sums);
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Copies the first channels of each pixel, and sets any further target
+// channels to opaque.
+template <size_t SourceChannels, size_t TargetChannels>
+void convertPixels(
+    uint8_t* pTarget,
+    const uint8_t* pSource,
+    size_t pixelCount) {
+  constexpr size_t copied = std::min(SourceChannels, TargetChannels);
+  for (size_t i = 0; i < pixelCount; ++i) {
+    for (size_t c = 0; c < copied; ++c) {
+      pTarget[c] = pSource[c];
+    }
+    for (size_t c = copied; c < TargetChannels; ++c) {
+      pTarget[c] = 255;
+    }
+    pSource += SourceChannels;
+    pTarget += TargetChannels;
+  }
+}
+
+template <size_t Channels>
+void premultiplyPixels(uint8_t* pPixels, size_t pixelCount) {
+  for (size_t i = 0; i < pixelCount; ++i) {
+    uint8_t* pPixel = pPixels + i * Channels;
+    const uint32_t alpha = pPixel[Channels - 1];
+    for (size_t c = 0; c + 1 < Channels; ++c) {
+      // Rounds value * alpha / 255 to the nearest integer without dividing.
+      const uint32_t product = uint32_t(pPixel[c]) * alpha + 128;
+      pPixel[c] = uint8_t((product + (product >> 8)) >> 8);
+    }
+  }
+}
+
+bool blitImageWithSums(
     CesiumGltf::ImageCesium& target,
     const PixelRectangle& targetPixels,
     const CesiumGltf::ImageCesium& source,
-    const PixelRectangle& sourcePixels) {
+    const PixelRectangle& sourcePixels,
+    std::vector<uint32_t>& sums) {
 
   if (sourcePixels.x < 0 || sourcePixels.y < 0 || sourcePixels.width < 0 ||
       sourcePixels.height < 0 ||
@@ -85,7 +238,7 @@ bool ImageManipulation::blitImage(
   if (sourcePixels.width == targetPixels.width &&
       sourcePixels.height == targetPixels.height) {
     // Simple, unscaled, byte-for-byte image copy.
-    unsafeBlitImage(
+    ImageManipulation::unsafeBlitImage(
         pTarget,
         bytesPerTargetRow,
         pSource,
@@ -99,6 +252,27 @@ bool ImageManipulation::blitImage(
       return false;
     }
 
+    // Whole-multiple downscales, such as those between levels of a quadtree,
+    // are a plain average of the covered source pixels.
+    if (targetPixels.width > 0 && targetPixels.height > 0 &&
+        sourcePixels.width >= targetPixels.width &&
+        sourcePixels.height >= targetPixels.height &&
+        sourcePixels.width % targetPixels.width == 0 &&
+        sourcePixels.height % targetPixels.height == 0 &&
+        boxDownscale(
+            reinterpret_cast<uint8_t*>(pTarget),
+            bytesPerTargetRow,
+            reinterpret_cast<const uint8_t*>(pSource),
+            bytesPerSourceRow,
+            size_t(targetPixels.width),
+            size_t(targetPixels.height),
+            size_t(target.channels),
+            size_t(sourcePixels.width / targetPixels.width),
+            size_t(sourcePixels.height / targetPixels.height),
+            sums)) {
+      return true;
+    }
+
     // Use STB to do the copy / scale
     stbir_resize_uint8(
         reinterpret_cast<const unsigned char*>(pSource),
@@ -114,4 +288,90 @@ bool ImageManipulation::blitImage(
 
   return true;
 }
+
+} // namespace
+
+bool ImageManipulation::blitImage(
+    CesiumGltf::ImageCesium& target,
+    const PixelRectangle& targetPixels,
+    const CesiumGltf::ImageCesium& source,
+    const PixelRectangle& sourcePixels) {
+  std::vector<uint32_t> sums;
+  return blitImageWithSums(target, targetPixels, source, sourcePixels, sums);
+}
+
+size_t ImageManipulation::blitImages(
+    CesiumGltf::ImageCesium& target,
+    const std::vector<ImageBlit>& blits) {
+  // The sums used for scaling are shared by all of the blits.
+  std::vector<uint32_t> sums;
+  size_t blitted = 0;
+  for (const ImageBlit& blit : blits) {
+    if (blit.pSource && blitImageWithSums(
+                            target,
+                            blit.targetPixels,
+                            *blit.pSource,
+                            blit.sourcePixels,
+                            sums)) {
+      ++blitted;
+    }
+  }
+  return blitted;
+}
+
+bool ImageManipulation::convertChannels(
+    CesiumGltf::ImageCesium& image,
+    int32_t channels) {
+  if (image.compressedPixelFormat !=
+          CesiumGltf::GpuCompressedPixelFormat::NONE ||
+      !image.mipPositions.empty() || image.bytesPerChannel != 1 ||
+      image.width < 0 || image.height < 0 ||
+      (image.channels != 3 && image.channels != 4) ||
+      (channels != 3 && channels != 4)) {
+    return false;
+  }
+
+  if (image.channels == channels) {
+    return true;
+  }
+
+  const size_t pixelCount = size_t(image.width) * size_t(image.height);
+  if (image.pixelData.size() < pixelCount * size_t(image.channels)) {
+    return false;
+  }
+
+  std::vector<std::byte> converted(pixelCount * size_t(channels));
+  const uint8_t* pSource =
+      reinterpret_cast<const uint8_t*>(image.pixelData.data());
+  uint8_t* pTarget = reinterpret_cast<uint8_t*>(converted.data());
+  if (channels == 4) {
+    convertPixels<3, 4>(pTarget, pSource, pixelCount);
+  } else {
+    convertPixels<4, 3>(pTarget, pSource, pixelCount);
+  }
+
+  image.pixelData = std::move(converted);
+  image.channels = channels;
+  return true;
+}
+
+bool ImageManipulation::premultiplyAlpha(CesiumGltf::ImageCesium& image) {
+  if (image.compressedPixelFormat !=
+          CesiumGltf::GpuCompressedPixelFormat::NONE ||
+      image.bytesPerChannel != 1 ||
+      (image.channels != 2 && image.channels != 4)) {
+    return false;
+  }
+
+  // The mipmaps have the same format as the base image, so every pixel in the
+  // buffer is premultiplied.
+  uint8_t* pPixels = reinterpret_cast<uint8_t*>(image.pixelData.data());
+  if (image.channels == 2) {
+    premultiplyPixels<2>(pPixels, image.pixelData.size() / 2);
+  } else {
+    premultiplyPixels<4>(pPixels, image.pixelData.size() / 4);
+  }
+
+  return true;
+}
 } // namespace CesiumGltfReader
@@ -0,0 +1,91 @@
+#include "computeMaximumImageDimensions.h"
+
+#include <CesiumGltf/ExtensionKhrTextureBasisu.h>
+#include <CesiumGltf/ExtensionTextureWebp.h>
+#include <CesiumGltf/Model.h>
+
+#include <optional>
+
+using namespace CesiumGltf;
+
+namespace CesiumGltfReader {
+
+namespace {
+void addImage(std::vector<int32_t>& dimensions, int32_t image, int32_t value) {
+  if (image >= 0 && size_t(image) < dimensions.size()) {
+    dimensions[size_t(image)] = value;
+  }
+}
+
+template <typename TTextureInfo>
+void addTextureImages(
+    const Model& model,
+    const std::optional<TTextureInfo>& textureInfo,
+    std::vector<int32_t>& dimensions,
+    int32_t maximumImageDimension) {
+  if (!textureInfo) {
+    return;
+  }
+
+  const Texture* pTexture = Model::getSafe(&model.textures, textureInfo->index);
+  if (!pTexture) {
+    return;
+  }
+
+  // A texture may name a different image for each of the extensions that
+  // provide other image formats.
+  addImage(dimensions, pTexture->source, maximumImageDimension);
+  const ExtensionKhrTextureBasisu* pBasisu =
+      pTexture->getExtension<ExtensionKhrTextureBasisu>();
+  if (pBasisu) {
+    addImage(dimensions, pBasisu->source, maximumImageDimension);
+  }
+  const ExtensionTextureWebp* pWebp =
+      pTexture->getExtension<ExtensionTextureWebp>();
+  if (pWebp) {
+    addImage(dimensions, pWebp->source, maximumImageDimension);
+  }
+}
+} // namespace
+
+std::vector<int32_t> computeMaximumImageDimensions(
+    const Model& model,
+    int32_t maximumImageDimension) {
+  std::vector<int32_t> dimensions(model.images.size(), 0);
+  if (maximumImageDimension <= 0) {
+    return dimensions;
+  }
+
+  for (const Material& material : model.materials) {
+    if (material.pbrMetallicRoughness) {
+      addTextureImages(
+          model,
+          material.pbrMetallicRoughness->baseColorTexture,
+          dimensions,
+          maximumImageDimension);
+      addTextureImages(
+          model,
+          material.pbrMetallicRoughness->metallicRoughnessTexture,
+          dimensions,
+          maximumImageDimension);
+    }
+    addTextureImages(
+        model,
+        material.normalTexture,
+        dimensions,
+        maximumImageDimension);
+    addTextureImages(
+        model,
+        material.occlusionTexture,
+        dimensions,
+        maximumImageDimension);
+    addTextureImages(
+        model,
+        material.emissiveTexture,
+        dimensions,
+        maximumImageDimension);
+  }
+
+  return dimensions;
+}
+} // namespace CesiumGltfReader
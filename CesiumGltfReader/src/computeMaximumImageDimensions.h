@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace CesiumGltf {
+struct Model;
+}
+
+namespace CesiumGltfReader {
+
+/**
+ * Computes the maximum width and height to decode each image of the model at.
+ *
+ * Only images that are used by the textures of materials may be downscaled.
+ * Other images, such as feature ID and feature property textures, hold exact
+ * values that resampling would corrupt, so they are always decoded at their
+ * full resolution, as is any image when `maximumImageDimension` is 0.
+ */
+std::vector<int32_t> computeMaximumImageDimensions(
+    const CesiumGltf::Model& model,
+    int32_t maximumImageDimension);
+} // namespace CesiumGltfReader
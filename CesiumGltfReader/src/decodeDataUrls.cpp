@@ -1,6 +1,7 @@
 #include "decodeDataUrls.h"
 
 #include "CesiumGltfReader/GltfReader.h"
+#include "computeMaximumImageDimensions.h"
 
 #include <CesiumGltf/Model.h>
 #include <CesiumUtility/Tracing.h>
@@ -114,7 +115,10 @@ void decodeDataUrls(
     }
   }
 
-  for (CesiumGltf::Image& image : model.images) {
+  const std::vector<int32_t> maximumDimensions =
+      computeMaximumImageDimensions(model, options.maximumImageDimension);
+  for (size_t i = 0; i < model.images.size(); ++i) {
+    CesiumGltf::Image& image = model.images[i];
     if (!image.uri) {
       continue;
     }
@@ -124,8 +128,10 @@ void decodeDataUrls(
       continue;
     }
 
-    ImageReaderResult imageResult =
-        reader.readImage(decoded.value().data, options.ktx2TranscodeTargets);
+    ImageReaderResult imageResult = reader.readImage(
+        decoded.value().data,
+        options.ktx2TranscodeTargets,
+        maximumDimensions[i]);
     if (imageResult.image) {
       image.cesium = std::move(imageResult.image.value());
     }
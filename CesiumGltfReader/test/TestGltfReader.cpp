@@ -414,6 +414,115 @@ TEST_CASE("Test KTX2") {
   REQUIRE(model.meshes.size() == 1);
 }
 
+TEST_CASE("Images are downscaled to the maximum dimension") {
+  std::filesystem::path dataDir = CesiumGltfReader_TEST_DATA_DIR;
+  Ktx2TranscodeTargets ktx2TranscodeTargets;
+
+  SECTION("PNG") {
+    std::vector<std::byte> data = readFile(dataDir / "RedAndBlue.png");
+
+    ImageReaderResult full = GltfReader::readImage(data, ktx2TranscodeTargets);
+    REQUIRE(full.image);
+    CHECK(full.image->width == 64);
+    CHECK(full.image->height == 32);
+
+    ImageReaderResult result =
+        GltfReader::readImage(data, ktx2TranscodeTargets, 20);
+    REQUIRE(result.image);
+    const ImageCesium& image = *result.image;
+    CHECK(image.width == 16);
+    CHECK(image.height == 8);
+    REQUIRE(image.pixelData.size() == 16 * 8 * 4);
+
+    // The left half is red and the right half blue.
+    CHECK(image.pixelData[0] == std::byte(255));
+    CHECK(image.pixelData[2] == std::byte(0));
+    CHECK(image.pixelData[15 * 4] == std::byte(0));
+    CHECK(image.pixelData[15 * 4 + 2] == std::byte(255));
+  }
+
+  SECTION("WebP") {
+    std::vector<std::byte> data =
+        readFile(dataDir / "BoxTexturedWebp" / "glTF" / "CesiumLogoFlat.webp");
+
+    ImageReaderResult result =
+        GltfReader::readImage(data, ktx2TranscodeTargets, 100);
+    REQUIRE(result.image);
+    CHECK(result.image->width == 64);
+    CHECK(result.image->height == 64);
+    CHECK(result.image->pixelData.size() == 64 * 64 * 4);
+  }
+
+  SECTION("Images that fit are not changed") {
+    std::vector<std::byte> data = readFile(dataDir / "RedAndBlue.png");
+    ImageReaderResult result =
+        GltfReader::readImage(data, ktx2TranscodeTargets, 64);
+    REQUIRE(result.image);
+    CHECK(result.image->width == 64);
+    CHECK(result.image->height == 32);
+  }
+}
+
+TEST_CASE("Only images used by materials are downscaled") {
+  // Both images are RedAndBlue.png. The first is the base color of a
+  // material, and the second is only used by a feature ID texture.
+  const std::string png =
+      "data:image/png;base64,"
+      "iVBORw0KGgoAAAANSUhEUgAAAEAAAAAgCAYAAACinX6EAAAAQ0lEQVR42u3QsQkAAAzDsPz/"
+      "dHpGoGjwbFCadNl43wAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAD/"
+      "AQ4oevDiNXRObwAAAABJRU5ErkJggg==";
+  const std::string s = R"(
+    {
+      "images": [{"uri": ")" + png +
+                        R"("}, {"uri": ")" + png + R"("}],
+      "textures": [{"source": 0}, {"source": 1}],
+      "materials": [
+        {"pbrMetallicRoughness": {"baseColorTexture": {"index": 0}}}
+      ],
+      "meshes": [
+        {
+          "primitives": [
+            {
+              "attributes": {},
+              "material": 0,
+              "extensions": {
+                "EXT_feature_metadata": {
+                  "featureIdTextures": [
+                    {
+                      "featureTable": "features",
+                      "featureIds": {
+                        "texture": {"index": 1, "texCoord": 0},
+                        "channels": "r"
+                      }
+                    }
+                  ]
+                }
+              }
+            }
+          ]
+        }
+      ]
+    }
+  )";
+
+  GltfReaderOptions options;
+  options.maximumImageDimension = 20;
+  GltfReader reader;
+  GltfReaderResult result = reader.readGltf(
+      gsl::span(reinterpret_cast<const std::byte*>(s.c_str()), s.size()),
+      options);
+  REQUIRE(result.model);
+  REQUIRE(result.model->images.size() == 2);
+
+  const ImageCesium& material = result.model->images[0].cesium;
+  CHECK(material.width == 16);
+  CHECK(material.height == 8);
+
+  const ImageCesium& featureIds = result.model->images[1].cesium;
+  CHECK(featureIds.width == 64);
+  CHECK(featureIds.height == 32);
+}
+
 TEST_CASE("Can apply RTC CENTER if model uses Cesium RTC extension") {
   const std::string s = R"(
     {
@@ -333,3 +333,160 @@ TEST_CASE("ImageManipulation::blitImage") {
     verifyTargetUnchanged();
   }
 }
+
+TEST_CASE("ImageManipulation::blitImage averages whole-multiple downscales") {
+  ImageCesium source;
+  source.width = 4;
+  source.height = 2;
+  source.channels = 2;
+  source.bytesPerChannel = 1;
+  const std::vector<uint8_t> sourceValues{
+      10, 0,  20, 100, 30, 255, 40, 255, // first row
+      50, 10, 60, 100, 70, 255, 81, 255}; // second row
+  for (uint8_t value : sourceValues) {
+    source.pixelData.emplace_back(std::byte(value));
+  }
+
+  ImageCesium target;
+  target.width = 2;
+  target.height = 1;
+  target.channels = 2;
+  target.bytesPerChannel = 1;
+  target.pixelData.resize(4);
+
+  CHECK(ImageManipulation::blitImage(
+      target,
+      PixelRectangle{0, 0, 2, 1},
+      source,
+      PixelRectangle{0, 0, 4, 2}));
+
+  // Each target pixel is the rounded average of a 2x2 block.
+  CHECK(target.pixelData[0] == std::byte(35));
+  CHECK(target.pixelData[1] == std::byte(53));
+  CHECK(target.pixelData[2] == std::byte(55));
+  CHECK(target.pixelData[3] == std::byte(255));
+}
+
+TEST_CASE("ImageManipulation::blitImages") {
+  ImageCesium target;
+  target.width = 4;
+  target.height = 2;
+  target.channels = 1;
+  target.bytesPerChannel = 1;
+  target.pixelData.resize(8, std::byte(0));
+
+  ImageCesium left;
+  left.width = 2;
+  left.height = 2;
+  left.channels = 1;
+  left.bytesPerChannel = 1;
+  left.pixelData.resize(4, std::byte(1));
+
+  ImageCesium right;
+  right.width = 4;
+  right.height = 4;
+  right.channels = 1;
+  right.bytesPerChannel = 1;
+  right.pixelData.resize(16, std::byte(2));
+
+  ImageCesium mismatched = left;
+  mismatched.channels = 4;
+
+  const std::vector<ImageBlit> blits{
+      {&left, PixelRectangle{0, 0, 2, 2}, PixelRectangle{0, 0, 2, 2}},
+      {&right, PixelRectangle{0, 0, 4, 4}, PixelRectangle{2, 0, 2, 2}},
+      {&mismatched, PixelRectangle{0, 0, 2, 2}, PixelRectangle{0, 0, 2, 2}},
+      {nullptr, PixelRectangle{0, 0, 2, 2}, PixelRectangle{0, 0, 2, 2}}};
+
+  CHECK(ImageManipulation::blitImages(target, blits) == 2);
+
+  const std::vector<std::byte> expected{
+      std::byte(1),
+      std::byte(1),
+      std::byte(2),
+      std::byte(2),
+      std::byte(1),
+      std::byte(1),
+      std::byte(2),
+      std::byte(2)};
+  CHECK(target.pixelData == expected);
+}
+
+TEST_CASE("ImageManipulation::convertChannels") {
+  ImageCesium image;
+  image.width = 2;
+  image.height = 1;
+  image.channels = 3;
+  image.bytesPerChannel = 1;
+  for (uint8_t value : std::vector<uint8_t>{1, 2, 3, 4, 5, 6}) {
+    image.pixelData.emplace_back(std::byte(value));
+  }
+
+  SECTION("adds an opaque alpha channel and removes it again") {
+    REQUIRE(ImageManipulation::convertChannels(image, 4));
+    CHECK(image.channels == 4);
+    const std::vector<std::byte> rgba{
+        std::byte(1),
+        std::byte(2),
+        std::byte(3),
+        std::byte(255),
+        std::byte(4),
+        std::byte(5),
+        std::byte(6),
+        std::byte(255)};
+    CHECK(image.pixelData == rgba);
+
+    REQUIRE(ImageManipulation::convertChannels(image, 3));
+    CHECK(image.channels == 3);
+    const std::vector<std::byte> rgb{
+        std::byte(1),
+        std::byte(2),
+        std::byte(3),
+        std::byte(4),
+        std::byte(5),
+        std::byte(6)};
+    CHECK(image.pixelData == rgb);
+  }
+
+  SECTION("returns false for an unsupported conversion") {
+    CHECK(!ImageManipulation::convertChannels(image, 2));
+    CHECK(image.channels == 3);
+
+    image.mipPositions.emplace_back(ImageCesiumMipPosition{0, 6});
+    CHECK(!ImageManipulation::convertChannels(image, 4));
+    CHECK(image.channels == 3);
+  }
+}
+
+TEST_CASE("ImageManipulation::premultiplyAlpha") {
+  ImageCesium image;
+  image.width = 2;
+  image.height = 1;
+  image.channels = 4;
+  image.bytesPerChannel = 1;
+  for (uint8_t value :
+       std::vector<uint8_t>{255, 128, 0, 128, 200, 100, 50, 255}) {
+    image.pixelData.emplace_back(std::byte(value));
+  }
+
+  SECTION("multiplies the color channels by alpha") {
+    REQUIRE(ImageManipulation::premultiplyAlpha(image));
+    const std::vector<std::byte> expected{
+        std::byte(128),
+        std::byte(64),
+        std::byte(0),
+        std::byte(128),
+        std::byte(200),
+        std::byte(100),
+        std::byte(50),
+        std::byte(255)};
+    CHECK(image.pixelData == expected);
+  }
+
+  SECTION("returns false for an image without alpha") {
+    image.channels = 3;
+    const std::vector<std::byte> original = image.pixelData;
+    CHECK(!ImageManipulation::premultiplyAlpha(image));
+    CHECK(image.pixelData == original);
+  }
+}
@@ -0,0 +1,290 @@
+#pragma once
+
+#include "Library.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CesiumUtility {
+
+/**
+ * @brief A count of events that only ever increases, such as the number of
+ * cache hits.
+ *
+ * Updating a counter is a single relaxed atomic operation, so it is safe and
+ * cheap to do from any thread.
+ */
+class CESIUMUTILITY_API MetricCounter final {
+public:
+  /**
+   * @brief Adds to the count.
+   *
+   * @param amount The amount to add.
+   */
+  void increment(int64_t amount = 1) noexcept {
+    this->_value.fetch_add(amount, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Gets the current count.
+   */
+  int64_t getValue() const noexcept {
+    return this->_value.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<int64_t> _value{0};
+
+  friend class MetricsRegistry;
+};
+
+/**
+ * @brief A value that may go up and down, such as the number of bytes held in
+ * a cache.
+ *
+ * Updating a gauge is a single relaxed atomic operation, so it is safe and
+ * cheap to do from any thread.
+ */
+class CESIUMUTILITY_API MetricGauge final {
+public:
+  /**
+   * @brief Sets the value.
+   *
+   * @param value The new value.
+   */
+  void set(int64_t value) noexcept {
+    this->_value.store(value, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Adds to the value.
+   *
+   * @param amount The amount to add, which may be negative.
+   */
+  void add(int64_t amount) noexcept {
+    this->_value.fetch_add(amount, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Gets the current value.
+   */
+  int64_t getValue() const noexcept {
+    return this->_value.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<int64_t> _value{0};
+
+  friend class MetricsRegistry;
+};
+
+/**
+ * @brief A distribution of non-negative values, such as durations in
+ * microseconds.
+ *
+ * Values are counted in buckets whose upper bounds are powers of two, so
+ * recording a value takes a few relaxed atomic operations and never
+ * allocates.
+ */
+class CESIUMUTILITY_API MetricHistogram final {
+public:
+  /**
+   * @brief The number of buckets. Bucket `i` counts values less than `2^i`
+   * that are not counted by an earlier bucket. The last bucket also counts
+   * all larger values.
+   */
+  static constexpr size_t BucketCount = 40;
+
+  /**
+   * @brief Records a value. Negative values are recorded as zero.
+   *
+   * @param value The value to record.
+   */
+  void record(int64_t value) noexcept;
+
+  /**
+   * @brief Gets the number of recorded values.
+   */
+  int64_t getCount() const noexcept {
+    return this->_count.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Gets the sum of the recorded values.
+   */
+  int64_t getSum() const noexcept {
+    return this->_sum.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Gets the number of recorded values in the given bucket.
+   *
+   * @param bucket The index of the bucket, less than {@link BucketCount}.
+   */
+  int64_t getBucketCount(size_t bucket) const noexcept {
+    return this->_buckets[bucket].load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Gets the exclusive upper bound of the values counted in the given
+   * bucket.
+   *
+   * @param bucket The index of the bucket, less than {@link BucketCount}.
+   */
+  static int64_t getBucketUpperBound(size_t bucket) noexcept {
+    return int64_t(1) << bucket;
+  }
+
+private:
+  void reset() noexcept;
+
+  std::array<std::atomic<int64_t>, BucketCount> _buckets{};
+  std::atomic<int64_t> _count{0};
+  std::atomic<int64_t> _sum{0};
+
+  friend class MetricsRegistry;
+};
+
+/**
+ * @brief A point-in-time copy of all the metrics in a
+ * {@link MetricsRegistry}, suitable for exporting to a monitoring system.
+ */
+struct CESIUMUTILITY_API MetricsSnapshot {
+  /**
+   * @brief The value of a counter or gauge.
+   */
+  struct Value {
+    /** @brief The name of the metric. */
+    std::string name;
+
+    /** @brief The value of the metric. */
+    int64_t value;
+  };
+
+  /**
+   * @brief The state of a histogram.
+   */
+  struct Histogram {
+    /** @brief The name of the metric. */
+    std::string name;
+
+    /** @brief The number of recorded values. */
+    int64_t count;
+
+    /** @brief The sum of the recorded values. */
+    int64_t sum;
+
+    /**
+     * @brief The number of values in each bucket. See
+     * {@link MetricHistogram::getBucketUpperBound} for the bucket bounds.
+     */
+    std::vector<int64_t> bucketCounts;
+  };
+
+  /** @brief The counters, sorted by name. */
+  std::vector<Value> counters;
+
+  /** @brief The gauges, sorted by name. */
+  std::vector<Value> gauges;
+
+  /** @brief The histograms, sorted by name. */
+  std::vector<Histogram> histograms;
+};
+
+/**
+ * @brief A collection of named metrics that subsystems publish to.
+ *
+ * Metrics are created the first time they are requested by name and live as
+ * long as the registry, so a reference to a metric may be kept and updated
+ * without touching the registry again. Looking a metric up by name takes a
+ * lock, so code on hot paths should look up its metrics once and keep the
+ * references.
+ *
+ * cesium-native publishes to {@link MetricsRegistry::getDefault}. The names
+ * of its metrics are dot-separated, starting with the subsystem, such as
+ * `tileset.tilesLoading` or `cache.hits`.
+ */
+class CESIUMUTILITY_API MetricsRegistry final {
+public:
+  /**
+   * @brief Gets the registry that cesium-native publishes its metrics to.
+   */
+  static MetricsRegistry& getDefault() noexcept;
+
+  /**
+   * @brief Gets the counter with the given name, creating it if necessary.
+   */
+  MetricCounter& counter(const std::string& name);
+
+  /**
+   * @brief Gets the gauge with the given name, creating it if necessary.
+   */
+  MetricGauge& gauge(const std::string& name);
+
+  /**
+   * @brief Gets the histogram with the given name, creating it if necessary.
+   */
+  MetricHistogram& histogram(const std::string& name);
+
+  /**
+   * @brief Copies the current value of every metric.
+   *
+   * Metrics may be updated by other threads while the snapshot is taken, so
+   * values in the snapshot are not guaranteed to be consistent with each
+   * other.
+   */
+  MetricsSnapshot snapshot() const;
+
+  /**
+   * @brief Resets every counter and histogram to zero.
+   *
+   * Gauges are left alone, because they track the current state of
+   * something rather than accumulate events.
+   */
+  void resetCounters() noexcept;
+
+private:
+  mutable std::mutex _mutex;
+  std::map<std::string, std::unique_ptr<MetricCounter>> _counters;
+  std::map<std::string, std::unique_ptr<MetricGauge>> _gauges;
+  std::map<std::string, std::unique_ptr<MetricHistogram>> _histograms;
+};
+
+/**
+ * @brief Records the time between its construction and destruction, in
+ * microseconds, in a {@link MetricHistogram}.
+ */
+class CESIUMUTILITY_API ScopedMetricTimer final {
+public:
+  /**
+   * @brief Starts timing.
+   *
+   * @param histogram The histogram that receives the elapsed time.
+   */
+  explicit ScopedMetricTimer(MetricHistogram& histogram) noexcept
+      : _histogram(histogram), _start(std::chrono::steady_clock::now()) {}
+
+  ~ScopedMetricTimer() noexcept {
+    this->_histogram.record(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - this->_start)
+            .count());
+  }
+
+  ScopedMetricTimer(const ScopedMetricTimer&) = delete;
+  ScopedMetricTimer& operator=(const ScopedMetricTimer&) = delete;
+
+private:
+  MetricHistogram& _histogram;
+  std::chrono::steady_clock::time_point _start;
+};
+
+} // namespace CesiumUtility
@@ -12,6 +12,7 @@
 
 #define CESIUM_TRACE_INIT(filename)
 #define CESIUM_TRACE_SHUTDOWN()
+#define CESIUM_TRACE_SET_ENABLED(enabled)
 #define CESIUM_TRACE(name)
 #define CESIUM_TRACE_BEGIN(name)
 #define CESIUM_TRACE_END(name)
@@ -27,7 +28,10 @@
 #include <atomic>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -52,6 +56,23 @@
 #define CESIUM_TRACE_SHUTDOWN()                                                \
   CesiumUtility::CesiumImpl::Tracer::instance().endTracing()
 
+/**
+ * @brief Pauses or resumes recording of trace events.
+ *
+ * Recording is enabled by {@link CESIUM_TRACE_INIT}. While it is paused, the
+ * tracing macros cost little more than a check of an atomic flag, so tracing
+ * can be compiled in and switched on only while it is needed.
+ *
+ * Whether a {@link CESIUM_TRACE} scope is recorded is decided when the scope
+ * begins, so pausing or resuming while it is open never records only half of
+ * it. Pausing between a {@link CESIUM_TRACE_BEGIN} and its
+ * {@link CESIUM_TRACE_END} drops the end event, so avoid doing so.
+ *
+ * @param enabled Whether trace events should be recorded.
+ */
+#define CESIUM_TRACE_SET_ENABLED(enabled)                                      \
+  CesiumUtility::CesiumImpl::Tracer::instance().setEnabled(enabled)
+
 /**
  * @brief Measures and records the time spent in the current scope.
  *
@@ -212,7 +233,12 @@ struct Trace {
 };
 
 class TrackReference;
+class TraceEventBuffer;
 
+// Events are recorded into a buffer owned by the recording thread without
+// taking any locks, and a background thread periodically writes them to the
+// output file. If a thread records events faster than they are written, the
+// excess events are dropped rather than blocking the thread.
 class Tracer {
 public:
   static Tracer& instance();
@@ -222,6 +248,11 @@ public:
   void startTracing(const std::string& filePath = "trace.json");
   void endTracing();
 
+  bool isEnabled() const noexcept {
+    return this->_enabled.load(std::memory_order_relaxed);
+  }
+  void setEnabled(bool enabled) noexcept;
+
   void writeCompleteEvent(const Trace& trace);
   void writeAsyncEventBegin(const char* name, int64_t id);
   void writeAsyncEventBegin(const char* name);
@@ -230,24 +261,47 @@ public:
 
   int64_t allocateTrackID();
 
+  uint64_t getDroppedEventCount() const noexcept;
+
 private:
   Tracer();
 
   int64_t getCurrentThreadTrackID() const;
-  void writeAsyncEvent(
-      const char* category,
+  void writeAsyncEvent(const char* name, char type, int64_t id);
+  void recordEvent(
       const char* name,
       char type,
-      int64_t id);
+      int64_t timestamp,
+      int64_t durationOrID);
+  void pushEvent(
+      const char* name,
+      char type,
+      int64_t timestamp,
+      int64_t durationOrID);
+  TraceEventBuffer& getCurrentThreadBuffer();
+  void flushContinuously();
+  void flushBuffers();
 
   std::ofstream _output;
   uint32_t _numTraces;
-  std::mutex _lock;
+  std::atomic<bool> _tracing;
+  std::atomic<bool> _enabled;
+  std::atomic<uint64_t> _session;
+  std::mutex _outputLock;
+  std::mutex _buffersLock;
+  std::vector<std::shared_ptr<TraceEventBuffer>> _buffers;
+  std::atomic<uint64_t> _droppedEvents;
+  std::thread _flushThread;
+  std::condition_variable _flushCondition;
+  bool _stopFlushing;
   std::atomic<int64_t> _lastAllocatedID;
+
+  friend class ScopedTrace;
 };
 
 class ScopedTrace {
 public:
+  explicit ScopedTrace(const char* message);
   explicit ScopedTrace(const std::string& message);
   ~ScopedTrace();
 
@@ -259,9 +313,16 @@ public:
   ScopedTrace& operator=(ScopedTrace&& rhs) = delete;
 
 private:
-  std::string _name;
+  // The name is copied, and truncated like the names of all trace events, so
+  // that tracing a scope never allocates.
+  char _name[64];
   std::chrono::steady_clock::time_point _startTime;
-  std::thread::id _threadId;
+  // The ID of the track in which the scope's begin event was recorded, or -1
+  // if the scope is recorded as a single complete event.
+  int64_t _trackID;
+  // The tracing session in which the scope began, so that its end event is
+  // recorded even if recording is paused before the scope ends.
+  uint64_t _session;
   bool _reset;
 };
 
@@ -0,0 +1,105 @@
+#include "CesiumUtility/Metrics.h"
+
+namespace CesiumUtility {
+namespace {
+size_t getBucket(int64_t value) noexcept {
+  size_t bucket = 0;
+  uint64_t remaining = static_cast<uint64_t>(value);
+  while (remaining != 0 && bucket < MetricHistogram::BucketCount - 1) {
+    remaining >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+template <typename T>
+T& findOrCreate(
+    std::map<std::string, std::unique_ptr<T>>& metrics,
+    const std::string& name) {
+  std::unique_ptr<T>& pMetric = metrics[name];
+  if (!pMetric) {
+    pMetric = std::make_unique<T>();
+  }
+  return *pMetric;
+}
+} // namespace
+
+void MetricHistogram::record(int64_t value) noexcept {
+  if (value < 0) {
+    value = 0;
+  }
+  this->_buckets[getBucket(value)].fetch_add(1, std::memory_order_relaxed);
+  this->_count.fetch_add(1, std::memory_order_relaxed);
+  this->_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+void MetricHistogram::reset() noexcept {
+  for (std::atomic<int64_t>& bucket : this->_buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  this->_count.store(0, std::memory_order_relaxed);
+  this->_sum.store(0, std::memory_order_relaxed);
+}
+
+MetricsRegistry& MetricsRegistry::getDefault() noexcept {
+  // Never destroyed, so that metrics may still be updated by threads that
+  // outlive static destruction.
+  static MetricsRegistry* pRegistry = new MetricsRegistry();
+  return *pRegistry;
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string& name) {
+  std::lock_guard<std::mutex> lock(this->_mutex);
+  return findOrCreate(this->_counters, name);
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name) {
+  std::lock_guard<std::mutex> lock(this->_mutex);
+  return findOrCreate(this->_gauges, name);
+}
+
+MetricHistogram& MetricsRegistry::histogram(const std::string& name) {
+  std::lock_guard<std::mutex> lock(this->_mutex);
+  return findOrCreate(this->_histograms, name);
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const {
+  MetricsSnapshot result;
+
+  std::lock_guard<std::mutex> lock(this->_mutex);
+
+  result.counters.reserve(this->_counters.size());
+  for (const auto& [name, pCounter] : this->_counters) {
+    result.counters.push_back({name, pCounter->getValue()});
+  }
+
+  result.gauges.reserve(this->_gauges.size());
+  for (const auto& [name, pGauge] : this->_gauges) {
+    result.gauges.push_back({name, pGauge->getValue()});
+  }
+
+  result.histograms.reserve(this->_histograms.size());
+  for (const auto& [name, pHistogram] : this->_histograms) {
+    MetricsSnapshot::Histogram& histogram = result.histograms.emplace_back();
+    histogram.name = name;
+    histogram.count = pHistogram->getCount();
+    histogram.sum = pHistogram->getSum();
+    histogram.bucketCounts.resize(MetricHistogram::BucketCount);
+    for (size_t i = 0; i < MetricHistogram::BucketCount; ++i) {
+      histogram.bucketCounts[i] = pHistogram->getBucketCount(i);
+    }
+  }
+
+  return result;
+}
+
+void MetricsRegistry::resetCounters() noexcept {
+  std::lock_guard<std::mutex> lock(this->_mutex);
+  for (auto& pair : this->_counters) {
+    pair.second->_value.store(0, std::memory_order_relaxed);
+  }
+  for (auto& pair : this->_histograms) {
+    pair.second->reset();
+  }
+}
+} // namespace CesiumUtility
@@ -5,12 +5,84 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 
 #if CESIUM_TRACING_ENABLED
 
 namespace CesiumUtility {
 namespace CesiumImpl {
 
+namespace {
+int64_t getMicroseconds(std::chrono::steady_clock::time_point time) {
+  return std::chrono::time_point_cast<std::chrono::microseconds>(time)
+      .time_since_epoch()
+      .count();
+}
+} // namespace
+
+struct TraceEvent {
+  // Names are copied, and truncated if necessary, so that recording an event
+  // never allocates.
+  char name[64];
+  char type;
+  int64_t timestamp;
+  int64_t durationOrID;
+};
+
+// A single-producer, single-consumer ring buffer of the events recorded by
+// one thread. Only the owning thread writes events, and only the flushing
+// thread (holding the Tracer's output lock) reads them.
+class TraceEventBuffer {
+public:
+  static constexpr uint64_t capacity = 1024;
+
+  TraceEventBuffer() noexcept
+      : threadID(std::this_thread::get_id()),
+        ownerExited(false),
+        _writeIndex(0),
+        _readIndex(0) {}
+
+  bool tryPush(
+      const char* name,
+      char type,
+      int64_t timestamp,
+      int64_t durationOrID) noexcept {
+    const uint64_t write = this->_writeIndex.load(std::memory_order_relaxed);
+    const uint64_t read = this->_readIndex.load(std::memory_order_acquire);
+    if (write - read >= capacity) {
+      return false;
+    }
+
+    TraceEvent& event = this->_events[write % capacity];
+    std::strncpy(event.name, name, sizeof(event.name) - 1);
+    event.name[sizeof(event.name) - 1] = '\0';
+    event.type = type;
+    event.timestamp = timestamp;
+    event.durationOrID = durationOrID;
+
+    this->_writeIndex.store(write + 1, std::memory_order_release);
+    return true;
+  }
+
+  template <typename Callback> bool drain(Callback&& callback) {
+    const uint64_t read = this->_readIndex.load(std::memory_order_relaxed);
+    const uint64_t write = this->_writeIndex.load(std::memory_order_acquire);
+    for (uint64_t i = read; i < write; ++i) {
+      callback(this->_events[i % capacity]);
+    }
+    this->_readIndex.store(write, std::memory_order_release);
+    return read != write;
+  }
+
+  const std::thread::id threadID;
+  std::atomic<bool> ownerExited;
+
+private:
+  std::atomic<uint64_t> _writeIndex;
+  std::atomic<uint64_t> _readIndex;
+  TraceEvent _events[capacity];
+};
+
 Tracer& Tracer::instance() {
   static Tracer instance;
   return instance;
@@ -19,39 +91,51 @@ Tracer& Tracer::instance() {
 Tracer::~Tracer() { endTracing(); }
 
 void Tracer::startTracing(const std::string& filePath) {
+  std::lock_guard<std::mutex> lock(this->_outputLock);
+  if (this->_tracing) {
+    return;
+  }
+
   this->_output.open(filePath);
   this->_output << "{\"otherData\": {},\"traceEvents\":[";
+  this->_numTraces = 0;
+  this->_stopFlushing = false;
+  this->_flushThread = std::thread([this]() { this->flushContinuously(); });
+  ++this->_session;
+  this->_tracing = true;
+  this->_enabled = true;
 }
 
 void Tracer::endTracing() {
-  this->_output << "]}";
-  this->_output.close();
-}
-
-void Tracer::writeCompleteEvent(const Trace& trace) {
-  std::lock_guard<std::mutex> lock(_lock);
-  if (!this->_output) {
+  if (!this->_tracing.exchange(false)) {
     return;
   }
+  this->_enabled = false;
 
-  // Chrome tracing wants the text like this
-  if (this->_numTraces++ > 0) {
-    this->_output << ",";
+  {
+    std::lock_guard<std::mutex> lock(this->_buffersLock);
+    this->_stopFlushing = true;
   }
+  this->_flushCondition.notify_one();
+  this->_flushThread.join();
+
+  this->flushBuffers();
+
+  std::lock_guard<std::mutex> lock(this->_outputLock);
+  this->_output << "]}";
+  this->_output.close();
+}
+
+void Tracer::setEnabled(bool enabled) noexcept {
+  this->_enabled = enabled && this->_tracing;
+}
 
-  this->_output << "{";
-  this->_output << "\"cat\":\"cesium\",";
-  this->_output << "\"dur\":" << trace.duration << ',';
-  this->_output << "\"name\":\"" << trace.name << "\",";
-  this->_output << "\"ph\":\"X\",";
-  this->_output << "\"pid\":0,";
-  this->_output << "\"tid\":" << trace.threadID << ",";
-  this->_output << "\"ts\":" << trace.start;
-  this->_output << "}";
+void Tracer::writeCompleteEvent(const Trace& trace) {
+  this->recordEvent(trace.name.c_str(), 'X', trace.start, trace.duration);
 }
 
 void Tracer::writeAsyncEventBegin(const char* name, int64_t id) {
-  this->writeAsyncEvent("cesium", name, 'b', id);
+  this->writeAsyncEvent(name, 'b', id);
 }
 
 void Tracer::writeAsyncEventBegin(const char* name) {
@@ -59,7 +143,7 @@ void Tracer::writeAsyncEventBegin(const char* name) {
 }
 
 void Tracer::writeAsyncEventEnd(const char* name, int64_t id) {
-  this->writeAsyncEvent("cesium", name, 'e', id);
+  this->writeAsyncEvent(name, 'e', id);
 }
 
 void Tracer::writeAsyncEventEnd(const char* name) {
@@ -68,23 +152,33 @@ void Tracer::writeAsyncEventEnd(const char* name) {
 
 int64_t Tracer::allocateTrackID() { return ++this->_lastAllocatedID; }
 
-Tracer::Tracer() : _output{}, _numTraces{0}, _lock{}, _lastAllocatedID(0) {}
+uint64_t Tracer::getDroppedEventCount() const noexcept {
+  return this->_droppedEvents;
+}
+
+Tracer::Tracer()
+    : _output{},
+      _numTraces{0},
+      _tracing{false},
+      _enabled{false},
+      _session{0},
+      _outputLock{},
+      _buffersLock{},
+      _buffers{},
+      _droppedEvents{0},
+      _flushThread{},
+      _flushCondition{},
+      _stopFlushing{false},
+      _lastAllocatedID(0) {}
 
 int64_t Tracer::getCurrentThreadTrackID() const {
   const TrackReference* pTrack = TrackReference::current();
   return pTrack->getTracingID();
 }
 
-void Tracer::writeAsyncEvent(
-    const char* category,
-    const char* name,
-    char type,
-    int64_t id) {
-
-  bool isAsync = true;
+void Tracer::writeAsyncEvent(const char* name, char type, int64_t id) {
   if (id < 0) {
     // Use a standard Duration event for slices without an async ID.
-    isAsync = false;
     if (type == 'b') {
       type = 'B';
     } else if (type == 'e') {
@@ -92,43 +186,147 @@ void Tracer::writeAsyncEvent(
     }
   }
 
-  std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
-  int64_t microseconds =
-      std::chrono::time_point_cast<std::chrono::microseconds>(time)
-          .time_since_epoch()
-          .count();
+  this->recordEvent(
+      name,
+      type,
+      getMicroseconds(std::chrono::steady_clock::now()),
+      id);
+}
 
-  std::lock_guard<std::mutex> lock(_lock);
-  if (!this->_output) {
+void Tracer::recordEvent(
+    const char* name,
+    char type,
+    int64_t timestamp,
+    int64_t durationOrID) {
+  if (!this->isEnabled()) {
     return;
   }
 
-  // Chrome tracing wants the text like this
-  if (this->_numTraces++ > 0) {
-    this->_output << ",";
+  this->pushEvent(name, type, timestamp, durationOrID);
+}
+
+void Tracer::pushEvent(
+    const char* name,
+    char type,
+    int64_t timestamp,
+    int64_t durationOrID) {
+  if (!this->getCurrentThreadBuffer()
+           .tryPush(name, type, timestamp, durationOrID)) {
+    ++this->_droppedEvents;
   }
-  this->_output << "{";
-  this->_output << "\"cat\":\"" << category << "\",";
-  if (isAsync) {
-    this->_output << "\"id\":" << id << ",";
-  } else {
-    this->_output << "\"tid\":" << std::this_thread::get_id() << ",";
+}
+
+TraceEventBuffer& Tracer::getCurrentThreadBuffer() {
+  // Marks the buffer so that it is discarded once its remaining events have
+  // been written, when the thread exits.
+  struct BufferOwner {
+    std::shared_ptr<TraceEventBuffer> pBuffer;
+
+    ~BufferOwner() {
+      if (this->pBuffer) {
+        this->pBuffer->ownerExited = true;
+      }
+    }
+  };
+
+  thread_local BufferOwner owner;
+  if (!owner.pBuffer) {
+    owner.pBuffer = std::make_shared<TraceEventBuffer>();
+    std::lock_guard<std::mutex> lock(this->_buffersLock);
+    this->_buffers.emplace_back(owner.pBuffer);
   }
-  this->_output << "\"name\":\"" << name << "\",";
-  this->_output << "\"ph\":\"" << type << "\",";
-  this->_output << "\"pid\":0,";
-  this->_output << "\"ts\":" << microseconds;
-  this->_output << "}";
+  return *owner.pBuffer;
 }
 
-ScopedTrace::ScopedTrace(const std::string& message)
-    : _name{message},
-      _startTime{std::chrono::steady_clock::now()},
-      _threadId{std::this_thread::get_id()},
-      _reset{false} {
-  CESIUM_TRACE_BEGIN_IN_TRACK(_name.c_str());
+void Tracer::flushContinuously() {
+  std::unique_lock<std::mutex> lock(this->_buffersLock);
+  while (!this->_stopFlushing) {
+    this->_flushCondition.wait_for(lock, std::chrono::milliseconds(20));
+    lock.unlock();
+    this->flushBuffers();
+    lock.lock();
+  }
+}
+
+void Tracer::flushBuffers() {
+  std::vector<std::shared_ptr<TraceEventBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(this->_buffersLock);
+    // Forget buffers whose threads have exited. They are drained one last
+    // time below.
+    buffers = this->_buffers;
+    this->_buffers.erase(
+        std::remove_if(
+            this->_buffers.begin(),
+            this->_buffers.end(),
+            [](const std::shared_ptr<TraceEventBuffer>& pBuffer) {
+              return pBuffer->ownerExited.load();
+            }),
+        this->_buffers.end());
+  }
+
+  std::lock_guard<std::mutex> lock(this->_outputLock);
+  for (const std::shared_ptr<TraceEventBuffer>& pBuffer : buffers) {
+    pBuffer->drain([this, &pBuffer](const TraceEvent& event) {
+      if (!this->_output) {
+        return;
+      }
+
+      // Chrome tracing wants the text like this
+      if (this->_numTraces++ > 0) {
+        this->_output << ",";
+      }
+
+      this->_output << "{";
+      this->_output << "\"cat\":\"cesium\",";
+      if (event.type == 'X') {
+        this->_output << "\"dur\":" << event.durationOrID << ',';
+        this->_output << "\"tid\":" << pBuffer->threadID << ",";
+      } else if (event.type == 'b' || event.type == 'e') {
+        this->_output << "\"id\":" << event.durationOrID << ",";
+      } else {
+        this->_output << "\"tid\":" << pBuffer->threadID << ",";
+      }
+      this->_output << "\"name\":\"" << event.name << "\",";
+      this->_output << "\"ph\":\"" << event.type << "\",";
+      this->_output << "\"pid\":0,";
+      this->_output << "\"ts\":" << event.timestamp;
+      this->_output << "}";
+    });
+  }
+}
+
+ScopedTrace::ScopedTrace(const char* message)
+    : _name{},
+      _startTime{},
+      _trackID{-1},
+      _session{0},
+      _reset{true} {
+  // Don't pay for copying the name or reading the clock when tracing is off.
+  Tracer& tracer = Tracer::instance();
+  if (!tracer.isEnabled()) {
+    return;
+  }
+
+  std::strncpy(this->_name, message, sizeof(this->_name) - 1);
+  this->_startTime = std::chrono::steady_clock::now();
+  this->_session = tracer._session;
+  this->_reset = false;
+
+  const TrackReference* pTrack = TrackReference::current();
+  if (pTrack) {
+    this->_trackID = pTrack->getTracingID();
+    tracer.pushEvent(
+        this->_name,
+        'b',
+        getMicroseconds(this->_startTime),
+        this->_trackID);
+  }
 }
 
+ScopedTrace::ScopedTrace(const std::string& message)
+    : ScopedTrace(message.c_str()) {}
+
 ScopedTrace::~ScopedTrace() {
   if (!this->_reset) {
     this->reset();
@@ -138,20 +336,18 @@ ScopedTrace::~ScopedTrace() {
 void ScopedTrace::reset() {
   this->_reset = true;
 
-  if (TrackReference::current() != nullptr) {
-    CESIUM_TRACE_END(_name.c_str());
+  Tracer& tracer = Tracer::instance();
+  const int64_t end = getMicroseconds(std::chrono::steady_clock::now());
+
+  if (this->_trackID >= 0) {
+    // The begin event has been recorded, so record the matching end event
+    // even if recording has been paused since, unless tracing has stopped.
+    if (tracer._tracing && tracer._session == this->_session) {
+      tracer.pushEvent(this->_name, 'e', end, this->_trackID);
+    }
   } else {
-    auto endTimePoint = std::chrono::steady_clock::now();
-    int64_t start = std::chrono::time_point_cast<std::chrono::microseconds>(
-                        this->_startTime)
-                        .time_since_epoch()
-                        .count();
-    int64_t end =
-        std::chrono::time_point_cast<std::chrono::microseconds>(endTimePoint)
-            .time_since_epoch()
-            .count();
-    Tracer::instance().writeCompleteEvent(
-        {this->_name, start, end - start, this->_threadId});
+    const int64_t start = getMicroseconds(this->_startTime);
+    tracer.recordEvent(this->_name, 'X', start, end - start);
   }
 }
 
@@ -0,0 +1,101 @@
+#include <CesiumUtility/Metrics.h>
+
+#include <catch2/catch.hpp>
+
+#include <limits>
+#include <thread>
+#include <vector>
+
+using namespace CesiumUtility;
+
+TEST_CASE("MetricsRegistry") {
+  MetricsRegistry registry;
+
+  SECTION("returns the same metric for the same name") {
+    MetricCounter& counter = registry.counter("test.counter");
+    CHECK(&registry.counter("test.counter") == &counter);
+    CHECK(&registry.counter("test.other") != &counter);
+  }
+
+  SECTION("counters and gauges accumulate") {
+    registry.counter("test.counter").increment();
+    registry.counter("test.counter").increment(4);
+    CHECK(registry.counter("test.counter").getValue() == 5);
+
+    MetricGauge& gauge = registry.gauge("test.gauge");
+    gauge.set(10);
+    gauge.add(-3);
+    CHECK(gauge.getValue() == 7);
+  }
+
+  SECTION("histograms count values in power-of-two buckets") {
+    MetricHistogram& histogram = registry.histogram("test.histogram");
+    histogram.record(0);
+    histogram.record(1);
+    histogram.record(5);
+    histogram.record(7);
+    histogram.record(-2);
+
+    CHECK(histogram.getCount() == 5);
+    CHECK(histogram.getSum() == 13);
+    CHECK(histogram.getBucketCount(0) == 2);
+    CHECK(histogram.getBucketCount(1) == 1);
+    CHECK(histogram.getBucketCount(3) == 2);
+    CHECK(MetricHistogram::getBucketUpperBound(3) == 8);
+
+    histogram.record(std::numeric_limits<int64_t>::max());
+    CHECK(histogram.getBucketCount(MetricHistogram::BucketCount - 1) == 1);
+  }
+
+  SECTION("snapshot copies every metric sorted by name") {
+    registry.counter("b").increment(2);
+    registry.counter("a").increment(1);
+    registry.gauge("g").set(3);
+    registry.histogram("h").record(4);
+
+    MetricsSnapshot snapshot = registry.snapshot();
+    REQUIRE(snapshot.counters.size() == 2);
+    CHECK(snapshot.counters[0].name == "a");
+    CHECK(snapshot.counters[0].value == 1);
+    CHECK(snapshot.counters[1].name == "b");
+    CHECK(snapshot.counters[1].value == 2);
+    REQUIRE(snapshot.gauges.size() == 1);
+    CHECK(snapshot.gauges[0].value == 3);
+    REQUIRE(snapshot.histograms.size() == 1);
+    CHECK(snapshot.histograms[0].count == 1);
+    CHECK(snapshot.histograms[0].sum == 4);
+    CHECK(
+        snapshot.histograms[0].bucketCounts.size() ==
+        MetricHistogram::BucketCount);
+    CHECK(snapshot.histograms[0].bucketCounts[3] == 1);
+  }
+
+  SECTION("resetCounters leaves gauges alone") {
+    registry.counter("c").increment(2);
+    registry.gauge("g").set(3);
+    registry.histogram("h").record(4);
+
+    registry.resetCounters();
+
+    CHECK(registry.counter("c").getValue() == 0);
+    CHECK(registry.gauge("g").getValue() == 3);
+    CHECK(registry.histogram("h").getCount() == 0);
+    CHECK(registry.histogram("h").getSum() == 0);
+  }
+
+  SECTION("metrics may be updated from many threads") {
+    MetricCounter& counter = registry.counter("test.counter");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([&counter]() {
+        for (int j = 0; j < 1000; ++j) {
+          counter.increment();
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    CHECK(counter.getValue() == 4000);
+  }
+}
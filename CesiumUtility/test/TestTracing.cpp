@@ -0,0 +1,120 @@
+#include <CesiumUtility/Tracing.h>
+
+// The tracing framework is only compiled when CESIUM_TRACING_ENABLED is set.
+#if CESIUM_TRACING_ENABLED
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CesiumUtility::CesiumImpl;
+
+namespace {
+// Records a trace while running the given function, and returns the JSON
+// that was written.
+template <typename Function> std::string recordTrace(Function&& function) {
+  const std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "cesium-native-trace.json";
+
+  CESIUM_TRACE_INIT(path.string());
+  function();
+  CESIUM_TRACE_SHUTDOWN();
+
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  file.close();
+  std::filesystem::remove(path);
+  return contents.str();
+}
+
+size_t countOccurrences(const std::string& text, const std::string& pattern) {
+  size_t count = 0;
+  for (size_t position = text.find(pattern); position != std::string::npos;
+       position = text.find(pattern, position + pattern.size())) {
+    ++count;
+  }
+  return count;
+}
+} // namespace
+
+TEST_CASE("Tracing") {
+  SECTION("writes or counts every event recorded on any thread") {
+    constexpr size_t threadCount = 4;
+    constexpr size_t eventsPerThread = 5000;
+
+    const uint64_t droppedBefore = Tracer::instance().getDroppedEventCount();
+    const std::string json = recordTrace([]() {
+      std::vector<std::thread> threads;
+      for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back([]() {
+          for (size_t j = 0; j < eventsPerThread; ++j) {
+            CESIUM_TRACE("scope");
+          }
+        });
+      }
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+    });
+    const uint64_t dropped =
+        Tracer::instance().getDroppedEventCount() - droppedBefore;
+
+    CHECK(json.rfind("{\"otherData\": {},\"traceEvents\":[", 0) == 0);
+    CHECK(json.substr(json.size() - 2) == "]}");
+    CHECK(
+        countOccurrences(json, "\"name\":\"scope\",\"ph\":\"X\"") + dropped ==
+        threadCount * eventsPerThread);
+  }
+
+  SECTION("truncates long names") {
+    const std::string json = recordTrace([]() {
+      CESIUM_TRACE(std::string(100, 'a'));
+    });
+    CHECK(countOccurrences(json, std::string(63, 'a') + "\"") == 1);
+    CHECK(countOccurrences(json, std::string(64, 'a')) == 0);
+  }
+
+  SECTION("records nothing while paused") {
+    const std::string json = recordTrace([]() {
+      CESIUM_TRACE_SET_ENABLED(false);
+      { CESIUM_TRACE("paused"); }
+      CESIUM_TRACE_SET_ENABLED(true);
+      { CESIUM_TRACE("resumed"); }
+    });
+    CHECK(countOccurrences(json, "\"name\":\"paused\"") == 0);
+    CHECK(countOccurrences(json, "\"name\":\"resumed\"") == 1);
+  }
+
+  SECTION("matches the events of a scope that is open while pausing") {
+    const std::string json = recordTrace([]() {
+      CESIUM_TRACE_DECLARE_TRACK_SET(tracks, "Tracks");
+      CESIUM_TRACE_USE_TRACK_SET(tracks);
+
+      {
+        CESIUM_TRACE("paused inside");
+        CESIUM_TRACE_SET_ENABLED(false);
+      }
+
+      {
+        CESIUM_TRACE("resumed inside");
+        CESIUM_TRACE_SET_ENABLED(true);
+      }
+    });
+
+    CHECK(
+        countOccurrences(json, "\"name\":\"paused inside\",\"ph\":\"b\"") ==
+        1);
+    CHECK(
+        countOccurrences(json, "\"name\":\"paused inside\",\"ph\":\"e\"") ==
+        1);
+    CHECK(countOccurrences(json, "\"name\":\"resumed inside\"") == 0);
+  }
+}
+
+#endif // CESIUM_TRACING_ENABLED